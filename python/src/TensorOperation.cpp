@@ -1,10 +1,7 @@
 #include "TensorOperation.h"
 #include <cstdint>
 #include <tuple>
-
-#ifdef _OPENMP
-#include <omp.h>
-#endif
+#include <einsum_ir/basic/parallel/ExecutionContext.h>
 
 einsum_ir::py::TensorOperation::op_type_t
 einsum_ir::py::TensorOperation::determine_op_type( prim_t prim_main ) {
@@ -24,15 +21,9 @@ einsum_ir::py::TensorOperation::determine_op_type( prim_t prim_main ) {
 
 int64_t einsum_ir::py::TensorOperation::get_num_threads( int64_t num_threads ) {
   int64_t l_num_threads = num_threads;
-#if defined(_OPENMP)
-  if (l_num_threads <= 0) {
-    l_num_threads = omp_get_max_threads();
-  }
-#else
   if( l_num_threads <= 0 ) {
-    l_num_threads = 1;
+    l_num_threads = einsum_ir::basic::ExecutionContext::get_default()->get_max_threads();
   }
-#endif
   return l_num_threads;
 }
 
@@ -143,6 +134,18 @@ einsum_ir::basic::kernel_t einsum_ir::py::TensorOperation::convert_prim_to_kerne
       return einsum_ir::basic::kernel_t::MADD;
     case einsum_ir::py::TensorOperation::prim_t::brgemm:
       return einsum_ir::basic::kernel_t::BR_MADD;
+    case einsum_ir::py::TensorOperation::prim_t::sigmoid:
+      return einsum_ir::basic::kernel_t::SIGMOID;
+    case einsum_ir::py::TensorOperation::prim_t::tanh:
+      return einsum_ir::basic::kernel_t::TANH;
+    case einsum_ir::py::TensorOperation::prim_t::gelu:
+      return einsum_ir::basic::kernel_t::GELU;
+    case einsum_ir::py::TensorOperation::prim_t::scale:
+      return einsum_ir::basic::kernel_t::SCALE;
+    case einsum_ir::py::TensorOperation::prim_t::clamp:
+      return einsum_ir::basic::kernel_t::CLAMP;
+    case einsum_ir::py::TensorOperation::prim_t::add_scaled:
+      return einsum_ir::basic::kernel_t::ADD_SCALED;
     default:
       break;
   }
@@ -222,10 +225,16 @@ int64_t einsum_ir::py::TensorOperation::dtype_to_num_bytes( dtype_t dtype ) {
   switch (dtype) {
     case dtype_t::fp32: return sizeof(float);
     case dtype_t::fp64: return sizeof(double);
+    case dtype_t::bf16: return 2;
+    case dtype_t::fp16: return 2;
     default:            return 0; // Undefined or unsupported type
   }
 }
 
+void einsum_ir::py::TensorOperation::set_last_touch_ops( std::vector< last_touch_op_t > const & ops ) {
+  m_last_touch_ops = ops;
+}
+
 einsum_ir::py::TensorOperation::error_t einsum_ir::py::TensorOperation::setup(
   dtype_t                                                      dtype,
   prim_t                                                       prim_first,
@@ -308,9 +317,11 @@ einsum_ir::py::TensorOperation::error_t einsum_ir::py::TensorOperation::setup_un
   switch (dtype) {
     case dtype_t::fp32: l_dtype_in = einsum_ir::basic::data_t::FP32; break;
     case dtype_t::fp64: l_dtype_in = einsum_ir::basic::data_t::FP64; break;
+    case dtype_t::bf16: l_dtype_in = einsum_ir::basic::data_t::BF16; break;
+    case dtype_t::fp16: l_dtype_in = einsum_ir::basic::data_t::FP16; break;
     default:            l_dtype_in = einsum_ir::basic::data_t::UNDEFINED_DTYPE; break;
   }
-  einsum_ir::basic::data_t l_dtype_comp = l_dtype_in;
+  einsum_ir::basic::data_t l_dtype_comp = einsum_ir::basic::ce_low_precision( l_dtype_in ) ? einsum_ir::basic::data_t::FP32 : l_dtype_in;
   einsum_ir::basic::data_t l_dtype_out  = l_dtype_in;
 
   // Convert kernel type
@@ -421,18 +432,35 @@ einsum_ir::py::TensorOperation::error_t einsum_ir::py::TensorOperation::setup_bi
   switch (dtype) {
     case dtype_t::fp32: l_dtype_left = einsum_ir::basic::data_t::FP32; break;
     case dtype_t::fp64: l_dtype_left = einsum_ir::basic::data_t::FP64; break;
+    case dtype_t::bf16: l_dtype_left = einsum_ir::basic::data_t::BF16; break;
+    case dtype_t::fp16: l_dtype_left = einsum_ir::basic::data_t::FP16; break;
     default:            l_dtype_left = einsum_ir::basic::data_t::UNDEFINED_DTYPE; break;
   }
   l_dtype_right = l_dtype_left;
-  l_dtype_comp  = l_dtype_left;
+  l_dtype_comp  = einsum_ir::basic::ce_low_precision( l_dtype_left ) ? einsum_ir::basic::data_t::FP32 : l_dtype_left;
   l_dtype_out   = l_dtype_left;
 
   l_ktype_first = convert_prim_to_kernel(prim_first);
   l_ktype_main = convert_prim_to_kernel(prim_main);
   l_ktype_last = convert_prim_to_kernel(prim_last);
 
-  // dummy strides for auxiliary output tensor
-  std::vector<int64_t> l_strides_out_aux(dim_sizes.size(), 0);
+  // convert the chain of last touch operations
+  std::vector<einsum_ir::basic::last_touch_op> l_last_touch_ops;
+  bool l_aux = false;
+  for (const auto & l_op : m_last_touch_ops) {
+    einsum_ir::basic::last_touch_op l_op_basic;
+    l_op_basic.ktype    = convert_prim_to_kernel(l_op.prim);
+    l_op_basic.scalar_0 = l_op.scalar_0;
+    l_op_basic.scalar_1 = l_op.scalar_1;
+    l_last_touch_ops.push_back(l_op_basic);
+
+    if (l_op.prim == prim_t::add_scaled) {
+      l_aux = true;
+    }
+  }
+
+  // auxiliary output tensor has the layout of the output if read by the last touch operations, dummy strides otherwise
+  std::vector<int64_t> l_strides_out_aux = l_aux ? l_strides_out : std::vector<int64_t>(dim_sizes.size(), 0);
 
   // init backend
   m_backend_binary.init( l_dim_types,
@@ -456,6 +484,10 @@ einsum_ir::py::TensorOperation::error_t einsum_ir::py::TensorOperation::setup_bi
                          l_num_threads[2],
                          nullptr );
 
+  if (l_last_touch_ops.size() > 0) {
+    m_backend_binary.set_last_touch_ops(l_last_touch_ops);
+  }
+
   // compile backend 
   einsum_ir::basic::err_t l_err = m_backend_binary.compile();
   if (l_err != einsum_ir::basic::err_t::SUCCESS) {
@@ -467,12 +499,28 @@ einsum_ir::py::TensorOperation::error_t einsum_ir::py::TensorOperation::setup_bi
 
 void einsum_ir::py::TensorOperation::execute( void const * tensor_in0,
                                               void const * tensor_in1,
-                                              void       * tensor_out) {
+                                              void       * tensor_out,
+                                              void const * tensor_aux ) {
   if (m_op_type == op_type_t::unary) {
     m_backend_unary.eval(tensor_in0, tensor_out);
   }
   else if (m_op_type == op_type_t::binary) {
-    m_backend_binary.contract(tensor_in0, tensor_in1, nullptr, tensor_out);
+    m_backend_binary.contract(tensor_in0, tensor_in1, tensor_aux, tensor_out);
+  }
+}
+
+void einsum_ir::py::TensorOperation::execute_batch( int64_t              num_batch,
+                                                    void const * const * tensors_in0,
+                                                    void const * const * tensors_in1,
+                                                    void       * const * tensors_out,
+                                                    void const * const * tensors_aux ) {
+  if (m_op_type == op_type_t::unary) {
+    for( int64_t l_ba = 0; l_ba < num_batch; l_ba++ ) {
+      m_backend_unary.eval(tensors_in0[l_ba], tensors_out[l_ba]);
+    }
+  }
+  else if (m_op_type == op_type_t::binary) {
+    m_backend_binary.contract_batch(num_batch, tensors_in0, tensors_in1, tensors_aux, tensors_out);
   }
 }
 
@@ -747,6 +795,8 @@ einsum_ir::py::TensorOperation::error_t einsum_ir::py::TensorOperation::optimize
                     br_gemm_support,
                     packing_support,
                     l_packed_gemm_support,
+                    false,
+                    false,
                     l_num_bytes,
                     l2_cache_size,
                     &num_threads[0],
@@ -49,13 +49,19 @@ class einsum_ir::py::TensorOperation {
 
     /// primitive type
     enum class prim_t : uint32_t {
-      none      =  0,
-      zero      =  1,
-      copy      =  2,
-      relu      =  3,
-      gemm      =  4,
-      brgemm    =  5,
-      undefined = 99
+      none       =  0,
+      zero       =  1,
+      copy       =  2,
+      relu       =  3,
+      gemm       =  4,
+      brgemm     =  5,
+      sigmoid    =  6,
+      tanh       =  7,
+      gelu       =  8,
+      scale      =  9,
+      clamp      = 10,
+      add_scaled = 11,
+      undefined  = 99
     };
 
     /// dimension type
@@ -70,7 +76,9 @@ class einsum_ir::py::TensorOperation {
     /// data type
     enum class dtype_t : uint32_t {
       fp32 = 0,
-      fp64 = 1
+      fp64 = 1,
+      bf16 = 2,
+      fp16 = 3
     };
 
     /// error codes
@@ -81,9 +89,27 @@ class einsum_ir::py::TensorOperation {
       invalid_optimization_config = 3
     };
 
+    /// fused last touch operation of a binary contraction
+    struct last_touch_op_t {
+      prim_t prim     = prim_t::none; // relu, sigmoid, tanh, gelu, scale, clamp or add_scaled
+      double scalar_0 = 0;            // factor of scale and add_scaled, lower bound of clamp
+      double scalar_1 = 0;            // upper bound of clamp
+    };
+
     op_type_t m_op_type = op_type_t::undefined;
     einsum_ir::basic::UnaryBackendTpp m_backend_unary;
     einsum_ir::basic::ContractionBackendTpp m_backend_binary;
+    std::vector< last_touch_op_t > m_last_touch_ops;
+
+    /**
+     * Sets a chain of last touch operations which replaces prim_last of binary contractions.
+     * The operations are applied in order to the output once the contraction finished.
+     * add_scaled reads an auxiliary tensor with the layout of the output.
+     * Has to be called before setup.
+     *
+     * @param ops Last touch operations.
+     **/
+    void set_last_touch_ops( std::vector< last_touch_op_t > const & ops );
 
     /**
      * Setup for a binary tensor contraction or a unary tensor operation.
@@ -118,10 +144,28 @@ class einsum_ir::py::TensorOperation {
      * @param tensor_in0 First input tensor.
      * @param tensor_in1 Second input tensor (use nullptr if unary).
      * @param tensor_out Output tensor.
+     * @param tensor_aux Auxiliary tensor of add_scaled (use nullptr otherwise).
      **/
     void execute( void const * tensor_in0,
                   void const * tensor_in1,
-                  void       * tensor_out );
+                  void       * tensor_out,
+                  void const * tensor_aux = nullptr );
+
+    /**
+     * Execute the tensor operation on a batch of tensors.
+     * Binary operations distribute the tasks of the whole batch across the threads of a single parallel region.
+     *
+     * @param num_batch   Number of tensor operations in the batch.
+     * @param tensors_in0 First input tensors.
+     * @param tensors_in1 Second input tensors (use nullptr if unary).
+     * @param tensors_out Output tensors.
+     * @param tensors_aux Auxiliary tensors of add_scaled (use nullptr otherwise).
+     **/
+    void execute_batch( int64_t              num_batch,
+                        void const * const * tensors_in0,
+                        void const * const * tensors_in1,
+                        void       * const * tensors_out,
+                        void const * const * tensors_aux = nullptr );
 
     /**
      * Optimizes a tensor operation configuration.
@@ -2,6 +2,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 #include <set>
+#include <stdexcept>
 #include "TensorOperation.h"
 
 namespace py  = pybind11;
@@ -18,17 +19,53 @@ PYBIND11_MODULE(_etops_core, m) {
   py::enum_<TensorOperation::dtype_t>(m, "DataType" )
     .value("float32",  TensorOperation::dtype_t::fp32)
     .value("float64",  TensorOperation::dtype_t::fp64)
+    .value("bfloat16", TensorOperation::dtype_t::bf16)
+    .value("float16",  TensorOperation::dtype_t::fp16)
     .export_values();
 
   py::enum_<TensorOperation::prim_t>(m, "PrimType")
-    .value("none",   TensorOperation::prim_t::none)
-    .value("zero",   TensorOperation::prim_t::zero)
-    .value("relu",   TensorOperation::prim_t::relu)
-    .value("copy",   TensorOperation::prim_t::copy)
-    .value("gemm",   TensorOperation::prim_t::gemm)
-    .value("brgemm", TensorOperation::prim_t::brgemm)
+    .value("none",       TensorOperation::prim_t::none)
+    .value("zero",       TensorOperation::prim_t::zero)
+    .value("relu",       TensorOperation::prim_t::relu)
+    .value("copy",       TensorOperation::prim_t::copy)
+    .value("gemm",       TensorOperation::prim_t::gemm)
+    .value("brgemm",     TensorOperation::prim_t::brgemm)
+    .value("sigmoid",    TensorOperation::prim_t::sigmoid)
+    .value("tanh",       TensorOperation::prim_t::tanh)
+    .value("gelu",       TensorOperation::prim_t::gelu)
+    .value("scale",      TensorOperation::prim_t::scale)
+    .value("clamp",      TensorOperation::prim_t::clamp)
+    .value("add_scaled", TensorOperation::prim_t::add_scaled)
     .export_values();
 
+  py::class_<TensorOperation::last_touch_op_t>(m, "LastTouchOp")
+    .def(
+      py::init(
+        []( TensorOperation::prim_t prim,
+            double                  scalar_0,
+            double                  scalar_1 ) {
+          TensorOperation::last_touch_op_t l_op;
+          l_op.prim     = prim;
+          l_op.scalar_0 = scalar_0;
+          l_op.scalar_1 = scalar_1;
+          return l_op;
+        }
+      ),
+      R"doc(
+        Fused last touch operation of a binary contraction.
+
+        :param prim: relu, sigmoid, tanh, gelu, scale, clamp or add_scaled.
+        :param scalar_0: Factor of scale and add_scaled, lower bound of clamp.
+        :param scalar_1: Upper bound of clamp.
+      )doc",
+      py::arg("prim"),
+      py::arg("scalar_0") = 0.0,
+      py::arg("scalar_1") = 0.0
+    )
+    .def_readwrite("prim",     &TensorOperation::last_touch_op_t::prim)
+    .def_readwrite("scalar_0", &TensorOperation::last_touch_op_t::scalar_0)
+    .def_readwrite("scalar_1", &TensorOperation::last_touch_op_t::scalar_1);
+
   py::enum_<TensorOperation::exec_t>(m, "ExecType")
     .value("prim",   TensorOperation::exec_t::prim)
     .value("seq",    TensorOperation::exec_t::seq)
@@ -45,6 +82,20 @@ PYBIND11_MODULE(_etops_core, m) {
 
   py::class_<TensorOperation>(m, "TensorOperation")
     .def(py::init<>())
+    .def(
+      "set_last_touch_ops",
+      &TensorOperation::set_last_touch_ops,
+      R"doc(
+        Set a chain of last touch operations which replaces prim_last of binary contractions.
+
+        The operations are applied in order to the output once the contraction finished.
+        add_scaled reads an auxiliary tensor with the layout of the output which is passed to execute.
+        Has to be called before setup.
+
+        :param ops: List of LastTouchOp.
+      )doc",
+      py::arg("ops")
+    )
     .def(
       "setup",
       [](
@@ -86,7 +137,8 @@ PYBIND11_MODULE(_etops_core, m) {
           - prim_main: gemm or brgemm
           - dim_types: use m, n, k, c as appropriate for contraction semantics
           - prim_first: zero or none (first touch operation)
-          - prim_last: relu or none (last touch operation)
+          - prim_last: relu, sigmoid, tanh, gelu or none (last touch operation),
+                       chains with scale, clamp and add_scaled through set_last_touch_ops
           - strides: [LEVEL][3][DIMENSION] tensor (each level has 3 tensors: in0, in1, out)
 
         Strides 3D tensor structure [LEVEL][TENSOR][DIMENSION]:
@@ -121,12 +173,14 @@ PYBIND11_MODULE(_etops_core, m) {
         TensorOperation & self,
         py::array_t<float, py::array::c_style | py::array::forcecast> in0,
         py::object                                                    in1,
-        py::array_t<float, py::array::c_style | py::array::forcecast> out
+        py::array_t<float, py::array::c_style | py::array::forcecast> out,
+        py::object                                                    aux
       ) {
         self.execute(
           in0.data(),
           in1.is_none() ? nullptr : py::array(in1).data(),
-          out.mutable_data()
+          out.mutable_data(),
+          aux.is_none() ? nullptr : py::array(aux).data()
         );
       },
       R"doc(
@@ -138,10 +192,75 @@ PYBIND11_MODULE(_etops_core, m) {
         :param in0: First input tensor data.
         :param in1: Second input tensor data (pass None for unary operations).
         :param out: Output tensor data.
+        :param aux: Auxiliary tensor data of add_scaled (pass None otherwise).
+      )doc",
+      py::arg("in0"),
+      py::arg("in1") = py::none(),
+      py::arg("out"),
+      py::arg("aux") = py::none()
+    )
+    .def(
+      "execute_batch",
+      [](
+        TensorOperation & self,
+        std::vector< py::array_t<float, py::array::c_style> > const & in0,
+        py::object                                                    in1,
+        std::vector< py::array_t<float, py::array::c_style> >       & out,
+        py::object                                                    aux
+      ) {
+        int64_t l_num_batch = in0.size();
+        std::vector< py::array_t<float, py::array::c_style> > l_in1;
+        if( !in1.is_none() ) {
+          l_in1 = in1.cast< std::vector< py::array_t<float, py::array::c_style> > >();
+        }
+        std::vector< py::array_t<float, py::array::c_style> > l_aux;
+        if( !aux.is_none() ) {
+          l_aux = aux.cast< std::vector< py::array_t<float, py::array::c_style> > >();
+        }
+        if(    (int64_t) out.size() != l_num_batch
+            || ( !in1.is_none() && (int64_t) l_in1.size() != l_num_batch )
+            || ( !aux.is_none() && (int64_t) l_aux.size() != l_num_batch ) ) {
+          throw std::invalid_argument( "execute_batch: all tensor lists must have the same length" );
+        }
+
+        std::vector< void const * > l_ptrs_in0( l_num_batch );
+        std::vector< void const * > l_ptrs_in1( l_num_batch, nullptr );
+        std::vector< void       * > l_ptrs_out( l_num_batch );
+        std::vector< void const * > l_ptrs_aux( l_num_batch, nullptr );
+        for( int64_t l_ba = 0; l_ba < l_num_batch; l_ba++ ) {
+          l_ptrs_in0[l_ba] = in0[l_ba].data();
+          if( !in1.is_none() ) {
+            l_ptrs_in1[l_ba] = l_in1[l_ba].data();
+          }
+          l_ptrs_out[l_ba] = out[l_ba].mutable_data();
+          if( !aux.is_none() ) {
+            l_ptrs_aux[l_ba] = l_aux[l_ba].data();
+          }
+        }
+
+        self.execute_batch(
+          l_num_batch,
+          l_ptrs_in0.data(),
+          l_ptrs_in1.data(),
+          l_ptrs_out.data(),
+          aux.is_none() ? nullptr : l_ptrs_aux.data()
+        );
+      },
+      R"doc(
+        Execute the tensor operation on a batch of tensors.
+
+        For binary operations, the work of the whole batch is distributed across the threads
+        in a single parallel region.
+
+        :param in0: List of first input tensors.
+        :param in1: List of second input tensors (pass None for unary operations).
+        :param out: List of output tensors.
+        :param aux: List of auxiliary tensors of add_scaled (pass None otherwise).
       )doc",
       py::arg("in0"),
       py::arg("in1") = py::none(),
-      py::arg("out")
+      py::arg("out"),
+      py::arg("aux") = py::none()
     )
     .def_static(
       "optimize",
@@ -13,7 +13,8 @@ from ._etops_core import (
     PrimType        as _PrimType,
     ExecType        as _ExecType,
     DimType         as _DimType,
-    ErrorType       as _ErrorType
+    ErrorType       as _ErrorType,
+    LastTouchOp     as _LastTouchOp
 )
 
 # Make _ErrorType the *single* public alias
@@ -24,6 +25,7 @@ DataType = _DataType
 PrimType = _PrimType
 ExecType = _ExecType
 DimType  = _DimType
+LastTouchOp = _LastTouchOp
 
 #: Alias for DataType
 dtype = DataType
@@ -32,21 +34,37 @@ dtype = DataType
 float32: _DataType = _DataType.float32
 #: Alias for DataType.float64
 float64: _DataType = _DataType.float64
+#: Alias for DataType.bfloat16
+bfloat16: _DataType = _DataType.bfloat16
+#: Alias for DataType.float16
+float16: _DataType = _DataType.float16
 
 class prim:
     """Namespace for primitive types used in tensor operations."""
     #: Alias for PrimType.none
-    none   = PrimType.none
+    none    = PrimType.none
     #: Alias for PrimType.zero
-    zero   = PrimType.zero
+    zero    = PrimType.zero
     #: Alias for PrimType.relu
-    relu   = PrimType.relu
+    relu    = PrimType.relu
     #: Alias for PrimType.copy
-    copy   = PrimType.copy
+    copy    = PrimType.copy
     #: Alias for PrimType.gemm
-    gemm   = PrimType.gemm
+    gemm    = PrimType.gemm
     #: Alias for PrimType.brgemm
-    brgemm = PrimType.brgemm
+    brgemm  = PrimType.brgemm
+    #: Alias for PrimType.sigmoid
+    sigmoid = PrimType.sigmoid
+    #: Alias for PrimType.tanh
+    tanh    = PrimType.tanh
+    #: Alias for PrimType.gelu
+    gelu    = PrimType.gelu
+    #: Alias for PrimType.scale
+    scale   = PrimType.scale
+    #: Alias for PrimType.clamp
+    clamp   = PrimType.clamp
+    #: Alias for PrimType.add_scaled
+    add_scaled = PrimType.add_scaled
 
     __all__ = [
         "none",
@@ -54,7 +72,13 @@ class prim:
         "relu",
         "copy",
         "gemm",
-        "brgemm"
+        "brgemm",
+        "sigmoid",
+        "tanh",
+        "gelu",
+        "scale",
+        "clamp",
+        "add_scaled"
     ]
 
     @classmethod
@@ -143,7 +167,10 @@ class TensorOperationConfig:
       - prim_main: etops.prim.gemm or etops.prim.brgemm
       - dim_types: combination of etops.dim.m, .n, .k, .c
       - prim_first: etops.prim.zero or .none (optional first touch)
-      - prim_last: etops.prim.relu or .none (optional last touch)
+      - prim_last: etops.prim.relu, .sigmoid, .tanh, .gelu or .none (optional last touch)
+      - last_touch_ops: optional chain of etops.LastTouchOp which replaces prim_last,
+        e.g. [LastTouchOp(prim.scale, 0.5), LastTouchOp(prim.clamp, -1.0, 1.0)].
+        add_scaled reads an auxiliary tensor with the layout of the output (aux argument of execute).
       - strides: shape [1 or more][3][num_dims]
 
     Unary Operations:
@@ -152,6 +179,7 @@ class TensorOperationConfig:
       - dim_types: must be etops.dim.c for all dimensions
       - prim_first: must be etops.prim.none
       - prim_last: must be etops.prim.none
+      - last_touch_ops: must be empty
       - strides: shape [1][2][num_dims]
     """
     data_type:  _DataType
@@ -163,6 +191,7 @@ class TensorOperationConfig:
     dim_sizes:  Sequence[int]
     strides:    Sequence[Sequence[Sequence[int]]]  # [LEVEL][TENSOR][DIMENSION]
     backend:    Optional[str] = None
+    last_touch_ops: Sequence[_LastTouchOp] = ()
 
     def __post_init__(self):
         """Validate configuration at creation time."""
@@ -241,6 +270,8 @@ class TensorOperationConfig:
                     f"For unary operations, prim_last must be etops.prim.none, "
                     f"got {self.prim_last}."
                 )
+            if len(self.last_touch_ops) > 0:
+                raise ValueError("For unary operations, last_touch_ops must be empty.")
 
         # Binary-specific validations
         if is_binary:
@@ -252,12 +283,23 @@ class TensorOperationConfig:
                 )
 
             # Validate prim_last is compatible
-            if self.prim_last not in [PrimType.none, PrimType.relu]:
+            if self.prim_last not in [PrimType.none, PrimType.relu, PrimType.sigmoid,
+                                      PrimType.tanh, PrimType.gelu]:
                 raise ValueError(
-                    f"For binary contractions, prim_last must be etops.prim.none or "
-                    f"etops.prim.relu, got {self.prim_last}."
+                    f"For binary contractions, prim_last must be etops.prim.none, "
+                    f"etops.prim.relu, etops.prim.sigmoid, etops.prim.tanh or "
+                    f"etops.prim.gelu, got {self.prim_last}."
                 )
 
+            # Validate the chain of last touch operations
+            for i, op in enumerate(self.last_touch_ops):
+                if op.prim not in [PrimType.relu, PrimType.sigmoid, PrimType.tanh, PrimType.gelu,
+                                   PrimType.scale, PrimType.clamp, PrimType.add_scaled]:
+                    raise ValueError(
+                        f"last_touch_ops[{i}] must be etops.prim.relu, .sigmoid, .tanh, "
+                        f".gelu, .scale, .clamp or .add_scaled, got {op.prim}."
+                    )
+
     def apply(self, op: _CppOp) -> None:
         """
         Apply this configuration to a TensorOperation instance.
@@ -266,6 +308,7 @@ class TensorOperationConfig:
         Raises:
             RuntimeError: If the setup fails.
         """
+        op.set_last_touch_ops(list(self.last_touch_ops))
         err = op.setup(
             self.backend,
             self.data_type,
@@ -390,7 +433,8 @@ def optimize(
         dim_types=opt_dim_types,
         exec_types=opt_exec_types,
         dim_sizes=opt_dim_sizes,
-        strides=opt_strides
+        strides=opt_strides,
+        last_touch_ops=config.last_touch_ops
     )
 
 __all__ = [
@@ -400,9 +444,12 @@ __all__ = [
     "PrimType",
     "ExecType",
     "DimType",
+    "LastTouchOp",
     "dtype",
     "float32",
     "float64",
+    "bfloat16",
+    "float16",
     "prim",
     "etype",
     "exec",
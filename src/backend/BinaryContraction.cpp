@@ -1,4 +1,5 @@
 #include "BinaryContraction.h"
+#include "../basic/parallel/HardwareTopology.h"
 #include <list>
 #include <algorithm>
 #include <cassert>
@@ -341,12 +342,26 @@ void einsum_ir::backend::BinaryContraction::init( int64_t
   m_ktype_first_touch = i_ktype_first_touch;
   m_ktype_main        = i_ktype_main;
   m_ktype_last_touch  = i_ktype_last_touch;
+  m_last_touch_ops.clear();
+  m_accumulate = false;
 
   m_memory = i_memory;
 
   m_num_threads = i_num_threads;
   
-  m_l2_cache_size = 1024 * 1024; // default to 1MB L2 cache size
+  m_l2_cache_size = basic::HardwareTopology::get_default()->get_l2_cache_size();
+}
+
+void einsum_ir::backend::BinaryContraction::set_last_touch_ops( std::vector< last_touch_op > const & i_ops ) {
+  m_last_touch_ops = i_ops;
+  m_ktype_last_touch = i_ops.size() > 0 ? i_ops[0].ktype : kernel_t::UNDEFINED_KTYPE;
+}
+
+void einsum_ir::backend::BinaryContraction::set_accumulate( bool i_accumulate ) {
+  m_accumulate = i_accumulate;
+  if( m_accumulate ) {
+    m_ktype_first_touch = kernel_t::UNDEFINED_KTYPE;
+  }
 }
 
 einsum_ir::err_t einsum_ir::backend::BinaryContraction::compile_base() {
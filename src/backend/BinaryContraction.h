@@ -117,6 +117,12 @@ class einsum_ir::backend::BinaryContraction {
     //! type of the last touch kernel
     kernel_t m_ktype_last_touch = UNDEFINED_KTYPE;
 
+    //! chain of last touch operations, empty if only the last touch kernel is used
+    std::vector< last_touch_op > m_last_touch_ops;
+
+    //! true if the contraction adds to the existing output
+    bool m_accumulate = false;
+
     //! true if the binary contraction was compiled
     bool m_compiled = false;
 
@@ -354,6 +360,23 @@ class einsum_ir::backend::BinaryContraction {
      **/
     err_t compile_base();
 
+    /**
+     * Sets a chain of last touch operations which replaces the last touch kernel given in init.
+     * Has to be called after init and before compile.
+     *
+     * @param i_ops last touch operations.
+     **/
+    void set_last_touch_ops( std::vector< last_touch_op > const & i_ops );
+
+    /**
+     * Sets the accumulate mode in which the contraction adds to the existing output, i.e., out += left * right.
+     * The default implementation drops the first-touch kernel, backends with native support override it.
+     * Has to be called after init and before compile.
+     *
+     * @param i_accumulate true if the contraction accumulates into the output.
+     **/
+    virtual void set_accumulate( bool i_accumulate );
+
     /**
      * Compiles the binary contraction. 
      *
@@ -388,7 +411,7 @@ class einsum_ir::backend::BinaryContraction {
     /**
      * Gets the number of operations for a single contraction.
      **/
-    int64_t num_ops();
+    virtual int64_t num_ops();
 
 };
 
@@ -110,6 +110,8 @@ einsum_ir::err_t einsum_ir::backend::BinaryContractionBlas::compile() {
                false,
                false,
                basic::packed_gemm_t::OUT_STRIDE_ONE,
+               false,
+               false,
                ce_n_bytes(m_dtype_out),
                m_l2_cache_size,
                &l_num_threads_shared,
@@ -4,6 +4,7 @@
 
 #ifdef PP_EINSUM_IR_HAS_LIBXSMM
 #include "BinaryContractionTpp.h"
+#include "BinaryContractionSparseTpp.h"
 #endif
 
 #ifdef PP_EINSUM_IR_HAS_BLAS
@@ -64,4 +65,17 @@ einsum_ir::backend::BinaryContraction * einsum_ir::backend::BinaryContractionFac
 #endif
 
   return nullptr;
-}
\ No newline at end of file
+}
+
+einsum_ir::backend::BinaryContraction * einsum_ir::backend::BinaryContractionFactory::create_sparse( einsum_ir::backend_t          i_backend,
+                                                                                                     sparse_tensor const * i_sparse_left ) {
+#ifdef PP_EINSUM_IR_HAS_LIBXSMM
+  if( i_backend == einsum_ir::backend_t::TPP ) {
+    BinaryContractionSparseTpp * l_cont = new BinaryContractionSparseTpp();
+    l_cont->set_sparse_left( i_sparse_left );
+    return l_cont;
+  }
+#endif
+
+  return nullptr;
+}
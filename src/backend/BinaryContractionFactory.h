@@ -28,6 +28,17 @@ class einsum_ir::backend::BinaryContractionFactory {
      * @return new binary contraction.
      **/
     static BinaryContraction * create( backend_t i_backend );
+
+    /**
+     * Create a binary contraction of a sparse left tensor and a dense right tensor using the given backend.
+     * If the backend does not support sparse contractions, a nullptr is returned.
+     *
+     * @param i_backend used backend.
+     * @param i_sparse_left sparse left tensor.
+     * @return new binary contraction.
+     **/
+    static BinaryContraction * create_sparse( backend_t             i_backend,
+                                              sparse_tensor const * i_sparse_left );
 };
 
 
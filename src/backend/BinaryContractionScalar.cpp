@@ -91,6 +91,8 @@ einsum_ir::err_t einsum_ir::backend::BinaryContractionScalar::compile() {
                false,
                false,
                basic::packed_gemm_t::ALL_STRIDE_ONE,
+               false,
+               false,
                ce_n_bytes(m_dtype_out),
                m_l2_cache_size,
                &l_num_threads_shared,
@@ -116,6 +118,14 @@ einsum_ir::err_t einsum_ir::backend::BinaryContractionScalar::compile() {
                   l_num_threads_m,
                   l_num_threads_n,
                   l_contraction_memory );
+
+  if( m_last_touch_ops.size() > 0 ) {
+    std::vector< basic::last_touch_op > l_last_touch_ops;
+    for( std::size_t l_op = 0; l_op < m_last_touch_ops.size(); l_op++ ) {
+      l_last_touch_ops.push_back( ce_last_touch_op_to_basic( m_last_touch_ops[l_op] ) );
+    }
+    m_backend.set_last_touch_ops( l_last_touch_ops );
+  }
   
   l_err = ce_basic_err_to_err(m_backend.compile());
   if( l_err != err_t::SUCCESS ) {
@@ -0,0 +1,434 @@
+#include "BinaryContractionSparseTpp.h"
+#include "../basic/binary/ContractionOptimizer.h"
+#include "../basic/parallel/ExecutionContext.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <numeric>
+
+void einsum_ir::backend::BinaryContractionSparseTpp::set_sparse_left( sparse_tensor const * i_sparse_left ) {
+  m_sparse_left = i_sparse_left;
+}
+
+einsum_ir::err_t einsum_ir::backend::BinaryContractionSparseTpp::coords_left( std::vector< int64_t > & o_coords ) {
+  int64_t l_num_dims = m_num_dims_left;
+  m_num_nnz = m_sparse_left->num_nnz;
+  o_coords.resize( m_num_nnz * l_num_dims );
+
+  if( m_sparse_left->format == sformat_t::COO ) {
+    if( m_num_nnz > 0 && m_sparse_left->coords == nullptr ) {
+      return err_t::INVALID_ID;
+    }
+    std::copy( m_sparse_left->coords,
+               m_sparse_left->coords + m_num_nnz * l_num_dims,
+               o_coords.begin() );
+  }
+  else if( m_sparse_left->format == sformat_t::CSF ) {
+    if(    (int64_t) m_sparse_left->pos.size() != l_num_dims
+        || (int64_t) m_sparse_left->crd.size() != l_num_dims ) {
+      return err_t::INVALID_ID;
+    }
+
+    // parents of the nodes on every level
+    std::vector< std::vector< int64_t > > l_parents( l_num_dims );
+    int64_t l_num_nodes = 1;
+    for( int64_t l_le = 0; l_le < l_num_dims; l_le++ ) {
+      int64_t const * l_pos = m_sparse_left->pos[l_le];
+      l_parents[l_le].resize( l_pos[l_num_nodes] );
+      for( int64_t l_no = 0; l_no < l_num_nodes; l_no++ ) {
+        for( int64_t l_ch = l_pos[l_no]; l_ch < l_pos[l_no+1]; l_ch++ ) {
+          l_parents[l_le][l_ch] = l_no;
+        }
+      }
+      l_num_nodes = l_pos[l_num_nodes];
+    }
+    if( l_num_nodes != m_num_nnz ) {
+      return err_t::INVALID_ID;
+    }
+
+    // walk from the leaves to the roots
+    for( int64_t l_nz = 0; l_nz < m_num_nnz; l_nz++ ) {
+      int64_t l_node = l_nz;
+      for( int64_t l_le = l_num_dims - 1; l_le >= 0; l_le-- ) {
+        o_coords[ l_nz * l_num_dims + l_le ] = m_sparse_left->crd[l_le][l_node];
+        l_node = l_parents[l_le][l_node];
+      }
+    }
+  }
+  else {
+    return err_t::INVALID_ID;
+  }
+
+  // check the coordinates
+  for( int64_t l_nz = 0; l_nz < m_num_nnz; l_nz++ ) {
+    for( int64_t l_di = 0; l_di < l_num_dims; l_di++ ) {
+      int64_t l_coord = o_coords[ l_nz * l_num_dims + l_di ];
+      if( l_coord < 0 || l_coord >= m_dim_sizes_inner->at( m_dim_ids_left[l_di] ) ) {
+        return err_t::INVALID_ID;
+      }
+    }
+  }
+
+  return err_t::SUCCESS;
+}
+
+einsum_ir::err_t einsum_ir::backend::BinaryContractionSparseTpp::compile_panel( basic::ContractionBackendTpp & o_backend ) {
+  // out( n, rows ) += panel( n, k ) * block( k, rows ) with n as the GEMM's M dimension
+  std::vector< basic::iter_property > l_loops( 3 );
+
+  l_loops[0].dim_type     = basic::dim_t::M;
+  l_loops[0].size         = m_size_block_n;
+  l_loops[0].stride_left  = 1;
+  l_loops[0].stride_out   = 1;
+
+  l_loops[1].dim_type     = basic::dim_t::N;
+  l_loops[1].size         = m_size_block_m;
+  l_loops[1].stride_right = m_size_block_k;
+  l_loops[1].stride_out   = m_size_block_n;
+
+  l_loops[2].dim_type     = basic::dim_t::K;
+  l_loops[2].size         = m_size_block_k;
+  l_loops[2].stride_left  = m_size_block_n;
+  l_loops[2].stride_right = 1;
+
+  basic::kernel_t l_ktype_main = basic::kernel_t::MADD;
+  int64_t l_num_threads_shared = 1;
+  int64_t l_num_threads_m = 1;
+  int64_t l_num_threads_n = 1;
+
+  basic::ContractionOptimizer l_optim;
+  l_optim.init( &l_loops,
+                &l_ktype_main,
+                m_size_block_n,
+                m_size_block_m,
+                m_size_block_k,
+                false,
+                true,
+                true,
+                basic::packed_gemm_t::NONE,
+                false,
+                false,
+                ce_n_bytes( m_dtype_out ),
+                m_l2_cache_size,
+                &l_num_threads_shared,
+                &l_num_threads_m,
+                &l_num_threads_n );
+  basic::err_t l_err = l_optim.optimize();
+  if( l_err != basic::err_t::SUCCESS ) {
+    return ce_basic_err_to_err( l_err );
+  }
+
+  o_backend.init( l_loops,
+                  ce_dtype_to_basic( m_dtype_left ),
+                  ce_dtype_to_basic( m_dtype_right ),
+                  ce_dtype_to_basic( m_dtype_comp ),
+                  ce_dtype_to_basic( m_dtype_out ),
+                  basic::kernel_t::UNDEFINED_KTYPE,
+                  l_ktype_main,
+                  basic::kernel_t::UNDEFINED_KTYPE,
+                  l_num_threads_shared,
+                  l_num_threads_m,
+                  l_num_threads_n,
+                  nullptr );
+
+  return ce_basic_err_to_err( o_backend.compile() );
+}
+
+einsum_ir::err_t einsum_ir::backend::BinaryContractionSparseTpp::compile() {
+  err_t l_err = err_t::UNDEFINED_ERROR;
+
+  l_err = BinaryContraction::compile_base();
+  if( l_err != einsum_ir::SUCCESS ) {
+    return l_err;
+  }
+
+  if( m_sparse_left == nullptr ) {
+    return err_t::NO_DATA_PTR_PROVIDED;
+  }
+
+  // the panels are contracted in the datatype of the tensors
+  if(    m_dtype_left != m_dtype_right
+      || m_dtype_left != m_dtype_comp
+      || m_dtype_left != m_dtype_out
+      || ( m_dtype_left != data_t::FP32 && m_dtype_left != data_t::FP64 ) ) {
+    return err_t::INVALID_DTYPE;
+  }
+
+  if(    m_ktype_main != kernel_t::MADD
+      || ( m_ktype_first_touch != kernel_t::ZERO && m_ktype_first_touch != kernel_t::UNDEFINED_KTYPE )
+      || m_ktype_last_touch != kernel_t::UNDEFINED_KTYPE
+      || m_last_touch_ops.size() > 0 ) {
+    return err_t::INVALID_KTYPE;
+  }
+
+  if( m_num_dims_i > 0 || m_num_dims_j > 0 ) {
+    return err_t::COMPILATION_FAILED;
+  }
+
+  // derive strides
+  std::map< int64_t, int64_t > l_strides_right;
+  std::map< int64_t, int64_t > l_strides_out;
+
+  strides( m_num_dims_right,
+           m_dim_ids_right,
+           m_dim_sizes_outer_right,
+           &l_strides_right );
+
+  strides( m_num_dims_out,
+           m_dim_ids_out,
+           m_dim_sizes_outer_out,
+           &l_strides_out );
+
+  m_size_out = 1;
+  for( int64_t l_di = 0; l_di < m_num_dims_out; l_di++ ) {
+    m_size_out *= m_dim_sizes_outer_out->at( m_dim_ids_out[l_di] );
+  }
+
+  // offsets of the N entries
+  m_size_n = 1;
+  for( int64_t l_n = 0; l_n < m_num_dims_n; l_n++ ) {
+    m_size_n *= m_sizes_n[l_n];
+  }
+  m_offsets_n_right.resize( m_size_n );
+  m_offsets_n_out.resize( m_size_n );
+  for( int64_t l_en = 0; l_en < m_size_n; l_en++ ) {
+    int64_t l_rem = l_en;
+    m_offsets_n_right[l_en] = 0;
+    m_offsets_n_out[l_en] = 0;
+    for( int64_t l_n = m_num_dims_n - 1; l_n >= 0; l_n-- ) {
+      int64_t l_id = m_dim_ids_n[l_n];
+      int64_t l_coord = l_rem % m_sizes_n[l_n];
+      l_rem /= m_sizes_n[l_n];
+      m_offsets_n_right[l_en] += l_coord * l_strides_right.at( l_id );
+      m_offsets_n_out[l_en]   += l_coord * l_strides_out.at( l_id );
+    }
+  }
+  m_size_block_n = std::min( m_size_block_n, std::max( m_size_n, int64_t(1) ) );
+
+  // row and panel row of every non-zero
+  std::vector< int64_t > l_coords;
+  l_err = coords_left( l_coords );
+  if( l_err != err_t::SUCCESS ) {
+    return l_err;
+  }
+
+  std::vector< int64_t > l_offsets_row( m_num_nnz, 0 );
+  std::vector< int64_t > l_offsets_right( m_num_nnz, 0 );
+  for( int64_t l_nz = 0; l_nz < m_num_nnz; l_nz++ ) {
+    for( int64_t l_di = 0; l_di < m_num_dims_left; l_di++ ) {
+      int64_t l_id = m_dim_ids_left[l_di];
+      int64_t l_coord = l_coords[ l_nz * m_num_dims_left + l_di ];
+      if( l_strides_out.count( l_id ) > 0 ) {
+        l_offsets_row[l_nz] += l_coord * l_strides_out.at( l_id );
+      }
+      if( l_strides_right.count( l_id ) > 0 ) {
+        l_offsets_right[l_nz] += l_coord * l_strides_right.at( l_id );
+      }
+    }
+  }
+
+  std::vector< int64_t > l_order( m_num_nnz );
+  std::iota( l_order.begin(), l_order.end(), 0 );
+  std::sort( l_order.begin(),
+             l_order.end(),
+             [&]( int64_t i_a, int64_t i_b ) {
+               if( l_offsets_row[i_a] != l_offsets_row[i_b] ) {
+                 return l_offsets_row[i_a] < l_offsets_row[i_b];
+               }
+               return l_offsets_right[i_a] < l_offsets_right[i_b];
+             } );
+
+  // assemble the blocks of rows and their panels
+  m_offsets_rows_out.clear();
+  m_ptr_panels.assign( 1, 0 );
+  m_offsets_panels_right.clear();
+  m_ptr_nnz.assign( 1, 0 );
+  m_pos_nnz.clear();
+  m_ids_nnz.clear();
+
+  int64_t l_nz = 0;
+  while( l_nz < m_num_nnz ) {
+    // non-zeros of the block
+    int64_t l_nz_first = l_nz;
+    int64_t l_num_rows = 0;
+    std::vector< int64_t > l_rows_nnz;
+    while( l_nz < m_num_nnz ) {
+      if( l_nz == l_nz_first || l_offsets_row[ l_order[l_nz] ] != l_offsets_row[ l_order[l_nz-1] ] ) {
+        if( l_num_rows == m_size_block_m ) {
+          break;
+        }
+        m_offsets_rows_out.push_back( l_offsets_row[ l_order[l_nz] ] );
+        l_num_rows++;
+      }
+      l_rows_nnz.push_back( l_num_rows - 1 );
+      l_nz++;
+    }
+    m_offsets_rows_out.resize( m_offsets_rows_out.size() + m_size_block_m - l_num_rows, -1 );
+
+    // rows of the right tensor which are gathered into the block's panels
+    std::vector< int64_t > l_panel_rows;
+    for( int64_t l_bn = l_nz_first; l_bn < l_nz; l_bn++ ) {
+      l_panel_rows.push_back( l_offsets_right[ l_order[l_bn] ] );
+    }
+    std::sort( l_panel_rows.begin(), l_panel_rows.end() );
+    l_panel_rows.erase( std::unique( l_panel_rows.begin(), l_panel_rows.end() ),
+                        l_panel_rows.end() );
+
+    int64_t l_num_panels = ( l_panel_rows.size() + m_size_block_k - 1 ) / m_size_block_k;
+    std::vector< std::vector< int64_t > > l_pos_panels( l_num_panels );
+    std::vector< std::vector< int64_t > > l_ids_panels( l_num_panels );
+    for( int64_t l_bn = l_nz_first; l_bn < l_nz; l_bn++ ) {
+      int64_t l_id = l_order[l_bn];
+      int64_t l_pr = std::lower_bound( l_panel_rows.begin(),
+                                       l_panel_rows.end(),
+                                       l_offsets_right[l_id] ) - l_panel_rows.begin();
+      int64_t l_pa = l_pr / m_size_block_k;
+      l_pos_panels[l_pa].push_back( l_rows_nnz[l_bn - l_nz_first] * m_size_block_k + l_pr % m_size_block_k );
+      l_ids_panels[l_pa].push_back( l_id );
+    }
+
+    l_panel_rows.resize( l_num_panels * m_size_block_k, -1 );
+    m_offsets_panels_right.insert( m_offsets_panels_right.end(),
+                                   l_panel_rows.begin(),
+                                   l_panel_rows.end() );
+    for( int64_t l_pa = 0; l_pa < l_num_panels; l_pa++ ) {
+      m_pos_nnz.insert( m_pos_nnz.end(), l_pos_panels[l_pa].begin(), l_pos_panels[l_pa].end() );
+      m_ids_nnz.insert( m_ids_nnz.end(), l_ids_panels[l_pa].begin(), l_ids_panels[l_pa].end() );
+      m_ptr_nnz.push_back( m_pos_nnz.size() );
+    }
+    m_ptr_panels.push_back( m_ptr_panels.back() + l_num_panels );
+  }
+
+  // thread-private panel contractions
+  m_backends.clear();
+  for( int64_t l_th = 0; l_th < m_num_threads; l_th++ ) {
+    m_backends.push_back( std::make_unique< basic::ContractionBackendTpp >() );
+
+    l_err = compile_panel( *m_backends.back() );
+    if( l_err != err_t::SUCCESS ) {
+      return l_err;
+    }
+  }
+
+  // thread-private buffers, padded to full cache lines
+  m_size_thread_buffers  =   m_size_block_k * m_size_block_n
+                           + m_size_block_m * m_size_block_k
+                           + m_size_block_m * m_size_block_n;
+  m_size_thread_buffers *= ce_n_bytes( m_dtype_out );
+  m_size_thread_buffers  = ( ( m_size_thread_buffers + 63 ) / 64 ) * 64;
+  m_thread_buffers.resize( m_num_threads * m_size_thread_buffers );
+
+  m_compiled = true;
+
+  return err_t::SUCCESS;
+}
+
+template< typename T >
+void einsum_ir::backend::BinaryContractionSparseTpp::contract_dtype( T const * i_values,
+                                                                     T const * i_tensor_right,
+                                                                     T       * io_tensor_out ) {
+  basic::ExecutionContext * l_ctx = basic::ExecutionContext::get_default();
+
+  if( m_ktype_first_touch == kernel_t::ZERO ) {
+    int64_t l_size_chunk = ( m_size_out + m_num_threads - 1 ) / m_num_threads;
+    l_ctx->parallel( m_num_threads,
+                     [&]( int64_t l_thread_id ) {
+      int64_t l_first = std::min( l_thread_id * l_size_chunk, m_size_out );
+      int64_t l_last  = std::min( l_first + l_size_chunk, m_size_out );
+      std::fill( io_tensor_out + l_first, io_tensor_out + l_last, T(0) );
+    } );
+  }
+
+  int64_t l_num_blocks_m = m_ptr_panels.size() - 1;
+  int64_t l_num_blocks_n = ( m_size_n + m_size_block_n - 1 ) / m_size_block_n;
+  int64_t l_num_tasks = l_num_blocks_m * l_num_blocks_n;
+  std::atomic< int64_t > l_next( 0 );
+
+  l_ctx->parallel( m_num_threads,
+                   [&]( int64_t l_thread_id ) {
+    T * l_panel = (T *) ( m_thread_buffers.data() + l_thread_id * m_size_thread_buffers );
+    T * l_block = l_panel + m_size_block_k * m_size_block_n;
+    T * l_out   = l_block + m_size_block_m * m_size_block_k;
+    basic::ContractionBackendTpp * l_backend = m_backends[l_thread_id].get();
+
+    int64_t l_ta = l_next.fetch_add( 1, std::memory_order_relaxed );
+    while( l_ta < l_num_tasks ) {
+      int64_t l_bm = l_ta / l_num_blocks_n;
+      int64_t l_first_n = (l_ta % l_num_blocks_n) * m_size_block_n;
+      int64_t l_size_n = std::min( m_size_block_n, m_size_n - l_first_n );
+
+      std::fill( l_out, l_out + m_size_block_m * m_size_block_n, T(0) );
+
+      for( int64_t l_pa = m_ptr_panels[l_bm]; l_pa < m_ptr_panels[l_bm+1]; l_pa++ ) {
+        // gather the rows of the right tensor
+        for( int64_t l_ro = 0; l_ro < m_size_block_k; l_ro++ ) {
+          int64_t l_offset = m_offsets_panels_right[ l_pa * m_size_block_k + l_ro ];
+          T * l_row = l_panel + l_ro * m_size_block_n;
+          if( l_offset < 0 ) {
+            std::fill( l_row, l_row + m_size_block_n, T(0) );
+            continue;
+          }
+          for( int64_t l_en = 0; l_en < l_size_n; l_en++ ) {
+            l_row[l_en] = i_tensor_right[ l_offset + m_offsets_n_right[ l_first_n + l_en ] ];
+          }
+          std::fill( l_row + l_size_n, l_row + m_size_block_n, T(0) );
+        }
+
+        // scatter the non-zeros into the dense block
+        std::fill( l_block, l_block + m_size_block_m * m_size_block_k, T(0) );
+        for( int64_t l_nz = m_ptr_nnz[l_pa]; l_nz < m_ptr_nnz[l_pa+1]; l_nz++ ) {
+          l_block[ m_pos_nnz[l_nz] ] = i_values[ m_ids_nnz[l_nz] ];
+        }
+
+        l_backend->contract( l_panel,
+                             l_block,
+                             nullptr,
+                             l_out );
+      }
+
+      // accumulate the block's rows in the output tensor
+      for( int64_t l_ro = 0; l_ro < m_size_block_m; l_ro++ ) {
+        int64_t l_offset = m_offsets_rows_out[ l_bm * m_size_block_m + l_ro ];
+        if( l_offset < 0 ) {
+          break;
+        }
+        T const * l_row = l_out + l_ro * m_size_block_n;
+        for( int64_t l_en = 0; l_en < l_size_n; l_en++ ) {
+          io_tensor_out[ l_offset + m_offsets_n_out[ l_first_n + l_en ] ] += l_row[l_en];
+        }
+      }
+
+      l_ta = l_next.fetch_add( 1, std::memory_order_relaxed );
+    }
+  } );
+}
+
+void einsum_ir::backend::BinaryContractionSparseTpp::contract( void const * i_tensor_left,
+                                                               void const * i_tensor_right,
+                                                               void       * io_tensor_out ) {
+  contract( i_tensor_left,
+            i_tensor_right,
+            nullptr,
+            io_tensor_out );
+}
+
+void einsum_ir::backend::BinaryContractionSparseTpp::contract( void const * i_tensor_left,
+                                                               void const * i_tensor_right,
+                                                               void const * ,
+                                                               void       * io_tensor_out ) {
+  if( m_dtype_out == data_t::FP32 ) {
+    contract_dtype( (float const *) i_tensor_left,
+                    (float const *) i_tensor_right,
+                    (float       *) io_tensor_out );
+  }
+  else if( m_dtype_out == data_t::FP64 ) {
+    contract_dtype( (double const *) i_tensor_left,
+                    (double const *) i_tensor_right,
+                    (double       *) io_tensor_out );
+  }
+}
+
+int64_t einsum_ir::backend::BinaryContractionSparseTpp::num_ops() {
+  return 2 * m_num_nnz * m_size_n;
+}
@@ -0,0 +1,151 @@
+#ifndef EINSUM_IR_BACKEND_BINARY_CONTRACTION_SPARSE_TPP
+#define EINSUM_IR_BACKEND_BINARY_CONTRACTION_SPARSE_TPP
+
+#include "BinaryContraction.h"
+#include "../basic/binary/ContractionBackendTpp.h"
+#include <memory>
+
+namespace einsum_ir {
+  namespace backend {
+    class BinaryContractionSparseTpp;
+  }
+}
+
+/**
+ * Binary contraction of a sparse left tensor (COO or CSF) and a dense right tensor.
+ * The non-zeros are grouped by output rows (C and M coordinates) into blocks of m_size_block_m rows.
+ * For every block the required rows of the right tensor (C and K coordinates) are gathered into packed dense panels,
+ * the non-zeros into small dense blocks, and both are multiplied by a fixed-size TPP contraction.
+ **/
+class einsum_ir::backend::BinaryContractionSparseTpp: public BinaryContraction {
+  private:
+    //! number of output rows in a block
+    int64_t m_size_block_m = 16;
+
+    //! number of columns of a panel
+    int64_t m_size_block_n = 64;
+
+    //! number of rows of a panel
+    int64_t m_size_block_k = 32;
+
+    //! sparse left tensor
+    sparse_tensor const * m_sparse_left = nullptr;
+
+    //! number of non-zeros of the left tensor
+    int64_t m_num_nnz = 0;
+
+    //! number of N entries, i.e., the product of the N dimensions' sizes
+    int64_t m_size_n = 0;
+
+    //! number of output elements
+    int64_t m_size_out = 0;
+
+    //! offsets of the N entries in the right tensor in elements
+    std::vector< int64_t > m_offsets_n_right;
+
+    //! offsets of the N entries in the output tensor in elements
+    std::vector< int64_t > m_offsets_n_out;
+
+    //! offsets of the rows of every block in the output tensor in elements, -1 for padding
+    std::vector< int64_t > m_offsets_rows_out;
+
+    //! range of the panels of every block
+    std::vector< int64_t > m_ptr_panels;
+
+    //! offsets of the panel rows in the right tensor in elements, -1 for padding
+    std::vector< int64_t > m_offsets_panels_right;
+
+    //! range of the non-zeros of every panel
+    std::vector< int64_t > m_ptr_nnz;
+
+    //! position of every non-zero in the dense left block of its panel
+    std::vector< int64_t > m_pos_nnz;
+
+    //! position of every non-zero in the values of the sparse left tensor
+    std::vector< int64_t > m_ids_nnz;
+
+    //! panel contractions, one per thread
+    std::vector< std::unique_ptr< basic::ContractionBackendTpp > > m_backends;
+
+    //! size of the buffers of a thread in bytes: panel, block and output block
+    int64_t m_size_thread_buffers = 0;
+
+    //! thread-private buffers of the panels, the dense left blocks and the output blocks
+    std::vector< char > m_thread_buffers;
+
+    /**
+     * Derives the coordinates of the left tensor's non-zeros.
+     *
+     * @param o_coords will be set to the coordinates, m_num_dims_left per non-zero.
+     *
+     * @return SUCCESS if the sparse tensor is valid, otherwise an appropiate error code.
+     **/
+    err_t coords_left( std::vector< int64_t > & o_coords );
+
+    /**
+     * Compiles the panel contraction.
+     *
+     * @param o_backend contraction which is compiled.
+     *
+     * @return SUCCESS if the compilation was successful, otherwise an appropiate error code.
+     **/
+    err_t compile_panel( basic::ContractionBackendTpp & o_backend );
+
+    /**
+     * Performs the contraction for the given datatype.
+     *
+     * @param i_values values of the left tensor's non-zeros.
+     * @param i_tensor_right right input tensor.
+     * @param io_tensor_out output tensor.
+     **/
+    template< typename T >
+    void contract_dtype( T const * i_values,
+                         T const * i_tensor_right,
+                         T       * io_tensor_out );
+
+  public:
+    /**
+     * Sets the sparse left tensor.
+     * Has to be called before compile, the structure of the tensor has to be constant afterwards.
+     *
+     * @param i_sparse_left sparse left tensor.
+     **/
+    void set_sparse_left( sparse_tensor const * i_sparse_left );
+
+    /**
+     * Compiles the binary contraction.
+     * @return SUCCESS if successful, error code otherwise.
+     **/
+    err_t compile();
+
+    /**
+     * Performs a contraction on the given input data.
+     *
+     * @param i_tensor_left values of the left tensor's non-zeros.
+     * @param i_tensor_right right input tensor.
+     * @param io_tensor_out output tensor.
+     **/
+    void contract( void const * i_tensor_left,
+                   void const * i_tensor_right,
+                   void       * io_tensor_out );
+
+    /**
+     * Performs a contraction on the given input data.
+     *
+     * @param i_tensor_left values of the left tensor's non-zeros.
+     * @param i_tensor_right right input tensor.
+     * @param i_tensor_out_aux auxiliary data w.r.t. output tensor, unused.
+     * @param io_tensor_out output tensor.
+     **/
+    void contract( void const * i_tensor_left,
+                   void const * i_tensor_right,
+                   void const * i_tensor_out_aux,
+                   void       * io_tensor_out );
+
+    /**
+     * Gets the number of operations for a single contraction.
+     **/
+    int64_t num_ops();
+};
+
+#endif
@@ -0,0 +1,193 @@
+#include <cmath>
+#include <vector>
+#include "catch.hpp"
+#include "BinaryContractionSparseTpp.h"
+#include "../frontend/EinsumExpression.h"
+
+TEST_CASE( "Sparse-dense contraction with a COO left tensor.", "[binary_contraction_sparse_tpp]" ) {
+  // einsum: cmk,ckn->cmn
+  // c: 0, m: 1, k: 2, n: 3
+  int64_t l_size_c = 2;
+  int64_t l_size_m = 37;
+  int64_t l_size_k = 45;
+  int64_t l_size_n = 70;
+
+  std::map< int64_t, int64_t > l_dim_sizes;
+  l_dim_sizes.insert( std::pair< int64_t, int64_t >( 0, l_size_c ) );
+  l_dim_sizes.insert( std::pair< int64_t, int64_t >( 1, l_size_m ) );
+  l_dim_sizes.insert( std::pair< int64_t, int64_t >( 2, l_size_k ) );
+  l_dim_sizes.insert( std::pair< int64_t, int64_t >( 3, l_size_n ) );
+
+  int64_t l_dim_ids_left[3]  = { 0, 1, 2 };
+  int64_t l_dim_ids_right[3] = { 0, 2, 3 };
+  int64_t l_dim_ids_out[3]   = { 0, 1, 3 };
+
+  // every seventh entry of the left tensor is non-zero
+  std::vector< int64_t > l_coords;
+  std::vector< float > l_values;
+  std::vector< float > l_dense_left( l_size_c * l_size_m * l_size_k, 0 );
+  for( int64_t l_en = 0; l_en < l_size_c * l_size_m * l_size_k; l_en += 7 ) {
+    int64_t l_c = l_en / ( l_size_m * l_size_k );
+    int64_t l_m = ( l_en / l_size_k ) % l_size_m;
+    int64_t l_k = l_en % l_size_k;
+    float l_val = (float) ( l_en % 13 ) - 6.0f;
+
+    l_coords.insert( l_coords.end(), { l_c, l_m, l_k } );
+    l_values.push_back( l_val );
+    l_dense_left[l_en] = l_val;
+  }
+
+  einsum_ir::sparse_tensor l_left;
+  l_left.format  = einsum_ir::COO;
+  l_left.num_nnz = l_values.size();
+  l_left.coords  = l_coords.data();
+  l_left.values  = l_values.data();
+
+  std::vector< float > l_right( l_size_c * l_size_k * l_size_n );
+  for( std::size_t l_en = 0; l_en < l_right.size(); l_en++ ) {
+    l_right[l_en] = (float) ( l_en % 11 ) - 5.0f;
+  }
+
+  // dense reference
+  std::vector< float > l_out_ref( l_size_c * l_size_m * l_size_n, 0 );
+  for( int64_t l_c = 0; l_c < l_size_c; l_c++ ) {
+    for( int64_t l_m = 0; l_m < l_size_m; l_m++ ) {
+      for( int64_t l_n = 0; l_n < l_size_n; l_n++ ) {
+        for( int64_t l_k = 0; l_k < l_size_k; l_k++ ) {
+          l_out_ref[ (l_c * l_size_m + l_m) * l_size_n + l_n ] +=   l_dense_left[ (l_c * l_size_m + l_m) * l_size_k + l_k ]
+                                                                  * l_right[ (l_c * l_size_k + l_k) * l_size_n + l_n ];
+        }
+      }
+    }
+  }
+
+  einsum_ir::backend::BinaryContractionSparseTpp l_cont;
+  l_cont.init( 3,
+               3,
+               3,
+               &l_dim_sizes,
+               &l_dim_sizes,
+               &l_dim_sizes,
+               nullptr,
+               &l_dim_sizes,
+               l_dim_ids_left,
+               l_dim_ids_right,
+               l_dim_ids_out,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::ZERO,
+               einsum_ir::MADD,
+               einsum_ir::UNDEFINED_KTYPE,
+               2 );
+  l_cont.set_sparse_left( &l_left );
+
+  REQUIRE( l_cont.compile() == einsum_ir::SUCCESS );
+  REQUIRE( l_cont.num_ops() == 2 * (int64_t) l_values.size() * l_size_n );
+
+  std::vector< float > l_out( l_out_ref.size(), 1.0f );
+  l_cont.contract( l_values.data(),
+                   l_right.data(),
+                   l_out.data() );
+
+  for( std::size_t l_en = 0; l_en < l_out.size(); l_en++ ) {
+    REQUIRE( std::abs( l_out[l_en] - l_out_ref[l_en] ) < 1E-3 );
+  }
+}
+
+TEST_CASE( "Einsum expression with a CSF input tensor.", "[binary_contraction_sparse_tpp]" ) {
+  // einsum: ik,kj,jl->li
+  // i: 0, j: 1, k: 2, l: 3
+  int64_t l_dim_sizes[4] = { 19, 23, 29, 6 };
+  int64_t l_size_i = l_dim_sizes[0];
+  int64_t l_size_j = l_dim_sizes[1];
+  int64_t l_size_k = l_dim_sizes[2];
+  int64_t l_size_l = l_dim_sizes[3];
+
+  int64_t l_string_num_dims[4] = { 2, 2, 2, 2 };
+  int64_t l_string_dim_ids[8] = { 0, 2,
+                                  2, 1,
+                                  1, 3,
+                                  3, 0 };
+  int64_t l_path[4] = { 1, 2, 0, 1 };
+
+  // left tensor: lower triangle of every third row
+  std::vector< int64_t > l_pos_i = { 0, 0 };
+  std::vector< int64_t > l_crd_i;
+  std::vector< int64_t > l_pos_k = { 0 };
+  std::vector< int64_t > l_crd_k;
+  std::vector< double > l_values;
+  std::vector< double > l_dense_left( l_size_i * l_size_k, 0 );
+  for( int64_t l_i = 0; l_i < l_size_i; l_i += 3 ) {
+    l_crd_i.push_back( l_i );
+    l_pos_i[1]++;
+    for( int64_t l_k = 0; l_k <= std::min( l_i, l_size_k - 1 ); l_k++ ) {
+      double l_val = 0.25 * (double) ( (l_i + 2 * l_k) % 9 ) - 1.0;
+      l_crd_k.push_back( l_k );
+      l_values.push_back( l_val );
+      l_dense_left[ l_i * l_size_k + l_k ] = l_val;
+    }
+    l_pos_k.push_back( l_crd_k.size() );
+  }
+
+  einsum_ir::sparse_tensor l_left;
+  l_left.format  = einsum_ir::CSF;
+  l_left.num_nnz = l_values.size();
+  l_left.pos     = { l_pos_i.data(), l_pos_k.data() };
+  l_left.crd     = { l_crd_i.data(), l_crd_k.data() };
+  l_left.values  = l_values.data();
+
+  std::vector< double > l_tensor_1( l_size_k * l_size_j );
+  std::vector< double > l_tensor_2( l_size_j * l_size_l );
+  for( std::size_t l_en = 0; l_en < l_tensor_1.size(); l_en++ ) {
+    l_tensor_1[l_en] = 0.5 * (double) ( l_en % 7 ) - 1.5;
+  }
+  for( std::size_t l_en = 0; l_en < l_tensor_2.size(); l_en++ ) {
+    l_tensor_2[l_en] = 0.125 * (double) ( l_en % 5 ) + 0.5;
+  }
+
+  // dense reference
+  std::vector< double > l_tmp( l_size_k * l_size_l, 0 );
+  for( int64_t l_k = 0; l_k < l_size_k; l_k++ ) {
+    for( int64_t l_l = 0; l_l < l_size_l; l_l++ ) {
+      for( int64_t l_j = 0; l_j < l_size_j; l_j++ ) {
+        l_tmp[ l_k * l_size_l + l_l ] += l_tensor_1[ l_k * l_size_j + l_j ] * l_tensor_2[ l_j * l_size_l + l_l ];
+      }
+    }
+  }
+  std::vector< double > l_out_ref( l_size_l * l_size_i, 0 );
+  for( int64_t l_l = 0; l_l < l_size_l; l_l++ ) {
+    for( int64_t l_i = 0; l_i < l_size_i; l_i++ ) {
+      for( int64_t l_k = 0; l_k < l_size_k; l_k++ ) {
+        l_out_ref[ l_l * l_size_i + l_i ] += l_dense_left[ l_i * l_size_k + l_k ] * l_tmp[ l_k * l_size_l + l_l ];
+      }
+    }
+  }
+
+  std::vector< double > l_out( l_size_l * l_size_i, 1.0 );
+  void * l_data_ptrs[4] = { nullptr,
+                            l_tensor_1.data(),
+                            l_tensor_2.data(),
+                            l_out.data() };
+
+  einsum_ir::frontend::EinsumExpression l_einsum_exp;
+  l_einsum_exp.init( 4,
+                     l_dim_sizes,
+                     2,
+                     l_string_num_dims,
+                     l_string_dim_ids,
+                     l_path,
+                     einsum_ir::FP64,
+                     l_data_ptrs );
+
+  REQUIRE( l_einsum_exp.set_sparse_input( 4, &l_left ) == einsum_ir::INVALID_ID );
+  REQUIRE( l_einsum_exp.set_sparse_input( 0, &l_left ) == einsum_ir::SUCCESS );
+  REQUIRE( l_einsum_exp.compile() == einsum_ir::SUCCESS );
+
+  l_einsum_exp.eval();
+
+  for( std::size_t l_en = 0; l_en < l_out.size(); l_en++ ) {
+    REQUIRE( std::abs( l_out[l_en] - l_out_ref[l_en] ) < 1E-10 );
+  }
+}
@@ -1,14 +1,29 @@
 #include "BinaryContractionTpp.h"
 #include "../basic/binary/ContractionOptimizer.h"
+#include "../basic/binary/ContractionCostModel.h"
+#include "../basic/binary/ContractionTunerTpp.h"
+#include <algorithm>
 
-einsum_ir::err_t einsum_ir::backend::BinaryContractionTpp::compile() {
-  err_t l_err = err_t::UNDEFINED_ERROR;
+einsum_ir::basic::ContractionBackendTpp * einsum_ir::backend::BinaryContractionTpp::add_backend() {
+  // evict the least recently used contraction if required
+  if( (int64_t) m_backends.size() >= m_max_backends ) {
+    m_backends.pop_back();
+  }
 
-  l_err = BinaryContraction::compile_base();
-  if( l_err != einsum_ir::SUCCESS ) {
-    return l_err;
+  m_backends.insert( m_backends.begin(),
+                     std::make_unique< basic::ContractionBackendTpp >() );
+
+  return m_backends.front().get();
+}
+
+einsum_ir::basic::ContractionMemoryManager * einsum_ir::backend::BinaryContractionTpp::contraction_memory() {
+  if( m_memory != nullptr ){
+    return m_memory->get_contraction_memory_manager();
   }
+  return nullptr;
+}
 
+void einsum_ir::backend::BinaryContractionTpp::lower_loops( std::vector< basic::iter_property > & o_loops ) {
   // derive strides
   std::map< int64_t, int64_t > l_strides_left;
   std::map< int64_t, int64_t > l_strides_right;
@@ -51,7 +66,8 @@ einsum_ir::err_t einsum_ir::backend::BinaryContractionTpp::compile() {
 
 
   //lower to ContractionOptimizer data structure
-  std::vector<basic::iter_property> l_loops;
+  std::vector<basic::iter_property> & l_loops = o_loops;
+  l_loops.clear();
   l_loops.resize(l_all_dim_ids.size());
 
   for(std::size_t l_id = 0; l_id < l_all_dim_ids.size(); l_id++){
@@ -65,67 +81,294 @@ einsum_ir::err_t einsum_ir::backend::BinaryContractionTpp::compile() {
     l_loops[l_id].stride_out     = map_find_default<int64_t>(&l_strides_out,     l_dim_id, 0);
   }
 
-  //convert kernel to basic
-  basic::kernel_t l_ktype_first_touch = ce_kernelt_to_basic(m_ktype_first_touch);
-  basic::kernel_t l_ktype_main        = ce_kernelt_to_basic(m_ktype_main);
-  basic::kernel_t l_ktype_last_touch  = ce_kernelt_to_basic(m_ktype_last_touch);
+  // set CPX dimension correctly
+  if( m_ktype_main == einsum_ir::kernel_t::CPX_MADD ) {
+    l_loops[0].dim_type = basic::dim_t::CPX;
+  }
+}
 
-  //convert dtype
-  basic::data_t l_dtype_left  = ce_dtype_to_basic(m_dtype_left);
-  basic::data_t l_dtype_right = ce_dtype_to_basic(m_dtype_right);
-  basic::data_t l_dtype_comp  = ce_dtype_to_basic(m_dtype_comp);
-  basic::data_t l_dtype_out   = ce_dtype_to_basic(m_dtype_out);
+void einsum_ir::backend::BinaryContractionTpp::optimizer_params( basic::tuning_params & o_params,
+                                                                 basic::packed_gemm_t & o_packed_gemm_support,
+                                                                 bool                 & o_split_k_support,
+                                                                 bool                 & o_cpx_3m_support ) {
+  //packed kernels support fp32 and fp64 only
+  bool l_low_precision_in  =    m_dtype_left  == BF16 || m_dtype_left  == FP16 || m_dtype_left  == INT8
+                             || m_dtype_right == BF16 || m_dtype_right == FP16 || m_dtype_right == INT8;
+  //low precision outputs are accumulated inside the kernels only: no split k partial sums
+  bool l_low_precision_out = m_dtype_out == BF16 || m_dtype_out == FP16 || m_dtype_out == INT8;
+
+  o_params = basic::tuning_params();
+  o_params.target_m      = m_target_prim_m;
+  o_params.target_n      = m_target_prim_n;
+  o_params.target_k      = m_target_prim_k;
+  o_params.l2_cache_size = m_l2_cache_size;
+  o_params.cost_model    = m_cost_model;
+
+  o_packed_gemm_support = l_low_precision_in || l_low_precision_out ? basic::packed_gemm_t::NONE : basic::packed_gemm_t::ALL_STRIDE_ONE;
+  o_split_k_support     = !l_low_precision_out;
+  o_cpx_3m_support      = !l_low_precision_in && !l_low_precision_out;
+}
 
-  //optimize loops
+void einsum_ir::backend::BinaryContractionTpp::lower( std::vector< basic::iter_property > & o_loops,
+                                                      basic::kernel_t                     & o_ktype_main,
+                                                      int64_t                             & o_num_threads_shared,
+                                                      int64_t                             & o_num_threads_m,
+                                                      int64_t                             & o_num_threads_n ) {
+  lower_loops( o_loops );
+
+  basic::tuning_params l_params;
+  basic::packed_gemm_t l_packed_gemm_support = basic::packed_gemm_t::NONE;
+  bool l_split_k_support = false;
+  bool l_cpx_3m_support = false;
+  optimizer_params( l_params,
+                    l_packed_gemm_support,
+                    l_split_k_support,
+                    l_cpx_3m_support );
+
+  //optimize loops, tuned parameters of the default tuning database replace the heuristic ones
   einsum_ir::basic::ContractionOptimizer l_optim;
 
-  int64_t l_num_threads_m = 1;
-  int64_t l_num_threads_n = 1;
-  int64_t l_num_threads_shared = m_num_threads;
-  l_optim.init(&l_loops,
-               &l_ktype_main,
-               m_target_prim_m,
-               m_target_prim_n,
-               m_target_prim_k,
+  o_ktype_main = ce_kernelt_to_basic(m_ktype_main);
+  o_num_threads_m = 1;
+  o_num_threads_n = 1;
+  o_num_threads_shared = m_num_threads;
+
+  l_optim.init(&o_loops,
+               &o_ktype_main,
+               l_params.target_m,
+               l_params.target_n,
+               l_params.target_k,
                true,
                true,
                true,
-               basic::packed_gemm_t::ALL_STRIDE_ONE,
+               l_packed_gemm_support,
+               l_split_k_support,
+               l_cpx_3m_support,
                ce_n_bytes(m_dtype_out),
-               m_l2_cache_size,
-               &l_num_threads_shared,
-               &l_num_threads_m,
-               &l_num_threads_n );
+               l_params.l2_cache_size,
+               &o_num_threads_shared,
+               &o_num_threads_m,
+               &o_num_threads_n );
+  l_optim.set_num_bytes_scalar_in( std::max( ce_n_bytes(m_dtype_left), ce_n_bytes(m_dtype_right) ) );
+  //requantized int8 outputs require all k dimensions in the primitive
+  l_optim.set_keep_k_whole( m_dtype_out == INT8 );
+  //same key as the one of tune()
+  l_optim.set_tuning_signature( ce_dtype_to_basic(m_dtype_left),
+                                ce_dtype_to_basic(m_dtype_right),
+                                ce_dtype_to_basic(m_dtype_comp),
+                                ce_dtype_to_basic(m_dtype_out),
+                                m_accumulate ? basic::kernel_t::UNDEFINED_KTYPE : ce_kernelt_to_basic(m_ktype_first_touch),
+                                ce_kernelt_to_basic(m_ktype_last_touch) );
+  if( l_params.cost_model ) {
+    l_optim.set_cost_model( basic::ContractionCostModel::get_default() );
+  }
   l_optim.optimize();
+}
 
-  einsum_ir::basic::ContractionMemoryManager * l_contraction_memory = nullptr;
-  if( m_memory != nullptr ){
-    l_contraction_memory = m_memory->get_contraction_memory_manager();
-  }
+einsum_ir::err_t einsum_ir::backend::BinaryContractionTpp::compile_backend( std::vector< basic::iter_property > const & i_loops,
+                                                                            basic::kernel_t                             i_ktype_main,
+                                                                            int64_t                                     i_num_threads_shared,
+                                                                            int64_t                                     i_num_threads_m,
+                                                                            int64_t                                     i_num_threads_n,
+                                                                            basic::ContractionMemoryManager           * i_contraction_memory,
+                                                                            basic::ContractionBackendTpp              & o_backend ) {
+  //convert kernel to basic
+  basic::kernel_t l_ktype_first_touch = ce_kernelt_to_basic(m_ktype_first_touch);
+  basic::kernel_t l_ktype_last_touch  = ce_kernelt_to_basic(m_ktype_last_touch);
+
+  //convert dtype
+  basic::data_t l_dtype_left  = ce_dtype_to_basic(m_dtype_left);
+  basic::data_t l_dtype_right = ce_dtype_to_basic(m_dtype_right);
+  basic::data_t l_dtype_comp  = ce_dtype_to_basic(m_dtype_comp);
+  basic::data_t l_dtype_out   = ce_dtype_to_basic(m_dtype_out);
 
   //compile backend
-  m_backend.init( l_loops,
+  o_backend.init( i_loops,
                   l_dtype_left,
                   l_dtype_right,
                   l_dtype_comp,
                   l_dtype_out,
                   l_ktype_first_touch,
-                  l_ktype_main,
+                  i_ktype_main,
                   l_ktype_last_touch,
-                  l_num_threads_shared,
-                  l_num_threads_m,
-                  l_num_threads_n,
-                  l_contraction_memory );
+                  i_num_threads_shared,
+                  i_num_threads_m,
+                  i_num_threads_n,
+                  i_contraction_memory );
 
-  
-  l_err = ce_basic_err_to_err(m_backend.compile());
+  o_backend.set_accumulate( m_accumulate );
+
+  if( m_last_touch_ops.size() > 0 ) {
+    std::vector< basic::last_touch_op > l_last_touch_ops;
+    for( std::size_t l_op = 0; l_op < m_last_touch_ops.size(); l_op++ ) {
+      l_last_touch_ops.push_back( ce_last_touch_op_to_basic( m_last_touch_ops[l_op] ) );
+    }
+    o_backend.set_last_touch_ops( l_last_touch_ops );
+  }
+
+  return ce_basic_err_to_err( o_backend.compile() );
+}
+
+einsum_ir::err_t einsum_ir::backend::BinaryContractionTpp::compile() {
+  err_t l_err = err_t::UNDEFINED_ERROR;
+
+  l_err = BinaryContraction::compile_base();
+  if( l_err != einsum_ir::SUCCESS ) {
+    return l_err;
+  }
+
+  std::vector< basic::iter_property > l_loops;
+  basic::kernel_t l_ktype_main = basic::kernel_t::UNDEFINED_KTYPE;
+  int64_t l_num_threads_shared = 1;
+  int64_t l_num_threads_m = 1;
+  int64_t l_num_threads_n = 1;
+  lower( l_loops,
+         l_ktype_main,
+         l_num_threads_shared,
+         l_num_threads_m,
+         l_num_threads_n );
+
+  // contractions of a previous compilation might use an outdated configuration
+  m_backends.clear();
+  basic::ContractionBackendTpp * l_backend = add_backend();
+
+  l_err = compile_backend( l_loops,
+                           l_ktype_main,
+                           l_num_threads_shared,
+                           l_num_threads_m,
+                           l_num_threads_n,
+                           contraction_memory(),
+                           *l_backend );
   if( l_err != err_t::SUCCESS ) {
     return l_err;
   }
 
+  m_compiled = true;
+
   return err_t::SUCCESS;
 }
 
+void einsum_ir::backend::BinaryContractionTpp::set_accumulate( bool i_accumulate ) {
+  m_accumulate = i_accumulate;
+}
+
+void einsum_ir::backend::BinaryContractionTpp::set_cost_model( bool i_cost_model ) {
+  m_cost_model = i_cost_model;
+}
+
+einsum_ir::err_t einsum_ir::backend::BinaryContractionTpp::tune() {
+  err_t l_err = BinaryContraction::compile_base();
+  if( l_err != einsum_ir::SUCCESS ) {
+    return l_err;
+  }
+
+  std::vector< basic::iter_property > l_loops;
+  lower_loops( l_loops );
+
+  basic::tuning_params l_params;
+  basic::packed_gemm_t l_packed_gemm_support = basic::packed_gemm_t::NONE;
+  bool l_split_k_support = false;
+  bool l_cpx_3m_support = false;
+  optimizer_params( l_params,
+                    l_packed_gemm_support,
+                    l_split_k_support,
+                    l_cpx_3m_support );
+
+  basic::ContractionTunerTpp l_tuner;
+  l_tuner.init( l_loops,
+                ce_dtype_to_basic( m_dtype_left ),
+                ce_dtype_to_basic( m_dtype_right ),
+                ce_dtype_to_basic( m_dtype_comp ),
+                ce_dtype_to_basic( m_dtype_out ),
+                m_accumulate ? basic::kernel_t::UNDEFINED_KTYPE : ce_kernelt_to_basic( m_ktype_first_touch ),
+                ce_kernelt_to_basic( m_ktype_main ),
+                ce_kernelt_to_basic( m_ktype_last_touch ),
+                m_num_threads,
+                l_packed_gemm_support,
+                l_split_k_support,
+                l_cpx_3m_support,
+                l_params );
+
+  return ce_basic_err_to_err( l_tuner.tune( basic::ContractionTuningDatabase::get_default() ) );
+}
+
+einsum_ir::err_t einsum_ir::backend::BinaryContractionTpp::bind_dim_sizes( std::map< int64_t, int64_t > const * i_dim_sizes ) {
+  if( m_compiled == false ) {
+    return err_t::CALLED_BEFORE_COMPILATION;
+  }
+
+  // keep the broadcasted dimensions of the auxiliary output tensor
+  if( m_dim_sizes_outer_out_aux != nullptr ) {
+    std::map< int64_t, int64_t > l_dim_sizes_out_aux = *i_dim_sizes;
+    for( int64_t l_di = 0; l_di < m_num_dims_out; l_di++ ) {
+      int64_t l_dim_id = m_dim_ids_out[l_di];
+      if(    m_dim_sizes_outer_out_aux->at( l_dim_id ) == 1
+          && m_dim_sizes_outer_out->at( l_dim_id ) > 1 ) {
+        l_dim_sizes_out_aux[l_dim_id] = 1;
+      }
+    }
+    m_dim_sizes_outer_out_aux_bound = l_dim_sizes_out_aux;
+    m_dim_sizes_outer_out_aux = &m_dim_sizes_outer_out_aux_bound;
+  }
+
+  m_dim_sizes_inner        = i_dim_sizes;
+  m_dim_sizes_outer_left   = i_dim_sizes;
+  m_dim_sizes_outer_right  = i_dim_sizes;
+  m_dim_sizes_outer_out    = i_dim_sizes;
+
+  err_t l_err = BinaryContraction::compile_base();
+  if( l_err != einsum_ir::SUCCESS ) {
+    return l_err;
+  }
+
+  std::vector< basic::iter_property > l_loops;
+  basic::kernel_t l_ktype_main = basic::kernel_t::UNDEFINED_KTYPE;
+  int64_t l_num_threads_shared = 1;
+  int64_t l_num_threads_m = 1;
+  int64_t l_num_threads_n = 1;
+  lower( l_loops,
+         l_ktype_main,
+         l_num_threads_shared,
+         l_num_threads_m,
+         l_num_threads_n );
+
+  // reuse the kernels of a compiled contraction with the same primitive loops
+  for( std::size_t l_ba = 0; l_ba < m_backends.size(); l_ba++ ) {
+    if( m_backends[l_ba]->primitives_match( l_loops, l_ktype_main ) == false ) {
+      continue;
+    }
+
+    std::unique_ptr< basic::ContractionBackendTpp > l_backend = std::move( m_backends[l_ba] );
+    m_backends.erase( m_backends.begin() + l_ba );
+    basic::err_t l_err_rebind = l_backend->rebind( l_loops,
+                                                   l_num_threads_shared,
+                                                   l_num_threads_m,
+                                                   l_num_threads_n );
+    if( l_err_rebind == basic::err_t::SUCCESS ) {
+      m_backends.insert( m_backends.begin(), std::move( l_backend ) );
+      return err_t::SUCCESS;
+    }
+
+    // the contraction is unusable after a failed rebind
+    break;
+  }
+
+  // compile a contraction for the new primitive loops
+  basic::ContractionBackendTpp * l_backend = add_backend();
+
+  return compile_backend( l_loops,
+                          l_ktype_main,
+                          l_num_threads_shared,
+                          l_num_threads_m,
+                          l_num_threads_n,
+                          contraction_memory(),
+                          *l_backend );
+}
+
+int64_t einsum_ir::backend::BinaryContractionTpp::num_backends() {
+  return m_backends.size();
+}
+
 void einsum_ir::backend::BinaryContractionTpp::contract( void const * i_tensor_left,
                                                          void const * i_tensor_right,
                                                          void       * io_tensor_out ){
@@ -139,9 +382,9 @@ void einsum_ir::backend::BinaryContractionTpp::contract( void const * i_tensor_l
                                                          void const * i_tensor_right,
                                                          void const * i_tensor_out_aux,
                                                          void       * io_tensor_out ){
-  m_backend.contract( i_tensor_left,
-                      i_tensor_right,
-                      i_tensor_out_aux,
-                      io_tensor_out );
+  m_backends.front()->contract( i_tensor_left,
+                                i_tensor_right,
+                                i_tensor_out_aux,
+                                io_tensor_out );
 }
 
@@ -3,6 +3,7 @@
 
 #include "BinaryContraction.h"
 #include "../basic/binary/ContractionBackendTpp.h"
+#include <memory>
 
 namespace einsum_ir {
   namespace backend {
@@ -20,9 +21,18 @@ class einsum_ir::backend::BinaryContractionTpp: public BinaryContraction {
 
     //! target for the primitive k dimension
     int64_t m_target_prim_k = 256;
+
+    //! true if the contraction optimizer uses the analytical cost model instead of the heuristics
+    bool m_cost_model = false;
    
-    //! contraction backend
-    einsum_ir::basic::ContractionBackendTpp m_backend;
+    //! maximum number of compiled contractions kept for different primitive loops
+    int64_t m_max_backends = 4;
+
+    //! compiled contractions, the first one is bound to the current dimension sizes
+    std::vector< std::unique_ptr< einsum_ir::basic::ContractionBackendTpp > > m_backends;
+
+    //! sizes of the auxiliary output tensor's dimensions after binding new dimension sizes
+    std::map< int64_t, int64_t > m_dim_sizes_outer_out_aux_bound;
 
     /**
      * Helper function for map find with default value
@@ -45,14 +55,111 @@ class einsum_ir::backend::BinaryContractionTpp: public BinaryContraction {
       }
     }
 
-  public:
+    /**
+     * Lowers the contraction to unoptimized loops w.r.t. the current dimension sizes.
+     *
+     * @param o_loops will be set to the unoptimized loops.
+     **/
+    void lower_loops( std::vector< basic::iter_property > & o_loops );
+
+    /**
+     * Derives the parameters of the contraction optimizer.
+     *
+     * @param o_params will be set to the kernel targets, L2 cache size and the cost model switch.
+     * @param o_packed_gemm_support will be set to the support level for packed gemms.
+     * @param o_split_k_support will be set to true if parallel k dimensions are supported.
+     * @param o_cpx_3m_support will be set to true if complex kernels using the 3m algorithm are supported.
+     **/
+    void optimizer_params( basic::tuning_params & o_params,
+                           basic::packed_gemm_t & o_packed_gemm_support,
+                           bool                 & o_split_k_support,
+                           bool                 & o_cpx_3m_support );
+
+    /**
+     * Lowers the contraction to optimized loops w.r.t. the current dimension sizes.
+     *
+     * @param o_loops will be set to the optimized loops.
+     * @param o_ktype_main will be set to the type of the main kernel.
+     * @param o_num_threads_shared will be set to the number of threads for the shared loops.
+     * @param o_num_threads_m will be set to the number of threads for the sfc m loops.
+     * @param o_num_threads_n will be set to the number of threads for the sfc n loops.
+     **/
+    void lower( std::vector< basic::iter_property > & o_loops,
+                basic::kernel_t                     & o_ktype_main,
+                int64_t                             & o_num_threads_shared,
+                int64_t                             & o_num_threads_m,
+                int64_t                             & o_num_threads_n );
+
+    /**
+     * Compiles a contraction backend for the given loops.
+     *
+     * @param i_loops optimized loops.
+     * @param i_ktype_main type of the main kernel.
+     * @param i_num_threads_shared number of threads for the shared loops.
+     * @param i_num_threads_m number of threads for the sfc m loops.
+     * @param i_num_threads_n number of threads for the sfc n loops.
+     * @param i_contraction_memory memory manager of the contraction, nullptr if the backend manages its memory.
+     * @param o_backend backend which is compiled.
+     *
+     * @return SUCCESS if successful, error code otherwise.
+     **/
+    err_t compile_backend( std::vector< basic::iter_property > const & i_loops,
+                           basic::kernel_t                             i_ktype_main,
+                           int64_t                                     i_num_threads_shared,
+                           int64_t                                     i_num_threads_m,
+                           int64_t                                     i_num_threads_n,
+                           basic::ContractionMemoryManager           * i_contraction_memory,
+                           basic::ContractionBackendTpp              & o_backend );
+
+    /**
+     * Adds a new contraction in front of the compiled ones.
+     * The least recently used contraction is evicted if m_max_backends contractions are kept already.
+     *
+     * @return contraction which was added.
+     **/
+    basic::ContractionBackendTpp * add_backend();
+
+    /**
+     * Gets the memory manager which is used by the compiled contractions.
+     *
+     * @return memory manager of the contraction, nullptr if the backends manage their memory.
+     **/
+    basic::ContractionMemoryManager * contraction_memory();
 
+  public:
     /**
      * Compiles the binary contraction.
      * @return SUCCESS if successful, error code otherwise.
      **/
     err_t compile();
 
+    /**
+     * Autotunes the contraction optimizer's parameters for the contraction by benchmarking a search space.
+     * The fastest parameters are stored in the default tuning database, which is consulted by subsequent compilations.
+     * Has to be called after init.
+     *
+     * @return SUCCESS if successful, error code otherwise.
+     **/
+    err_t tune();
+
+    /**
+     * Sets the accumulate mode in which the contraction adds to the existing output, i.e., out += left * right.
+     * The mode is forwarded to the compiled contractions which drop their first-touch kernels.
+     * Has to be called after init and before compile.
+     *
+     * @param i_accumulate true if the contraction accumulates into the output.
+     **/
+    void set_accumulate( bool i_accumulate );
+
+    /**
+     * Enables the analytical cost model which derives the kernel targets and the blocking instead of the heuristics.
+     * Tuned parameters of the default tuning database take precedence.
+     * Has to be called before compile.
+     *
+     * @param i_cost_model true if the cost model is used.
+     **/
+    void set_cost_model( bool i_cost_model );
+
     /**
      * Initializes the threading configuration of the contraction.
      *
@@ -60,6 +167,25 @@ class einsum_ir::backend::BinaryContractionTpp: public BinaryContraction {
      **/
     void threading( int64_t i_num_tasks_target  );
 
+    /**
+     * Binds new dimension sizes to the compiled contraction, e.g., a different batch size.
+     * All tensors are assumed to be dense w.r.t. the new sizes.
+     * The only exception are broadcasted dimensions of the auxiliary output tensor, i.e., dimensions of size 1 in the auxiliary output tensor which are larger in the output tensor, which stay broadcasted.
+     * If the optimized primitive loops are unchanged, the compiled kernels are reused and only the thread partitioning is recomputed.
+     * Otherwise a contraction is compiled for the new primitive loops; at most m_max_backends of them are kept.
+     *
+     * @param i_dim_sizes mapping from the dimension ids to the new sizes, has to outlive the contraction's use.
+     * @return SUCCESS if successful, error code otherwise.
+     **/
+    err_t bind_dim_sizes( std::map< int64_t, int64_t > const * i_dim_sizes );
+
+    /**
+     * Gets the number of compiled contractions, i.e., the number of distinct primitive loops which are kept.
+     *
+     * @return number of compiled contractions.
+     **/
+    int64_t num_backends();
+
     /**
      * Performs a contraction on the given input data.
      *
@@ -0,0 +1,502 @@
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+#include "catch.hpp"
+#include "BinaryContractionTpp.h"
+#include "../basic/binary/ContractionTuningDatabase.h"
+
+TEST_CASE( "TPP-based binary contraction with rebound dimension sizes.", "[binary_contraction_tpp]" ) {
+  // einsum: ckm,cnk->cnm
+  // c: 0, m: 1, n: 2, k: 3
+  int64_t l_dim_ids_left[3]  = { 0, 3, 1 };
+  int64_t l_dim_ids_right[3] = { 0, 2, 3 };
+  int64_t l_dim_ids_out[3]   = { 0, 2, 1 };
+
+  std::map< int64_t, int64_t > l_dim_sizes;
+  l_dim_sizes[0] = 3;
+  l_dim_sizes[1] = 32;
+  l_dim_sizes[2] = 24;
+  l_dim_sizes[3] = 40;
+
+  // runs the contraction for the given sizes and compares to a reference
+  auto l_check = [&]( einsum_ir::backend::BinaryContractionTpp & io_cont,
+                      std::map< int64_t, int64_t > const       & i_sizes ) {
+    int64_t l_size_c = i_sizes.at( 0 );
+    int64_t l_size_m = i_sizes.at( 1 );
+    int64_t l_size_n = i_sizes.at( 2 );
+    int64_t l_size_k = i_sizes.at( 3 );
+
+    std::vector< float > l_left( l_size_c * l_size_k * l_size_m );
+    std::vector< float > l_right( l_size_c * l_size_n * l_size_k );
+    for( std::size_t l_en = 0; l_en < l_left.size(); l_en++ ) {
+      l_left[l_en] = (float) ( l_en % 13 ) - 6.0f;
+    }
+    for( std::size_t l_en = 0; l_en < l_right.size(); l_en++ ) {
+      l_right[l_en] = (float) ( l_en % 7 ) - 3.0f;
+    }
+
+    std::vector< float > l_out_ref( l_size_c * l_size_n * l_size_m, 1.0f );
+    for( int64_t l_c = 0; l_c < l_size_c; l_c++ ) {
+      for( int64_t l_n = 0; l_n < l_size_n; l_n++ ) {
+        for( int64_t l_m = 0; l_m < l_size_m; l_m++ ) {
+          for( int64_t l_k = 0; l_k < l_size_k; l_k++ ) {
+            l_out_ref[ (l_c * l_size_n + l_n) * l_size_m + l_m ] +=   l_left[  (l_c * l_size_k + l_k) * l_size_m + l_m ]
+                                                                    * l_right[ (l_c * l_size_n + l_n) * l_size_k + l_k ];
+          }
+        }
+      }
+    }
+
+    std::vector< float > l_out( l_out_ref.size(), 1.0f );
+    io_cont.contract( l_left.data(),
+                      l_right.data(),
+                      l_out.data() );
+
+    for( std::size_t l_en = 0; l_en < l_out.size(); l_en++ ) {
+      REQUIRE( std::abs( l_out[l_en] - l_out_ref[l_en] ) < 1E-3 );
+    }
+  };
+
+  einsum_ir::backend::BinaryContractionTpp l_cont;
+  l_cont.init( 3,
+               3,
+               3,
+               &l_dim_sizes,
+               &l_dim_sizes,
+               &l_dim_sizes,
+               nullptr,
+               &l_dim_sizes,
+               l_dim_ids_left,
+               l_dim_ids_right,
+               l_dim_ids_out,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::UNDEFINED_KTYPE,
+               einsum_ir::MADD,
+               einsum_ir::UNDEFINED_KTYPE,
+               2 );
+
+  REQUIRE( l_cont.bind_dim_sizes( &l_dim_sizes ) == einsum_ir::CALLED_BEFORE_COMPILATION );
+  REQUIRE( l_cont.compile() == einsum_ir::SUCCESS );
+  REQUIRE( l_cont.num_backends() == 1 );
+  l_check( l_cont, l_dim_sizes );
+
+  // new batch size: the kernels are reused
+  std::map< int64_t, int64_t > l_dim_sizes_batch = l_dim_sizes;
+  l_dim_sizes_batch[0] = 7;
+  REQUIRE( l_cont.bind_dim_sizes( &l_dim_sizes_batch ) == einsum_ir::SUCCESS );
+  REQUIRE( l_cont.num_backends() == 1 );
+  l_check( l_cont, l_dim_sizes_batch );
+
+  // new primitive size: an additional contraction is compiled
+  std::map< int64_t, int64_t > l_dim_sizes_prim = l_dim_sizes;
+  l_dim_sizes_prim[1] = 20;
+  REQUIRE( l_cont.bind_dim_sizes( &l_dim_sizes_prim ) == einsum_ir::SUCCESS );
+  REQUIRE( l_cont.num_backends() == 2 );
+  l_check( l_cont, l_dim_sizes_prim );
+
+  // back to the original primitive size with another batch size
+  std::map< int64_t, int64_t > l_dim_sizes_batch_2 = l_dim_sizes;
+  l_dim_sizes_batch_2[0] = 1;
+  REQUIRE( l_cont.bind_dim_sizes( &l_dim_sizes_batch_2 ) == einsum_ir::SUCCESS );
+  REQUIRE( l_cont.num_backends() == 2 );
+  l_check( l_cont, l_dim_sizes_batch_2 );
+}
+
+TEST_CASE( "TPP-based binary contraction with rebound dimension sizes and a broadcasted bias.", "[binary_contraction_tpp]" ) {
+  // einsum: ckm,cnk->cnm with bias m->cnm
+  // c: 0, m: 1, n: 2, k: 3
+  int64_t l_dim_ids_left[3]  = { 0, 3, 1 };
+  int64_t l_dim_ids_right[3] = { 0, 2, 3 };
+  int64_t l_dim_ids_out[3]   = { 0, 2, 1 };
+
+  std::map< int64_t, int64_t > l_dim_sizes;
+  l_dim_sizes[0] = 3;
+  l_dim_sizes[1] = 32;
+  l_dim_sizes[2] = 24;
+  l_dim_sizes[3] = 40;
+
+  std::map< int64_t, int64_t > l_dim_sizes_bias = l_dim_sizes;
+  l_dim_sizes_bias[0] = 1;
+  l_dim_sizes_bias[2] = 1;
+
+  // runs the contraction for the given sizes and compares to a reference
+  auto l_check = [&]( einsum_ir::backend::BinaryContractionTpp & io_cont,
+                      std::map< int64_t, int64_t > const       & i_sizes ) {
+    int64_t l_size_c = i_sizes.at( 0 );
+    int64_t l_size_m = i_sizes.at( 1 );
+    int64_t l_size_n = i_sizes.at( 2 );
+    int64_t l_size_k = i_sizes.at( 3 );
+
+    std::vector< float > l_left( l_size_c * l_size_k * l_size_m );
+    std::vector< float > l_right( l_size_c * l_size_n * l_size_k );
+    std::vector< float > l_bias( l_size_m );
+    for( std::size_t l_en = 0; l_en < l_left.size(); l_en++ ) {
+      l_left[l_en] = (float) ( l_en % 13 ) - 6.0f;
+    }
+    for( std::size_t l_en = 0; l_en < l_right.size(); l_en++ ) {
+      l_right[l_en] = (float) ( l_en % 7 ) - 3.0f;
+    }
+    for( std::size_t l_en = 0; l_en < l_bias.size(); l_en++ ) {
+      l_bias[l_en] = (float) ( l_en % 5 ) + 0.5f;
+    }
+
+    std::vector< float > l_out_ref( l_size_c * l_size_n * l_size_m );
+    for( int64_t l_c = 0; l_c < l_size_c; l_c++ ) {
+      for( int64_t l_n = 0; l_n < l_size_n; l_n++ ) {
+        for( int64_t l_m = 0; l_m < l_size_m; l_m++ ) {
+          float l_sum = l_bias[l_m];
+          for( int64_t l_k = 0; l_k < l_size_k; l_k++ ) {
+            l_sum +=   l_left[  (l_c * l_size_k + l_k) * l_size_m + l_m ]
+                     * l_right[ (l_c * l_size_n + l_n) * l_size_k + l_k ];
+          }
+          l_out_ref[ (l_c * l_size_n + l_n) * l_size_m + l_m ] = l_sum;
+        }
+      }
+    }
+
+    std::vector< float > l_out( l_out_ref.size(), 0.0f );
+    io_cont.contract( l_left.data(),
+                      l_right.data(),
+                      l_bias.data(),
+                      l_out.data() );
+
+    for( std::size_t l_en = 0; l_en < l_out.size(); l_en++ ) {
+      REQUIRE( std::abs( l_out[l_en] - l_out_ref[l_en] ) < 1E-3 );
+    }
+  };
+
+  einsum_ir::backend::BinaryContractionTpp l_cont;
+  l_cont.init( 3,
+               3,
+               3,
+               &l_dim_sizes,
+               &l_dim_sizes,
+               &l_dim_sizes,
+               &l_dim_sizes_bias,
+               &l_dim_sizes,
+               l_dim_ids_left,
+               l_dim_ids_right,
+               l_dim_ids_out,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::COPY,
+               einsum_ir::MADD,
+               einsum_ir::UNDEFINED_KTYPE,
+               2 );
+
+  REQUIRE( l_cont.compile() == einsum_ir::SUCCESS );
+  l_check( l_cont, l_dim_sizes );
+
+  // new batch size: the bias stays broadcasted in c and n
+  std::map< int64_t, int64_t > l_dim_sizes_batch = l_dim_sizes;
+  l_dim_sizes_batch[0] = 5;
+  REQUIRE( l_cont.bind_dim_sizes( &l_dim_sizes_batch ) == einsum_ir::SUCCESS );
+  REQUIRE( l_cont.num_backends() == 1 );
+  l_check( l_cont, l_dim_sizes_batch );
+
+  // new primitive sizes: at most four contractions are kept
+  for( int64_t l_size_m = 8; l_size_m <= 48; l_size_m += 8 ) {
+    std::map< int64_t, int64_t > l_dim_sizes_prim = l_dim_sizes_batch;
+    l_dim_sizes_prim[1] = l_size_m;
+    REQUIRE( l_cont.bind_dim_sizes( &l_dim_sizes_prim ) == einsum_ir::SUCCESS );
+    REQUIRE( l_cont.num_backends() <= 4 );
+    l_check( l_cont, l_dim_sizes_prim );
+  }
+
+  // recompilation discards the contractions of other sizes
+  REQUIRE( l_cont.bind_dim_sizes( &l_dim_sizes_batch ) == einsum_ir::SUCCESS );
+  REQUIRE( l_cont.compile() == einsum_ir::SUCCESS );
+  REQUIRE( l_cont.num_backends() == 1 );
+  l_check( l_cont, l_dim_sizes_batch );
+}
+
+TEST_CASE( "TPP-based binary contraction with autotuned optimizer parameters.", "[binary_contraction_tpp]" ) {
+  // einsum: km,nk->nm
+  // m: 0, n: 1, k: 2
+  int64_t l_dim_ids_left[2]  = { 2, 0 };
+  int64_t l_dim_ids_right[2] = { 1, 2 };
+  int64_t l_dim_ids_out[2]   = { 1, 0 };
+
+  std::map< int64_t, int64_t > l_dim_sizes;
+  l_dim_sizes[0] = 29;
+  l_dim_sizes[1] = 31;
+  l_dim_sizes[2] = 37;
+
+  einsum_ir::basic::ContractionTuningDatabase * l_db = einsum_ir::basic::ContractionTuningDatabase::get_default();
+  int64_t l_size_db = l_db->size();
+
+  einsum_ir::backend::BinaryContractionTpp l_cont;
+  l_cont.init( 2,
+               2,
+               2,
+               &l_dim_sizes,
+               &l_dim_sizes,
+               &l_dim_sizes,
+               nullptr,
+               &l_dim_sizes,
+               l_dim_ids_left,
+               l_dim_ids_right,
+               l_dim_ids_out,
+               einsum_ir::FP64,
+               einsum_ir::FP64,
+               einsum_ir::FP64,
+               einsum_ir::FP64,
+               einsum_ir::ZERO,
+               einsum_ir::MADD,
+               einsum_ir::UNDEFINED_KTYPE,
+               2 );
+
+  REQUIRE( l_cont.tune() == einsum_ir::SUCCESS );
+  REQUIRE( l_db->size() == l_size_db + 1 );
+  REQUIRE( l_cont.compile() == einsum_ir::SUCCESS );
+
+  std::vector< double > l_left( 37 * 29 );
+  std::vector< double > l_right( 31 * 37 );
+  for( std::size_t l_en = 0; l_en < l_left.size(); l_en++ ) {
+    l_left[l_en] = 0.5 * (double) ( l_en % 9 ) - 2.0;
+  }
+  for( std::size_t l_en = 0; l_en < l_right.size(); l_en++ ) {
+    l_right[l_en] = 0.25 * (double) ( l_en % 7 ) - 0.75;
+  }
+
+  std::vector< double > l_out( 31 * 29, 1.0 );
+  l_cont.contract( l_left.data(),
+                   l_right.data(),
+                   l_out.data() );
+
+  for( int64_t l_n = 0; l_n < 31; l_n++ ) {
+    for( int64_t l_m = 0; l_m < 29; l_m++ ) {
+      double l_ref = 0;
+      for( int64_t l_k = 0; l_k < 37; l_k++ ) {
+        l_ref += l_left[ l_k * 29 + l_m ] * l_right[ l_n * 37 + l_k ];
+      }
+      REQUIRE( std::abs( l_out[ l_n * 29 + l_m ] - l_ref ) < 1E-10 );
+    }
+  }
+}
+
+TEST_CASE( "TPP-based binary contraction using the analytical cost model.", "[binary_contraction_tpp]" ) {
+  // einsum: ckm,cnk->cnm
+  // c: 0, m: 1, n: 2, k: 3
+  int64_t l_dim_ids_left[3]  = { 0, 3, 1 };
+  int64_t l_dim_ids_right[3] = { 0, 2, 3 };
+  int64_t l_dim_ids_out[3]   = { 0, 2, 1 };
+
+  int64_t l_size_c = 2;
+  int64_t l_size_m = 96;
+  int64_t l_size_n = 80;
+  int64_t l_size_k = 128;
+
+  std::map< int64_t, int64_t > l_dim_sizes;
+  l_dim_sizes[0] = l_size_c;
+  l_dim_sizes[1] = l_size_m;
+  l_dim_sizes[2] = l_size_n;
+  l_dim_sizes[3] = l_size_k;
+
+  einsum_ir::backend::BinaryContractionTpp l_cont;
+  l_cont.init( 3,
+               3,
+               3,
+               &l_dim_sizes,
+               &l_dim_sizes,
+               &l_dim_sizes,
+               nullptr,
+               &l_dim_sizes,
+               l_dim_ids_left,
+               l_dim_ids_right,
+               l_dim_ids_out,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::UNDEFINED_KTYPE,
+               einsum_ir::MADD,
+               einsum_ir::UNDEFINED_KTYPE,
+               2 );
+  l_cont.set_cost_model( true );
+  REQUIRE( l_cont.compile() == einsum_ir::SUCCESS );
+
+  std::vector< float > l_left( l_size_c * l_size_k * l_size_m );
+  std::vector< float > l_right( l_size_c * l_size_n * l_size_k );
+  for( std::size_t l_en = 0; l_en < l_left.size(); l_en++ ) {
+    l_left[l_en] = (float) ( l_en % 13 ) - 6.0f;
+  }
+  for( std::size_t l_en = 0; l_en < l_right.size(); l_en++ ) {
+    l_right[l_en] = (float) ( l_en % 7 ) - 3.0f;
+  }
+
+  std::vector< float > l_out( l_size_c * l_size_n * l_size_m, 1.0f );
+  l_cont.contract( l_left.data(),
+                   l_right.data(),
+                   l_out.data() );
+
+  for( int64_t l_c = 0; l_c < l_size_c; l_c++ ) {
+    for( int64_t l_n = 0; l_n < l_size_n; l_n++ ) {
+      for( int64_t l_m = 0; l_m < l_size_m; l_m++ ) {
+        float l_ref = 1.0f;
+        for( int64_t l_k = 0; l_k < l_size_k; l_k++ ) {
+          l_ref +=   l_left[  (l_c * l_size_k + l_k) * l_size_m + l_m ]
+                   * l_right[ (l_c * l_size_n + l_n) * l_size_k + l_k ];
+        }
+        REQUIRE( std::abs( l_out[ (l_c * l_size_n + l_n) * l_size_m + l_m ] - l_ref ) < 1E-3 );
+      }
+    }
+  }
+}
+
+TEST_CASE( "TPP-based binary contraction which accumulates into the output.", "[binary_contraction_tpp]" ) {
+  // einsum: km,nk->nm
+  // m: 0, n: 1, k: 2
+  int64_t l_dim_ids_left[2]  = { 2, 0 };
+  int64_t l_dim_ids_right[2] = { 1, 2 };
+  int64_t l_dim_ids_out[2]   = { 1, 0 };
+
+  std::map< int64_t, int64_t > l_dim_sizes;
+  l_dim_sizes[0] = 24;
+  l_dim_sizes[1] = 20;
+  l_dim_sizes[2] = 16;
+
+  // the zero first-touch kernel is dropped by the accumulate mode
+  einsum_ir::backend::BinaryContractionTpp l_cont;
+  l_cont.init( 2,
+               2,
+               2,
+               &l_dim_sizes,
+               &l_dim_sizes,
+               &l_dim_sizes,
+               nullptr,
+               &l_dim_sizes,
+               l_dim_ids_left,
+               l_dim_ids_right,
+               l_dim_ids_out,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::ZERO,
+               einsum_ir::MADD,
+               einsum_ir::UNDEFINED_KTYPE,
+               2 );
+  l_cont.set_accumulate( true );
+  REQUIRE( l_cont.compile() == einsum_ir::SUCCESS );
+
+  // runs the contraction twice for the given sizes and compares to a reference
+  auto l_check = [&]( std::map< int64_t, int64_t > const & i_sizes ) {
+    int64_t l_size_m = i_sizes.at( 0 );
+    int64_t l_size_n = i_sizes.at( 1 );
+    int64_t l_size_k = i_sizes.at( 2 );
+
+    std::vector< float > l_left( l_size_k * l_size_m );
+    std::vector< float > l_right( l_size_n * l_size_k );
+    for( std::size_t l_en = 0; l_en < l_left.size(); l_en++ ) {
+      l_left[l_en] = (float) ( l_en % 11 ) - 5.0f;
+    }
+    for( std::size_t l_en = 0; l_en < l_right.size(); l_en++ ) {
+      l_right[l_en] = (float) ( l_en % 5 ) - 2.0f;
+    }
+
+    std::vector< float > l_out( l_size_n * l_size_m, 3.0f );
+    for( int64_t l_re = 0; l_re < 2; l_re++ ) {
+      l_cont.contract( l_left.data(),
+                       l_right.data(),
+                       l_out.data() );
+    }
+
+    for( int64_t l_n = 0; l_n < l_size_n; l_n++ ) {
+      for( int64_t l_m = 0; l_m < l_size_m; l_m++ ) {
+        float l_ref = 0;
+        for( int64_t l_k = 0; l_k < l_size_k; l_k++ ) {
+          l_ref += l_left[ l_k * l_size_m + l_m ] * l_right[ l_n * l_size_k + l_k ];
+        }
+        REQUIRE( std::abs( l_out[ l_n * l_size_m + l_m ] - ( 3.0f + 2.0f * l_ref ) ) < 1E-3 );
+      }
+    }
+  };
+  l_check( l_dim_sizes );
+
+  // contractions compiled for new sizes accumulate as well
+  std::map< int64_t, int64_t > l_dim_sizes_prim = l_dim_sizes;
+  l_dim_sizes_prim[0] = 40;
+  REQUIRE( l_cont.bind_dim_sizes( &l_dim_sizes_prim ) == einsum_ir::SUCCESS );
+  l_check( l_dim_sizes_prim );
+}
+
+TEST_CASE( "TPP-based binary contraction with INT8 inputs and requantized INT8 output.", "[binary_contraction_tpp]" ) {
+  // einsum: km,nk->nm
+  // m: 0, n: 1, k: 2
+  int64_t l_dim_ids_left[2]  = { 2, 0 };
+  int64_t l_dim_ids_right[2] = { 1, 2 };
+  int64_t l_dim_ids_out[2]   = { 1, 0 };
+
+  // the requantization requires the whole k dimension in the primitive
+  auto l_sizes = GENERATE( std::make_tuple( 2048,  64,  512, false ),
+                           std::make_tuple(   96,  80, 4096, false ),
+                           std::make_tuple(  256, 256, 1024, true  ) );
+  int64_t l_size_m     = std::get< 0 >( l_sizes );
+  int64_t l_size_n     = std::get< 1 >( l_sizes );
+  int64_t l_size_k     = std::get< 2 >( l_sizes );
+  bool    l_cost_model = std::get< 3 >( l_sizes );
+
+  std::map< int64_t, int64_t > l_dim_sizes;
+  l_dim_sizes[0] = l_size_m;
+  l_dim_sizes[1] = l_size_n;
+  l_dim_sizes[2] = l_size_k;
+
+  einsum_ir::backend::BinaryContractionTpp l_cont;
+  l_cont.init( 2,
+               2,
+               2,
+               &l_dim_sizes,
+               &l_dim_sizes,
+               &l_dim_sizes,
+               nullptr,
+               &l_dim_sizes,
+               l_dim_ids_left,
+               l_dim_ids_right,
+               l_dim_ids_out,
+               einsum_ir::INT8,
+               einsum_ir::INT8,
+               einsum_ir::INT32,
+               einsum_ir::INT8,
+               einsum_ir::ZERO,
+               einsum_ir::MADD,
+               einsum_ir::REQUANTIZE,
+               4 );
+  double l_scale = 1.0 / ( 8 * l_size_k );
+  double l_zero_point = 3;
+  l_cont.set_last_touch_ops( { { einsum_ir::REQUANTIZE, l_scale, l_zero_point } } );
+  l_cont.set_cost_model( l_cost_model );
+  REQUIRE( l_cont.compile() == einsum_ir::SUCCESS );
+
+  std::vector< int8_t > l_left( l_size_k * l_size_m );
+  std::vector< int8_t > l_right( l_size_n * l_size_k );
+  for( std::size_t l_en = 0; l_en < l_left.size(); l_en++ ) {
+    l_left[l_en] = (int8_t) ( ( l_en * 37 ) % 255 ) - 127;
+  }
+  for( std::size_t l_en = 0; l_en < l_right.size(); l_en++ ) {
+    l_right[l_en] = (int8_t) ( ( l_en * 59 ) % 251 ) - 125;
+  }
+
+  std::vector< int8_t > l_out( l_size_n * l_size_m, 0 );
+  l_cont.contract( l_left.data(),
+                   l_right.data(),
+                   l_out.data() );
+
+  for( int64_t l_n = 0; l_n < l_size_n; l_n++ ) {
+    for( int64_t l_m = 0; l_m < l_size_m; l_m++ ) {
+      int32_t l_acc = 0;
+      for( int64_t l_k = 0; l_k < l_size_k; l_k++ ) {
+        l_acc += (int32_t) l_left[ l_k * l_size_m + l_m ] * (int32_t) l_right[ l_n * l_size_k + l_k ];
+      }
+      float l_ref = std::nearbyint( (float) l_scale * (float) l_acc ) + (float) l_zero_point;
+      l_ref = std::min( std::max( l_ref, -128.0f ), 127.0f );
+      REQUIRE( std::abs( (float) l_out[ l_n * l_size_m + l_m ] - l_ref ) <= 1 );
+    }
+  }
+}
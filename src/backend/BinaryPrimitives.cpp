@@ -37,6 +37,20 @@ einsum_ir::err_t einsum_ir::backend::BinaryPrimitives::init( data_t    i_data_ty
              6,  32,
             16, 256 );
     }
+    else if(    i_data_type == data_t::BF16
+             || i_data_type == data_t::FP16 ){
+      init(  8,  32,
+            32, 128,
+            12,  64,
+            64, 1024 );
+    }
+    else if(    i_data_type == data_t::INT8
+             || i_data_type == data_t::INT32 ){
+      init( 16,  64,
+            32, 128,
+            12,  64,
+           128, 2048 );
+    }
     else {
       return err_t::INVALID_DTYPE;
     }
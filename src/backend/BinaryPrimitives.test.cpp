@@ -181,6 +181,62 @@ TEST_CASE( "Blocking of a matrix-matrix multiplication with non-contiguous memor
   REQUIRE( l_dim_ids_nb[ 1 ] == 'f' );
 }
 
+TEST_CASE( "Blocking of a matrix-matrix multiplication with the default TPP sizes of FP32 and FP64.", "[binary_primitives]" ) {
+  // the default sizes are independent of the vector registers of the machine
+  einsum_ir::data_t l_dtype = GENERATE( einsum_ir::data_t::FP32,
+                                        einsum_ir::data_t::FP64 );
+
+  einsum_ir::backend::BinaryPrimitives l_bpr;
+  REQUIRE( l_bpr.init( l_dtype,
+                       einsum_ir::backend_t::TPP ) == einsum_ir::err_t::SUCCESS );
+
+  std::map< int64_t, int64_t > l_dim_sizes;
+  l_dim_sizes.insert( std::pair< int64_t, int64_t >( 'a', 64 ) );
+  l_dim_sizes.insert( std::pair< int64_t, int64_t >( 'b',  8 ) );
+  l_dim_sizes.insert( std::pair< int64_t, int64_t >( 'c', 64 ) );
+  l_dim_sizes.insert( std::pair< int64_t, int64_t >( 'd', 16 ) );
+
+  int64_t l_dim_ids_left[ 3 ]  = { 'a', 'b', 'd' };
+  int64_t l_dim_ids_right[ 2 ] = { 'c', 'a' };
+  int64_t l_dim_ids_out[ 3 ]   = { 'c', 'b', 'd' };
+
+  std::vector< int64_t > l_dim_ids_cb;
+  std::vector< int64_t > l_dim_ids_mb;
+  std::vector< int64_t > l_dim_ids_nb;
+  std::vector< int64_t > l_dim_ids_kb;
+
+  einsum_ir::err_t l_err = l_bpr.blocking( einsum_ir::primblo_t::LEFT_KB_X_MB_CB_RIGHT_NB_X_KB_CB_OUT_NB_X_MB_CB,
+                                           3,
+                                           2,
+                                           3,
+                                           l_dim_ids_left,
+                                           l_dim_ids_right,
+                                           l_dim_ids_out,
+                                           &l_dim_sizes,
+                                           nullptr,
+                                           nullptr,
+                                           nullptr,
+                                           &l_dim_ids_cb,
+                                           &l_dim_ids_mb,
+                                           &l_dim_ids_nb,
+                                           &l_dim_ids_kb );
+
+  REQUIRE( l_err == einsum_ir::err_t::SUCCESS );
+
+  // FP32 blocks up to 128 and FP64 up to 64 entries in m
+  if( l_dtype == einsum_ir::data_t::FP32 ) {
+    REQUIRE( l_dim_ids_mb.size() == 2 );
+    REQUIRE( l_dim_ids_mb[ 0 ] == 'b' );
+    REQUIRE( l_dim_ids_mb[ 1 ] == 'd' );
+  }
+  else {
+    REQUIRE( l_dim_ids_mb.size() == 1 );
+    REQUIRE( l_dim_ids_mb[ 0 ] == 'd' );
+  }
+  REQUIRE( l_dim_ids_nb.size() == 1 );
+  REQUIRE( l_dim_ids_kb.size() == 1 );
+}
+
 TEST_CASE( "Blocking of the binary contraction: 12 13 2 3 9 10 11 14 , 0 9 10 1 11 -> 0 1 12 13 14", "[binary_primitives]" ) {
   einsum_ir::backend::BinaryPrimitives l_bpr;
 
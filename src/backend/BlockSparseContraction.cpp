@@ -0,0 +1,350 @@
+#include "BlockSparseContraction.h"
+#include "../basic/binary/ContractionOptimizer.h"
+#include "../basic/parallel/ExecutionContext.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <set>
+
+void einsum_ir::backend::BlockSparseContraction::init( block_sparse_tensor                          const * i_left,
+                                                       block_sparse_tensor                          const * i_right,
+                                                       block_sparse_tensor                          const * i_out,
+                                                       std::map< int64_t, std::vector< int64_t > >  const * i_block_sizes,
+                                                       data_t                                               i_dtype_left,
+                                                       data_t                                               i_dtype_right,
+                                                       data_t                                               i_dtype_comp,
+                                                       data_t                                               i_dtype_out,
+                                                       int64_t                                              i_num_threads ) {
+  m_left        = i_left;
+  m_right       = i_right;
+  m_out         = i_out;
+  m_block_sizes = i_block_sizes;
+
+  m_dtype_left  = i_dtype_left;
+  m_dtype_right = i_dtype_right;
+  m_dtype_comp  = i_dtype_comp;
+  m_dtype_out   = i_dtype_out;
+
+  m_num_threads = i_num_threads;
+}
+
+einsum_ir::err_t einsum_ir::backend::BlockSparseContraction::block_sizes( block_sparse_tensor const & i_tensor,
+                                                                          int64_t                     i_id_block,
+                                                                          std::map< int64_t, int64_t > & o_sizes ) {
+  int64_t l_num_dims = i_tensor.dim_ids.size();
+
+  for( int64_t l_di = 0; l_di < l_num_dims; l_di++ ) {
+    int64_t l_dim_id   = i_tensor.dim_ids[l_di];
+    int64_t l_block_id = i_tensor.block_ids[ i_id_block * l_num_dims + l_di ];
+
+    if( m_block_sizes->count( l_dim_id ) == 0 ) {
+      return err_t::INVALID_ID;
+    }
+    std::vector< int64_t > const & l_sizes = m_block_sizes->at( l_dim_id );
+    if( l_block_id < 0 || l_block_id >= (int64_t) l_sizes.size() ) {
+      return err_t::INVALID_ID;
+    }
+
+    o_sizes[l_dim_id] = l_sizes[l_block_id];
+  }
+
+  return err_t::SUCCESS;
+}
+
+einsum_ir::err_t einsum_ir::backend::BlockSparseContraction::compile_group( std::map< int64_t, int64_t > const & i_sizes,
+                                                                            basic::ContractionBackendTpp       & o_backend ) {
+  // strides of the dense blocks
+  std::map< int64_t, int64_t > l_strides[3];
+  block_sparse_tensor const * l_tensors[3] = { m_left, m_right, m_out };
+  for( int64_t l_te = 0; l_te < 3; l_te++ ) {
+    int64_t l_stride = 1;
+    for( int64_t l_di = l_tensors[l_te]->dim_ids.size() - 1; l_di >= 0; l_di-- ) {
+      int64_t l_dim_id = l_tensors[l_te]->dim_ids[l_di];
+      l_strides[l_te][l_dim_id] = l_stride;
+      l_stride *= i_sizes.at( l_dim_id );
+    }
+  }
+
+  // lower to ContractionOptimizer data structure: C, M, N, K
+  std::vector< basic::iter_property > l_loops;
+  for( basic::dim_t l_dim_type : { basic::dim_t::C, basic::dim_t::M, basic::dim_t::N, basic::dim_t::K } ) {
+    for( std::map< int64_t, int64_t >::const_iterator l_it = i_sizes.begin(); l_it != i_sizes.end(); l_it++ ) {
+      int64_t l_dim_id = l_it->first;
+      bool l_left  = l_strides[0].count( l_dim_id ) > 0;
+      bool l_right = l_strides[1].count( l_dim_id ) > 0;
+      bool l_out   = l_strides[2].count( l_dim_id ) > 0;
+
+      basic::dim_t l_type = basic::dim_t::UNDEFINED_DIM;
+      if(      l_left  && l_right && l_out ) l_type = basic::dim_t::C;
+      else if( l_left  && l_out            ) l_type = basic::dim_t::M;
+      else if( l_right && l_out            ) l_type = basic::dim_t::N;
+      else if( l_left  && l_right          ) l_type = basic::dim_t::K;
+
+      if( l_type != l_dim_type ) {
+        continue;
+      }
+
+      basic::iter_property l_iter;
+      l_iter.dim_type     = l_type;
+      l_iter.exec_type    = basic::exec_t::SEQ;
+      l_iter.size         = l_it->second;
+      l_iter.stride_left  = l_left  ? l_strides[0].at( l_dim_id ) : 0;
+      l_iter.stride_right = l_right ? l_strides[1].at( l_dim_id ) : 0;
+      l_iter.stride_out   = l_out   ? l_strides[2].at( l_dim_id ) : 0;
+      l_loops.push_back( l_iter );
+    }
+  }
+
+  // packed kernels support fp32 and fp64 only
+  bool l_low_precision =    basic::ce_low_precision( ce_dtype_to_basic( m_dtype_left  ) )
+                         || basic::ce_low_precision( ce_dtype_to_basic( m_dtype_right ) )
+                         || basic::ce_low_precision( ce_dtype_to_basic( m_dtype_out   ) );
+
+  // every block pair is contracted by a single thread
+  basic::kernel_t l_ktype_main = basic::kernel_t::MADD;
+  int64_t l_num_threads_shared = 1;
+  int64_t l_num_threads_m = 1;
+  int64_t l_num_threads_n = 1;
+
+  basic::ContractionOptimizer l_optim;
+  l_optim.init( &l_loops,
+                &l_ktype_main,
+                m_target_prim_m,
+                m_target_prim_n,
+                m_target_prim_k,
+                false,
+                true,
+                true,
+                l_low_precision ? basic::packed_gemm_t::NONE : basic::packed_gemm_t::ALL_STRIDE_ONE,
+                false,
+                false,
+                ce_n_bytes( m_dtype_out ),
+                m_l2_cache_size,
+                &l_num_threads_shared,
+                &l_num_threads_m,
+                &l_num_threads_n );
+  basic::err_t l_err = l_optim.optimize();
+  if( l_err != basic::err_t::SUCCESS ) {
+    return ce_basic_err_to_err( l_err );
+  }
+
+  o_backend.init( l_loops,
+                  ce_dtype_to_basic( m_dtype_left ),
+                  ce_dtype_to_basic( m_dtype_right ),
+                  ce_dtype_to_basic( m_dtype_comp ),
+                  ce_dtype_to_basic( m_dtype_out ),
+                  basic::kernel_t::UNDEFINED_KTYPE,
+                  l_ktype_main,
+                  basic::kernel_t::UNDEFINED_KTYPE,
+                  l_num_threads_shared,
+                  l_num_threads_m,
+                  l_num_threads_n,
+                  nullptr );
+
+  return ce_basic_err_to_err( o_backend.compile() );
+}
+
+einsum_ir::err_t einsum_ir::backend::BlockSparseContraction::compile() {
+  err_t l_err = err_t::UNDEFINED_ERROR;
+
+  // contractions of a previous compilation are outdated
+  m_backends.clear();
+  m_num_groups = 0;
+
+  // check the dimension types: every dimension has to appear in two tensors at least
+  std::set< int64_t > l_dims_left(  m_left->dim_ids.begin(),  m_left->dim_ids.end()  );
+  std::set< int64_t > l_dims_right( m_right->dim_ids.begin(), m_right->dim_ids.end() );
+  std::set< int64_t > l_dims_out(   m_out->dim_ids.begin(),   m_out->dim_ids.end()   );
+
+  std::set< int64_t > l_dims_all = l_dims_left;
+  l_dims_all.insert( l_dims_right.begin(), l_dims_right.end() );
+  l_dims_all.insert( l_dims_out.begin(),   l_dims_out.end()   );
+
+  // dimensions on which the blocks of left and right have to match
+  std::vector< int64_t > l_dims_shared;
+  for( std::set< int64_t >::iterator l_it = l_dims_all.begin(); l_it != l_dims_all.end(); l_it++ ) {
+    int64_t l_num_tensors =   l_dims_left.count( *l_it )
+                            + l_dims_right.count( *l_it )
+                            + l_dims_out.count( *l_it );
+    if( l_num_tensors < 2 ) {
+      return err_t::COMPILATION_FAILED;
+    }
+    if( l_dims_left.count( *l_it ) > 0 && l_dims_right.count( *l_it ) > 0 ) {
+      l_dims_shared.push_back( *l_it );
+    }
+  }
+
+  int64_t l_num_dims_left  = m_left->dim_ids.size();
+  int64_t l_num_dims_right = m_right->dim_ids.size();
+  int64_t l_num_dims_out   = m_out->dim_ids.size();
+  int64_t l_num_blocks_left  = l_num_dims_left  > 0 ? m_left->block_ids.size()  / l_num_dims_left  : 0;
+  int64_t l_num_blocks_right = l_num_dims_right > 0 ? m_right->block_ids.size() / l_num_dims_right : 0;
+  int64_t l_num_blocks_out   = l_num_dims_out   > 0 ? m_out->block_ids.size()   / l_num_dims_out   : 0;
+
+  // output blocks by their block ids
+  std::map< std::vector< int64_t >, int64_t > l_ids_out;
+  m_sizes_out.resize( l_num_blocks_out );
+  for( int64_t l_bl = 0; l_bl < l_num_blocks_out; l_bl++ ) {
+    std::map< int64_t, int64_t > l_sizes;
+    l_err = block_sizes( *m_out,
+                         l_bl,
+                         l_sizes );
+    if( l_err != err_t::SUCCESS ) {
+      return l_err;
+    }
+
+    m_sizes_out[l_bl] = ce_n_bytes( m_dtype_out );
+    for( std::map< int64_t, int64_t >::iterator l_it = l_sizes.begin(); l_it != l_sizes.end(); l_it++ ) {
+      m_sizes_out[l_bl] *= l_it->second;
+    }
+
+    std::vector< int64_t > l_key( m_out->block_ids.begin() +  l_bl      * l_num_dims_out,
+                                  m_out->block_ids.begin() + (l_bl + 1) * l_num_dims_out );
+    l_ids_out[l_key] = l_bl;
+  }
+
+  // right blocks by their block ids in the shared dimensions
+  std::map< std::vector< int64_t >, std::vector< int64_t > > l_ids_right;
+  for( int64_t l_bl = 0; l_bl < l_num_blocks_right; l_bl++ ) {
+    std::vector< int64_t > l_key;
+    for( std::size_t l_sh = 0; l_sh < l_dims_shared.size(); l_sh++ ) {
+      int64_t l_di = std::find( m_right->dim_ids.begin(), m_right->dim_ids.end(), l_dims_shared[l_sh] ) - m_right->dim_ids.begin();
+      l_key.push_back( m_right->block_ids[ l_bl * l_num_dims_right + l_di ] );
+    }
+    l_ids_right[l_key].push_back( l_bl );
+  }
+
+  // enumerate the non-zero block pairs and group them by shape
+  std::map< std::vector< int64_t >, int64_t > l_ids_group;
+  std::vector< int64_t > l_work_out( l_num_blocks_out, 0 );
+  m_pairs_out.clear();
+  m_pairs_out.resize( l_num_blocks_out );
+
+  for( int64_t l_bl = 0; l_bl < l_num_blocks_left; l_bl++ ) {
+    std::vector< int64_t > l_key;
+    for( std::size_t l_sh = 0; l_sh < l_dims_shared.size(); l_sh++ ) {
+      int64_t l_di = std::find( m_left->dim_ids.begin(), m_left->dim_ids.end(), l_dims_shared[l_sh] ) - m_left->dim_ids.begin();
+      l_key.push_back( m_left->block_ids[ l_bl * l_num_dims_left + l_di ] );
+    }
+    if( l_ids_right.count( l_key ) == 0 ) {
+      continue;
+    }
+
+    std::map< int64_t, int64_t > l_sizes_left;
+    l_err = block_sizes( *m_left,
+                         l_bl,
+                         l_sizes_left );
+    if( l_err != err_t::SUCCESS ) {
+      return l_err;
+    }
+
+    std::vector< int64_t > const & l_bls_right = l_ids_right.at( l_key );
+    for( std::size_t l_pa = 0; l_pa < l_bls_right.size(); l_pa++ ) {
+      int64_t l_bl_right = l_bls_right[l_pa];
+
+      std::map< int64_t, int64_t > l_sizes = l_sizes_left;
+      l_err = block_sizes( *m_right,
+                           l_bl_right,
+                           l_sizes );
+      if( l_err != err_t::SUCCESS ) {
+        return l_err;
+      }
+
+      // output block of the pair
+      std::vector< int64_t > l_key_out;
+      for( int64_t l_di = 0; l_di < l_num_dims_out; l_di++ ) {
+        int64_t l_dim_id = m_out->dim_ids[l_di];
+        std::vector< int64_t >::const_iterator l_pos = std::find( m_left->dim_ids.begin(), m_left->dim_ids.end(), l_dim_id );
+        if( l_pos != m_left->dim_ids.end() ) {
+          l_key_out.push_back( m_left->block_ids[ l_bl * l_num_dims_left + ( l_pos - m_left->dim_ids.begin() ) ] );
+        }
+        else {
+          l_pos = std::find( m_right->dim_ids.begin(), m_right->dim_ids.end(), l_dim_id );
+          l_key_out.push_back( m_right->block_ids[ l_bl_right * l_num_dims_right + ( l_pos - m_right->dim_ids.begin() ) ] );
+        }
+      }
+      if( l_ids_out.count( l_key_out ) == 0 ) {
+        return err_t::INVALID_ID;
+      }
+      int64_t l_bl_out = l_ids_out.at( l_key_out );
+
+      // group of the pair
+      std::vector< int64_t > l_shape;
+      int64_t l_work = 1;
+      for( std::map< int64_t, int64_t >::iterator l_it = l_sizes.begin(); l_it != l_sizes.end(); l_it++ ) {
+        l_shape.push_back( l_it->second );
+        l_work *= l_it->second;
+      }
+      if( l_ids_group.count( l_shape ) == 0 ) {
+        int64_t l_id_group = l_ids_group.size();
+        l_ids_group[l_shape] = l_id_group;
+
+        for( int64_t l_th = 0; l_th < m_num_threads; l_th++ ) {
+          m_backends.push_back( std::make_unique< basic::ContractionBackendTpp >() );
+
+          l_err = compile_group( l_sizes,
+                                 *m_backends.back() );
+          if( l_err != err_t::SUCCESS ) {
+            return l_err;
+          }
+        }
+      }
+
+      block_pair l_pair;
+      l_pair.id_left  = l_bl;
+      l_pair.id_right = l_bl_right;
+      l_pair.id_group = l_ids_group.at( l_shape );
+      m_pairs_out[l_bl_out].push_back( l_pair );
+      l_work_out[l_bl_out] += l_work;
+    }
+  }
+  m_num_groups = l_ids_group.size();
+
+  // schedule the output blocks with the most work first
+  m_order_out.resize( l_num_blocks_out );
+  for( int64_t l_bl = 0; l_bl < l_num_blocks_out; l_bl++ ) {
+    m_order_out[l_bl] = l_bl;
+  }
+  std::stable_sort( m_order_out.begin(),
+                    m_order_out.end(),
+                    [&]( int64_t i_a, int64_t i_b ) {
+                      return l_work_out[i_a] > l_work_out[i_b];
+                    } );
+
+  return err_t::SUCCESS;
+}
+
+int64_t einsum_ir::backend::BlockSparseContraction::num_groups() {
+  return m_num_groups;
+}
+
+void einsum_ir::backend::BlockSparseContraction::contract( void const * const * i_blocks_left,
+                                                           void const * const * i_blocks_right,
+                                                           void       * const * io_blocks_out ) {
+  int64_t l_num_blocks_out = m_order_out.size();
+  std::atomic< int64_t > l_next( 0 );
+
+  basic::ExecutionContext::get_default()->parallel( m_num_threads,
+                                                     [&]( int64_t l_thread_id ) {
+    int64_t l_id = l_next.fetch_add( 1, std::memory_order_relaxed );
+    while( l_id < l_num_blocks_out ) {
+      int64_t l_bl_out = m_order_out[l_id];
+
+      std::memset( io_blocks_out[l_bl_out],
+                   0,
+                   m_sizes_out[l_bl_out] );
+
+      std::vector< block_pair > const & l_pairs = m_pairs_out[l_bl_out];
+      for( std::size_t l_pa = 0; l_pa < l_pairs.size(); l_pa++ ) {
+        basic::ContractionBackendTpp * l_backend = m_backends[ l_pairs[l_pa].id_group * m_num_threads + l_thread_id ].get();
+        l_backend->contract( i_blocks_left[  l_pairs[l_pa].id_left  ],
+                             i_blocks_right[ l_pairs[l_pa].id_right ],
+                             nullptr,
+                             io_blocks_out[  l_bl_out ] );
+      }
+
+      l_id = l_next.fetch_add( 1, std::memory_order_relaxed );
+    }
+  } );
+}
@@ -0,0 +1,168 @@
+#ifndef EINSUM_IR_BACKEND_BLOCK_SPARSE_CONTRACTION
+#define EINSUM_IR_BACKEND_BLOCK_SPARSE_CONTRACTION
+
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <memory>
+#include "../constants.h"
+#include "../basic/binary/ContractionBackendTpp.h"
+
+namespace einsum_ir {
+  namespace backend {
+    class BlockSparseContraction;
+  }
+}
+
+/**
+ * Binary contraction of block-sparse tensors.
+ * The non-zero block pairs of the inputs are grouped by their shape.
+ * Every group is executed by a compiled TPP contraction, the output blocks are distributed among the threads.
+ **/
+class einsum_ir::backend::BlockSparseContraction {
+  private:
+    //! pair of non-zero input blocks which contributes to an output block
+    struct block_pair {
+      //! id of the left block
+      int64_t id_left = 0;
+      //! id of the right block
+      int64_t id_right = 0;
+      //! id of the group of the pair
+      int64_t id_group = 0;
+    };
+
+    //! target for the primitive m dimension
+    int64_t m_target_prim_m = 16;
+
+    //! target for the primitive n dimension
+    int64_t m_target_prim_n = 64;
+
+    //! target for the primitive k dimension
+    int64_t m_target_prim_k = 256;
+
+    //! size of the L2 cache in bytes, zero if the L2 cache size of the hardware topology is used
+    int64_t m_l2_cache_size = 0;
+
+    //! left tensor
+    block_sparse_tensor const * m_left = nullptr;
+
+    //! right tensor
+    block_sparse_tensor const * m_right = nullptr;
+
+    //! output tensor
+    block_sparse_tensor const * m_out = nullptr;
+
+    //! mapping from the dimension ids to the block sizes of the dimensions
+    std::map< int64_t, std::vector< int64_t > > const * m_block_sizes = nullptr;
+
+    //! datatype of the left input
+    data_t m_dtype_left = UNDEFINED_DTYPE;
+
+    //! datatype of the right input
+    data_t m_dtype_right = UNDEFINED_DTYPE;
+
+    //! datatype of the computations
+    data_t m_dtype_comp = UNDEFINED_DTYPE;
+
+    //! datatype of the output
+    data_t m_dtype_out = UNDEFINED_DTYPE;
+
+    //! number of threads
+    int64_t m_num_threads = 1;
+
+    //! block pairs of every output block
+    std::vector< std::vector< block_pair > > m_pairs_out;
+
+    //! output block ids ordered by decreasing work
+    std::vector< int64_t > m_order_out;
+
+    //! size of every output block in bytes
+    std::vector< int64_t > m_sizes_out;
+
+    //! number of groups
+    int64_t m_num_groups = 0;
+
+    /**
+     * Contractions of the groups, m_num_threads thread-private contractions per group.
+     * A compiled contraction keeps per-call state, e.g., thread infos, packing buffers and cached packed pointers.
+     * Thus, a contraction can't be executed concurrently by multiple threads and every thread uses its own copy.
+     **/
+    std::vector< std::unique_ptr< basic::ContractionBackendTpp > > m_backends;
+
+    /**
+     * Derives the extents of a block.
+     *
+     * @param i_tensor block-sparse tensor.
+     * @param i_id_block id of the block.
+     * @param o_sizes will be set to the sizes of the block's dimensions.
+     *
+     * @return SUCCESS if the block ids are valid, otherwise an appropiate error code.
+     **/
+    err_t block_sizes( block_sparse_tensor const & i_tensor,
+                       int64_t                     i_id_block,
+                       std::map< int64_t, int64_t > & o_sizes );
+
+    /**
+     * Compiles the contraction of a group.
+     *
+     * @param i_sizes sizes of the dimensions of the group's blocks.
+     * @param o_backend contraction which is compiled.
+     *
+     * @return SUCCESS if the compilation was successful, otherwise an appropiate error code.
+     **/
+    err_t compile_group( std::map< int64_t, int64_t > const & i_sizes,
+                         basic::ContractionBackendTpp       & o_backend );
+
+  public:
+    /**
+     * Initializes the block-sparse contraction.
+     * Dimensions which appear in all three tensors are C dimensions, in left and out M, in right and out N, in left and right K.
+     *
+     * @param i_left left tensor.
+     * @param i_right right tensor.
+     * @param i_out output tensor, has to contain all blocks to which non-zero block pairs contribute.
+     * @param i_block_sizes mapping from the dimension ids to the block sizes of the dimensions.
+     * @param i_dtype_left datatype of the left input.
+     * @param i_dtype_right datatype of the right input.
+     * @param i_dtype_comp datatype of the computations.
+     * @param i_dtype_out datatype of the output.
+     * @param i_num_threads number of threads.
+     **/
+    void init( block_sparse_tensor                          const * i_left,
+               block_sparse_tensor                          const * i_right,
+               block_sparse_tensor                          const * i_out,
+               std::map< int64_t, std::vector< int64_t > >  const * i_block_sizes,
+               data_t                                               i_dtype_left,
+               data_t                                               i_dtype_right,
+               data_t                                               i_dtype_comp,
+               data_t                                               i_dtype_out,
+               int64_t                                              i_num_threads );
+
+    /**
+     * Compiles the block-sparse contraction.
+     *
+     * @return SUCCESS if the compilation was successful, otherwise an appropiate error code.
+     **/
+    err_t compile();
+
+    /**
+     * Gets the number of groups of block pairs with the same shape.
+     *
+     * @return number of groups.
+     **/
+    int64_t num_groups();
+
+    /**
+     * Performs the contraction: out = left * right.
+     * Output blocks without contributing block pairs are zeroed.
+     *
+     * @param i_blocks_left data pointers of the left tensor's blocks.
+     * @param i_blocks_right data pointers of the right tensor's blocks.
+     * @param io_blocks_out data pointers of the output tensor's blocks.
+     **/
+    void contract( void const * const * i_blocks_left,
+                   void const * const * i_blocks_right,
+                   void       * const * io_blocks_out );
+};
+
+#endif
@@ -0,0 +1,197 @@
+#include <cmath>
+#include <vector>
+#include "catch.hpp"
+#include "BlockSparseContraction.h"
+
+TEST_CASE( "Block-sparse batched contraction with Z2 block structure.", "[block_sparse_contraction]" ) {
+  // einsum: ckm,cnk->cnm
+  // c: 0, m: 1, n: 2, k: 3
+  // non-zero blocks: ( c + k + m ) % 2 == 0 (left), ( c + n + k ) % 2 == 0 (right), ( n + m ) % 2 == 0 (out)
+  std::map< int64_t, std::vector< int64_t > > l_block_sizes;
+  l_block_sizes[0] = { 2, 3 };
+  l_block_sizes[1] = { 4, 4 };
+  l_block_sizes[2] = { 3, 3 };
+  l_block_sizes[3] = { 6, 6, 7 };
+
+  einsum_ir::block_sparse_tensor l_left;
+  einsum_ir::block_sparse_tensor l_right;
+  einsum_ir::block_sparse_tensor l_out;
+  l_left.dim_ids  = { 0, 3, 1 };
+  l_right.dim_ids = { 0, 2, 3 };
+  l_out.dim_ids   = { 0, 2, 1 };
+
+  for( int64_t l_c = 0; l_c < 2; l_c++ ) {
+    for( int64_t l_k = 0; l_k < 3; l_k++ ) {
+      for( int64_t l_m = 0; l_m < 2; l_m++ ) {
+        if( (l_c + l_k + l_m) % 2 == 0 ) {
+          l_left.block_ids.insert( l_left.block_ids.end(), { l_c, l_k, l_m } );
+        }
+      }
+      for( int64_t l_n = 0; l_n < 2; l_n++ ) {
+        if( (l_c + l_n + l_k) % 2 == 0 ) {
+          l_right.block_ids.insert( l_right.block_ids.end(), { l_c, l_n, l_k } );
+        }
+      }
+    }
+    for( int64_t l_n = 0; l_n < 2; l_n++ ) {
+      for( int64_t l_m = 0; l_m < 2; l_m++ ) {
+        if( (l_n + l_m) % 2 == 0 ) {
+          l_out.block_ids.insert( l_out.block_ids.end(), { l_c, l_n, l_m } );
+        }
+      }
+    }
+  }
+
+  // offsets of the blocks in the dense tensors
+  std::map< int64_t, std::vector< int64_t > > l_offsets;
+  std::map< int64_t, int64_t > l_sizes_dense;
+  for( std::map< int64_t, std::vector< int64_t > >::iterator l_it = l_block_sizes.begin(); l_it != l_block_sizes.end(); l_it++ ) {
+    int64_t l_offset = 0;
+    for( std::size_t l_bl = 0; l_bl < l_it->second.size(); l_bl++ ) {
+      l_offsets[l_it->first].push_back( l_offset );
+      l_offset += l_it->second[l_bl];
+    }
+    l_sizes_dense[l_it->first] = l_offset;
+  }
+  int64_t l_size_c = l_sizes_dense[0];
+  int64_t l_size_m = l_sizes_dense[1];
+  int64_t l_size_n = l_sizes_dense[2];
+  int64_t l_size_k = l_sizes_dense[3];
+
+  // fills the blocks of a tensor and scatters them to a dense tensor
+  auto l_fill = [&]( einsum_ir::block_sparse_tensor const & i_tensor,
+                     std::vector< std::vector< float > >  & o_blocks,
+                     std::vector< float >                 & o_dense,
+                     bool                                   i_random ) {
+    int64_t l_dims[3] = { i_tensor.dim_ids[0], i_tensor.dim_ids[1], i_tensor.dim_ids[2] };
+    o_dense.assign( l_sizes_dense[l_dims[0]] * l_sizes_dense[l_dims[1]] * l_sizes_dense[l_dims[2]], 0 );
+    int64_t l_num_blocks = i_tensor.block_ids.size() / 3;
+    o_blocks.resize( l_num_blocks );
+    for( int64_t l_bl = 0; l_bl < l_num_blocks; l_bl++ ) {
+      int64_t const * l_ids = i_tensor.block_ids.data() + 3*l_bl;
+      int64_t l_s0 = l_block_sizes[l_dims[0]][l_ids[0]];
+      int64_t l_s1 = l_block_sizes[l_dims[1]][l_ids[1]];
+      int64_t l_s2 = l_block_sizes[l_dims[2]][l_ids[2]];
+      o_blocks[l_bl].resize( l_s0 * l_s1 * l_s2 );
+      for( int64_t l_i0 = 0; l_i0 < l_s0; l_i0++ ) {
+        for( int64_t l_i1 = 0; l_i1 < l_s1; l_i1++ ) {
+          for( int64_t l_i2 = 0; l_i2 < l_s2; l_i2++ ) {
+            float l_val = i_random ? (float) ( ( 7 * l_bl + 3 * l_i0 + 5 * l_i1 + l_i2 ) % 11 ) - 5.0f : 1.0f;
+            o_blocks[l_bl][ (l_i0 * l_s1 + l_i1) * l_s2 + l_i2 ] = l_val;
+            int64_t l_d0 = l_offsets[l_dims[0]][l_ids[0]] + l_i0;
+            int64_t l_d1 = l_offsets[l_dims[1]][l_ids[1]] + l_i1;
+            int64_t l_d2 = l_offsets[l_dims[2]][l_ids[2]] + l_i2;
+            o_dense[ (l_d0 * l_sizes_dense[l_dims[1]] + l_d1) * l_sizes_dense[l_dims[2]] + l_d2 ] = l_val;
+          }
+        }
+      }
+    }
+  };
+
+  std::vector< std::vector< float > > l_blocks_left, l_blocks_right, l_blocks_out;
+  std::vector< float > l_dense_left, l_dense_right, l_dense_out;
+  l_fill( l_left,  l_blocks_left,  l_dense_left,  true  );
+  l_fill( l_right, l_blocks_right, l_dense_right, true  );
+  l_fill( l_out,   l_blocks_out,   l_dense_out,   false );
+
+  // dense reference
+  std::vector< float > l_dense_ref( l_size_c * l_size_n * l_size_m, 0 );
+  for( int64_t l_c = 0; l_c < l_size_c; l_c++ ) {
+    for( int64_t l_n = 0; l_n < l_size_n; l_n++ ) {
+      for( int64_t l_m = 0; l_m < l_size_m; l_m++ ) {
+        for( int64_t l_k = 0; l_k < l_size_k; l_k++ ) {
+          l_dense_ref[ (l_c * l_size_n + l_n) * l_size_m + l_m ] +=   l_dense_left[  (l_c * l_size_k + l_k) * l_size_m + l_m ]
+                                                                    * l_dense_right[ (l_c * l_size_n + l_n) * l_size_k + l_k ];
+        }
+      }
+    }
+  }
+
+  einsum_ir::backend::BlockSparseContraction l_cont;
+  l_cont.init( &l_left,
+               &l_right,
+               &l_out,
+               &l_block_sizes,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               2 );
+
+  einsum_ir::err_t l_err = l_cont.compile();
+  REQUIRE( l_err == einsum_ir::SUCCESS );
+
+  // six pairs: the shapes only depend on the sizes of the c and k blocks
+  REQUIRE( l_cont.num_groups() == 4 );
+
+  // recompilation replaces the contractions of the groups
+  l_err = l_cont.compile();
+  REQUIRE( l_err == einsum_ir::SUCCESS );
+  REQUIRE( l_cont.num_groups() == 4 );
+
+  std::vector< void const * > l_ptrs_left, l_ptrs_right;
+  std::vector< void * > l_ptrs_out;
+  for( std::size_t l_bl = 0; l_bl < l_blocks_left.size();  l_bl++ ) l_ptrs_left.push_back(  l_blocks_left[l_bl].data()  );
+  for( std::size_t l_bl = 0; l_bl < l_blocks_right.size(); l_bl++ ) l_ptrs_right.push_back( l_blocks_right[l_bl].data() );
+  for( std::size_t l_bl = 0; l_bl < l_blocks_out.size();   l_bl++ ) l_ptrs_out.push_back(   l_blocks_out[l_bl].data()   );
+
+  l_cont.contract( l_ptrs_left.data(),
+                   l_ptrs_right.data(),
+                   l_ptrs_out.data() );
+
+  // scatter the result and compare to the dense reference
+  std::vector< float > l_dense_result( l_dense_ref.size(), 0 );
+  for( std::size_t l_bl = 0; l_bl < l_blocks_out.size(); l_bl++ ) {
+    int64_t const * l_ids = l_out.block_ids.data() + 3*l_bl;
+    int64_t l_s_c = l_block_sizes[0][l_ids[0]];
+    int64_t l_s_n = l_block_sizes[2][l_ids[1]];
+    int64_t l_s_m = l_block_sizes[1][l_ids[2]];
+    for( int64_t l_c = 0; l_c < l_s_c; l_c++ ) {
+      for( int64_t l_n = 0; l_n < l_s_n; l_n++ ) {
+        for( int64_t l_m = 0; l_m < l_s_m; l_m++ ) {
+          int64_t l_d_c = l_offsets[0][l_ids[0]] + l_c;
+          int64_t l_d_n = l_offsets[2][l_ids[1]] + l_n;
+          int64_t l_d_m = l_offsets[1][l_ids[2]] + l_m;
+          l_dense_result[ (l_d_c * l_size_n + l_d_n) * l_size_m + l_d_m ] = l_blocks_out[l_bl][ (l_c * l_s_n + l_n) * l_s_m + l_m ];
+        }
+      }
+    }
+  }
+
+  for( std::size_t l_en = 0; l_en < l_dense_ref.size(); l_en++ ) {
+    REQUIRE( std::abs( l_dense_result[l_en] - l_dense_ref[l_en] ) < 1E-3 );
+  }
+}
+
+TEST_CASE( "Block-sparse contraction with a missing output block.", "[block_sparse_contraction]" ) {
+  // einsum: km,nk->nm
+  // m: 0, n: 1, k: 2
+  std::map< int64_t, std::vector< int64_t > > l_block_sizes;
+  l_block_sizes[0] = { 8, 8 };
+  l_block_sizes[1] = { 4, 4 };
+  l_block_sizes[2] = { 16 };
+
+  einsum_ir::block_sparse_tensor l_left;
+  einsum_ir::block_sparse_tensor l_right;
+  einsum_ir::block_sparse_tensor l_out;
+  l_left.dim_ids    = { 2, 0 };
+  l_left.block_ids  = { 0, 0,
+                        0, 1 };
+  l_right.dim_ids   = { 1, 2 };
+  l_right.block_ids = { 1, 0 };
+  l_out.dim_ids     = { 1, 0 };
+  l_out.block_ids   = { 1, 0 };
+
+  einsum_ir::backend::BlockSparseContraction l_cont;
+  l_cont.init( &l_left,
+               &l_right,
+               &l_out,
+               &l_block_sizes,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               einsum_ir::FP32,
+               1 );
+
+  REQUIRE( l_cont.compile() == einsum_ir::INVALID_ID );
+}
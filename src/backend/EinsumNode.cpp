@@ -30,6 +30,7 @@ void einsum_ir::backend::EinsumNode::init( int64_t
   m_ktype_first_touch   = kernel_t::UNDEFINED_KTYPE;
   m_ktype_main          = kernel_t::UNDEFINED_KTYPE;
   m_ktype_last_touch    = kernel_t::UNDEFINED_KTYPE;
+  m_last_touch_ops.clear();
 
   m_size                = 0;
 
@@ -55,6 +56,7 @@ void einsum_ir::backend::EinsumNode::init( int64_t
   m_data_ptr_int        = nullptr;
   m_data_ptr_active     = nullptr;
   m_data_ptr_ext        = i_data_ptr;
+  m_sparse              = nullptr;
 
   m_btype_unary         = backend_t::AUTO;
   m_btype_binary        = backend_t::AUTO;
@@ -182,6 +184,7 @@ void einsum_ir::backend::EinsumNode::init( int64_t
   m_ktype_first_touch   = i_ktype_first_touch;
   m_ktype_main          = i_ktype_main;
   m_ktype_last_touch    = i_ktype_last_touch;
+  m_last_touch_ops.clear();
 
   m_children.resize( 2 );
   m_children[0] = i_left;
@@ -189,6 +192,20 @@ void einsum_ir::backend::EinsumNode::init( int64_t
 
   m_num_threads = i_num_threads;
 }
+void einsum_ir::backend::EinsumNode::set_last_touch_ops( std::vector< last_touch_op > const & i_ops ) {
+  m_last_touch_ops = i_ops;
+  m_ktype_last_touch = i_ops.size() > 0 ? i_ops[0].ktype : kernel_t::UNDEFINED_KTYPE;
+}
+
+void einsum_ir::backend::EinsumNode::set_accumulate( bool i_accumulate ) {
+  m_accumulate = i_accumulate;
+}
+
+void einsum_ir::backend::EinsumNode::set_sparse( sparse_tensor const * i_sparse ) {
+  m_sparse       = i_sparse;
+  m_data_ptr_ext = const_cast< void * >( i_sparse->values );
+}
+
 einsum_ir::err_t einsum_ir::backend::EinsumNode::compile(){
   err_t l_err = err_t::UNDEFINED_ERROR;
   l_err = compile_recursive();
@@ -206,14 +223,14 @@ einsum_ir::err_t einsum_ir::backend::EinsumNode::compile_recursive() {
 
   // derive backend for binary contractions
   if( m_btype_binary == backend_t::AUTO ) {
-    if(    ce_cpx_op(m_ktype_first_touch)
-        || ce_cpx_op(m_ktype_main)
-        || ce_cpx_op(m_ktype_last_touch) ) {
-      m_btype_binary = backend_t::BLAS;
-    }
-    else if( BinaryContractionFactory::supports( backend_t::TPP ) ) {
+    if( BinaryContractionFactory::supports( backend_t::TPP ) ) {
       m_btype_binary = backend_t::TPP;
     }
+    else if(    ce_cpx_op(m_ktype_first_touch)
+             || ce_cpx_op(m_ktype_main)
+             || ce_cpx_op(m_ktype_last_touch) ) {
+      m_btype_binary = backend_t::BLAS;
+    }
     else if( BinaryContractionFactory::supports( backend_t::TBLIS ) ) {
       m_btype_binary = backend_t::TBLIS;
     }
@@ -236,22 +253,35 @@ einsum_ir::err_t einsum_ir::backend::EinsumNode::compile_recursive() {
 
   // compile contraction
   if( m_children.size() == 2 ) {
+    // sparse tensors are always the left input of a sparse-dense contraction
+    bool l_sparse = m_children[0]->m_sparse != nullptr || m_children[1]->m_sparse != nullptr;
+    if( m_children[0]->m_sparse != nullptr && m_children[1]->m_sparse != nullptr ) {
+      return err_t::COMPILATION_FAILED;
+    }
+
     // swap left and right if required by the primitives
-    bool l_swap_inputs = BinaryPrimitives::swap_inputs( m_children[0]->m_num_dims,
-                                                        m_children[1]->m_num_dims,
-                                                        m_num_dims,
-                                                        m_children[0]->m_dim_ids_ext,
-                                                        m_children[1]->m_dim_ids_ext,
-                                                        m_dim_ids_int.data() );
+    bool l_swap_inputs = false;
+    if( l_sparse ) {
+      l_swap_inputs = m_children[1]->m_sparse != nullptr;
+    }
+    else {
+      l_swap_inputs = BinaryPrimitives::swap_inputs( m_children[0]->m_num_dims,
+                                                     m_children[1]->m_num_dims,
+                                                     m_num_dims,
+                                                     m_children[0]->m_dim_ids_ext,
+                                                     m_children[1]->m_dim_ids_ext,
+                                                     m_dim_ids_int.data() );
+    }
     if( l_swap_inputs ) {
       std::swap( m_children[0],
                  m_children[1] );
     }
 
     // reorder dimensions of input tensors for the primitives
+    // the sparse-dense kernel supports arbitrary dimension orders
     std::vector<int64_t> l_packing_left;
     std::vector<int64_t> l_packing_right;
-    if( m_reorder_dims ) {
+    if( m_reorder_dims && !l_sparse ) {
       BinaryPrimitives l_bin_prims;
       l_bin_prims.init( m_dtype,
                         m_btype_binary );
@@ -285,7 +315,34 @@ einsum_ir::err_t einsum_ir::backend::EinsumNode::compile_recursive() {
       }
     }
 
-    m_cont = BinaryContractionFactory::create( m_btype_binary );
+    // low precision tensors are accumulated in fp32, integer tensors in int32
+    data_t l_dtype_comp = m_dtype;
+    if(    m_dtype == data_t::BF16
+        || m_dtype == data_t::FP16 ) {
+      l_dtype_comp = data_t::FP32;
+    }
+    else if(    m_dtype == data_t::INT8
+             || m_dtype == data_t::INT32 ) {
+      l_dtype_comp = data_t::INT32;
+    }
+
+    if( l_sparse ) {
+      m_cont = BinaryContractionFactory::create_sparse( m_btype_binary,
+                                                        m_children[0]->m_sparse );
+    }
+    else {
+      m_cont = BinaryContractionFactory::create( m_btype_binary );
+    }
+    if( m_cont == nullptr ) {
+      return err_t::INVALID_BACKEND;
+    }
+
+    // accumulating contractions add to the external data in place
+    if(    m_accumulate
+        && ( m_data_ptr_ext == nullptr || requires_permutation() ) ) {
+      return err_t::COMPILATION_FAILED;
+    }
+
     m_cont->init( m_children[0]->m_num_dims,
                   m_children[1]->m_num_dims,
                   m_num_dims,
@@ -303,12 +360,18 @@ einsum_ir::err_t einsum_ir::backend::EinsumNode::compile_recursive() {
                   m_memory,
                   m_children[0]->m_dtype,
                   m_children[1]->m_dtype,
-                  m_dtype,
+                  l_dtype_comp,
                   m_dtype,
                   m_ktype_first_touch,
                   m_ktype_main,
                   m_ktype_last_touch,
                   m_num_threads );
+    if( m_last_touch_ops.size() > 0 ) {
+      m_cont->set_last_touch_ops( m_last_touch_ops );
+    }
+    if( m_accumulate ) {
+      m_cont->set_accumulate( true );
+    }
 
     l_err = m_cont->compile();
     if( l_err != einsum_ir::SUCCESS ) {
@@ -462,6 +525,9 @@ einsum_ir::err_t einsum_ir::backend::EinsumNode::store_and_lock_data() {
   else if( m_data_ptr_ext == nullptr ) {
     return err_t::NO_DATA_PTR_PROVIDED;
   }
+  else if( m_sparse != nullptr ) {
+    return err_t::INVALID_ID;
+  }
 
   // allocate memory for intermediate data if required
   if( m_data_ptr_int == nullptr ) {
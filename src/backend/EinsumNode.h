@@ -24,6 +24,8 @@ class einsum_ir::backend::EinsumNode {
     kernel_t m_ktype_main = kernel_t::UNDEFINED_KTYPE;
     //! type of the last-touch kernel
     kernel_t m_ktype_last_touch = kernel_t::UNDEFINED_KTYPE;
+    //! chain of last-touch operations, empty if only the last-touch kernel is used
+    std::vector< last_touch_op > m_last_touch_ops;
 
     //! size of the node's tensor in bytes
     int64_t m_size = 0;
@@ -59,6 +61,9 @@ class einsum_ir::backend::EinsumNode {
     //! external auxiliary data
     void * m_data_ptr_aux_ext = nullptr;
 
+    //! sparse data of an input node, nullptr if the tensor is dense
+    sparse_tensor const * m_sparse = nullptr;
+
     //! external local auxiliary tensor offset in bytes
     std::map< int64_t, int64_t > const * m_offsets_aux_ext = nullptr;
     //! external local tensor offset in bytes
@@ -72,6 +77,9 @@ class einsum_ir::backend::EinsumNode {
     //! true if dimension reordering is enabled
     bool m_reorder_dims = false;
 
+    //! true if the contraction adds to the node's external data
+    bool m_accumulate = false;
+
     //! true if packing is enabled
     bool m_pack_inputs = false;
 
@@ -207,6 +215,33 @@ class einsum_ir::backend::EinsumNode {
                MemoryManager                      * i_memory,
                int64_t                              i_num_threads );
 
+    /**
+     * Sets a chain of last-touch operations which replaces the last-touch kernel of the node's contraction.
+     * Has to be called after init and before compile.
+     *
+     * @param i_ops last-touch operations.
+     **/
+    void set_last_touch_ops( std::vector< last_touch_op > const & i_ops );
+
+    /**
+     * Sets the accumulate mode in which the node's contraction adds to the node's external data.
+     * The first-touch kernel is dropped, no additional pass over the data is required.
+     * The node has to be a contraction with external data which does not require a permutation.
+     * Has to be called after init and before compile.
+     *
+     * @param i_accumulate true if the contraction accumulates into the external data.
+     **/
+    void set_accumulate( bool i_accumulate );
+
+    /**
+     * Sets the sparse data of an input node.
+     * The contraction consuming the node uses a sparse-dense kernel instead of the node's dense data.
+     * Has to be called after init and before compile.
+     *
+     * @param i_sparse sparse tensor.
+     **/
+    void set_sparse( sparse_tensor const * i_sparse );
+
     /**
      * Compiles the contraction of the node and recursively those of all children.
      * 
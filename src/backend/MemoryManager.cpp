@@ -1,8 +1,12 @@
 #include "MemoryManager.h"
+#include "../basic/parallel/ExecutionContext.h"
+#include "../basic/parallel/NumaTopology.h"
 
 einsum_ir::backend::MemoryManager::~MemoryManager() {
   if(  m_memory_ptr != nullptr ) {
-    delete [] (char *)  m_memory_ptr;
+    einsum_ir::basic::NumaTopology::free_pages( m_memory_ptr,
+                                                m_alloc_mem,
+                                                m_page_type );
   }
 }
 
@@ -81,12 +85,25 @@ void einsum_ir::backend::MemoryManager::remove_reservation( int64_t i_id ){
 void einsum_ir::backend::MemoryManager::alloc_all_memory(){
   if( m_req_mem ){
     //allocate memory 
-    m_memory_ptr = new char[m_req_mem + m_alignment_page];
+    m_alloc_mem = m_req_mem + m_alignment_page;
+    m_page_type = einsum_ir::basic::NumaTopology::get_page_type();
+    m_memory_ptr = einsum_ir::basic::NumaTopology::alloc_pages( m_alloc_mem,
+                                                                m_page_type );
 
     //allign data in memory 
     int64_t l_align_offset = (unsigned long)m_memory_ptr % m_alignment_page;
     l_align_offset = l_align_offset ? m_alignment_page - l_align_offset : 0;
     m_aligned_memory_ptr = m_memory_ptr + l_align_offset;
+
+    //first touch policy
+    einsum_ir::basic::ExecutionContext * l_ctx = einsum_ir::basic::ExecutionContext::get_default();
+    int64_t l_size_page = einsum_ir::basic::NumaTopology::get_size_page( m_page_type );
+    int64_t l_num_pages = (m_alloc_mem + l_size_page - 1) / l_size_page;
+    l_ctx->parallel_for( l_ctx->get_max_threads(),
+                         l_num_pages,
+                         [&]( int64_t l_page ){
+                           m_memory_ptr[ l_page * l_size_page ] = 0;
+                         } );
   }
 
   m_contraction_memory_manager.alloc_all_memory();
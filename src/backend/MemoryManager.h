@@ -25,6 +25,10 @@ class einsum_ir::backend::MemoryManager{
     char * m_aligned_memory_ptr = nullptr;
     //! the required memory for all data
     int64_t m_req_mem = 0;
+    //! size of the allocated memory
+    int64_t m_alloc_mem = 0;
+    //! type of the pages backing the memory
+    einsum_ir::basic::page_t m_page_type = einsum_ir::basic::page_t::SMALL_PAGES;
 
     //! last id given to any tensor
     int64_t m_last_id = 0;
@@ -68,6 +72,8 @@ class einsum_ir::backend::MemoryManager{
 
     /**
      * Allocates the required memory.
+     * The pages are first-touched in contiguous chunks by all threads of the default execution context to spread them over the NUMA nodes.
+     * The pages are of the type set in basic::NumaTopology::set_page_type.
      **/
     void alloc_all_memory();
 
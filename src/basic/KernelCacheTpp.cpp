@@ -0,0 +1,162 @@
+#include "KernelCacheTpp.h"
+
+einsum_ir::basic::KernelCacheTpp * einsum_ir::basic::KernelCacheTpp::get_default() {
+  static KernelCacheTpp l_cache;
+  return &l_cache;
+}
+
+template< typename T_generate >
+einsum_ir::basic::KernelCacheTpp::kernel einsum_ir::basic::KernelCacheTpp::lookup( std::vector< int64_t > const & i_key,
+                                                                                   T_generate                     i_generate ) {
+  std::lock_guard< std::mutex > l_lock( m_mutex );
+
+  std::map< std::vector< int64_t >, kernel >::iterator l_it = m_kernels.find( i_key );
+  if( l_it != m_kernels.end() ) {
+    m_num_hits++;
+    return l_it->second;
+  }
+
+  m_num_misses++;
+  kernel l_kernel = i_generate();
+  if(    l_kernel.unary  != nullptr
+      || l_kernel.binary != nullptr
+      || l_kernel.gemm   != nullptr ) {
+    m_kernels.insert( std::pair< std::vector< int64_t >, kernel >( i_key, l_kernel ) );
+  }
+
+  return l_kernel;
+}
+
+libxsmm_meltwfunction_unary einsum_ir::basic::KernelCacheTpp::dispatch_unary( libxsmm_meltw_unary_type  i_type,
+                                                                              libxsmm_meltw_unary_shape i_shape,
+                                                                              libxsmm_bitfield          i_flags ) {
+  std::vector< int64_t > l_key = { kind_t::UNARY,
+                                   i_type,
+                                   i_shape.m,
+                                   i_shape.n,
+                                   i_shape.ldi,
+                                   i_shape.ldo,
+                                   i_shape.in0_type,
+                                   i_shape.out_type,
+                                   i_shape.comp_type,
+                                   i_flags };
+
+  return lookup( l_key,
+                 [&]() {
+                   kernel l_kernel;
+                   l_kernel.unary = libxsmm_dispatch_meltw_unary( i_type,
+                                                                  i_shape,
+                                                                  i_flags );
+                   return l_kernel;
+                 } ).unary;
+}
+
+libxsmm_meltwfunction_binary einsum_ir::basic::KernelCacheTpp::dispatch_binary( libxsmm_meltw_binary_type  i_type,
+                                                                                libxsmm_meltw_binary_shape i_shape,
+                                                                                libxsmm_bitfield           i_flags ) {
+  std::vector< int64_t > l_key = { kind_t::BINARY,
+                                   i_type,
+                                   i_shape.m,
+                                   i_shape.n,
+                                   i_shape.ldi,
+                                   i_shape.ldi2,
+                                   i_shape.ldo,
+                                   i_shape.in0_type,
+                                   i_shape.in1_type,
+                                   i_shape.out_type,
+                                   i_shape.comp_type,
+                                   i_flags };
+
+  return lookup( l_key,
+                 [&]() {
+                   kernel l_kernel;
+                   l_kernel.binary = libxsmm_dispatch_meltw_binary( i_type,
+                                                                    i_shape,
+                                                                    i_flags );
+                   return l_kernel;
+                 } ).binary;
+}
+
+libxsmm_gemmfunction einsum_ir::basic::KernelCacheTpp::dispatch_brgemm( libxsmm_gemm_shape               i_shape,
+                                                                        libxsmm_bitfield                 i_flags,
+                                                                        libxsmm_bitfield                 i_prefetch_flags,
+                                                                        libxsmm_gemm_batch_reduce_config i_brconfig ) {
+  std::vector< int64_t > l_key = { kind_t::BRGEMM,
+                                   i_shape.m,
+                                   i_shape.n,
+                                   i_shape.k,
+                                   i_shape.lda,
+                                   i_shape.ldb,
+                                   i_shape.ldc,
+                                   i_shape.a_in_type,
+                                   i_shape.b_in_type,
+                                   i_shape.out_type,
+                                   i_shape.comp_type,
+                                   i_flags,
+                                   i_prefetch_flags,
+                                   i_brconfig.br_type,
+                                   i_brconfig.br_stride_a_hint,
+                                   i_brconfig.br_stride_b_hint,
+                                   i_brconfig.br_unroll_hint };
+
+  return lookup( l_key,
+                 [&]() {
+                   kernel l_kernel;
+                   l_kernel.gemm = libxsmm_dispatch_brgemm( i_shape,
+                                                            i_flags,
+                                                            i_prefetch_flags,
+                                                            i_brconfig );
+                   return l_kernel;
+                 } ).gemm;
+}
+
+libxsmm_gemmfunction einsum_ir::basic::KernelCacheTpp::create_packed_gemm( libxsmm_gemm_shape i_shape,
+                                                                           libxsmm_bitfield   i_flags,
+                                                                           libxsmm_bitfield   i_prefetch_flags,
+                                                                           libxsmm_blasint    i_packed_width ) {
+  std::vector< int64_t > l_key = { kind_t::PACKED_GEMM,
+                                   i_shape.m,
+                                   i_shape.n,
+                                   i_shape.k,
+                                   i_shape.lda,
+                                   i_shape.ldb,
+                                   i_shape.ldc,
+                                   i_shape.a_in_type,
+                                   i_shape.b_in_type,
+                                   i_shape.out_type,
+                                   i_shape.comp_type,
+                                   i_flags,
+                                   i_prefetch_flags,
+                                   i_packed_width };
+
+  return lookup( l_key,
+                 [&]() {
+                   kernel l_kernel;
+                   l_kernel.gemm = libxsmm_create_packed_gemm( i_shape,
+                                                               i_flags,
+                                                               i_prefetch_flags,
+                                                               i_packed_width );
+                   return l_kernel;
+                 } ).gemm;
+}
+
+int64_t einsum_ir::basic::KernelCacheTpp::num_hits() {
+  std::lock_guard< std::mutex > l_lock( m_mutex );
+  return m_num_hits;
+}
+
+int64_t einsum_ir::basic::KernelCacheTpp::num_misses() {
+  std::lock_guard< std::mutex > l_lock( m_mutex );
+  return m_num_misses;
+}
+
+int64_t einsum_ir::basic::KernelCacheTpp::size() {
+  std::lock_guard< std::mutex > l_lock( m_mutex );
+  return m_kernels.size();
+}
+
+void einsum_ir::basic::KernelCacheTpp::reset_stats() {
+  std::lock_guard< std::mutex > l_lock( m_mutex );
+  m_num_hits = 0;
+  m_num_misses = 0;
+}
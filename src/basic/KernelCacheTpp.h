@@ -0,0 +1,158 @@
+#ifndef EINSUM_IR_BASIC_KERNEL_CACHE_TPP
+#define EINSUM_IR_BASIC_KERNEL_CACHE_TPP
+
+#include <libxsmm.h>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "constants.h"
+
+namespace einsum_ir {
+  namespace basic {
+    class KernelCacheTpp;
+  }
+}
+
+/**
+ * Process-wide cache of LIBXSMM kernels.
+ * The kernels are keyed by their complete descriptor, i.e., kernel type, shape, leading dimensions, datatypes and flags.
+ * All backends share the cache, thus repeating kernel shapes are generated only once.
+ **/
+class einsum_ir::basic::KernelCacheTpp {
+  private:
+    //! cached kernel, only the member of the descriptor's kind is set
+    struct kernel {
+      //! unary kernel
+      libxsmm_meltwfunction_unary unary = nullptr;
+      //! binary kernel
+      libxsmm_meltwfunction_binary binary = nullptr;
+      //! gemm kernel
+      libxsmm_gemmfunction gemm = nullptr;
+    };
+
+    //! kinds of cached kernels, first entry of every key
+    enum kind_t {
+      UNARY       = 0,
+      BINARY      = 1,
+      BRGEMM      = 2,
+      PACKED_GEMM = 3
+    };
+
+    //! mutex which guards the cache
+    std::mutex m_mutex;
+
+    //! cached kernels
+    std::map< std::vector< int64_t >, kernel > m_kernels;
+
+    //! number of lookups which returned a cached kernel
+    int64_t m_num_hits = 0;
+
+    //! number of lookups which generated a kernel
+    int64_t m_num_misses = 0;
+
+    /**
+     * Looks up a kernel and generates it on a miss.
+     * Failed generations are not cached.
+     *
+     * @param i_key descriptor of the kernel.
+     * @param i_generate function which generates the kernel.
+     *
+     * @return cached or generated kernel.
+     **/
+    template< typename T_generate >
+    kernel lookup( std::vector< int64_t > const & i_key,
+                   T_generate                     i_generate );
+
+  public:
+    /**
+     * Gets the process-wide cache.
+     *
+     * @return cache.
+     **/
+    static KernelCacheTpp * get_default();
+
+    /**
+     * Gets a unary kernel, see libxsmm_dispatch_meltw_unary.
+     *
+     * @param i_type type of the unary operation.
+     * @param i_shape shape of the operation.
+     * @param i_flags flags of the operation.
+     *
+     * @return kernel, nullptr if the generation failed.
+     **/
+    libxsmm_meltwfunction_unary dispatch_unary( libxsmm_meltw_unary_type  i_type,
+                                                libxsmm_meltw_unary_shape i_shape,
+                                                libxsmm_bitfield          i_flags );
+
+    /**
+     * Gets a binary kernel, see libxsmm_dispatch_meltw_binary.
+     *
+     * @param i_type type of the binary operation.
+     * @param i_shape shape of the operation.
+     * @param i_flags flags of the operation.
+     *
+     * @return kernel, nullptr if the generation failed.
+     **/
+    libxsmm_meltwfunction_binary dispatch_binary( libxsmm_meltw_binary_type  i_type,
+                                                  libxsmm_meltw_binary_shape i_shape,
+                                                  libxsmm_bitfield           i_flags );
+
+    /**
+     * Gets a batch-reduce gemm kernel, see libxsmm_dispatch_brgemm.
+     *
+     * @param i_shape shape of the gemm.
+     * @param i_flags gemm flags.
+     * @param i_prefetch_flags prefetch flags.
+     * @param i_brconfig batch-reduce configuration.
+     *
+     * @return kernel, nullptr if the generation failed.
+     **/
+    libxsmm_gemmfunction dispatch_brgemm( libxsmm_gemm_shape               i_shape,
+                                          libxsmm_bitfield                 i_flags,
+                                          libxsmm_bitfield                 i_prefetch_flags,
+                                          libxsmm_gemm_batch_reduce_config i_brconfig );
+
+    /**
+     * Gets a packed gemm kernel, see libxsmm_create_packed_gemm.
+     *
+     * @param i_shape shape of the gemm.
+     * @param i_flags gemm flags.
+     * @param i_prefetch_flags prefetch flags.
+     * @param i_packed_width packed width.
+     *
+     * @return kernel, nullptr if the generation failed.
+     **/
+    libxsmm_gemmfunction create_packed_gemm( libxsmm_gemm_shape i_shape,
+                                             libxsmm_bitfield   i_flags,
+                                             libxsmm_bitfield   i_prefetch_flags,
+                                             libxsmm_blasint    i_packed_width );
+
+    /**
+     * Gets the number of lookups which returned a cached kernel.
+     *
+     * @return number of hits.
+     **/
+    int64_t num_hits();
+
+    /**
+     * Gets the number of lookups which generated a kernel.
+     *
+     * @return number of misses.
+     **/
+    int64_t num_misses();
+
+    /**
+     * Gets the number of cached kernels.
+     *
+     * @return number of kernels.
+     **/
+    int64_t size();
+
+    /**
+     * Resets the hit and miss counters.
+     * The cached kernels are kept.
+     **/
+    void reset_stats();
+};
+
+#endif
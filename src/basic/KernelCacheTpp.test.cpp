@@ -0,0 +1,164 @@
+#include <vector>
+#include "catch.hpp"
+#include "KernelCacheTpp.h"
+#include "binary/ContractionBackendTpp.h"
+
+TEST_CASE( "Lookups of unary and binary kernels in the kernel cache.", "[kernel_cache_tpp]" ) {
+  using namespace einsum_ir::basic;
+
+  KernelCacheTpp * l_cache = KernelCacheTpp::get_default();
+
+  libxsmm_meltw_unary_shape l_shape = libxsmm_create_meltw_unary_shape( 7,
+                                                                        5,
+                                                                        11,
+                                                                        11,
+                                                                        LIBXSMM_DATATYPE_F32,
+                                                                        LIBXSMM_DATATYPE_F32,
+                                                                        LIBXSMM_DATATYPE_F32 );
+  libxsmm_meltw_binary_shape l_shape_binary = libxsmm_create_meltw_binary_shape( 7,
+                                                                                 5,
+                                                                                 11,
+                                                                                 11,
+                                                                                 11,
+                                                                                 LIBXSMM_DATATYPE_F32,
+                                                                                 LIBXSMM_DATATYPE_F32,
+                                                                                 LIBXSMM_DATATYPE_F32,
+                                                                                 LIBXSMM_DATATYPE_F32 );
+
+  // warm up
+  l_cache->dispatch_unary( LIBXSMM_MELTW_TYPE_UNARY_IDENTITY,
+                           l_shape,
+                           LIBXSMM_MELTW_FLAG_UNARY_NONE );
+  l_cache->reset_stats();
+  int64_t l_size = l_cache->size();
+
+  // same descriptor
+  libxsmm_meltwfunction_unary l_copy = l_cache->dispatch_unary( LIBXSMM_MELTW_TYPE_UNARY_IDENTITY,
+                                                                l_shape,
+                                                                LIBXSMM_MELTW_FLAG_UNARY_NONE );
+  REQUIRE( l_copy != nullptr );
+  REQUIRE( l_cache->num_hits() == 1 );
+  REQUIRE( l_cache->num_misses() == 0 );
+  REQUIRE( l_cache->size() == l_size );
+
+  // different flags and kinds are different descriptors
+  l_cache->dispatch_unary( LIBXSMM_MELTW_TYPE_UNARY_IDENTITY,
+                           l_shape,
+                           LIBXSMM_MELTW_FLAG_UNARY_BCAST_SCALAR );
+  l_cache->dispatch_binary( LIBXSMM_MELTW_TYPE_BINARY_ADD,
+                            l_shape_binary,
+                            LIBXSMM_MELTW_FLAG_BINARY_NONE );
+  REQUIRE( l_cache->num_hits() == 1 );
+  REQUIRE( l_cache->num_misses() == 2 );
+  REQUIRE( l_cache->size() == l_size + 2 );
+
+  // cached kernel
+  std::vector< float > l_in( 11 * 5 );
+  std::vector< float > l_out( 11 * 5, 0 );
+  for( std::size_t l_en = 0; l_en < l_in.size(); l_en++ ) {
+    l_in[l_en] = (float) l_en;
+  }
+  libxsmm_meltw_unary_param l_param;
+  l_param.in.primary  = l_in.data();
+  l_param.out.primary = l_out.data();
+  l_copy( &l_param );
+
+  for( int64_t l_n = 0; l_n < 5; l_n++ ) {
+    for( int64_t l_m = 0; l_m < 11; l_m++ ) {
+      REQUIRE( l_out[ l_n * 11 + l_m ] == ( l_m < 7 ? l_in[ l_n * 11 + l_m ] : 0 ) );
+    }
+  }
+}
+
+TEST_CASE( "Repeated contraction shapes share the cached kernels.", "[kernel_cache_tpp]" ) {
+  //example: [c1,k1,m1],[c1,n1,k1]->[c1,n1,m1]
+  //sizes:   [ 3,13,20],[ 3,47,13]->[ 3,47,20]
+  using namespace einsum_ir::basic;
+
+  std::vector< dim_t >  l_loop_dim_type  = { dim_t::C,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::K };
+  std::vector< exec_t > l_loop_exec_type = { exec_t::SEQ,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM };
+
+  //                                                  c1,m1,n1,k1
+  std::vector< int64_t > l_loop_sizes            = {   3,20,47,13 };
+  std::vector< int64_t > l_loop_strides_left     = { 260, 1, 0,20 };
+  std::vector< int64_t > l_loop_strides_right    = { 611, 0,13, 1 };
+  std::vector< int64_t > l_loop_strides_out_aux  = {   0, 0, 0, 0 };
+  std::vector< int64_t > l_loop_strides_out      = { 940, 1,20, 0 };
+  std::vector< int64_t > l_packing_strides_left  = {};
+  std::vector< int64_t > l_packing_strides_right = {};
+
+  KernelCacheTpp * l_cache = KernelCacheTpp::get_default();
+
+  ContractionBackendTpp l_conts[2];
+  for( int64_t l_co = 0; l_co < 2; l_co++ ) {
+    l_cache->reset_stats();
+
+    l_conts[l_co].init( l_loop_dim_type,
+                        l_loop_exec_type,
+                        l_loop_sizes,
+                        l_loop_strides_left,
+                        l_loop_strides_right,
+                        l_loop_strides_out_aux,
+                        l_loop_strides_out,
+                        l_packing_strides_left,
+                        l_packing_strides_right,
+                        data_t::FP32,
+                        data_t::FP32,
+                        data_t::FP32,
+                        data_t::FP32,
+                        kernel_t::ZERO,
+                        kernel_t::MADD,
+                        kernel_t::RELU,
+                        1,
+                        1,
+                        1,
+                        nullptr );
+    REQUIRE( l_conts[l_co].compile() == err_t::SUCCESS );
+  }
+
+  // first touch, main and last touch kernels of the second contraction are cached
+  REQUIRE( l_cache->num_hits() == 3 );
+  REQUIRE( l_cache->num_misses() == 0 );
+
+  std::vector< float > l_left( 3 * 13 * 20 );
+  std::vector< float > l_right( 3 * 47 * 13 );
+  for( std::size_t l_en = 0; l_en < l_left.size(); l_en++ ) {
+    l_left[l_en] = (float) ( l_en % 5 ) - 2.0f;
+  }
+  for( std::size_t l_en = 0; l_en < l_right.size(); l_en++ ) {
+    l_right[l_en] = (float) ( l_en % 3 ) - 1.0f;
+  }
+
+  std::vector< float > l_out_0( 3 * 47 * 20, 1.0f );
+  std::vector< float > l_out_1( 3 * 47 * 20, 2.0f );
+  l_conts[0].contract( l_left.data(),
+                       l_right.data(),
+                       nullptr,
+                       l_out_0.data() );
+  l_conts[1].contract( l_left.data(),
+                       l_right.data(),
+                       nullptr,
+                       l_out_1.data() );
+
+  for( int64_t l_c = 0; l_c < 3; l_c++ ) {
+    for( int64_t l_n = 0; l_n < 47; l_n++ ) {
+      for( int64_t l_m = 0; l_m < 20; l_m++ ) {
+        float l_ref = 0;
+        for( int64_t l_k = 0; l_k < 13; l_k++ ) {
+          l_ref += l_left[ (l_c * 13 + l_k) * 20 + l_m ] * l_right[ (l_c * 47 + l_n) * 13 + l_k ];
+        }
+        l_ref = l_ref > 0 ? l_ref : 0;
+
+        int64_t l_id = (l_c * 47 + l_n) * 20 + l_m;
+        REQUIRE( l_out_0[l_id] == l_ref );
+        REQUIRE( l_out_1[l_id] == l_ref );
+      }
+    }
+  }
+}
@@ -1,10 +1,9 @@
 #include "ContractionBackend.h"
 #include "../unary/UnaryOptimizer.h"
+#include "../parallel/ExecutionContext.h"
+#include "../parallel/AsyncExecutor.h"
 #include <algorithm>
-
-#ifdef _OPENMP
-#include <omp.h>
-#endif
+#include <cassert>
 
 void einsum_ir::basic::ContractionBackend::init( std::vector< dim_t >   const & i_dim_type,
                                                  std::vector< exec_t >  const & i_exec_type,
@@ -54,9 +53,15 @@ void einsum_ir::basic::ContractionBackend::init( std::vector< dim_t >   const &
   m_dtype_out   = i_dtype_out;
   m_dtype_comp  = i_dtype_comp;
 
-  m_ktype_first_touch = i_ktype_first_touch;
-  m_ktype_main        = i_ktype_main;
-  m_ktype_last_touch  = i_ktype_last_touch;
+  m_ktype_first_touch_config = i_ktype_first_touch;
+  m_ktype_first_touch        = i_ktype_first_touch;
+  m_ktype_main               = i_ktype_main;
+  m_ktype_last_touch         = i_ktype_last_touch;
+
+  m_last_touch_ops.clear();
+  if( i_ktype_last_touch != kernel_t::UNDEFINED_KTYPE ) {
+    m_last_touch_ops.push_back( { i_ktype_last_touch, 0, 0 } );
+  }
 
   m_num_threads_sfc_m  = i_num_threads_sfc_m;
   m_num_threads_sfc_n  = i_num_threads_sfc_n;
@@ -109,9 +114,15 @@ void einsum_ir::basic::ContractionBackend::init( std::vector< iter_property > co
   m_dtype_out   = i_dtype_out;
   m_dtype_comp  = i_dtype_comp;
 
-  m_ktype_first_touch = i_ktype_first_touch;
-  m_ktype_main        = i_ktype_main;
-  m_ktype_last_touch  = i_ktype_last_touch;
+  m_ktype_first_touch_config = i_ktype_first_touch;
+  m_ktype_first_touch        = i_ktype_first_touch;
+  m_ktype_main               = i_ktype_main;
+  m_ktype_last_touch         = i_ktype_last_touch;
+
+  m_last_touch_ops.clear();
+  if( i_ktype_last_touch != kernel_t::UNDEFINED_KTYPE ) {
+    m_last_touch_ops.push_back( { i_ktype_last_touch, 0, 0 } );
+  }
 
   m_num_threads_sfc_m  = i_num_threads_sfc_m;
   m_num_threads_sfc_n  = i_num_threads_sfc_n;
@@ -122,12 +133,47 @@ void einsum_ir::basic::ContractionBackend::init( std::vector< iter_property > co
   m_is_compiled = false;
 }
 
+void einsum_ir::basic::ContractionBackend::set_last_touch_ops( std::vector< last_touch_op > const & i_ops ) {
+  m_last_touch_ops = i_ops;
+  m_ktype_last_touch = i_ops.size() > 0 ? i_ops[0].ktype : kernel_t::UNDEFINED_KTYPE;
+}
+
+void einsum_ir::basic::ContractionBackend::set_accumulate( bool i_accumulate ) {
+  m_accumulate = i_accumulate;
+}
+
+void einsum_ir::basic::ContractionBackend::set_constant_inputs( bool i_constant_left,
+                                                                bool i_constant_right ) {
+  m_constant_left.enabled  = i_constant_left;
+  m_constant_right.enabled = i_constant_right;
+}
+
+void einsum_ir::basic::ContractionBackend::set_loop_nest( loop_nest_t i_loop_nest ) {
+  m_loop_nest = i_loop_nest;
+}
+
+void einsum_ir::basic::ContractionBackend::set_sched( sched_t i_sched ) {
+  m_sched = i_sched;
+}
+
+void einsum_ir::basic::ContractionBackend::set_prefetch( prefetch_t i_prefetch ) {
+  m_prefetch_requested = i_prefetch;
+}
+
+void einsum_ir::basic::ContractionBackend::invalidate_constant_inputs() {
+  m_constant_left.packed  = false;
+  m_constant_right.packed = false;
+}
+
 einsum_ir::basic::err_t einsum_ir::basic::ContractionBackend::compile(){
   err_t l_err = err_t::UNDEFINED_ERROR;
   if( m_is_compiled ){
     return err_t::SUCCESS;
   }
 
+  // derive the first touch kernel, the main kernels add to the existing output when accumulating
+  m_ktype_first_touch = m_accumulate ? kernel_t::UNDEFINED_KTYPE : m_ktype_first_touch_config;
+
   // get kernel shape
   l_err = set_kernel_shape();
   if( l_err != err_t::SUCCESS ) {
@@ -140,17 +186,139 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackend::compile(){
     return l_err;
   }
 
+  // keep the primitive loops, a rebind has to preserve them
+  m_iters_prim.clear();
+  int64_t l_id_first_prim = m_dim_type.size();
+  while(    l_id_first_prim > 0
+         && m_exec_type[l_id_first_prim - 1] == exec_t::PRIM ){
+    l_id_first_prim--;
+  }
+  for( std::size_t l_id = l_id_first_prim; l_id < m_dim_type.size(); l_id++ ){
+    iter_property l_iter;
+    l_iter.dim_type             = m_dim_type[l_id];
+    l_iter.exec_type            = m_exec_type[l_id];
+    l_iter.size                 = m_dim_sizes[l_id];
+    l_iter.stride_left          = m_strides_left[l_id];
+    l_iter.stride_right         = m_strides_right[l_id];
+    l_iter.stride_out_aux       = m_strides_out_aux[l_id];
+    l_iter.stride_out           = m_strides_out[l_id];
+    l_iter.packing_stride_left  = m_packing_strides_left[l_id];
+    l_iter.packing_stride_right = m_packing_strides_right[l_id];
+    m_iters_prim.push_back( l_iter );
+  }
+
+  l_err = compile_loops();
+  if( l_err != err_t::SUCCESS ) {
+    return l_err;
+  }
+
+  m_is_compiled = true;
+  return err_t::SUCCESS;
+}
+
+bool einsum_ir::basic::ContractionBackend::primitives_match( std::vector< iter_property > const & i_iterations,
+                                                            kernel_t                             i_ktype_main ) const {
+  if( i_ktype_main != m_ktype_main ){
+    return false;
+  }
+
+  int64_t l_num_iters = i_iterations.size();
+  int64_t l_num_prims = m_iters_prim.size();
+  if( l_num_prims == 0 || l_num_iters < l_num_prims ){
+    return false;
+  }
+  for( int64_t l_pr = 0; l_pr < l_num_prims; l_pr++ ){
+    iter_property const & l_old = m_iters_prim[l_pr];
+    iter_property const & l_new = i_iterations[l_num_iters - l_num_prims + l_pr];
+    if(    l_old.dim_type             != l_new.dim_type
+        || l_old.exec_type            != l_new.exec_type
+        || l_old.size                 != l_new.size
+        || l_old.stride_left          != l_new.stride_left
+        || l_old.stride_right         != l_new.stride_right
+        || l_old.stride_out_aux       != l_new.stride_out_aux
+        || l_old.stride_out           != l_new.stride_out
+        || l_old.packing_stride_left  != l_new.packing_stride_left
+        || l_old.packing_stride_right != l_new.packing_stride_right ){
+      return false;
+    }
+  }
+  for( int64_t l_id = 0; l_id < l_num_iters - l_num_prims; l_id++ ){
+    if( i_iterations[l_id].exec_type == exec_t::PRIM ){
+      return false;
+    }
+  }
+
+  return true;
+}
+
+einsum_ir::basic::err_t einsum_ir::basic::ContractionBackend::rebind( std::vector< iter_property > const & i_iterations,
+                                                                      int64_t                              i_num_threads_shared,
+                                                                      int64_t                              i_num_threads_sfc_m,
+                                                                      int64_t                              i_num_threads_sfc_n ){
+  if( m_is_compiled == false ){
+    return err_t::COMPILATION_FAILED;
+  }
+
+  // the primitive loops are baked into the kernels
+  if( primitives_match( i_iterations, m_ktype_main ) == false ){
+    return err_t::COMPILATION_FAILED;
+  }
+  int64_t l_num_iters = i_iterations.size();
+
+  m_dim_type.resize( l_num_iters );
+  m_exec_type.resize( l_num_iters );
+  m_dim_sizes.resize( l_num_iters );
+  m_strides_left.resize( l_num_iters );
+  m_strides_right.resize( l_num_iters );
+  m_strides_out.resize( l_num_iters );
+  m_strides_out_aux.resize( l_num_iters );
+  m_packing_strides_left.resize( l_num_iters );
+  m_packing_strides_right.resize( l_num_iters );
+
+  for( int64_t l_id = 0; l_id < l_num_iters; l_id++ ){
+    m_dim_type[             l_id] = i_iterations[l_id].dim_type;
+    m_exec_type[            l_id] = i_iterations[l_id].exec_type;
+    m_dim_sizes[            l_id] = i_iterations[l_id].size;
+    m_strides_left[         l_id] = i_iterations[l_id].stride_left;
+    m_strides_right[        l_id] = i_iterations[l_id].stride_right;
+    m_strides_out[          l_id] = i_iterations[l_id].stride_out;
+    m_strides_out_aux[      l_id] = i_iterations[l_id].stride_out_aux;
+    m_packing_strides_left[ l_id] = i_iterations[l_id].packing_stride_left;
+    m_packing_strides_right[l_id] = i_iterations[l_id].packing_stride_right;
+  }
+
+  m_num_threads_shared = i_num_threads_shared;
+  m_num_threads_sfc_m  = i_num_threads_sfc_m;
+  m_num_threads_sfc_n  = i_num_threads_sfc_n;
+
+  return compile_loops();
+}
+
+einsum_ir::basic::err_t einsum_ir::basic::ContractionBackend::compile_loops(){
+  err_t l_err = err_t::UNDEFINED_ERROR;
+
   //update number of threads if loops are to small
   int64_t l_num_iters = m_dim_type.size();
   int64_t l_size_shared = 1;
   int64_t l_size_sfc_m  = 1;
   int64_t l_size_sfc_n  = 1;
+  int64_t l_size_split_k = 1;
   m_num_sfc_loops = 0;
   m_num_shared_loops = 0;
+  m_num_split_k_loops = 0;
   for(int64_t l_id = 0; l_id < l_num_iters; l_id++){
     if( m_exec_type.at(l_id) == exec_t::OMP ){
       l_size_shared *= m_dim_sizes.at(l_id);
       m_num_shared_loops++;
+
+      //parallel k loops have to be the outermost shared loops
+      if( m_dim_type.at(l_id) == dim_t::K ){
+        if( m_num_split_k_loops != m_num_shared_loops - 1 ){
+          return err_t::COMPILATION_FAILED;
+        }
+        l_size_split_k *= m_dim_sizes.at(l_id);
+        m_num_split_k_loops++;
+      }
     }
     else if( m_exec_type.at(l_id) == exec_t::SFC ){
       if( m_dim_type.at(l_id) == dim_t::M ){
@@ -166,41 +334,80 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackend::compile(){
   m_num_threads_sfc_n  = std::min(m_num_threads_sfc_n,  l_size_sfc_n);
   m_num_threads_shared = std::min(m_num_threads_shared, l_size_shared);
   m_num_threads = m_num_threads_sfc_m * m_num_threads_sfc_n * m_num_threads_shared;
+  m_num_tasks_first_split = l_size_shared / l_size_split_k;
+
+  //split parallel dimensions into tasks
+  int64_t l_num_tasks_shared = 0;
+  int64_t l_num_tasks_sfc_m  = 0;
+  int64_t l_num_tasks_sfc_n  = 0;
+  split_tasks( l_size_shared,
+               l_size_sfc_m,
+               l_size_sfc_n,
+               l_num_tasks_shared,
+               l_num_tasks_sfc_m,
+               l_num_tasks_sfc_n );
+  m_num_tasks = l_num_tasks_shared * l_num_tasks_sfc_m * l_num_tasks_sfc_n;
 
   //check if first and last touch exists
   m_has_first_touch = m_ktype_first_touch != kernel_t::UNDEFINED_KTYPE;
   m_has_last_touch = m_ktype_last_touch != kernel_t::UNDEFINED_KTYPE;
 
   //create packing
+  m_size_packing_left = 0;
+  m_size_packing_right = 0;
   create_packing( m_packing_left_id,
                   m_size_packing_left,
                   m_unary_left,
                   m_strides_left,
-                  m_packing_strides_left);
+                  m_packing_strides_left,
+                  m_dtype_left );
   m_size_packing_left *= ce_n_bytes(m_dtype_left);
   
   create_packing( m_packing_right_id,
                   m_size_packing_right,
                   m_unary_right,
                   m_strides_right,
-                  m_packing_strides_right);
+                  m_packing_strides_right,
+                  m_dtype_right );
   m_size_packing_right *= ce_n_bytes(m_dtype_right);
 
+  //constant inputs are packed once
+  setup_constant_input( m_constant_left,
+                        m_packing_left_id,
+                        m_size_packing_left,
+                        m_strides_left,
+                        m_packing_strides_left,
+                        ce_n_bytes(m_dtype_left) );
+  setup_constant_input( m_constant_right,
+                        m_packing_right_id,
+                        m_size_packing_right,
+                        m_strides_right,
+                        m_packing_strides_right,
+                        ce_n_bytes(m_dtype_right) );
+
   //multiply strides by size of datatype 
   for(int64_t l_id = 0; l_id < l_num_iters; l_id++){
     m_strides_left[l_id]    *= ce_n_bytes(m_dtype_left );
     m_strides_right[l_id]   *= ce_n_bytes(m_dtype_right);
     m_strides_out[l_id]     *= ce_n_bytes(m_dtype_out  );
-    m_strides_out_aux[l_id] *= ce_n_bytes(m_dtype_out  );
+    m_strides_out_aux[l_id] *= ce_n_bytes(ce_dtype_out_aux(m_dtype_out));
+  }
+
+  //create reduction of parallel k loops
+  l_err = create_split_k_reduction();
+  if( l_err != err_t::SUCCESS ) {
+    return l_err;
   }
   
   // init iteration spaces
+  m_iter = IterationSpace();
+  m_thread_infos.clear();
   m_iter.init( &m_dim_type,
                &m_exec_type,
                &m_dim_sizes,
-               m_num_threads_sfc_m,
-               m_num_threads_sfc_n,
-               m_num_threads_shared );
+               l_num_tasks_sfc_m,
+               l_num_tasks_sfc_n,
+               l_num_tasks_shared );
 
   // compile iteration spaces
   l_err = m_iter.setup( m_strides_left,
@@ -216,15 +423,44 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackend::compile(){
   m_num_cached_ptrs_left = m_iter.get_caching_size();
   m_num_cached_ptrs_right = m_iter.get_caching_size();
 
+  //assign tasks to threads
+  if( m_sched == sched_t::DYNAMIC ){
+    assign_tasks( l_num_tasks_shared,
+                  l_num_tasks_sfc_m,
+                  l_num_tasks_sfc_n );
+  }
+
+  m_batch_thread_infos.clear();
+
+  //caches of the threads' packing memory
+  m_thread_cached_ptrs_left.clear();
+  m_thread_cached_ptrs_right.clear();
+  m_thread_cached_ptrs_left.resize( m_num_threads );
+  m_thread_cached_ptrs_right.resize( m_num_threads );
+  for( int64_t l_th = 0; l_th < m_num_threads; l_th++ ){
+    m_thread_cached_ptrs_left[l_th].resize(  m_num_cached_ptrs_left,  nullptr );
+    m_thread_cached_ptrs_right[l_th].resize( m_num_cached_ptrs_right, nullptr );
+  }
+
   //reserve memory for packing
-  int64_t l_reserved_size = m_size_packing_left * m_num_cached_ptrs_left + m_size_packing_right * m_num_cached_ptrs_right;
-  if( m_memory == nullptr ){
+  m_offset_memory_out = m_size_packing_left * m_num_cached_ptrs_left + m_size_packing_right * m_num_cached_ptrs_right;
+  int64_t l_reserved_size = m_offset_memory_out + m_size_memory_out;
+  if( m_memory == nullptr || m_memory == &m_personal_memory ){
     m_memory = &m_personal_memory;
     m_memory->reserve_thread_memory( l_reserved_size, m_num_threads );
     m_memory->alloc_all_memory();
   }
+  else if( m_is_compiled ){
+    //external memory is allocated once by its owner: a rebind must not grow it
+    if(    l_reserved_size > m_reserved_thread_memory
+        || m_num_threads   > m_reserved_num_threads ){
+      return err_t::COMPILATION_FAILED;
+    }
+  }
   else{
     m_memory->reserve_thread_memory( l_reserved_size, m_num_threads );
+    m_reserved_thread_memory = l_reserved_size;
+    m_reserved_num_threads = m_num_threads;
   }
 
   //setup function pointer vector
@@ -247,55 +483,723 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackend::compile(){
     }
   }
 
-  m_is_compiled = true;
+  //derive pointer increments of the shared loops
+  int64_t l_id_first_shared = 0;
+  while(    l_id_first_shared < l_num_iters
+         && m_exec_type[l_id_first_shared] != exec_t::OMP ){
+    l_id_first_shared++;
+  }
+  derive_loop_incs( l_id_first_shared, l_id_first_shared + m_num_shared_loops, m_strides_left,    m_shared_incs.left    );
+  derive_loop_incs( l_id_first_shared, l_id_first_shared + m_num_shared_loops, m_strides_right,   m_shared_incs.right   );
+  derive_loop_incs( l_id_first_shared, l_id_first_shared + m_num_shared_loops, m_strides_out_aux, m_shared_incs.out_aux );
+  derive_loop_incs( l_id_first_shared, l_id_first_shared + m_num_shared_loops, m_strides_out,     m_shared_incs.out     );
+
+  //derive increments of the sfc movements
+  m_sfc_moves.resize( 2 * l_num_iters );
+  for( int64_t l_id = 0; l_id < l_num_iters; l_id++ ){
+    for( int64_t l_sign = 0; l_sign < 2; l_sign++ ){
+      int64_t l_direction = 1 - (l_sign << 1);
+      sfc_move_t & l_move = m_sfc_moves[ (l_id << 1) + l_sign ];
+      l_move.left     = l_direction * m_strides_left[    l_id ];
+      l_move.right    = l_direction * m_strides_right[   l_id ];
+      l_move.out_aux  = l_direction * m_strides_out_aux[ l_id ];
+      l_move.out      = l_direction * m_strides_out[     l_id ];
+      l_move.id_sfc_m = l_direction * (m_dim_type[l_id] == dim_t::M);
+      l_move.id_sfc_n = l_direction * (m_dim_type[l_id] == dim_t::N);
+    }
+  }
+
+  //prefetching requires the kernels to be called directly by the sfc loops
+  m_prefetch = prefetch_t::NO_PREFETCH;
+  m_prefetch_offsets_left.clear();
+  m_prefetch_offsets_right.clear();
+  m_prefetch_offsets_out.clear();
+  if( m_prefetch_requested == prefetch_t::SFC_PREFETCH ){
+    int64_t l_id_first_prim = 0;
+    while(    l_id_first_prim < l_num_iters
+           && m_exec_type[l_id_first_prim] != exec_t::PRIM ){
+      l_id_first_prim++;
+    }
+    if(    l_id_first_prim > 0
+        && m_exec_type[l_id_first_prim - 1] == exec_t::SFC ){
+      m_prefetch = prefetch_t::SFC_PREFETCH;
+      derive_prefetch_offsets( m_strides_left,  ce_n_bytes( m_dtype_left  ), m_prefetch_offsets_left  );
+      derive_prefetch_offsets( m_strides_right, ce_n_bytes( m_dtype_right ), m_prefetch_offsets_right );
+      derive_prefetch_offsets( m_strides_out,   ce_n_bytes( m_dtype_out   ), m_prefetch_offsets_out   );
+    }
+  }
+
+  //flatten sequential and sfc loops
+  m_flat_loop_ids.clear();
+  if( m_loop_nest == loop_nest_t::FLAT ){
+    compile_flat_loop_nest();
+  }
+
+  for( std::size_t l_th = 0; l_th < m_thread_infos.size(); l_th++ ){
+    m_thread_infos[l_th].shared_counters.resize( m_num_shared_loops );
+    m_thread_infos[l_th].flat_states.resize( m_flat_loop_ids.size() + 1 );
+  }
+
   return err_t::SUCCESS;
 }
 
+einsum_ir::basic::err_t einsum_ir::basic::ContractionBackend::create_split_k_reduction(){
+  m_size_memory_out = 0;
+  m_split_offsets_out.clear();
+  m_split_offsets_out_aux.clear();
+  m_split_tile_offsets_out.clear();
+  m_num_split_blocks_tile = 0;
+  m_split_touched.clear();
+  if( m_num_split_k_loops == 0 ){
+    return err_t::SUCCESS;
+  }
+
+  int64_t l_num_iters = m_dim_type.size();
+  int64_t l_num_bytes = ce_n_bytes( m_dtype_out );
+
+  //the private output memory has the layout of the output tensor
+  m_size_memory_out = l_num_bytes;
+  for( int64_t l_id = 0; l_id < l_num_iters; l_id++ ){
+    m_size_memory_out += (m_dim_sizes[l_id] - 1) * m_strides_out[l_id];
+  }
+
+  //the loops up to the shared loops span the tiles, the remaining loops the blocks of a tile
+  int64_t l_id_end_shared = 0;
+  while(    l_id_end_shared < l_num_iters
+         && m_exec_type[l_id_end_shared] != exec_t::OMP ){
+    l_id_end_shared++;
+  }
+  l_id_end_shared += m_num_shared_loops;
+
+  //derive offsets of the tiles, the blocks inside a tile and the iterations inside a block
+  std::vector< std::pair< int64_t, int64_t > > l_tile_offsets  = { {0, 0} };
+  std::vector< std::pair< int64_t, int64_t > > l_block_offsets = { {0, 0} };
+  std::vector< iter_property > l_reduce_iters;
+  for( int64_t l_id = 0; l_id < l_num_iters; l_id++ ){
+    if( m_dim_type[l_id] == dim_t::K ){
+      continue;
+    }
+
+    if( m_exec_type[l_id] == exec_t::PRIM ){
+      iter_property l_iter;
+      l_iter.exec_type    = exec_t::SEQ;
+      l_iter.size         = m_dim_sizes[l_id];
+      l_iter.stride_left  = m_strides_out[l_id] / l_num_bytes;
+      l_iter.stride_out   = m_strides_out[l_id] / l_num_bytes;
+      l_reduce_iters.push_back( l_iter );
+    }
+    else{
+      std::vector< std::pair< int64_t, int64_t > > & l_offsets = l_id < l_id_end_shared ? l_tile_offsets : l_block_offsets;
+      std::size_t l_num_offsets = l_offsets.size();
+      for( int64_t l_it = 1; l_it < m_dim_sizes[l_id]; l_it++ ){
+        for( std::size_t l_of = 0; l_of < l_num_offsets; l_of++ ){
+          l_offsets.push_back( { l_offsets[l_of].first  + l_it * m_strides_out[l_id],
+                                 l_offsets[l_of].second + l_it * m_strides_out_aux[l_id] } );
+        }
+      }
+    }
+  }
+
+  //tiles are looked up by their offset during the contraction
+  std::sort( l_tile_offsets.begin(), l_tile_offsets.end() );
+  m_num_split_blocks_tile = l_block_offsets.size();
+  for( std::size_t l_ti = 0; l_ti < l_tile_offsets.size(); l_ti++ ){
+    m_split_tile_offsets_out.push_back( l_tile_offsets[l_ti].first );
+    for( std::size_t l_bl = 0; l_bl < l_block_offsets.size(); l_bl++ ){
+      m_split_offsets_out.push_back(     l_tile_offsets[l_ti].first  + l_block_offsets[l_bl].first  );
+      m_split_offsets_out_aux.push_back( l_tile_offsets[l_ti].second + l_block_offsets[l_bl].second );
+    }
+  }
+  m_split_touched.resize( m_num_threads, std::vector< uint8_t >( m_split_tile_offsets_out.size(), 0 ) );
+
+  //create reduction and zeroing kernels
+  UnaryOptimizer l_unary_opt;
+  l_unary_opt.init( &l_reduce_iters, 1, false );
+  err_t l_err = l_unary_opt.optimize();
+  if( l_err != err_t::SUCCESS ) {
+    return l_err;
+  }
+
+  m_unary_reduce.init( l_reduce_iters, m_dtype_out, m_dtype_comp, m_dtype_out, kernel_t::ADD, 1 );
+  l_err = m_unary_reduce.compile();
+  if( l_err != err_t::SUCCESS ) {
+    return l_err;
+  }
+
+  m_unary_zero.init( l_reduce_iters, m_dtype_out, m_dtype_comp, m_dtype_out, kernel_t::ZERO, 1 );
+  return m_unary_zero.compile();
+}
+
+void einsum_ir::basic::ContractionBackend::touch_split_tile( thread_info * io_thread_info,
+                                                             char  const * i_ptr_out ){
+  //offset of the tile without the offset of the task's first sfc block
+  int64_t l_offset = i_ptr_out - io_thread_info->tensor_out - io_thread_info->offset_out;
+  std::vector< int64_t >::const_iterator l_tile = std::lower_bound( m_split_tile_offsets_out.begin(),
+                                                                    m_split_tile_offsets_out.end(),
+                                                                    l_offset );
+  assert( l_tile != m_split_tile_offsets_out.end() && *l_tile == l_offset );
+  int64_t l_id_tile = l_tile - m_split_tile_offsets_out.begin();
+
+  if( io_thread_info->touched_out[l_id_tile] == 0 ){
+    int64_t l_id_block = l_id_tile * m_num_split_blocks_tile;
+    for( int64_t l_bl = 0; l_bl < m_num_split_blocks_tile; l_bl++ ){
+      m_unary_zero.eval( nullptr,
+                         io_thread_info->memory_out + m_split_offsets_out[l_id_block + l_bl] );
+    }
+    io_thread_info->touched_out[l_id_tile] = 1;
+  }
+}
+
+void einsum_ir::basic::ContractionBackend::reduce_split_k( void const * i_tensor_out_aux,
+                                                           void       * io_tensor_out ){
+  char const * l_tensor_out_aux = (char const *) i_tensor_out_aux;
+  char       * l_tensor_out     = (char       *) io_tensor_out;
+  int64_t l_num_blocks = m_split_offsets_out.size();
+
+  ExecutionContext::get_default()->parallel_for( m_num_threads,
+                                                  l_num_blocks,
+                                                  [&]( int64_t l_bl ){
+    char * l_ptr_out = l_tensor_out + m_split_offsets_out[l_bl];
+    int64_t l_id_tile = l_bl / m_num_split_blocks_tile;
+
+    //add private output memory of the threads which accumulated in the tile
+    for( int64_t l_th = 0; l_th < m_num_threads; l_th++ ){
+      if( m_split_touched[l_th][l_id_tile] != 0 ){
+        char const * l_ptr_memory = m_memory->get_thread_memory( l_th ) + m_offset_memory_out + m_split_offsets_out[l_bl];
+        m_unary_reduce.eval( l_ptr_memory, l_ptr_out );
+      }
+    }
+
+    if( m_has_last_touch ){
+      kernel_last_touch( l_tensor_out_aux + m_split_offsets_out_aux[l_bl],
+                         l_ptr_out );
+    }
+  } );
+}
+
+void einsum_ir::basic::ContractionBackend::split_tasks( int64_t   i_size_shared,
+                                                        int64_t   i_size_sfc_m,
+                                                        int64_t   i_size_sfc_n,
+                                                        int64_t & o_num_tasks_shared,
+                                                        int64_t & o_num_tasks_sfc_m,
+                                                        int64_t & o_num_tasks_sfc_n ){
+  o_num_tasks_shared = m_num_threads_shared;
+  o_num_tasks_sfc_m  = m_num_threads_sfc_m;
+  o_num_tasks_sfc_n  = m_num_threads_sfc_n;
+
+  if( m_sched != sched_t::DYNAMIC ){
+    return;
+  }
+
+  //prefer splitting the shared dimensions since their tasks do not share data
+  o_num_tasks_shared = std::min( i_size_shared, m_num_threads_shared * m_num_tasks_per_thread );
+
+  //split the sfc dimensions evenly, every split halves the sfc blocks in one dimension
+  int64_t l_num_tasks_target = m_num_threads * m_num_tasks_per_thread;
+  while( o_num_tasks_shared * o_num_tasks_sfc_m * o_num_tasks_sfc_n < l_num_tasks_target ){
+    bool l_split_m = 2 * o_num_tasks_sfc_m <= i_size_sfc_m;
+    bool l_split_n = 2 * o_num_tasks_sfc_n <= i_size_sfc_n;
+
+    if( l_split_m && ( !l_split_n || o_num_tasks_sfc_m * m_num_threads_sfc_n <= o_num_tasks_sfc_n * m_num_threads_sfc_m ) ){
+      o_num_tasks_sfc_m *= 2;
+    }
+    else if( l_split_n ){
+      o_num_tasks_sfc_n *= 2;
+    }
+    else{
+      break;
+    }
+  }
+}
+
+void einsum_ir::basic::ContractionBackend::assign_tasks( int64_t i_num_tasks_shared,
+                                                         int64_t i_num_tasks_sfc_m,
+                                                         int64_t i_num_tasks_sfc_n ){
+  // first task owned by a thread, task t is owned by thread floor( t * threads / tasks )
+  auto l_first_task = []( int64_t i_id_thread,
+                          int64_t i_num_threads,
+                          int64_t i_num_tasks ){
+    return ( i_id_thread * i_num_tasks + i_num_threads - 1 ) / i_num_threads;
+  };
+
+  m_task_ids.clear();
+  m_task_offsets.resize( m_num_threads + 1 );
+  m_task_offsets[0] = 0;
+
+  for( int64_t l_th = 0; l_th < m_num_threads; l_th++ ){
+    int64_t l_th_m      = l_th % m_num_threads_sfc_m;
+    int64_t l_rem       = l_th / m_num_threads_sfc_m;
+    int64_t l_th_n      = l_rem % m_num_threads_sfc_n;
+    int64_t l_th_shared = l_rem / m_num_threads_sfc_n;
+
+    for( int64_t l_ta_shared = l_first_task( l_th_shared,     m_num_threads_shared, i_num_tasks_shared );
+                 l_ta_shared < l_first_task( l_th_shared + 1, m_num_threads_shared, i_num_tasks_shared );
+                 l_ta_shared++ ){
+      for( int64_t l_ta_n = l_first_task( l_th_n,     m_num_threads_sfc_n, i_num_tasks_sfc_n );
+                   l_ta_n < l_first_task( l_th_n + 1, m_num_threads_sfc_n, i_num_tasks_sfc_n );
+                   l_ta_n++ ){
+        for( int64_t l_ta_m = l_first_task( l_th_m,     m_num_threads_sfc_m, i_num_tasks_sfc_m );
+                     l_ta_m < l_first_task( l_th_m + 1, m_num_threads_sfc_m, i_num_tasks_sfc_m );
+                     l_ta_m++ ){
+          int64_t l_id_task = l_ta_m + l_ta_n * i_num_tasks_sfc_m + l_ta_shared * i_num_tasks_sfc_m * i_num_tasks_sfc_n;
+
+          //skip tasks without iterations
+          thread_info const & l_task = m_thread_infos[l_id_task];
+          if(    l_task.id_shared_loop_start < l_task.id_shared_loop_end
+              && l_task.movement_ids.size() > 0 ){
+            m_task_ids.push_back( l_id_task );
+          }
+        }
+      }
+    }
+    m_task_offsets[l_th+1] = m_task_ids.size();
+  }
+
+  m_task_queues = std::vector< task_queue_t >( m_num_threads );
+}
+
+bool einsum_ir::basic::ContractionBackend::claim_task( int64_t   i_id_queue,
+                                                       bool      i_front,
+                                                       int64_t & o_id_task ){
+  std::atomic< int64_t > & l_queue = m_task_queues[i_id_queue].range;
+  int64_t l_range = l_queue.load( std::memory_order_relaxed );
+
+  while( true ){
+    int64_t l_begin = l_range >> 32;
+    int64_t l_end   = l_range & 0xFFFFFFFF;
+    if( l_begin >= l_end ){
+      return false;
+    }
+
+    int64_t l_range_new = i_front ? ( (l_begin + 1) << 32 ) |  l_end
+                                  : (  l_begin      << 32 ) | (l_end - 1);
+    if( l_queue.compare_exchange_weak( l_range,
+                                       l_range_new,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_relaxed ) ){
+      o_id_task = i_front ? l_begin : l_end - 1;
+      return true;
+    }
+  }
+}
+
+void einsum_ir::basic::ContractionBackend::derive_loop_incs( int64_t                        i_id_first,
+                                                             int64_t                        i_id_end,
+                                                             std::vector< int64_t > const & i_strides,
+                                                             std::vector< int64_t >       & o_incs ){
+  o_incs.resize( i_id_end - i_id_first );
+
+  // rewind of all inner loops after they wrapped around
+  int64_t l_rewind = 0;
+  for( int64_t l_id = i_id_end - 1; l_id >= i_id_first; l_id-- ){
+    o_incs[l_id - i_id_first] = i_strides[l_id] - l_rewind;
+    l_rewind += (m_dim_sizes[l_id] - 1) * i_strides[l_id];
+  }
+}
+
+void einsum_ir::basic::ContractionBackend::derive_prefetch_offsets( std::vector< int64_t > const & i_strides,
+                                                                    int64_t                        i_num_bytes,
+                                                                    std::vector< int64_t >       & o_offsets ){
+  int64_t l_num_iters = m_dim_type.size();
+  int64_t l_size_cache_line = 64;
+
+  //a contiguous primitive loop forms the rows of the block
+  int64_t l_id_row = -1;
+  int64_t l_size_row = i_num_bytes;
+  for( int64_t l_id = 0; l_id < l_num_iters; l_id++ ){
+    if(    m_exec_type[l_id] == exec_t::PRIM
+        && i_strides[l_id] == i_num_bytes ){
+      l_id_row = l_id;
+      l_size_row = m_dim_sizes[l_id] * i_num_bytes;
+      break;
+    }
+  }
+
+  //derive the offsets of the rows
+  std::vector< int64_t > l_offsets_rows( 1, 0 );
+  for( int64_t l_id = 0; l_id < l_num_iters; l_id++ ){
+    if(    m_exec_type[l_id] != exec_t::PRIM
+        || l_id == l_id_row
+        || i_strides[l_id] == 0 ){
+      continue;
+    }
+    std::size_t l_num_rows = l_offsets_rows.size();
+    for( int64_t l_it = 1; l_it < m_dim_sizes[l_id]; l_it++ ){
+      for( std::size_t l_ro = 0; l_ro < l_num_rows; l_ro++ ){
+        l_offsets_rows.push_back( l_offsets_rows[l_ro] + l_it * i_strides[l_id] );
+      }
+    }
+  }
+
+  //one offset per cache line, the last byte covers rows which are not aligned
+  o_offsets.clear();
+  for( std::size_t l_ro = 0; l_ro < l_offsets_rows.size(); l_ro++ ){
+    for( int64_t l_by = 0; l_by < l_size_row; l_by += l_size_cache_line ){
+      o_offsets.push_back( l_offsets_rows[l_ro] + l_by );
+    }
+    o_offsets.push_back( l_offsets_rows[l_ro] + l_size_row - 1 );
+  }
+  std::sort( o_offsets.begin(), o_offsets.end() );
+  o_offsets.erase( std::unique( o_offsets.begin(), o_offsets.end() ), o_offsets.end() );
+}
+
+void einsum_ir::basic::ContractionBackend::prefetch_sfc_step( sfc_move_t const & i_move,
+                                                              char       const * i_ptr_left,
+                                                              char       const * i_ptr_right,
+                                                              char       const * i_ptr_out ){
+  if( i_move.left != 0 ){
+    char const * l_ptr = i_ptr_left + i_move.left;
+    for( std::size_t l_of = 0; l_of < m_prefetch_offsets_left.size(); l_of++ ){
+      __builtin_prefetch( l_ptr + m_prefetch_offsets_left[l_of], 0, 2 );
+    }
+  }
+  if( i_move.right != 0 ){
+    char const * l_ptr = i_ptr_right + i_move.right;
+    for( std::size_t l_of = 0; l_of < m_prefetch_offsets_right.size(); l_of++ ){
+      __builtin_prefetch( l_ptr + m_prefetch_offsets_right[l_of], 0, 2 );
+    }
+  }
+  if( i_move.out != 0 ){
+    char const * l_ptr = i_ptr_out + i_move.out;
+    for( std::size_t l_of = 0; l_of < m_prefetch_offsets_out.size(); l_of++ ){
+      __builtin_prefetch( l_ptr + m_prefetch_offsets_out[l_of], 1, 2 );
+    }
+  }
+}
+
+void einsum_ir::basic::ContractionBackend::setup_constant_input( constant_input_t             & io_constant,
+                                                                 int64_t                      & io_packing_id,
+                                                                 int64_t                      & io_size_packing,
+                                                                 std::vector< int64_t >       & io_strides,
+                                                                 std::vector< int64_t > const & i_packing_strides,
+                                                                 int64_t                        i_num_bytes ){
+  io_constant.active = false;
+  io_constant.packed = false;
+  io_constant.sizes.clear();
+  io_constant.strides_unpacked.clear();
+  io_constant.strides_packed.clear();
+  if( !io_constant.enabled || io_packing_id < 0 ){
+    return;
+  }
+
+  //the loops inside of the packing loop have to be covered by the packed panels
+  int64_t l_num_iters = io_strides.size();
+  for( int64_t l_id = io_packing_id; l_id < l_num_iters; l_id++ ){
+    if( i_packing_strides[l_id] == 0 && io_strides[l_id] != 0 ){
+      return;
+    }
+  }
+
+  //lay out the panels in the order of the outer loops
+  int64_t l_size_packed = io_size_packing / i_num_bytes;
+  for( int64_t l_id = io_packing_id - 1; l_id >= 0; l_id-- ){
+    if( io_strides[l_id] == 0 ){
+      continue;
+    }
+    io_constant.sizes.push_back( m_dim_sizes[l_id] );
+    io_constant.strides_unpacked.push_back( io_strides[l_id] * i_num_bytes );
+    io_constant.strides_packed.push_back( l_size_packed * i_num_bytes );
+    io_strides[l_id] = l_size_packed;
+    l_size_packed *= m_dim_sizes[l_id];
+  }
+
+  io_constant.size_panel = io_size_packing;
+  io_constant.memory.resize( l_size_packed * i_num_bytes + 64 );
+  int64_t l_align_offset = (uintptr_t) io_constant.memory.data() % 64;
+  io_constant.data = io_constant.memory.data() + ( l_align_offset ? 64 - l_align_offset : 0 );
+  io_constant.active = true;
+
+  io_packing_id = -1;
+  io_size_packing = 0;
+}
+
+void const * einsum_ir::basic::ContractionBackend::get_input( constant_input_t & io_constant,
+                                                              UnaryBackendTpp  & i_unary,
+                                                              void     const   * i_tensor ){
+  if( !io_constant.active ){
+    return i_tensor;
+  }
+  if( io_constant.packed ){
+    return io_constant.data;
+  }
+
+  //pack all panels, the threads pack contiguous chunks of panels
+  int64_t l_num_loops = io_constant.sizes.size();
+  int64_t l_num_panels = 1;
+  for( int64_t l_lo = 0; l_lo < l_num_loops; l_lo++ ){
+    l_num_panels *= io_constant.sizes[l_lo];
+  }
+  int64_t l_num_threads = std::min( ExecutionContext::get_default()->get_max_threads(),
+                                    l_num_panels );
+
+  ExecutionContext::get_default()->parallel( l_num_threads,
+                                              [&]( int64_t l_thread_id ) {
+    int64_t l_first = ( l_thread_id       * l_num_panels ) / l_num_threads;
+    int64_t l_end   = ( (l_thread_id + 1) * l_num_panels ) / l_num_threads;
+    for( int64_t l_pa = l_first; l_pa < l_end; l_pa++ ){
+      char const * l_ptr_unpacked = (char const *) i_tensor;
+      char       * l_ptr_packed   = io_constant.data;
+      int64_t l_id = l_pa;
+      for( int64_t l_lo = 0; l_lo < l_num_loops; l_lo++ ){
+        int64_t l_it = l_id % io_constant.sizes[l_lo];
+        l_id        /= io_constant.sizes[l_lo];
+        l_ptr_unpacked += l_it * io_constant.strides_unpacked[l_lo];
+        l_ptr_packed   += l_it * io_constant.strides_packed[l_lo];
+      }
+      i_unary.eval( l_ptr_unpacked, l_ptr_packed );
+    }
+  } );
+  io_constant.packed = true;
+
+  return io_constant.data;
+}
+
+void einsum_ir::basic::ContractionBackend::compile_flat_loop_nest(){
+  int64_t l_num_iters = m_dim_type.size();
+
+  //find the sequential and sfc loops in front of the primitive loops
+  int64_t l_id_end = 0;
+  while(    l_id_end < l_num_iters
+         && m_exec_type[l_id_end] != exec_t::PRIM ){
+    l_id_end++;
+  }
+  int64_t l_id_first = l_id_end;
+  while(    l_id_first > 0
+         && (    m_exec_type[l_id_first - 1] == exec_t::SEQ
+              || m_exec_type[l_id_first - 1] == exec_t::SFC ) ){
+    l_id_first--;
+  }
+
+  for( int64_t l_id = l_id_first; l_id < l_id_end; l_id++ ){
+    m_flat_loop_ids.push_back( l_id );
+    if( m_exec_type[l_id] == exec_t::SFC ){
+      l_id += m_num_sfc_loops - 1;
+    }
+  }
+
+  if( m_flat_loop_ids.size() > 0 ){
+    m_loop_functs[l_id_first] = &ContractionBackend::contract_iter_flat;
+  }
+}
+
 void einsum_ir::basic::ContractionBackend::contract( void const * i_tensor_left,
                                                      void const * i_tensor_right,
                                                      void const * i_tensor_out_aux,
                                                      void       * io_tensor_out ) {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(m_num_threads)
-#endif
-  for( int64_t l_thread_id = 0; l_thread_id < m_num_threads; l_thread_id++ ) {
-    thread_info * l_thread_inf = &m_thread_infos[l_thread_id];
-    //get packing memory
-    if( m_size_packing_left || m_size_packing_right ){
-      l_thread_inf->memory_left  = m_memory->get_thread_memory( l_thread_id );
-      l_thread_inf->memory_right = l_thread_inf->memory_left + m_size_packing_left * m_num_cached_ptrs_left;
-      l_thread_inf->cached_ptrs_left.resize(  m_num_cached_ptrs_left,  nullptr );
-      l_thread_inf->cached_ptrs_right.resize( m_num_cached_ptrs_right, nullptr );
-    }
-
-    //add thread offset
-    char * l_tensor_left    = (char *) i_tensor_left    + l_thread_inf->offset_left;
-    char * l_tensor_right   = (char *) i_tensor_right   + l_thread_inf->offset_right;
-    char * l_tensor_out_aux = (char *) i_tensor_out_aux + l_thread_inf->offset_out_aux;
-    char * l_tensor_out     = (char *) io_tensor_out    + l_thread_inf->offset_out;
+  //replace constant inputs by their packed data
+  i_tensor_left  = get_input( m_constant_left,  m_unary_left,  i_tensor_left  );
+  i_tensor_right = get_input( m_constant_right, m_unary_right, i_tensor_right );
+
+  //fill task queues
+  if( m_sched == sched_t::DYNAMIC ){
+    for( int64_t l_thread_id = 0; l_thread_id < m_num_threads; l_thread_id++ ) {
+      m_task_queues[l_thread_id].range.store(   ( m_task_offsets[l_thread_id] << 32 )
+                                              |   m_task_offsets[l_thread_id + 1],
+                                              std::memory_order_relaxed );
+    }
+  }
 
+  ExecutionContext::get_default()->parallel( m_num_threads,
+                                              [&]( int64_t l_thread_id ) {
+    //private output memory of parallel k loops is zeroed on first use
+    if( m_size_memory_out > 0 ){
+      std::fill( m_split_touched[l_thread_id].begin(), m_split_touched[l_thread_id].end(), 0 );
+    }
 
-    //pack left tensor
-    if( m_packing_left_id == 0)  {
-      m_unary_left.eval(l_tensor_left, l_thread_inf->memory_left);
-      l_tensor_left = l_thread_inf->memory_left;
+    //packed data of previous contractions might be overwritten
+    std::fill( m_thread_cached_ptrs_left[l_thread_id].begin(),  m_thread_cached_ptrs_left[l_thread_id].end(),  nullptr );
+    std::fill( m_thread_cached_ptrs_right[l_thread_id].begin(), m_thread_cached_ptrs_right[l_thread_id].end(), nullptr );
+
+    if( m_sched == sched_t::STATIC ){
+      contract_task( &m_thread_infos[l_thread_id],
+                     l_thread_id,
+                     i_tensor_left,
+                     i_tensor_right,
+                     i_tensor_out_aux,
+                     io_tensor_out );
     }
+    else {
+      //execute own tasks
+      int64_t l_id_task = 0;
+      while( claim_task( l_thread_id, true, l_id_task ) ) {
+        contract_task( &m_thread_infos[ m_task_ids[l_id_task] ],
+                       l_thread_id,
+                       i_tensor_left,
+                       i_tensor_right,
+                       i_tensor_out_aux,
+                       io_tensor_out );
+      }
 
-    //pack right tensor
-    if( m_packing_right_id == 0 )  {
-      m_unary_right.eval(l_tensor_right, l_thread_inf->memory_right);
-      l_tensor_right = l_thread_inf->memory_right;
+      //steal tasks of other threads
+      for( int64_t l_offset = 1; l_offset < m_num_threads; l_offset++ ) {
+        int64_t l_id_victim = (l_thread_id + l_offset) % m_num_threads;
+        while( claim_task( l_id_victim, false, l_id_task ) ) {
+          contract_task( &m_thread_infos[ m_task_ids[l_id_task] ],
+                         l_thread_id,
+                         i_tensor_left,
+                         i_tensor_right,
+                         i_tensor_out_aux,
+                         io_tensor_out );
+        }
+      }
     }
+  } );
 
-    //contract
-    (this->*(m_loop_functs[0]))( l_thread_inf,
-                                 0,
-                                 l_tensor_left,
-                                 l_tensor_right,
-                                 l_tensor_out_aux,
-                                 l_tensor_out,
-                                 m_has_first_touch,
-                                 m_has_last_touch );
+  //reduce private output memory of parallel k loops
+  if( m_num_split_k_loops > 0 ){
+    reduce_split_k( i_tensor_out_aux,
+                    io_tensor_out );
+  }
+}
+
+std::future< void > einsum_ir::basic::ContractionBackend::contract_async( void const * i_tensor_left,
+                                                                          void const * i_tensor_right,
+                                                                          void const * i_tensor_out_aux,
+                                                                          void       * io_tensor_out ) {
+  return AsyncExecutor::get_default()->submit( [ this,
+                                                 i_tensor_left,
+                                                 i_tensor_right,
+                                                 i_tensor_out_aux,
+                                                 io_tensor_out ]() {
+                                                 contract( i_tensor_left,
+                                                           i_tensor_right,
+                                                           i_tensor_out_aux,
+                                                           io_tensor_out );
+                                               } );
+}
+
+void einsum_ir::basic::ContractionBackend::contract_batch( int64_t              i_num_batch,
+                                                           void const * const * i_tensors_left,
+                                                           void const * const * i_tensors_right,
+                                                           void const * const * i_tensors_out_aux,
+                                                           void       * const * io_tensors_out ) {
+  //the private output memory of parallel k loops is reduced per contraction
+  if( m_num_split_k_loops > 0 ){
+    for( int64_t l_ba = 0; l_ba < i_num_batch; l_ba++ ){
+      contract( i_tensors_left[l_ba],
+                i_tensors_right[l_ba],
+                i_tensors_out_aux != nullptr ? i_tensors_out_aux[l_ba] : nullptr,
+                io_tensors_out[l_ba] );
+    }
+    return;
+  }
+
+  //all contractions of the batch share the packed data of constant inputs
+  void const * l_tensor_left  = nullptr;
+  void const * l_tensor_right = nullptr;
+  if( i_num_batch > 0 ){
+    l_tensor_left  = get_input( m_constant_left,  m_unary_left,  i_tensors_left[0]  );
+    l_tensor_right = get_input( m_constant_right, m_unary_right, i_tensors_right[0] );
+  }
+
+  int64_t l_num_items = i_num_batch * m_num_tasks;
+  int64_t l_num_threads = ExecutionContext::get_default()->get_max_threads();
+  if( m_memory != &m_personal_memory ){
+    //external memory is allocated once by its owner
+    l_num_threads = std::min( l_num_threads, m_reserved_num_threads );
+  }
+  l_num_threads = std::max( std::min( l_num_threads, l_num_items ), (int64_t) 1 );
+
+  //thread memory and packing caches of additional threads are reserved on first use
+  if( l_num_threads > (int64_t) m_thread_cached_ptrs_left.size() ){
+    if( m_memory == &m_personal_memory ){
+      m_memory->reserve_thread_memory( m_offset_memory_out + m_size_memory_out,
+                                       l_num_threads );
+      m_memory->alloc_all_memory();
+    }
+    m_thread_cached_ptrs_left.resize(  l_num_threads, std::vector< char const * >( m_num_cached_ptrs_left,  nullptr ) );
+    m_thread_cached_ptrs_right.resize( l_num_threads, std::vector< char const * >( m_num_cached_ptrs_right, nullptr ) );
+  }
+
+  //every thread mutates the thread infos of the executed tasks and requires its own copy
+  if( (int64_t) m_batch_thread_infos.size() < l_num_threads ){
+    m_batch_thread_infos.resize( l_num_threads, m_thread_infos );
+  }
+
+  ExecutionContext::get_default()->parallel( l_num_threads,
+                                              [&]( int64_t l_thread_id ) {
+    std::vector< thread_info > & l_tasks = m_batch_thread_infos[l_thread_id];
+
+    //packed data of previous contractions might be overwritten
+    std::fill( m_thread_cached_ptrs_left[l_thread_id].begin(),  m_thread_cached_ptrs_left[l_thread_id].end(),  nullptr );
+    std::fill( m_thread_cached_ptrs_right[l_thread_id].begin(), m_thread_cached_ptrs_right[l_thread_id].end(), nullptr );
+
+    //execute a contiguous chunk of the (batch x tasks) items
+    int64_t l_first = ( l_thread_id       * l_num_items ) / l_num_threads;
+    int64_t l_end   = ( (l_thread_id + 1) * l_num_items ) / l_num_threads;
+    for( int64_t l_it = l_first; l_it < l_end; l_it++ ){
+      int64_t l_ba      = l_it / m_num_tasks;
+      int64_t l_id_task = l_it % m_num_tasks;
+
+      contract_task( &l_tasks[l_id_task],
+                     l_thread_id,
+                     m_constant_left.active  ? l_tensor_left  : i_tensors_left[l_ba],
+                     m_constant_right.active ? l_tensor_right : i_tensors_right[l_ba],
+                     i_tensors_out_aux != nullptr ? i_tensors_out_aux[l_ba] : nullptr,
+                     io_tensors_out[l_ba] );
+    }
+  } );
+}
+
+void einsum_ir::basic::ContractionBackend::contract_task( thread_info * io_task,
+                                                          int64_t       i_id_thread,
+                                                          void  const * i_tensor_left,
+                                                          void  const * i_tensor_right,
+                                                          void  const * i_tensor_out_aux,
+                                                          void        * io_tensor_out ) {
+  thread_info * l_thread_inf = io_task;
+  bool l_packing = m_size_packing_left || m_size_packing_right;
+
+  //get packing memory
+  if( l_packing ){
+    l_thread_inf->memory_left  = m_memory->get_thread_memory( i_id_thread );
+    l_thread_inf->memory_right = l_thread_inf->memory_left + m_size_packing_left * m_num_cached_ptrs_left;
+
+    //the cache belongs to the memory of the executing thread
+    l_thread_inf->cached_ptrs_left.swap(  m_thread_cached_ptrs_left[i_id_thread]  );
+    l_thread_inf->cached_ptrs_right.swap( m_thread_cached_ptrs_right[i_id_thread] );
+  }
+
+  //get private output memory
+  if( m_size_memory_out > 0 ){
+    l_thread_inf->memory_out  = m_memory->get_thread_memory( i_id_thread ) + m_offset_memory_out;
+    l_thread_inf->tensor_out  = (char *) io_tensor_out;
+    l_thread_inf->touched_out = m_split_touched[i_id_thread].data();
+  }
+
+  //add thread offset
+  char * l_tensor_left    = (char *) i_tensor_left    + l_thread_inf->offset_left;
+  char * l_tensor_right   = (char *) i_tensor_right   + l_thread_inf->offset_right;
+  char * l_tensor_out_aux = (char *) i_tensor_out_aux + l_thread_inf->offset_out_aux;
+  char * l_tensor_out     = (char *) io_tensor_out    + l_thread_inf->offset_out;
+
+
+  //pack left tensor
+  if( m_packing_left_id == 0)  {
+    m_unary_left.eval(l_tensor_left, l_thread_inf->memory_left);
+    l_tensor_left = l_thread_inf->memory_left;
+  }
+
+  //pack right tensor
+  if( m_packing_right_id == 0 )  {
+    m_unary_right.eval(l_tensor_right, l_thread_inf->memory_right);
+    l_tensor_right = l_thread_inf->memory_right;
+  }
+
+  //contract
+  (this->*(m_loop_functs[0]))( l_thread_inf,
+                               0,
+                               l_tensor_left,
+                               l_tensor_right,
+                               l_tensor_out_aux,
+                               l_tensor_out,
+                               m_has_first_touch,
+                               m_has_last_touch && m_num_split_k_loops == 0 );
+
+  //return the cache to the executing thread
+  if( l_packing ){
+    l_thread_inf->cached_ptrs_left.swap(  m_thread_cached_ptrs_left[i_id_thread]  );
+    l_thread_inf->cached_ptrs_right.swap( m_thread_cached_ptrs_right[i_id_thread] );
   }
 }
 
@@ -366,24 +1270,34 @@ void einsum_ir::basic::ContractionBackend::contract_iter_shared( thread_info   *
   int64_t l_id_next_loop = i_id_loop + m_num_shared_loops;
   int64_t l_start = i_thread_info->id_shared_loop_start;
   int64_t l_end   = i_thread_info->id_shared_loop_end;
+  int64_t * l_counters = i_thread_info->shared_counters.data();
+
+  //derive the iterations of the individual loops for the first task
+  int64_t l_it_all_loops = l_start;
+  for( int64_t l_loop = m_num_shared_loops - 1; l_loop >= 0; l_loop-- ) {
+    l_counters[l_loop] = l_it_all_loops % m_dim_sizes[i_id_loop + l_loop];
+    l_it_all_loops     = l_it_all_loops / m_dim_sizes[i_id_loop + l_loop];
+
+    i_ptr_left    += l_counters[l_loop] * m_strides_left[    i_id_loop + l_loop ];
+    i_ptr_right   += l_counters[l_loop] * m_strides_right[   i_id_loop + l_loop ];
+    i_ptr_out_aux += l_counters[l_loop] * m_strides_out_aux[ i_id_loop + l_loop ];
+    i_ptr_out     += l_counters[l_loop] * m_strides_out[     i_id_loop + l_loop ];
+  }
+
   for( int64_t l_it = l_start; l_it < l_end; l_it++ ) {
 
     char const * l_ptr_left    = i_ptr_left;
     char const * l_ptr_right   = i_ptr_right;
     char const * l_ptr_out_aux = i_ptr_out_aux;
     char       * l_ptr_out     = i_ptr_out;
+    bool l_first_access = i_first_access;
 
-    int64_t l_it_all_loops   = l_it;
-    int64_t l_it_single_loop = 0;
-    for( int64_t l_loop = i_id_loop + m_num_shared_loops - 1; l_loop >= i_id_loop; l_loop-- ) {
-      l_it_single_loop = l_it_all_loops % m_dim_sizes[l_loop];
-      l_it_all_loops   = l_it_all_loops / m_dim_sizes[l_loop];
-
-      //update pointer
-      l_ptr_left    = l_ptr_left    + l_it_single_loop * m_strides_left[    l_loop ];
-      l_ptr_right   = l_ptr_right   + l_it_single_loop * m_strides_right[   l_loop ];
-      l_ptr_out_aux = l_ptr_out_aux + l_it_single_loop * m_strides_out_aux[ l_loop ];
-      l_ptr_out     = l_ptr_out     + l_it_single_loop * m_strides_out[     l_loop ];
+    //all but the first iteration of the parallel k loops accumulate in private memory
+    if( l_it >= m_num_tasks_first_split ){
+      touch_split_tile( i_thread_info,
+                        i_ptr_out );
+      l_ptr_out      = i_thread_info->memory_out + (i_ptr_out - i_thread_info->tensor_out);
+      l_first_access = false;
     }
 
     //pack left tensor
@@ -412,8 +1326,24 @@ void einsum_ir::basic::ContractionBackend::contract_iter_shared( thread_info   *
                                               l_ptr_right,
                                               l_ptr_out_aux,
                                               l_ptr_out,
-                                              i_first_access,
+                                              l_first_access,
                                               i_last_access );
+
+    //advance to the next task
+    int64_t l_loop = m_num_shared_loops - 1;
+    while( l_loop > 0 && ++l_counters[l_loop] == m_dim_sizes[i_id_loop + l_loop] ) {
+      l_counters[l_loop] = 0;
+      l_loop--;
+    }
+    if( l_loop == 0 ) {
+      l_counters[0]++;
+    }
+
+    //update pointer
+    i_ptr_left    += m_shared_incs.left[    l_loop ];
+    i_ptr_right   += m_shared_incs.right[   l_loop ];
+    i_ptr_out_aux += m_shared_incs.out_aux[ l_loop ];
+    i_ptr_out     += m_shared_incs.out[     l_loop ];
   }
 }
 
@@ -453,6 +1383,14 @@ void einsum_ir::basic::ContractionBackend::contract_iter_sfc( thread_info   * i_
     l_direction  = 1 - ( (int64_t)l_sign << 1); 
     l_current_id = l_move >> 1;
 
+    //prefetch blocks of the next step
+    if( m_prefetch == prefetch_t::SFC_PREFETCH && l_it + 1 < l_size ){
+      prefetch_sfc_step( m_sfc_moves[l_move],
+                         i_ptr_left,
+                         i_ptr_right,
+                         i_ptr_out );
+    }
+
     //pack left tensor
     const char * l_ptr_left_active = i_ptr_left;
     if( m_packing_left_id == l_id_next_loop )  {
@@ -498,6 +1436,307 @@ void einsum_ir::basic::ContractionBackend::contract_iter_sfc( thread_info   * i_
 }
 
 
+void einsum_ir::basic::ContractionBackend::enter_flat_loop( thread_info           * i_thread_info,
+                                                            flat_loop_state const * i_state_outer,
+                                                            flat_loop_state       * io_state,
+                                                            int64_t                 i_id_loop,
+                                                            bool                    i_reset ) {
+  int64_t l_id_next_loop = i_id_loop + 1;
+
+  if( m_exec_type[i_id_loop] == exec_t::SEQ ) {
+    //update pointer
+    if( i_reset ) {
+      io_state->ptr_left    = i_state_outer->ptr_left_active;
+      io_state->ptr_right   = i_state_outer->ptr_right_active;
+      io_state->ptr_out_aux = i_state_outer->ptr_out_aux;
+      io_state->ptr_out     = i_state_outer->ptr_out;
+    }
+    else {
+      io_state->ptr_left    += m_strides_left[    i_id_loop ];
+      io_state->ptr_right   += m_strides_right[   i_id_loop ];
+      io_state->ptr_out_aux += m_strides_out_aux[ i_id_loop ];
+      io_state->ptr_out     += m_strides_out[     i_id_loop ];
+    }
+
+    //determine if this is the first or last access in the k dimension
+    bool l_non_k_loop = m_dim_type[i_id_loop] != dim_t::K;
+    io_state->first_access = i_state_outer->first_access && ( l_non_k_loop || io_state->counter == 0 );
+    io_state->last_access  = i_state_outer->last_access  && ( l_non_k_loop || io_state->counter == m_dim_sizes[i_id_loop] - 1 );
+
+    //pack left tensor
+    io_state->ptr_left_active = io_state->ptr_left;
+    if( m_packing_left_id == l_id_next_loop ) {
+      io_state->ptr_left_active = i_thread_info->memory_left;
+      m_unary_left.eval( io_state->ptr_left, i_thread_info->memory_left );
+    }
+
+    //pack right tensor
+    io_state->ptr_right_active = io_state->ptr_right;
+    if( m_packing_right_id == l_id_next_loop ) {
+      io_state->ptr_right_active = i_thread_info->memory_right;
+      m_unary_right.eval( io_state->ptr_right, i_thread_info->memory_right );
+    }
+  }
+  else {
+    l_id_next_loop = i_id_loop + m_num_sfc_loops;
+
+    //update pointer and position on the sfc
+    if( i_reset ) {
+      io_state->ptr_left    = i_state_outer->ptr_left_active;
+      io_state->ptr_right   = i_state_outer->ptr_right_active;
+      io_state->ptr_out_aux = i_state_outer->ptr_out_aux;
+      io_state->ptr_out     = i_state_outer->ptr_out;
+      io_state->id_sfc_m    = 0;
+      io_state->id_sfc_n    = 0;
+    }
+    else {
+      sfc_move_t const & l_move = m_sfc_moves[ i_thread_info->movement_ids[io_state->counter - 1] ];
+
+      io_state->id_sfc_m += l_move.id_sfc_m;
+      io_state->id_sfc_n += l_move.id_sfc_n;
+
+      io_state->ptr_left    += l_move.left;
+      io_state->ptr_right   += l_move.right;
+      io_state->ptr_out_aux += l_move.out_aux;
+      io_state->ptr_out     += l_move.out;
+    }
+
+    //determine if this is the first or last access in the k dimension
+    int32_t & l_k_count = i_thread_info->k_count[ io_state->id_sfc_m + io_state->id_sfc_n * i_thread_info->sfc_size_m ];
+    io_state->first_access = i_state_outer->first_access && ( l_k_count == 0 );
+    if( ++l_k_count == i_thread_info->sfc_size_k ) {
+      l_k_count = 0;
+    }
+    io_state->last_access  = i_state_outer->last_access  && ( l_k_count == 0 );
+
+    //pack left tensor
+    io_state->ptr_left_active = io_state->ptr_left;
+    if( m_packing_left_id == l_id_next_loop ) {
+      int64_t l_id = io_state->id_sfc_m % m_num_cached_ptrs_left;
+      io_state->ptr_left_active = i_thread_info->memory_left + l_id * m_size_packing_left;
+      if( io_state->ptr_left != i_thread_info->cached_ptrs_left[l_id] ) {
+        m_unary_left.eval( io_state->ptr_left, (void *) io_state->ptr_left_active );
+        i_thread_info->cached_ptrs_left[l_id] = io_state->ptr_left;
+      }
+    }
+
+    //pack right tensor
+    io_state->ptr_right_active = io_state->ptr_right;
+    if( m_packing_right_id == l_id_next_loop ) {
+      int64_t l_id = io_state->id_sfc_n % m_num_cached_ptrs_right;
+      io_state->ptr_right_active = i_thread_info->memory_right + l_id * m_size_packing_right;
+      if( io_state->ptr_right != i_thread_info->cached_ptrs_right[l_id] ) {
+        m_unary_right.eval( io_state->ptr_right, (void *) io_state->ptr_right_active );
+        i_thread_info->cached_ptrs_right[l_id] = io_state->ptr_right;
+      }
+    }
+  }
+}
+
+void einsum_ir::basic::ContractionBackend::contract_iter_flat( thread_info   * i_thread_info,
+                                                               int64_t         i_id_loop,
+                                                               char    const * i_ptr_left,
+                                                               char    const * i_ptr_right,
+                                                               char    const * i_ptr_out_aux,
+                                                               char          * i_ptr_out,
+                                                               bool            i_first_access,
+                                                               bool            i_last_access ) {
+  //only the first loop of the flat loop nest dispatches to the flat loop nest
+  assert( i_id_loop == m_flat_loop_ids[0] );
+  (void) i_id_loop;
+
+  int64_t l_num_loops = m_flat_loop_ids.size();
+  int64_t l_size_sfc  = i_thread_info->movement_ids.size();
+  if( m_num_sfc_loops > 0 && l_size_sfc == 0 ) {
+    return;
+  }
+
+  //state 0 holds the input of the flat loop nest, state l+1 belongs to loop l
+  flat_loop_state * l_states = i_thread_info->flat_states.data();
+  l_states[0].ptr_left_active  = i_ptr_left;
+  l_states[0].ptr_right_active = i_ptr_right;
+  l_states[0].ptr_out_aux      = i_ptr_out_aux;
+  l_states[0].ptr_out          = i_ptr_out;
+  l_states[0].first_access     = i_first_access;
+  l_states[0].last_access      = i_last_access;
+
+  for( int64_t l_loop = 1; l_loop < l_num_loops; l_loop++ ) {
+    l_states[l_loop].counter = 0;
+    enter_flat_loop( i_thread_info,
+                     l_states + l_loop - 1,
+                     l_states + l_loop,
+                     m_flat_loop_ids[l_loop - 1],
+                     true );
+  }
+
+  while( true ) {
+    contract_flat_inner( i_thread_info,
+                         l_states + l_num_loops - 1,
+                         m_flat_loop_ids[l_num_loops - 1] );
+
+    //find the innermost outer loop which is not finished
+    int64_t l_loop = l_num_loops - 1;
+    while( l_loop > 0 ) {
+      int64_t l_id_loop = m_flat_loop_ids[l_loop - 1];
+      int64_t l_size = m_exec_type[l_id_loop] == exec_t::SFC ? l_size_sfc : m_dim_sizes[l_id_loop];
+      if( ++l_states[l_loop].counter < l_size ) {
+        break;
+      }
+      l_loop--;
+    }
+    if( l_loop == 0 ) {
+      break;
+    }
+
+    //advance the loop and restart all inner loops
+    enter_flat_loop( i_thread_info,
+                     l_states + l_loop - 1,
+                     l_states + l_loop,
+                     m_flat_loop_ids[l_loop - 1],
+                     false );
+    for( int64_t l_inner = l_loop + 1; l_inner < l_num_loops; l_inner++ ) {
+      l_states[l_inner].counter = 0;
+      enter_flat_loop( i_thread_info,
+                       l_states + l_inner - 1,
+                       l_states + l_inner,
+                       m_flat_loop_ids[l_inner - 1],
+                       true );
+    }
+  }
+}
+
+void einsum_ir::basic::ContractionBackend::contract_flat_inner( thread_info           * i_thread_info,
+                                                                flat_loop_state const * i_state_outer,
+                                                                int64_t                 i_id_loop ) {
+  char const * l_ptr_left    = i_state_outer->ptr_left_active;
+  char const * l_ptr_right   = i_state_outer->ptr_right_active;
+  char const * l_ptr_out_aux = i_state_outer->ptr_out_aux;
+  char       * l_ptr_out     = i_state_outer->ptr_out;
+
+  if( m_exec_type[i_id_loop] == exec_t::SEQ ) {
+    int64_t l_size = m_dim_sizes[i_id_loop];
+    bool l_k_loop = m_dim_type[i_id_loop] == dim_t::K;
+    bool l_packing_left  = m_packing_left_id  == i_id_loop + 1;
+    bool l_packing_right = m_packing_right_id == i_id_loop + 1;
+
+    int64_t l_stride_left    = m_strides_left[    i_id_loop ];
+    int64_t l_stride_right   = m_strides_right[   i_id_loop ];
+    int64_t l_stride_out_aux = m_strides_out_aux[ i_id_loop ];
+    int64_t l_stride_out     = m_strides_out[     i_id_loop ];
+
+    for( int64_t l_it = 0; l_it < l_size; l_it++ ) {
+      bool l_first_access = i_state_outer->first_access && ( !l_k_loop || l_it == 0 );
+      bool l_last_access  = i_state_outer->last_access  && ( !l_k_loop || l_it == l_size - 1 );
+
+      //pack left tensor
+      char const * l_ptr_left_active = l_ptr_left;
+      if( l_packing_left ) {
+        l_ptr_left_active = i_thread_info->memory_left;
+        m_unary_left.eval( l_ptr_left, i_thread_info->memory_left );
+      }
+
+      //pack right tensor
+      char const * l_ptr_right_active = l_ptr_right;
+      if( l_packing_right ) {
+        l_ptr_right_active = i_thread_info->memory_right;
+        m_unary_right.eval( l_ptr_right, i_thread_info->memory_right );
+      }
+
+      if( l_first_access ) {
+        kernel_first_touch( l_ptr_out_aux,
+                            l_ptr_out );
+      }
+      kernel_main( l_ptr_left_active,
+                   l_ptr_right_active,
+                   l_ptr_out );
+      if( l_last_access ) {
+        kernel_last_touch( l_ptr_out_aux,
+                           l_ptr_out );
+      }
+
+      //update pointer
+      l_ptr_left    += l_stride_left;
+      l_ptr_right   += l_stride_right;
+      l_ptr_out_aux += l_stride_out_aux;
+      l_ptr_out     += l_stride_out;
+    }
+  }
+  else {
+    int64_t l_size = i_thread_info->movement_ids.size();
+    bool l_packing_left  = m_packing_left_id  == i_id_loop + m_num_sfc_loops;
+    bool l_packing_right = m_packing_right_id == i_id_loop + m_num_sfc_loops;
+    bool l_prefetch      = m_prefetch == prefetch_t::SFC_PREFETCH;
+
+    sfc_t   const * l_movement_ids = i_thread_info->movement_ids.data();
+    int32_t       * l_k_counts     = i_thread_info->k_count.data();
+    int64_t l_sfc_size_m = i_thread_info->sfc_size_m;
+    int32_t l_sfc_size_k = i_thread_info->sfc_size_k;
+
+    int64_t l_id_m = 0;
+    int64_t l_id_n = 0;
+    for( int64_t l_it = 0; l_it < l_size; l_it++ ) {
+      //determine if this is the first or last access in the k dimension
+      int32_t & l_k_count = l_k_counts[ l_id_m + l_id_n * l_sfc_size_m ];
+      bool l_first_access = i_state_outer->first_access && ( l_k_count == 0 );
+      if( ++l_k_count == l_sfc_size_k ) {
+        l_k_count = 0;
+      }
+      bool l_last_access  = i_state_outer->last_access  && ( l_k_count == 0 );
+
+      //prefetch blocks of the next step
+      sfc_move_t const & l_move = m_sfc_moves[ l_movement_ids[l_it] ];
+      if( l_prefetch && l_it + 1 < l_size ) {
+        prefetch_sfc_step( l_move,
+                           l_ptr_left,
+                           l_ptr_right,
+                           l_ptr_out );
+      }
+
+      //pack left tensor
+      char const * l_ptr_left_active = l_ptr_left;
+      if( l_packing_left ) {
+        int64_t l_id = l_id_m % m_num_cached_ptrs_left;
+        l_ptr_left_active = i_thread_info->memory_left + l_id * m_size_packing_left;
+        if( l_ptr_left != i_thread_info->cached_ptrs_left[l_id] ) {
+          m_unary_left.eval( l_ptr_left, (void *) l_ptr_left_active );
+          i_thread_info->cached_ptrs_left[l_id] = l_ptr_left;
+        }
+      }
+
+      //pack right tensor
+      char const * l_ptr_right_active = l_ptr_right;
+      if( l_packing_right ) {
+        int64_t l_id = l_id_n % m_num_cached_ptrs_right;
+        l_ptr_right_active = i_thread_info->memory_right + l_id * m_size_packing_right;
+        if( l_ptr_right != i_thread_info->cached_ptrs_right[l_id] ) {
+          m_unary_right.eval( l_ptr_right, (void *) l_ptr_right_active );
+          i_thread_info->cached_ptrs_right[l_id] = l_ptr_right;
+        }
+      }
+
+      if( l_first_access ) {
+        kernel_first_touch( l_ptr_out_aux,
+                            l_ptr_out );
+      }
+      kernel_main( l_ptr_left_active,
+                   l_ptr_right_active,
+                   l_ptr_out );
+      if( l_last_access ) {
+        kernel_last_touch( l_ptr_out_aux,
+                           l_ptr_out );
+      }
+
+      //move along the sfc
+      l_id_m        += l_move.id_sfc_m;
+      l_id_n        += l_move.id_sfc_n;
+      l_ptr_left    += l_move.left;
+      l_ptr_right   += l_move.right;
+      l_ptr_out_aux += l_move.out_aux;
+      l_ptr_out     += l_move.out;
+    }
+  }
+}
+
 void einsum_ir::basic::ContractionBackend::contract_iter_kernel( thread_info   * i_thread_info,
                                                                  int64_t         i_id_loop,
                                                                  char    const * i_ptr_left,
@@ -535,6 +1774,7 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackend::set_kernel_shape(
   if(    ( m_ktype_main == kernel_t::MADD            && l_num_prims != 3 )
       || ( m_ktype_main == kernel_t::BR_MADD         && l_num_prims != 4 )
       || ( m_ktype_main == kernel_t::CPX_MADD        && l_num_prims != 4 )
+      || ( m_ktype_main == kernel_t::CPX_MADD_3M     && l_num_prims != 4 )
       || ( m_ktype_main == kernel_t::PACKED_MADD     && l_num_prims != 4 )
       || ( m_ktype_main == kernel_t::CPX_PACKED_MADD && l_num_prims != 5 ) ){
     return err_t::COMPILATION_FAILED; 
@@ -554,7 +1794,7 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackend::set_kernel_shape(
       && m_dim_type[l_size-4] != dim_t::C ){
       return err_t::COMPILATION_FAILED; 
   }
-  if(    m_ktype_main == kernel_t::CPX_MADD 
+  if(    ( m_ktype_main == kernel_t::CPX_MADD || m_ktype_main == kernel_t::CPX_MADD_3M )
       && m_dim_type[l_size-4] != dim_t::CPX ){
       return err_t::COMPILATION_FAILED; 
   }
@@ -669,6 +1909,7 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackend::set_kernel_shape(
   //set complex parameter
   int64_t l_id_cpx = -1;
   l_id_cpx = (m_ktype_main == kernel_t::CPX_MADD       ) ? l_size - 4 : l_id_cpx;
+  l_id_cpx = (m_ktype_main == kernel_t::CPX_MADD_3M    ) ? l_size - 4 : l_id_cpx;
   l_id_cpx = (m_ktype_main == kernel_t::CPX_PACKED_MADD) ? l_size - 5 : l_id_cpx;
   if( l_id_cpx >= 0){
     if( m_dim_sizes[l_id_cpx] != 2 ){
@@ -676,7 +1917,7 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackend::set_kernel_shape(
     }
     m_cpx_stride_in_left_bytes  = m_strides_left[   l_id_cpx] * ce_n_bytes(m_dtype_left );
     m_cpx_stride_in_right_bytes = m_strides_right[  l_id_cpx] * ce_n_bytes(m_dtype_right);
-    m_cpx_stride_out_aux_bytes  = m_strides_out_aux[l_id_cpx] * ce_n_bytes(m_dtype_out  );
+    m_cpx_stride_out_aux_bytes  = m_strides_out_aux[l_id_cpx] * ce_n_bytes(ce_dtype_out_aux(m_dtype_out));
     m_cpx_stride_out_bytes      = m_strides_out[    l_id_cpx] * ce_n_bytes(m_dtype_out  );
   }
 
@@ -687,7 +1928,8 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackend::create_packing( in
                                                                               int64_t              & o_size_packing,
                                                                               UnaryBackendTpp      & o_unary,
                                                                               std::vector<int64_t> & i_strides,
-                                                                              std::vector<int64_t> & i_packing_strides ){
+                                                                              std::vector<int64_t> & i_packing_strides,
+                                                                              data_t                 i_dtype ){
   //determine size of and iteration id of packing
   o_packing_id = -1;
   for( std::size_t l_id = 0; l_id < i_packing_strides.size(); l_id++ ) {
@@ -733,7 +1975,7 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackend::create_packing( in
     }
 
     //init and compile kernel
-    o_unary.init(l_packing_iters, m_dtype_left, m_dtype_comp, m_dtype_out, kernel_t::COPY, 1);
+    o_unary.init(l_packing_iters, i_dtype, m_dtype_comp, i_dtype, kernel_t::COPY, 1);
     l_err = o_unary.compile();
     if( l_err != err_t::SUCCESS ) {
       return l_err;
@@ -1,6 +1,8 @@
 #ifndef EINSUM_IR_BASIC_BINARY_CONTRACTION_BACKEND
 #define EINSUM_IR_BASIC_BINARY_CONTRACTION_BACKEND
 
+#include <atomic>
+#include <future>
 #include <vector>
 
 #include "../constants.h"
@@ -17,6 +19,48 @@ namespace einsum_ir {
 
 class einsum_ir::basic::ContractionBackend {
   private:
+    struct loop_incs_t {
+      std::vector< int64_t > left;
+      std::vector< int64_t > right;
+      std::vector< int64_t > out_aux;
+      std::vector< int64_t > out;
+    };
+
+    struct sfc_move_t {
+      int64_t left     = 0;
+      int64_t right    = 0;
+      int64_t out_aux  = 0;
+      int64_t out      = 0;
+      int64_t id_sfc_m = 0;
+      int64_t id_sfc_n = 0;
+    };
+
+    struct constant_input_t {
+      //! true if the input is constant
+      bool enabled = false;
+      //! true if the packed layout of the input is used
+      bool active = false;
+      //! true if the packed data is valid
+      bool packed = false;
+      //! sizes of the loops outside of the packed panels
+      std::vector< int64_t > sizes;
+      //! strides of these loops in the unpacked input in bytes
+      std::vector< int64_t > strides_unpacked;
+      //! strides of these loops in the packed input in bytes
+      std::vector< int64_t > strides_packed;
+      //! size of a packed panel in bytes
+      int64_t size_panel = 0;
+      //! memory of the packed input including alignment
+      std::vector< char > memory;
+      //! packed input
+      char * data = nullptr;
+    };
+
+    struct alignas(64) task_queue_t {
+      //! packed range of unclaimed tasks: first task in the upper, end of the tasks in the lower 32 bits
+      std::atomic< int64_t > range;
+    };
+
     //! Iteration Space for parallel execution
     IterationSpace m_iter;
 
@@ -32,9 +76,18 @@ class einsum_ir::basic::ContractionBackend {
     //! number of shared loops
     int64_t m_num_shared_loops = 0;
 
+    //! number of parallel k loops, which are the outermost shared loops
+    int64_t m_num_split_k_loops = 0;
+
+    //! number of shared tasks in the first iteration of the parallel k loops
+    int64_t m_num_tasks_first_split = 0;
+
     //! number of threads used for execution
     int64_t m_num_threads = 0;
 
+    //! number of tasks, equals the number of threads for static scheduling
+    int64_t m_num_tasks = 0;
+
     //! number of threads used for sfc m dimension
     int64_t m_num_threads_sfc_m = 0;
     //! number of threads used for sfc n dimension
@@ -81,6 +134,300 @@ class einsum_ir::basic::ContractionBackend {
     //! number of cached pointers for right input tensor
     int64_t m_num_cached_ptrs_right = 1;
 
+    //! true if the contraction adds to the existing output
+    bool m_accumulate = false;
+
+    //! constant left input
+    constant_input_t m_constant_left;
+
+    //! constant right input
+    constant_input_t m_constant_right;
+
+    //! size of the private output memory of a thread, used for accumulation in parallel k loops.
+    //! every thread holds a full copy of the output tensor, i.e., the bound is #threads x size of the output tensor
+    int64_t m_size_memory_out = 0;
+
+    //! offset of the private output memory in the thread memory
+    int64_t m_offset_memory_out = 0;
+
+    //! offsets of the output blocks reduced after the contraction with parallel k loops
+    std::vector< int64_t > m_split_offsets_out;
+
+    //! offsets of the auxiliary output blocks used by the last touch after the reduction
+    std::vector< int64_t > m_split_offsets_out_aux;
+
+    //! sorted offsets of the output tiles, a tile covers the output blocks of one iteration of the loops up to the shared loops
+    std::vector< int64_t > m_split_tile_offsets_out;
+
+    //! number of output blocks in a tile
+    int64_t m_num_split_blocks_tile = 0;
+
+    //! tiles in which a thread accumulated during the current contraction, one flag per thread and tile
+    std::vector< std::vector< uint8_t > > m_split_touched;
+
+    //! unary backend adding a block of private output memory to the output tensor
+    UnaryBackendTpp m_unary_reduce;
+
+    //! unary backend zeroing a block of private output memory before a thread first accumulates in it
+    UnaryBackendTpp m_unary_zero;
+
+    //! type of the loop nest used for contraction, set by set_loop_nest
+    loop_nest_t m_loop_nest = loop_nest_t::RECURSIVE;
+
+    //! pointer increments of the shared loops, applied if the respective loop is advanced
+    loop_incs_t m_shared_incs;
+
+    //! type of the scheduling of tasks to threads, set by set_sched
+    sched_t m_sched = sched_t::STATIC;
+
+    //! targeted number of tasks per thread for dynamic scheduling
+    int64_t m_num_tasks_per_thread = 4;
+
+    //! ids of the non-empty tasks, the tasks owned by a thread are consecutive
+    std::vector< int64_t > m_task_ids;
+
+    //! offsets of the threads' tasks in m_task_ids
+    std::vector< int64_t > m_task_offsets;
+
+    //! task queues of the threads for dynamic scheduling
+    std::vector< task_queue_t > m_task_queues;
+
+    //! cached pointers of the threads' left packing memory
+    std::vector< std::vector< char const * > > m_thread_cached_ptrs_left;
+
+    //! cached pointers of the threads' right packing memory
+    std::vector< std::vector< char const * > > m_thread_cached_ptrs_right;
+
+    //! private copies of the tasks' thread infos for every thread of batched contractions
+    std::vector< std::vector< thread_info > > m_batch_thread_infos;
+
+    //! ids of the loops in the flat loop nest, sfc loops are represented by the first sfc loop
+    std::vector< int64_t > m_flat_loop_ids;
+
+    //! pointer increments and sfc id changes of all sfc movements, indexed by the movement id
+    std::vector< sfc_move_t > m_sfc_moves;
+
+    //! type of the software prefetching
+    prefetch_t m_prefetch = prefetch_t::NO_PREFETCH;
+
+    //! type of the software prefetching requested by set_prefetch
+    prefetch_t m_prefetch_requested = prefetch_t::NO_PREFETCH;
+
+    //! primitive loops of the compiled kernels, strides in elements
+    std::vector< iter_property > m_iters_prim;
+
+    //! thread memory reserved in an external memory manager
+    int64_t m_reserved_thread_memory = 0;
+
+    //! number of threads for which external thread memory was reserved, bounds the threads of batched contractions
+    int64_t m_reserved_num_threads = 0;
+
+    //! offsets of the cache lines of a kernel's left block
+    std::vector< int64_t > m_prefetch_offsets_left;
+
+    //! offsets of the cache lines of a kernel's right block
+    std::vector< int64_t > m_prefetch_offsets_right;
+
+    //! offsets of the cache lines of a kernel's output block
+    std::vector< int64_t > m_prefetch_offsets_out;
+
+    /**
+     * Compiles everything of the contraction which depends on the non-primitive loops:
+     * thread partitioning, packing, split-k reduction, iteration spaces and loop nest.
+     *
+     * @return SUCCESS if the compilation was successful, otherwise an appropiate error code.
+     **/
+    err_t compile_loops();
+
+    /**
+     * Splits the parallel dimensions into tasks and assigns the tasks to the owning threads.
+     * For dynamic scheduling every thread owns multiple neighboring tasks.
+     *
+     * @param i_size_shared number of iterations of the shared loops.
+     * @param i_size_sfc_m number of iterations of the sfc m loops.
+     * @param i_size_sfc_n number of iterations of the sfc n loops.
+     * @param o_num_tasks_shared will be set to the number of tasks in the shared dimensions.
+     * @param o_num_tasks_sfc_m will be set to the number of tasks in the sfc m dimension.
+     * @param o_num_tasks_sfc_n will be set to the number of tasks in the sfc n dimension.
+     **/
+    void split_tasks( int64_t   i_size_shared,
+                      int64_t   i_size_sfc_m,
+                      int64_t   i_size_sfc_n,
+                      int64_t & o_num_tasks_shared,
+                      int64_t & o_num_tasks_sfc_m,
+                      int64_t & o_num_tasks_sfc_n );
+
+    /**
+     * Derives the owners of the tasks after the tasks were set up by the iteration space.
+     *
+     * @param i_num_tasks_shared number of tasks in the shared dimensions.
+     * @param i_num_tasks_sfc_m number of tasks in the sfc m dimension.
+     * @param i_num_tasks_sfc_n number of tasks in the sfc n dimension.
+     **/
+    void assign_tasks( int64_t i_num_tasks_shared,
+                       int64_t i_num_tasks_sfc_m,
+                       int64_t i_num_tasks_sfc_n );
+
+    /**
+     * Claims a task from the queue of a thread.
+     * The owning thread claims tasks from the front, stealing threads from the back of the queue.
+     *
+     * @param i_id_queue id of the queue.
+     * @param i_front true if the task is claimed from the front, false if from the back.
+     * @param o_id_task will be set to the id of the claimed task.
+     *
+     * @return true if a task was claimed, false if the queue is empty.
+     **/
+    bool claim_task( int64_t   i_id_queue,
+                     bool      i_front,
+                     int64_t & o_id_task );
+
+    /**
+     * Executes a task.
+     *
+     * @param io_task thread info of the task.
+     * @param i_id_thread id of the executing thread.
+     * @param i_tensor_left left tensor.
+     * @param i_tensor_right right tensor.
+     * @param i_tensor_out_aux auxiliary data w.r.t. output tensor.
+     * @param io_tensor_out output tensor.
+     **/
+    void contract_task( thread_info * io_task,
+                        int64_t       i_id_thread,
+                        void  const * i_tensor_left,
+                        void  const * i_tensor_right,
+                        void  const * i_tensor_out_aux,
+                        void        * io_tensor_out );
+
+    /**
+     * Creates the reduction of the private output memory for parallel k loops.
+     *
+     * @return SUCCESS if the reduction was created successfully, otherwise an appropiate error code.
+     **/
+    err_t create_split_k_reduction();
+
+    /**
+     * Zeroes the private output memory of a tile if the thread accumulates in it for the first time in the current contraction.
+     *
+     * @param io_thread_info thread info of the executed task.
+     * @param i_ptr_out pointer to the output tensor at the first element of the tile.
+     **/
+    void touch_split_tile( thread_info * io_thread_info,
+                           char  const * i_ptr_out );
+
+    /**
+     * Reduces the private output memory of the threads which accumulated in a tile into the output tensor and applies the last touch.
+     *
+     * @param i_tensor_out_aux auxiliary data w.r.t. output tensor.
+     * @param io_tensor_out output tensor.
+     **/
+    void reduce_split_k( void const * i_tensor_out_aux,
+                         void       * io_tensor_out );
+
+    /**
+     * Derives the pointer increments of consecutive loops.
+     * The increment of a loop is applied when the loop is advanced and all inner loops wrap around.
+     *
+     * @param i_id_first id of the first loop.
+     * @param i_id_end id after the last loop.
+     * @param i_strides strides of all loops.
+     * @param o_incs will be set to the pointer increments.
+     **/
+    void derive_loop_incs( int64_t                        i_id_first,
+                           int64_t                        i_id_end,
+                           std::vector< int64_t > const & i_strides,
+                           std::vector< int64_t >       & o_incs );
+
+    /**
+     * Derives the offsets of the cache lines which are touched by a kernel in one tensor.
+     *
+     * @param i_strides strides of all loops in bytes.
+     * @param i_num_bytes number of bytes per element of the tensor.
+     * @param o_offsets will be set to the offsets of the cache lines.
+     **/
+    void derive_prefetch_offsets( std::vector< int64_t > const & i_strides,
+                                  int64_t                        i_num_bytes,
+                                  std::vector< int64_t >       & o_offsets );
+
+    /**
+     * Prefetches the blocks of the next sfc step into the L2 cache.
+     * Only the blocks of tensors which change in the sfc movement are prefetched.
+     *
+     * @param i_move sfc movement from the current to the next step.
+     * @param i_ptr_left pointer to the left tensor's data of the current step.
+     * @param i_ptr_right pointer to the right tensor's data of the current step.
+     * @param i_ptr_out pointer to the output tensor's data of the current step.
+     **/
+    void prefetch_sfc_step( sfc_move_t const & i_move,
+                            char       const * i_ptr_left,
+                            char       const * i_ptr_right,
+                            char       const * i_ptr_out );
+
+    /**
+     * Sets up the packed layout of a constant input.
+     * The loops outside of the packing loop are laid out in the order of the loops with packed panels innermost.
+     * The loops' strides are replaced by the strides of the packed layout and the packing during contraction is disabled.
+     *
+     * @param io_constant constant input.
+     * @param io_packing_id id of the packing loop, set to -1 if the packed layout is used.
+     * @param io_size_packing size of a packed panel in bytes, set to 0 if the packed layout is used.
+     * @param io_strides strides of the input in elements.
+     * @param i_packing_strides packing strides of the input in elements.
+     * @param i_num_bytes number of bytes per element of the input.
+     **/
+    void setup_constant_input( constant_input_t             & io_constant,
+                               int64_t                      & io_packing_id,
+                               int64_t                      & io_size_packing,
+                               std::vector< int64_t >       & io_strides,
+                               std::vector< int64_t > const & i_packing_strides,
+                               int64_t                        i_num_bytes );
+
+    /**
+     * Gets the data of an input which is used by the contraction.
+     * A constant input is packed by the first call and the packed data is returned by all later calls.
+     *
+     * @param io_constant constant input.
+     * @param i_unary packing kernel of the input.
+     * @param i_tensor unpacked input.
+     *
+     * @return packed data if the input is constant, otherwise the unpacked input.
+     **/
+    void const * get_input( constant_input_t & io_constant,
+                            UnaryBackendTpp  & i_unary,
+                            void     const   * i_tensor );
+
+    /**
+     * Flattens the sequential and sfc loops between the shared and the primitive loops into a single loop nest.
+     **/
+    void compile_flat_loop_nest();
+
+    /**
+     * Enters an iteration of a loop in the flat loop nest.
+     * Updates the pointers and first/last access information, and packs the input tensors if required.
+     *
+     * @param i_thread_info information for the executing thread.
+     * @param i_state_outer state of the outer loop.
+     * @param io_state state of the entered loop.
+     * @param i_id_loop dimension id of the entered loop.
+     * @param i_reset true if the loop starts over, false if it is advanced.
+     **/
+    void enter_flat_loop( thread_info           * i_thread_info,
+                          flat_loop_state const * i_state_outer,
+                          flat_loop_state       * io_state,
+                          int64_t                 i_id_loop,
+                          bool                    i_reset );
+
+    /**
+     * Executes the innermost loop of the flat loop nest and calls the kernels.
+     *
+     * @param i_thread_info information for the executing thread.
+     * @param i_state_outer state of the outer loop.
+     * @param i_id_loop dimension id of the innermost loop.
+     **/
+    void contract_flat_inner( thread_info           * i_thread_info,
+                              flat_loop_state const * i_state_outer,
+                              int64_t                 i_id_loop );
+
   protected:
     //! datatype of the left input
     data_t m_dtype_left = UNDEFINED_DTYPE;
@@ -122,12 +469,16 @@ class einsum_ir::basic::ContractionBackend {
     //! vector with the packing strides of right tensor
     std::vector< int64_t > m_packing_strides_right;
 
-    //! type of the first touch kernel
+    //! type of the first touch kernel given in init
+    kernel_t m_ktype_first_touch_config = UNDEFINED_KTYPE;
+    //! type of the first touch kernel of the compiled contraction, derived from the configured one and the accumulate mode
     kernel_t m_ktype_first_touch = UNDEFINED_KTYPE;
     //! type of the main kernel
     kernel_t  m_ktype_main = UNDEFINED_KTYPE;
     //! type of the last touch kernel
     kernel_t m_ktype_last_touch = UNDEFINED_KTYPE;
+    //! chain of last touch operations, the first operation has type m_ktype_last_touch
+    std::vector< last_touch_op > m_last_touch_ops;
 
     //! kernel br size
     uint64_t m_br = 0;
@@ -188,6 +539,11 @@ class einsum_ir::basic::ContractionBackend {
                                               bool) > m_loop_functs;
     
   public:
+    /**
+     * Virtual destructor.
+     **/
+    virtual ~ContractionBackend(){};
+
     /**
      * Initializes the class.
      *
@@ -263,6 +619,67 @@ class einsum_ir::basic::ContractionBackend {
                int64_t                              i_num_threads_sfc_n,
                ContractionMemoryManager           * i_contraction_mem );
 
+    /**
+     * Sets a chain of last touch operations which replaces the last touch kernel given in init.
+     * The operations are applied in order to every block of the output tensor once the main kernels finished.
+     * Has to be called before compile.
+     *
+     * @param i_ops last touch operations.
+     **/
+    void set_last_touch_ops( std::vector< last_touch_op > const & i_ops );
+
+    /**
+     * Sets the accumulate mode in which the contraction adds to the existing output, i.e., out += left * right.
+     * The first touch kernel is dropped and the main kernels accumulate directly into the output (beta=1).
+     * Has to be called before compile.
+     *
+     * @param i_accumulate true if the contraction accumulates into the output.
+     **/
+    void set_accumulate( bool i_accumulate );
+
+    /**
+     * Marks inputs as constant, e.g., the weights in inference.
+     * A constant input with packing is packed once into the layout used by the primitives.
+     * All later contractions use the packed data and ignore the passed tensor until invalidate_constant_inputs is called.
+     * Has to be called before compile.
+     *
+     * @param i_constant_left true if the left input is constant.
+     * @param i_constant_right true if the right input is constant.
+     **/
+    void set_constant_inputs( bool i_constant_left,
+                              bool i_constant_right );
+
+    /**
+     * Sets the type of the loop nest used for contraction, the default are recursive loops.
+     * Has to be called before compile.
+     *
+     * @param i_loop_nest type of the loop nest.
+     **/
+    void set_loop_nest( loop_nest_t i_loop_nest );
+
+    /**
+     * Sets the scheduling of tasks to threads.
+     * Has to be called before compile.
+     *
+     * @param i_sched type of the scheduling.
+     **/
+    void set_sched( sched_t i_sched );
+
+    /**
+     * Sets the software prefetching.
+     * Prefetching is only applied if the kernels are called directly by sfc loops.
+     * Has to be called before compile.
+     *
+     * @param i_prefetch type of the software prefetching.
+     **/
+    void set_prefetch( prefetch_t i_prefetch );
+
+    /**
+     * Invalidates the packed data of the constant inputs, e.g., after the weights changed.
+     * The next contraction packs the constant inputs again.
+     **/
+    void invalidate_constant_inputs();
+
     /**
      * Compiles the contraction loop interface.
      *
@@ -270,6 +687,35 @@ class einsum_ir::basic::ContractionBackend {
      **/
     err_t compile();
 
+    /**
+     * Checks if the given loops have the primitive loops and main kernel of the compiled contraction.
+     *
+     * @param i_iterations loops.
+     * @param i_ktype_main type of the main kernel.
+     *
+     * @return true if the compiled kernels can be reused for the loops, false otherwise.
+     **/
+    bool primitives_match( std::vector< iter_property > const & i_iterations,
+                           kernel_t                             i_ktype_main ) const;
+
+    /**
+     * Binds new loops to a compiled contraction without generating new kernels.
+     * Only the non-primitive loops may change, e.g., the size of a batch dimension;
+     * the primitive loops have to match those of the compilation.
+     * The thread partitioning, packing and loop nest are recomputed.
+     *
+     * @param i_iterations new loops.
+     * @param i_num_threads_shared number of threads for the shared loops.
+     * @param i_num_threads_sfc_m number of threads for the sfc m loops.
+     * @param i_num_threads_sfc_n number of threads for the sfc n loops.
+     *
+     * @return SUCCESS if the loops were bound, COMPILATION_FAILED if the contraction requires new kernels.
+     **/
+    err_t rebind( std::vector< iter_property > const & i_iterations,
+                  int64_t                              i_num_threads_shared,
+                  int64_t                              i_num_threads_sfc_m,
+                  int64_t                              i_num_threads_sfc_n );
+
     /**
      * Contracts the two tensors.
      *
@@ -282,6 +728,40 @@ class einsum_ir::basic::ContractionBackend {
                    void const * i_tensor_right,
                    void const * i_tensor_out_aux,
                    void       * io_tensor_out );
+
+    /**
+     * Contracts a batch of tensor pairs in a single parallel region.
+     * The tasks of all contractions in the batch are distributed to the threads of the default execution context.
+     * Thread memory of threads beyond the compiled number of threads is reserved on first use.
+     *
+     * @param i_num_batch number of contractions in the batch.
+     * @param i_tensors_left left tensors.
+     * @param i_tensors_right right tensors.
+     * @param i_tensors_out_aux auxiliary data w.r.t. output tensors, nullptr if not required.
+     * @param io_tensors_out output tensors.
+     **/
+    void contract_batch( int64_t              i_num_batch,
+                         void const * const * i_tensors_left,
+                         void const * const * i_tensors_right,
+                         void const * const * i_tensors_out_aux,
+                         void       * const * io_tensors_out );
+
+    /**
+     * Enqueues the contraction of the two tensors on the default async executor.
+     * Asynchronous contractions and evaluations are executed one after another in submission order.
+     * The backend and the tensors must not be used or modified until the returned future is ready.
+     *
+     * @param i_tensor_left left tensor.
+     * @param i_tensor_right right tensor.
+     * @param i_tensor_out_aux auxiliary data w.r.t. output tensor.
+     * @param io_tensor_out output tensor.
+     *
+     * @return future which becomes ready once the contraction finished.
+     **/
+    std::future< void > contract_async( void const * i_tensor_left,
+                                        void const * i_tensor_right,
+                                        void const * i_tensor_out_aux,
+                                        void       * io_tensor_out );
     
     /**
      * General purpose loop implementation featuring first and last touch operations.
@@ -348,6 +828,28 @@ class einsum_ir::basic::ContractionBackend {
                             bool            i_first_access,
                             bool            i_last_access );
 
+    /**
+     * Flat loop implementation featuring first and last touch operations.
+     * Executes all sequential and sfc loops in front of the primitive loops iteratively and calls the kernels directly.
+     *
+     * @param i_thread_info information for the executing thread.
+     * @param i_id_loop dimension id of the first loop of the flat loop nest.
+     * @param i_ptr_left pointer to the left tensor's data.
+     * @param i_ptr_right pointer to the right tensor's data.
+     * @param i_ptr_out_aux pointer to the auxiliary output tensor's data.
+     * @param i_ptr_out pointer to the output tensor's data.
+     * @param i_first_access true if first time accessing this data
+     * @param i_last_access true if last time accessing this data
+     **/
+    void contract_iter_flat( thread_info   * i_thread_info,
+                             int64_t         i_id_loop,
+                             char    const * i_ptr_left,
+                             char    const * i_ptr_right,
+                             char    const * i_ptr_out_aux,
+                             char          * i_ptr_out,
+                             bool            i_first_access,
+                             bool            i_last_access );
+
     /**
      * Inner most loop implementation based on kernel call featuring first and last touch operations.
      *
@@ -384,6 +886,7 @@ class einsum_ir::basic::ContractionBackend {
      * @param o_unary compiled unary backend used for packing.
      * @param i_strides strides of the input tensor.
      * @param i_packing_strides strides of the packing tensor.
+     * @param i_dtype datatype of the packed tensor.
      *
      * @return SUCCESS if packing was created successfully, otherwise an appropiate error code.
      **/
@@ -391,7 +894,8 @@ class einsum_ir::basic::ContractionBackend {
                           int64_t              & o_size_packing,
                           UnaryBackendTpp      & o_unary,
                           std::vector<int64_t> & i_strides,
-                          std::vector<int64_t> & i_packing_strides );
+                          std::vector<int64_t> & i_packing_strides,
+                          data_t                 i_dtype );
 
     /**
      * Kernel applied to the output tensor before the main primitive touches the memory.
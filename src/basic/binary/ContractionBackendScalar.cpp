@@ -102,7 +102,10 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackendScalar::compile_kern
   }
 
   // last-touch kernel
-  if( m_ktype_last_touch == kernel_t::RELU ) {
+  if( m_last_touch_ops.size() > 1 ) {
+    return err_t::COMPILATION_FAILED;
+  }
+  else if( m_ktype_last_touch == kernel_t::RELU ) {
     if( l_dtype_all_fp32 ) {
       m_kernel_last_touch = &kernel_relu< float >;
     }
@@ -1,5 +1,11 @@
 #include "ContractionBackendTpp.h"
 
+#include <algorithm>
+#include <cmath>
+
+thread_local std::vector< int32_t > einsum_ir::basic::ContractionBackendTpp::s_acc;
+thread_local std::vector< char > einsum_ir::basic::ContractionBackendTpp::s_cpx_3m_scratch;
+
 libxsmm_datatype einsum_ir::basic::ContractionBackendTpp::dtype_to_libxsmm( data_t i_dtype ) {
   if( i_dtype == FP32 ) {
     return libxsmm_datatype::LIBXSMM_DATATYPE_F32;
@@ -7,6 +13,18 @@ libxsmm_datatype einsum_ir::basic::ContractionBackendTpp::dtype_to_libxsmm( data
   else if( i_dtype == FP64 ) {
     return libxsmm_datatype::LIBXSMM_DATATYPE_F64;
   }
+  else if( i_dtype == BF16 ) {
+    return libxsmm_datatype::LIBXSMM_DATATYPE_BF16;
+  }
+  else if( i_dtype == FP16 ) {
+    return libxsmm_datatype::LIBXSMM_DATATYPE_F16;
+  }
+  else if( i_dtype == INT8 ) {
+    return libxsmm_datatype::LIBXSMM_DATATYPE_I8;
+  }
+  else if( i_dtype == INT32 ) {
+    return libxsmm_datatype::LIBXSMM_DATATYPE_I32;
+  }
 
   return libxsmm_datatype::LIBXSMM_DATATYPE_UNSUPPORTED;
 }
@@ -14,7 +32,21 @@ libxsmm_datatype einsum_ir::basic::ContractionBackendTpp::dtype_to_libxsmm( data
 
 void einsum_ir::basic::ContractionBackendTpp::kernel_first_touch( void const * i_out_aux,
                                                                   void       * io_out ){
+  //the accumulator block is overwritten by the main kernel
+  if( m_requantize ) {
+    return;
+  }
 
+  kernel_first_touch_part( i_out_aux,
+                           io_out );
+  if( m_cpx ) {
+    kernel_first_touch_part( (char const *) i_out_aux + m_cpx_stride_out_aux_bytes,
+                             (char       *) io_out    + m_cpx_stride_out_bytes );
+  }
+}
+
+void einsum_ir::basic::ContractionBackendTpp::kernel_first_touch_part( void const * i_out_aux,
+                                                                       void       * io_out ){
   if( m_xmm_kernel_first_touch_unary != nullptr ) {
     libxsmm_meltw_unary_param l_param;
     l_param.in.primary  = (void *) i_out_aux;
@@ -33,35 +65,325 @@ void einsum_ir::basic::ContractionBackendTpp::kernel_first_touch( void const * i
 
 void einsum_ir::basic::ContractionBackendTpp::kernel_last_touch( void const * i_out_aux,
                                                                  void       * io_out ){
-  if( m_xmm_kernel_last_touch_unary != nullptr ) {
-    libxsmm_meltw_unary_param l_param;
-    l_param.in.primary = io_out;
-    l_param.out.primary = io_out;
-    m_xmm_kernel_last_touch_unary( &l_param );
+  if( m_requantize ) {
+    requantize( i_out_aux,
+                io_out );
+    return;
   }
-  else if( m_xmm_kernel_last_touch_binary != nullptr ) {
-    libxsmm_meltw_binary_param l_param;
-    l_param.in0.primary = (void *) io_out;
-    l_param.in1.primary = (void *) i_out_aux;
-    l_param.out.primary =          io_out;
-    m_xmm_kernel_last_touch_binary( &l_param );
+
+  kernel_last_touch_part( i_out_aux,
+                          io_out );
+  if( m_cpx ) {
+    kernel_last_touch_part( (char const *) i_out_aux + m_cpx_stride_out_aux_bytes,
+                            (char       *) io_out    + m_cpx_stride_out_bytes );
+  }
+}
+
+void einsum_ir::basic::ContractionBackendTpp::kernel_last_touch_part( void const * i_out_aux,
+                                                                      void       * io_out ){
+  for( std::size_t l_st = 0; l_st < m_last_touch_stages.size(); l_st++ ) {
+    last_touch_stage const & l_stage = m_last_touch_stages[l_st];
+
+    if( l_stage.unary != nullptr ) {
+      libxsmm_meltw_unary_param l_param;
+      l_param.in.primary = io_out;
+      l_param.out.primary = io_out;
+      l_stage.unary( &l_param );
+    }
+    else if( l_stage.binary != nullptr ) {
+      void const * l_in1 = i_out_aux;
+      if( !l_stage.aux ) {
+        l_in1 = m_dtype_out == FP64 ? (void const *) &l_stage.scalar_fp64 : (void const *) &l_stage.scalar_fp32;
+      }
+
+      libxsmm_meltw_binary_param l_param;
+      l_param.in0.primary = (void *) io_out;
+      l_param.in1.primary = (void *) l_in1;
+      l_param.out.primary =          io_out;
+      l_stage.binary( &l_param );
+    }
+    else if( l_stage.add_scaled ) {
+      if( m_dtype_out == FP64 ) {
+        add_scaled< double >( i_out_aux,
+                              l_stage.scalar_fp64,
+                              io_out );
+      }
+      else {
+        add_scaled< float >( i_out_aux,
+                             l_stage.scalar_fp32,
+                             io_out );
+      }
+    }
   }
 }
 
+template < typename T >
+void einsum_ir::basic::ContractionBackendTpp::add_scaled( void const * i_out_aux,
+                                                          T            i_scalar,
+                                                          void       * io_out ) {
+  T const * l_out_aux = (T const *) i_out_aux;
+  T       * l_out     = (T       *) io_out;
+
+  //packed kernels require the layout of the output tensor
+  int64_t l_stride_m_out_aux = m_r > 1 ? 1 : m_stride_m_out_aux;
+
+  for( int64_t l_n = 0; l_n < (int64_t) m_n; l_n++ ) {
+    for( int64_t l_m = 0; l_m < (int64_t) (m_m * m_r); l_m++ ) {
+      l_out[ l_n * m_ld_last_touch + l_m ] += i_scalar * l_out_aux[ l_n * m_stride_n_out_aux + l_m * l_stride_m_out_aux ];
+    }
+  }
+}
+
+
+void einsum_ir::basic::ContractionBackendTpp::requantize( void const * i_out_aux,
+                                                          void       * io_out ) {
+  float   const * l_scales = (float const *) i_out_aux;
+  int8_t        * l_out    = (int8_t       *) io_out;
+
+  for( int64_t l_n = 0; l_n < (int64_t) m_n; l_n++ ) {
+    for( int64_t l_m = 0; l_m < (int64_t) m_m; l_m++ ) {
+      float l_scale = m_requantize_scale;
+      if( m_requantize_per_channel ) {
+        l_scale *= l_scales[ l_n * m_stride_n_out_aux + l_m * m_stride_m_out_aux ];
+      }
+
+      float l_val = std::nearbyint( l_scale * (float) s_acc[ l_n * m_m + l_m ] ) + m_requantize_zero_point;
+      l_val = std::min( std::max( l_val, -128.0f ), 127.0f );
+
+      l_out[ l_n * m_ld_last_touch + l_m ] = (int8_t) l_val;
+    }
+  }
+}
+
+void einsum_ir::basic::ContractionBackendTpp::kernel_main_cpx_3m( void const * i_left,
+                                                                  void const * i_right,
+                                                                  void       * io_out ){
+  if( s_cpx_3m_scratch.size() < (std::size_t) m_cpx_3m_size_scratch ) {
+    s_cpx_3m_scratch.resize( m_cpx_3m_size_scratch );
+  }
+  char * l_sum_left  = s_cpx_3m_scratch.data();
+  char * l_sum_right = l_sum_left + m_cpx_3m_offset_sum_right;
+  char * l_prod_real = l_sum_left + m_cpx_3m_offset_prod_real;
+  char * l_prod_imag = l_sum_left + m_cpx_3m_offset_prod_imag;
+
+  char const * l_left_imag  = (char const *) i_left  + m_cpx_stride_in_left_bytes;
+  char const * l_right_imag = (char const *) i_right + m_cpx_stride_in_right_bytes;
+  char       * l_out_imag   = (char       *) io_out  + m_cpx_stride_out_bytes;
+
+  // Ar+Ai and Br+Bi
+  libxsmm_meltw_binary_param l_param_sum;
+  l_param_sum.in0.primary = (void *) i_left;
+  l_param_sum.in1.primary = (void *) l_left_imag;
+  l_param_sum.out.primary =          l_sum_left;
+  m_xmm_kernel_cpx_3m_sum_left( &l_param_sum );
+
+  l_param_sum.in0.primary = (void *) i_right;
+  l_param_sum.in1.primary = (void *) l_right_imag;
+  l_param_sum.out.primary =          l_sum_right;
+  m_xmm_kernel_cpx_3m_sum_right( &l_param_sum );
+
+  // imag += (Ar+Ai)(Br+Bi)
+  libxsmm_gemm_param l_param;
+  l_param.a.primary = l_sum_left;
+  l_param.b.primary = l_sum_right;
+  l_param.c.primary = l_out_imag;
+  l_param.op.tertiary = &m_br;
+  m_xmm_kernel_main( &l_param );
+
+  // ArBr and AiBi
+  l_param.a.primary = (void *) i_left;
+  l_param.b.primary = (void *) i_right;
+  l_param.c.primary =          l_prod_real;
+  m_xmm_kernel_cpx_3m_prod( &l_param );
+
+  l_param.a.primary = (void *) l_left_imag;
+  l_param.b.primary = (void *) l_right_imag;
+  l_param.c.primary =          l_prod_imag;
+  m_xmm_kernel_cpx_3m_prod( &l_param );
+
+  // real += ArBr - AiBi, imag -= ArBr + AiBi
+  libxsmm_meltw_binary_param l_param_comb;
+  l_param_comb.in0.primary = io_out;
+  l_param_comb.out.primary = io_out;
+  l_param_comb.in1.primary = l_prod_real;
+  m_xmm_kernel_cpx_3m_add( &l_param_comb );
+  l_param_comb.in1.primary = l_prod_imag;
+  m_xmm_kernel_cpx_3m_sub( &l_param_comb );
+
+  l_param_comb.in0.primary = l_out_imag;
+  l_param_comb.out.primary = l_out_imag;
+  m_xmm_kernel_cpx_3m_sub( &l_param_comb );
+  l_param_comb.in1.primary = l_prod_real;
+  m_xmm_kernel_cpx_3m_sub( &l_param_comb );
+}
 
 void einsum_ir::basic::ContractionBackendTpp::kernel_main( void const * i_left,
                                                            void const * i_right,
                                                            void       * io_out ){
+  if( m_cpx_3m ) {
+    kernel_main_cpx_3m( i_left,
+                        i_right,
+                        io_out );
+    return;
+  }
+
+  void * l_out = io_out;
+  if( m_requantize ) {
+    if( s_acc.size() < m_m * m_n ) {
+      s_acc.resize( m_m * m_n );
+    }
+    l_out = s_acc.data();
+  }
+
   libxsmm_gemm_param l_param;
   l_param.a.primary = (void *) i_left;
   l_param.b.primary = (void *) i_right;
-  l_param.c.primary =          io_out;
+  l_param.c.primary =          l_out;
   l_param.op.tertiary = &m_br;
 
   m_xmm_kernel_main( &l_param );
+
+  if( m_cpx ) {
+    char const * l_left_imag  = (char const *) i_left  + m_cpx_stride_in_left_bytes;
+    char const * l_right_imag = (char const *) i_right + m_cpx_stride_in_right_bytes;
+    char       * l_out_imag   = (char       *) l_out   + m_cpx_stride_out_bytes;
+
+    // imag += real * imag
+    l_param.b.primary = (void *) l_right_imag;
+    l_param.c.primary = (void *) l_out_imag;
+    m_xmm_kernel_main( &l_param );
+
+    // imag += imag * real
+    l_param.a.primary = (void *) l_left_imag;
+    l_param.b.primary = (void *) i_right;
+    m_xmm_kernel_main( &l_param );
+
+    // real -= imag * imag, the kernels only accumulate: real = -( -real + imag * imag )
+    libxsmm_meltw_unary_param l_param_negate;
+    l_param_negate.in.primary  = l_out;
+    l_param_negate.out.primary = l_out;
+    m_xmm_kernel_negate( &l_param_negate );
+
+    l_param.b.primary = (void *) l_right_imag;
+    l_param.c.primary =          l_out;
+    m_xmm_kernel_main( &l_param );
+
+    m_xmm_kernel_negate( &l_param_negate );
+  }
 }
 
 
+einsum_ir::basic::err_t einsum_ir::basic::ContractionBackendTpp::compile_last_touch( libxsmm_datatype i_xmm_dtype_out,
+                                                                                     libxsmm_datatype i_xmm_dtype_touch,
+                                                                                     libxsmm_bitfield i_flag_out_aux_binary ) {
+  m_last_touch_stages.clear();
+  m_ld_last_touch = m_ldc;
+
+  //requantization is the only last-touch operation of int8 outputs
+  if( m_requantize ) {
+    return err_t::SUCCESS;
+  }
+
+  libxsmm_meltw_unary_shape l_shape_unary = libxsmm_create_meltw_unary_shape( m_m * m_r,
+                                                                              m_n,
+                                                                              m_ldc,
+                                                                              m_ldc,
+                                                                              i_xmm_dtype_out,
+                                                                              i_xmm_dtype_out,
+                                                                              i_xmm_dtype_touch );
+
+  libxsmm_meltw_binary_shape l_shape_binary_aux = libxsmm_create_meltw_binary_shape( m_m * m_r,
+                                                                                     m_n,
+                                                                                     m_ldc,
+                                                                                     m_stride_n_out_aux,
+                                                                                     m_ldc,
+                                                                                     i_xmm_dtype_out,
+                                                                                     i_xmm_dtype_out,
+                                                                                     i_xmm_dtype_out,
+                                                                                     i_xmm_dtype_touch );
+
+  libxsmm_meltw_binary_shape l_shape_binary_scalar = libxsmm_create_meltw_binary_shape( m_m * m_r,
+                                                                                        m_n,
+                                                                                        m_ldc,
+                                                                                        1,
+                                                                                        m_ldc,
+                                                                                        i_xmm_dtype_out,
+                                                                                        i_xmm_dtype_touch,
+                                                                                        i_xmm_dtype_out,
+                                                                                        i_xmm_dtype_touch );
+
+  for( std::size_t l_op = 0; l_op < m_last_touch_ops.size(); l_op++ ) {
+    kernel_t l_ktype = m_last_touch_ops[l_op].ktype;
+
+    //packed kernels support auxiliary output tensors in the layout of the output tensor only
+    if(    m_r > 1
+        && m_stride_m_out_aux != m_r
+        && (    l_ktype == kernel_t::ADD
+             || l_ktype == kernel_t::MUL
+             || l_ktype == kernel_t::ADD_SCALED ) ) {
+      return err_t::COMPILATION_FAILED;
+    }
+    double l_scalars[2] = { m_last_touch_ops[l_op].scalar_0,
+                            m_last_touch_ops[l_op].scalar_1 };
+
+    // unary operations in place
+    libxsmm_meltw_unary_type l_type_unary = LIBXSMM_MELTW_TYPE_UNARY_NONE;
+    if(      l_ktype == kernel_t::RELU    ) l_type_unary = LIBXSMM_MELTW_TYPE_UNARY_RELU;
+    else if( l_ktype == kernel_t::SIGMOID ) l_type_unary = LIBXSMM_MELTW_TYPE_UNARY_SIGMOID;
+    else if( l_ktype == kernel_t::TANH    ) l_type_unary = LIBXSMM_MELTW_TYPE_UNARY_TANH;
+    else if( l_ktype == kernel_t::GELU    ) l_type_unary = LIBXSMM_MELTW_TYPE_UNARY_GELU;
+
+    // binary operations with the auxiliary output tensor or a scalar as second input
+    libxsmm_meltw_binary_type l_types_binary[2] = { LIBXSMM_MELTW_TYPE_BINARY_NONE,
+                                                    LIBXSMM_MELTW_TYPE_BINARY_NONE };
+    bool l_aux = false;
+    if(      l_ktype == kernel_t::ADD   ) { l_types_binary[0] = LIBXSMM_MELTW_TYPE_BINARY_ADD; l_aux = true; }
+    else if( l_ktype == kernel_t::MUL   ) { l_types_binary[0] = LIBXSMM_MELTW_TYPE_BINARY_MUL; l_aux = true; }
+    else if( l_ktype == kernel_t::SCALE ) { l_types_binary[0] = LIBXSMM_MELTW_TYPE_BINARY_MUL; }
+    else if( l_ktype == kernel_t::CLAMP ) { l_types_binary[0] = LIBXSMM_MELTW_TYPE_BINARY_MAX;
+                                            l_types_binary[1] = LIBXSMM_MELTW_TYPE_BINARY_MIN; }
+
+    if( l_type_unary != LIBXSMM_MELTW_TYPE_UNARY_NONE ) {
+      last_touch_stage l_stage;
+      l_stage.unary = KernelCacheTpp::get_default()->dispatch_unary( l_type_unary,
+                                                                     l_shape_unary,
+                                                                     LIBXSMM_MELTW_FLAG_UNARY_NONE );
+      if( l_stage.unary == nullptr ) {
+        return err_t::COMPILATION_FAILED;
+      }
+      m_last_touch_stages.push_back( l_stage );
+    }
+    else if( l_types_binary[0] != LIBXSMM_MELTW_TYPE_BINARY_NONE ) {
+      for( int64_t l_st = 0; l_st < 2 && l_types_binary[l_st] != LIBXSMM_MELTW_TYPE_BINARY_NONE; l_st++ ) {
+        last_touch_stage l_stage;
+        l_stage.aux = l_aux;
+        l_stage.scalar_fp32 = l_scalars[l_st];
+        l_stage.scalar_fp64 = l_scalars[l_st];
+        l_stage.binary = KernelCacheTpp::get_default()->dispatch_binary( l_types_binary[l_st],
+                                                                         l_aux ? l_shape_binary_aux : l_shape_binary_scalar,
+                                                                         l_aux ? i_flag_out_aux_binary : LIBXSMM_MELTW_FLAG_BINARY_BCAST_SCALAR_IN_1 );
+        if( l_stage.binary == nullptr ) {
+          return err_t::COMPILATION_FAILED;
+        }
+        m_last_touch_stages.push_back( l_stage );
+      }
+    }
+    else if(    l_ktype == kernel_t::ADD_SCALED
+             && !ce_low_precision( m_dtype_out ) ) {
+      last_touch_stage l_stage;
+      l_stage.add_scaled = true;
+      l_stage.scalar_fp32 = l_scalars[0];
+      l_stage.scalar_fp64 = l_scalars[0];
+      m_last_touch_stages.push_back( l_stage );
+    }
+    else {
+      return err_t::COMPILATION_FAILED;
+    }
+  }
+
+  return err_t::SUCCESS;
+}
+
 einsum_ir::basic::err_t einsum_ir::basic::ContractionBackendTpp::compile_kernels(){
 
   // libxsmm data types
@@ -77,6 +399,80 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackendTpp::compile_kernels
     return err_t::COMPILATION_FAILED;
   }
 
+  // low precision tensors require matching inputs and fp32 accumulation
+  if(    ce_low_precision( m_dtype_left  )
+      || ce_low_precision( m_dtype_right )
+      || ce_low_precision( m_dtype_out   ) ) {
+    if(    m_dtype_left != m_dtype_right
+        || m_dtype_comp != FP32
+        || ( m_dtype_out != FP32 && m_dtype_out != m_dtype_left ) ) {
+      return err_t::COMPILATION_FAILED;
+    }
+  }
+
+  // integer tensors require int8 inputs and int32 accumulation
+  if(    m_dtype_left  == INT8 || m_dtype_left  == INT32
+      || m_dtype_right == INT8 || m_dtype_right == INT32
+      || m_dtype_out   == INT8 || m_dtype_out   == INT32 ) {
+    if(    m_dtype_left  != INT8
+        || m_dtype_right != INT8
+        || m_dtype_comp  != INT32 ) {
+      return err_t::COMPILATION_FAILED;
+    }
+  }
+
+  // complex primitives operate on the real and imaginary parts with real kernels
+  m_cpx = m_ktype_main == kernel_t::CPX_MADD || m_ktype_main == kernel_t::CPX_MADD_3M || m_ktype_main == kernel_t::CPX_PACKED_MADD;
+  m_cpx_3m = m_ktype_main == kernel_t::CPX_MADD_3M;
+  if( m_cpx ) {
+    if( m_dtype_comp != FP32 && m_dtype_comp != FP64 ) {
+      return err_t::COMPILATION_FAILED;
+    }
+    // the 3m algorithm sums the real and imaginary parts of the inputs in the compute type
+    if(    m_cpx_3m
+        && (    m_dtype_left  != m_dtype_comp
+             || m_dtype_right != m_dtype_comp
+             || m_dtype_out   != m_dtype_comp ) ) {
+      return err_t::COMPILATION_FAILED;
+    }
+    if(      m_ktype_first_touch == kernel_t::CPX_ZERO ) m_ktype_first_touch = kernel_t::ZERO;
+    else if( m_ktype_first_touch == kernel_t::CPX_COPY ) m_ktype_first_touch = kernel_t::COPY;
+    else if( m_ktype_first_touch == kernel_t::CPX_ADD  ) m_ktype_first_touch = kernel_t::ADD;
+    for( std::size_t l_op = 0; l_op < m_last_touch_ops.size(); l_op++ ) {
+      if(      m_last_touch_ops[l_op].ktype == kernel_t::CPX_COPY ) m_last_touch_ops[l_op].ktype = kernel_t::COPY;
+      else if( m_last_touch_ops[l_op].ktype == kernel_t::CPX_ADD  ) m_last_touch_ops[l_op].ktype = kernel_t::ADD;
+    }
+  }
+
+  // int8 outputs are requantized from an int32 accumulator block, which requires all k dimensions in the primitive
+  m_requantize = m_dtype_out == INT8;
+  if( m_requantize ) {
+    if(    m_ktype_first_touch != kernel_t::ZERO
+        || m_last_touch_ops.size() != 1
+        || m_last_touch_ops[0].ktype != kernel_t::REQUANTIZE
+        || m_r != 1 ) {
+      return err_t::COMPILATION_FAILED;
+    }
+    for( std::size_t l_id = 0; l_id < m_dim_type.size(); l_id++ ) {
+      if(    m_dim_type[l_id] == dim_t::K
+          && m_exec_type[l_id] != exec_t::PRIM ) {
+        return err_t::COMPILATION_FAILED;
+      }
+    }
+
+    m_requantize_per_channel = false;
+    for( std::size_t l_id = 0; l_id < m_strides_out_aux.size(); l_id++ ) {
+      if( m_strides_out_aux[l_id] != 0 ) {
+        m_requantize_per_channel = true;
+      }
+    }
+    m_requantize_scale      = m_last_touch_ops[0].scalar_0;
+    m_requantize_zero_point = m_last_touch_ops[0].scalar_1;
+  }
+
+  // element-wise operations on low precision outputs are computed in fp32
+  libxsmm_datatype l_xmm_dtype_touch = ce_low_precision( m_dtype_out ) ? l_xmm_dtype_comp : l_xmm_dtype_out;
+
   // setup bcast 
   libxsmm_bitfield l_flag_out_aux_unary  = LIBXSMM_MELTW_FLAG_UNARY_NONE;
   libxsmm_bitfield l_flag_out_aux_binary = LIBXSMM_MELTW_FLAG_BINARY_NONE;
@@ -107,7 +503,7 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackendTpp::compile_kernels
                                                                                      m_ldc,
                                                                                      l_xmm_dtype_out,
                                                                                      l_xmm_dtype_out,
-                                                                                     l_xmm_dtype_out );
+                                                                                     l_xmm_dtype_touch );
   
   libxsmm_meltw_unary_shape l_shape_single_touch_aux_unary = libxsmm_create_meltw_unary_shape( m_m * m_r,
                                                                                                m_n,
@@ -115,7 +511,7 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackendTpp::compile_kernels
                                                                                                m_ldc,
                                                                                                l_xmm_dtype_out,
                                                                                                l_xmm_dtype_out,
-                                                                                               l_xmm_dtype_out );
+                                                                                               l_xmm_dtype_touch );
 
   libxsmm_meltw_binary_shape l_shape_single_touch_aux_binary = libxsmm_create_meltw_binary_shape( m_m * m_r,
                                                                                                   m_n,
@@ -125,41 +521,44 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackendTpp::compile_kernels
                                                                                                   l_xmm_dtype_out,
                                                                                                   l_xmm_dtype_out,
                                                                                                   l_xmm_dtype_out,
-                                                                                                  l_xmm_dtype_out );
+                                                                                                  l_xmm_dtype_touch );
 
   //first touch kernel
   if( m_ktype_first_touch == kernel_t::ZERO ) {
-    m_xmm_kernel_first_touch_unary = libxsmm_dispatch_meltw_unary( LIBXSMM_MELTW_TYPE_UNARY_XOR,
-                                                                   l_shape_single_touch,
-                                                                   LIBXSMM_MELTW_FLAG_UNARY_NONE );
+    m_xmm_kernel_first_touch_unary = KernelCacheTpp::get_default()->dispatch_unary( LIBXSMM_MELTW_TYPE_UNARY_XOR,
+                                                                                    l_shape_single_touch,
+                                                                                    LIBXSMM_MELTW_FLAG_UNARY_NONE );
   }
   else if( m_ktype_first_touch == kernel_t::COPY ) {
-    m_xmm_kernel_first_touch_unary = libxsmm_dispatch_meltw_unary( LIBXSMM_MELTW_TYPE_UNARY_IDENTITY,
-                                                                   l_shape_single_touch_aux_unary,
-                                                                   l_flag_out_aux_unary );
+    m_xmm_kernel_first_touch_unary = KernelCacheTpp::get_default()->dispatch_unary( LIBXSMM_MELTW_TYPE_UNARY_IDENTITY,
+                                                                                    l_shape_single_touch_aux_unary,
+                                                                                    l_flag_out_aux_unary );
   }
   else if( m_ktype_first_touch == kernel_t::ADD ) {
-    m_xmm_kernel_first_touch_binary = libxsmm_dispatch_meltw_binary( LIBXSMM_MELTW_TYPE_BINARY_ADD,
-                                                                     l_shape_single_touch_aux_binary,
-                                                                     l_flag_out_aux_binary );
+    m_xmm_kernel_first_touch_binary = KernelCacheTpp::get_default()->dispatch_binary( LIBXSMM_MELTW_TYPE_BINARY_ADD,
+                                                                                      l_shape_single_touch_aux_binary,
+                                                                                      l_flag_out_aux_binary );
   }
   else if( m_ktype_first_touch != kernel_t::UNDEFINED_KTYPE ) {
     return err_t::COMPILATION_FAILED;
   }
 
-  // last touch kernel
-  if( m_ktype_last_touch == kernel_t::RELU ) {
-    m_xmm_kernel_last_touch_unary = libxsmm_dispatch_meltw_unary( LIBXSMM_MELTW_TYPE_UNARY_RELU,
-                                                                  l_shape_single_touch,
-                                                                  LIBXSMM_MELTW_FLAG_UNARY_NONE );
+  // last touch kernels
+  err_t l_err = compile_last_touch( l_xmm_dtype_out,
+                                    l_xmm_dtype_touch,
+                                    l_flag_out_aux_binary );
+  if( l_err != err_t::SUCCESS ) {
+    return l_err;
   }
-  else if( m_ktype_last_touch == kernel_t::ADD ) {
-    m_xmm_kernel_last_touch_binary = libxsmm_dispatch_meltw_binary( LIBXSMM_MELTW_TYPE_BINARY_ADD,
-                                                                    l_shape_single_touch_aux_binary,
-                                                                    l_flag_out_aux_binary );
-  }
-  else if( m_ktype_last_touch != kernel_t::UNDEFINED_KTYPE ) {
-    return err_t::COMPILATION_FAILED;
+
+  // negation of the real part in complex primitives
+  if( m_cpx && !m_cpx_3m ) {
+    m_xmm_kernel_negate = KernelCacheTpp::get_default()->dispatch_unary( LIBXSMM_MELTW_TYPE_UNARY_NEGATE,
+                                                                         l_shape_single_touch,
+                                                                         LIBXSMM_MELTW_FLAG_UNARY_NONE );
+    if( m_xmm_kernel_negate == nullptr ) {
+      return err_t::COMPILATION_FAILED;
+    }
   }
 
 
@@ -167,23 +566,30 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackendTpp::compile_kernels
   libxsmm_bitfield l_flags_brgemm = LIBXSMM_GEMM_FLAGS('N', 'N');
   l_flags_brgemm |= ( m_trans_a ? LIBXSMM_GEMM_FLAG_TRANS_A : 0);
   l_flags_brgemm |= ( m_trans_b ? LIBXSMM_GEMM_FLAG_TRANS_B : 0);
+  l_flags_brgemm |= ( m_requantize ? LIBXSMM_GEMM_FLAG_BETA_0 : 0);
 
   //remove packed stride from leading dimensions
   m_lda /= m_r; 
   m_ldb /= m_r; 
   m_ldc /= m_r;
 
+  //the 3m main kernel multiplies the contiguous sums of the real and imaginary parts
+  int64_t l_rows_left  = m_trans_a ? m_k : m_m;
+  int64_t l_cols_left  = m_trans_a ? m_m : m_k;
+  int64_t l_rows_right = m_trans_b ? m_n : m_k;
+  int64_t l_cols_right = m_trans_b ? m_k : m_n;
+
   //create main kernel shape
   libxsmm_gemm_shape l_shape_brgemm;
   l_shape_brgemm = libxsmm_create_gemm_shape( m_m,
                                               m_n,
                                               m_k,
-                                              m_lda,
-                                              m_ldb,
-                                              m_ldc,
+                                              m_cpx_3m ? l_rows_left  : m_lda,
+                                              m_cpx_3m ? l_rows_right : m_ldb,
+                                              m_requantize ? m_m : m_ldc,
                                               l_xmm_dtype_left,
                                               l_xmm_dtype_right,
-                                              l_xmm_dtype_out,
+                                              m_requantize ? l_xmm_dtype_comp : l_xmm_dtype_out,
                                               l_xmm_dtype_comp );
 
   //set br type and scale br strides
@@ -203,23 +609,98 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionBackendTpp::compile_kernels
   l_brconfig.br_unroll_hint = 0;
 
   //create main kernel
-  if( m_ktype_main == kernel_t::BR_MADD ||
-      m_ktype_main == kernel_t::MADD       ){
-    m_xmm_kernel_main = libxsmm_dispatch_brgemm( l_shape_brgemm,
-                                                 l_flags_brgemm,
-                                                 l_prefetch_flags_brgemm,
-                                                 l_brconfig );
+  if( m_ktype_main == kernel_t::BR_MADD     ||
+      m_ktype_main == kernel_t::MADD        ||
+      m_ktype_main == kernel_t::CPX_MADD    ||
+      m_ktype_main == kernel_t::CPX_MADD_3M    ){
+    m_xmm_kernel_main = KernelCacheTpp::get_default()->dispatch_brgemm( l_shape_brgemm,
+                                                                        l_flags_brgemm,
+                                                                        l_prefetch_flags_brgemm,
+                                                                        l_brconfig );
   }
-  else if( m_ktype_main == kernel_t::PACKED_MADD ){
-     m_xmm_kernel_main = libxsmm_create_packed_gemm( l_shape_brgemm,
-                                                     l_flags_brgemm,
-                                                     l_prefetch_flags_brgemm,
-                                                     m_r );
+  else if( m_ktype_main == kernel_t::PACKED_MADD ||
+           m_ktype_main == kernel_t::CPX_PACKED_MADD ){
+     m_xmm_kernel_main = KernelCacheTpp::get_default()->create_packed_gemm( l_shape_brgemm,
+                                                                            l_flags_brgemm,
+                                                                            l_prefetch_flags_brgemm,
+                                                                            m_r );
   }
 
   if( m_xmm_kernel_main == nullptr ) {
     return err_t::COMPILATION_FAILED;
   }
+
+  //create 3m kernels
+  if( m_cpx_3m ) {
+    int64_t l_num_bytes = ce_n_bytes( m_dtype_comp );
+    m_cpx_3m_offset_sum_right = l_rows_left * l_cols_left * l_num_bytes;
+    m_cpx_3m_offset_prod_real = m_cpx_3m_offset_sum_right + l_rows_right * l_cols_right * l_num_bytes;
+    m_cpx_3m_offset_prod_imag = m_cpx_3m_offset_prod_real + m_m * m_n * l_num_bytes;
+    m_cpx_3m_size_scratch     = m_cpx_3m_offset_prod_imag + m_m * m_n * l_num_bytes;
+
+    libxsmm_meltw_binary_shape l_shape_sum_left = libxsmm_create_meltw_binary_shape( l_rows_left,
+                                                                                     l_cols_left,
+                                                                                     m_lda,
+                                                                                     m_lda,
+                                                                                     l_rows_left,
+                                                                                     l_xmm_dtype_comp,
+                                                                                     l_xmm_dtype_comp,
+                                                                                     l_xmm_dtype_comp,
+                                                                                     l_xmm_dtype_comp );
+    libxsmm_meltw_binary_shape l_shape_sum_right = libxsmm_create_meltw_binary_shape( l_rows_right,
+                                                                                      l_cols_right,
+                                                                                      m_ldb,
+                                                                                      m_ldb,
+                                                                                      l_rows_right,
+                                                                                      l_xmm_dtype_comp,
+                                                                                      l_xmm_dtype_comp,
+                                                                                      l_xmm_dtype_comp,
+                                                                                      l_xmm_dtype_comp );
+    libxsmm_meltw_binary_shape l_shape_comb = libxsmm_create_meltw_binary_shape( m_m,
+                                                                                 m_n,
+                                                                                 m_ldc,
+                                                                                 m_m,
+                                                                                 m_ldc,
+                                                                                 l_xmm_dtype_comp,
+                                                                                 l_xmm_dtype_comp,
+                                                                                 l_xmm_dtype_comp,
+                                                                                 l_xmm_dtype_comp );
+    libxsmm_gemm_shape l_shape_prod = libxsmm_create_gemm_shape( m_m,
+                                                                 m_n,
+                                                                 m_k,
+                                                                 m_lda,
+                                                                 m_ldb,
+                                                                 m_m,
+                                                                 l_xmm_dtype_comp,
+                                                                 l_xmm_dtype_comp,
+                                                                 l_xmm_dtype_comp,
+                                                                 l_xmm_dtype_comp );
+
+    m_xmm_kernel_cpx_3m_sum_left  = KernelCacheTpp::get_default()->dispatch_binary( LIBXSMM_MELTW_TYPE_BINARY_ADD,
+                                                                                    l_shape_sum_left,
+                                                                                    LIBXSMM_MELTW_FLAG_BINARY_NONE );
+    m_xmm_kernel_cpx_3m_sum_right = KernelCacheTpp::get_default()->dispatch_binary( LIBXSMM_MELTW_TYPE_BINARY_ADD,
+                                                                                    l_shape_sum_right,
+                                                                                    LIBXSMM_MELTW_FLAG_BINARY_NONE );
+    m_xmm_kernel_cpx_3m_add       = KernelCacheTpp::get_default()->dispatch_binary( LIBXSMM_MELTW_TYPE_BINARY_ADD,
+                                                                                    l_shape_comb,
+                                                                                    LIBXSMM_MELTW_FLAG_BINARY_NONE );
+    m_xmm_kernel_cpx_3m_sub       = KernelCacheTpp::get_default()->dispatch_binary( LIBXSMM_MELTW_TYPE_BINARY_SUB,
+                                                                                    l_shape_comb,
+                                                                                    LIBXSMM_MELTW_FLAG_BINARY_NONE );
+    m_xmm_kernel_cpx_3m_prod      = KernelCacheTpp::get_default()->dispatch_brgemm( l_shape_prod,
+                                                                                    l_flags_brgemm | LIBXSMM_GEMM_FLAG_BETA_0,
+                                                                                    l_prefetch_flags_brgemm,
+                                                                                    l_brconfig );
+
+    if(    m_xmm_kernel_cpx_3m_sum_left  == nullptr
+        || m_xmm_kernel_cpx_3m_sum_right == nullptr
+        || m_xmm_kernel_cpx_3m_add       == nullptr
+        || m_xmm_kernel_cpx_3m_sub       == nullptr
+        || m_xmm_kernel_cpx_3m_prod      == nullptr ) {
+      return err_t::COMPILATION_FAILED;
+    }
+  }
   
   return err_t::SUCCESS;
 }
\ No newline at end of file
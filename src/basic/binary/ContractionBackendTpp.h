@@ -3,6 +3,7 @@
 
 #include <libxsmm.h>
 #include "ContractionBackend.h"
+#include "../KernelCacheTpp.h"
 
 namespace einsum_ir {
   namespace basic {
@@ -22,11 +23,81 @@ class einsum_ir::basic::ContractionBackendTpp: public ContractionBackend {
     //! LIBXSMM-based main TPP
     libxsmm_gemmfunction m_xmm_kernel_main = nullptr;
 
-    //! LIBXSMM-based unary last-touch TPP
-    libxsmm_meltwfunction_unary m_xmm_kernel_last_touch_unary = nullptr;
+    //! LIBXSMM-based negation of an output block used by complex primitives
+    libxsmm_meltwfunction_unary m_xmm_kernel_negate = nullptr;
 
-    //! LIBXSMM-based binary last-touch TPP
-    libxsmm_meltwfunction_binary m_xmm_kernel_last_touch_binary = nullptr;
+    //! true if the primitive operates on complex tensors with separate real and imaginary parts
+    bool m_cpx = false;
+
+    //! true if the complex primitive uses the 3m algorithm with three real gemms
+    bool m_cpx_3m = false;
+
+    //! LIBXSMM-based sum of the real and imaginary part of the left tensor block (3m)
+    libxsmm_meltwfunction_binary m_xmm_kernel_cpx_3m_sum_left = nullptr;
+
+    //! LIBXSMM-based sum of the real and imaginary part of the right tensor block (3m)
+    libxsmm_meltwfunction_binary m_xmm_kernel_cpx_3m_sum_right = nullptr;
+
+    //! LIBXSMM-based gemm which writes the products of the real and imaginary parts to the scratch blocks (3m)
+    libxsmm_gemmfunction m_xmm_kernel_cpx_3m_prod = nullptr;
+
+    //! LIBXSMM-based addition of a scratch product block to an output block (3m)
+    libxsmm_meltwfunction_binary m_xmm_kernel_cpx_3m_add = nullptr;
+
+    //! LIBXSMM-based subtraction of a scratch product block from an output block (3m)
+    libxsmm_meltwfunction_binary m_xmm_kernel_cpx_3m_sub = nullptr;
+
+    //! byte offset of the right sum in the scratch memory (3m)
+    int64_t m_cpx_3m_offset_sum_right = 0;
+
+    //! byte offset of the product of the real parts in the scratch memory (3m)
+    int64_t m_cpx_3m_offset_prod_real = 0;
+
+    //! byte offset of the product of the imaginary parts in the scratch memory (3m)
+    int64_t m_cpx_3m_offset_prod_imag = 0;
+
+    //! size of the scratch memory in bytes (3m)
+    int64_t m_cpx_3m_size_scratch = 0;
+
+    //! thread-private scratch memory of complex primitives using the 3m algorithm
+    static thread_local std::vector< char > s_cpx_3m_scratch;
+
+    //! stage of the last-touch chain
+    struct last_touch_stage {
+      //! LIBXSMM-based unary TPP
+      libxsmm_meltwfunction_unary unary = nullptr;
+      //! LIBXSMM-based binary TPP
+      libxsmm_meltwfunction_binary binary = nullptr;
+      //! true if the stage is applied by add_scaled
+      bool add_scaled = false;
+      //! true if the second input is the auxiliary output tensor, false if it is the scalar operand
+      bool aux = false;
+      //! scalar operand in FP32
+      float scalar_fp32 = 0;
+      //! scalar operand in FP64
+      double scalar_fp64 = 0;
+    };
+
+    //! stages of the last-touch chain
+    std::vector< last_touch_stage > m_last_touch_stages;
+
+    //! leading dimension of the output tensor in the last-touch stages
+    int64_t m_ld_last_touch = 0;
+
+    //! true if the int32 accumulator block is requantized to the int8 output tensor
+    bool m_requantize = false;
+
+    //! true if the auxiliary output tensor holds per-channel scales of the requantization
+    bool m_requantize_per_channel = false;
+
+    //! per-tensor scale of the requantization
+    float m_requantize_scale = 0;
+
+    //! zero point of the requantization
+    float m_requantize_zero_point = 0;
+
+    //! thread-private int32 accumulator block of requantized contractions
+    static thread_local std::vector< int32_t > s_acc;
 
     /**
      * converts internal datatypes to libxsmm datatypes
@@ -34,6 +105,71 @@ class einsum_ir::basic::ContractionBackendTpp: public ContractionBackend {
      * @return libxsmm datatype.
      **/
     libxsmm_datatype dtype_to_libxsmm( data_t i_dtype );
+
+    /**
+     * Adds the scaled auxiliary output tensor to a block of the output tensor.
+     *
+     * @param i_out_aux pointer to a data section of the auxiliary output tensor.
+     * @param i_scalar factor of the auxiliary output tensor.
+     * @param io_out pointer to a data section of the output tensor.
+     **/
+    template < typename T >
+    void add_scaled( void const * i_out_aux,
+                     T            i_scalar,
+                     void       * io_out );
+
+    /**
+     * First-touch kernel applied to the real or imaginary part of the output tensor.
+     *
+     * @param i_out_aux pointer to a data section of the auxiliary output tensor.
+     * @param io_out pointer to a data section of the output tensor.
+     **/
+    void kernel_first_touch_part( void const * i_out_aux,
+                                  void       * io_out );
+
+    /**
+     * Last-touch kernels applied to the real or imaginary part of the output tensor.
+     *
+     * @param i_out_aux pointer to a data section of the auxiliary output tensor.
+     * @param io_out pointer to a data section of the output tensor.
+     **/
+    void kernel_last_touch_part( void const * i_out_aux,
+                                 void       * io_out );
+
+    /**
+     * Complex main kernel using the 3m algorithm:
+     *   out_real += ArBr - AiBi
+     *   out_imag += (Ar+Ai)(Br+Bi) - ArBr - AiBi
+     *
+     * @param i_left pointer to a data section of the left tensor.
+     * @param i_right pointer to a data section of the right tensor.
+     * @param io_out pointer to a data section of the output tensor.
+     **/
+    void kernel_main_cpx_3m( void const * i_left,
+                             void const * i_right,
+                             void       * io_out );
+
+    /**
+     * Requantizes the int32 accumulator block of the calling thread to a block of the int8 output tensor.
+     *
+     * @param i_out_aux pointer to a data section of the auxiliary output tensor with per-channel scales.
+     * @param io_out pointer to a data section of the output tensor.
+     **/
+    void requantize( void const * i_out_aux,
+                     void       * io_out );
+
+    /**
+     * Compiles the stages of the last-touch chain.
+     *
+     * @param i_xmm_dtype_out libxsmm datatype of the output tensor.
+     * @param i_xmm_dtype_touch libxsmm datatype in which the element-wise operations are computed.
+     * @param i_flag_out_aux_binary broadcast flag of the auxiliary output tensor in binary TPPs.
+     *
+     * @return SUCCESS if the compilation was successful, otherwise an appropiate error code.
+     **/
+    err_t compile_last_touch( libxsmm_datatype i_xmm_dtype_out,
+                              libxsmm_datatype i_xmm_dtype_touch,
+                              libxsmm_bitfield i_flag_out_aux_binary );
     
   public:
     /**
@@ -68,6 +68,108 @@ TEST_CASE( "Matmul with sequential batch dimension.", "[contraction_backend]" )
   REQUIRE( at::allclose( l_out, l_out_ref, 1E-4, 1E-5 ) );
 }
 
+TEST_CASE( "Queued asynchronous matmuls with sequential batch dimension.", "[contraction_backend]" ) {
+  //example: [c1,k1,m1],[c1,n1,k1]->[c1,n1,m1]
+  //sizes:   [17,13,20],[17,47,13]->[17,47,20] and [9,32,24],[9,16,32]->[9,16,24]
+  using namespace einsum_ir::basic;
+
+  std::vector< dim_t >  l_loop_dim_type  = { dim_t::C,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::K };
+  std::vector< exec_t > l_loop_exec_type = { exec_t::SEQ,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM };
+
+  //                                                    c1, m1, n1, k1
+  std::vector< int64_t > l_loop_sizes_0          = {   17, 20, 47, 13 };
+  std::vector< int64_t > l_loop_strides_left_0   = {  260,  1,  0, 20 };
+  std::vector< int64_t > l_loop_strides_right_0  = {  611,  0, 13,  1 };
+  std::vector< int64_t > l_loop_strides_out_0    = {  940,  1, 20,  0 };
+
+  std::vector< int64_t > l_loop_sizes_1          = {    9, 24, 16, 32 };
+  std::vector< int64_t > l_loop_strides_left_1   = {  768,  1,  0, 24 };
+  std::vector< int64_t > l_loop_strides_right_1  = {  512,  0, 32,  1 };
+  std::vector< int64_t > l_loop_strides_out_1    = {  384,  1, 24,  0 };
+
+  std::vector< int64_t > l_loop_strides_out_aux  = {    0,  0,  0,  0 };
+  std::vector< int64_t > l_packing_strides       = {};
+
+  at::Tensor l_left_0  = at::randn( { 17,13,20 } );
+  at::Tensor l_right_0 = at::randn( { 17,47,13 } );
+  at::Tensor l_out_0   = at::zeros( { 17,47,20 } );
+
+  at::Tensor l_left_1  = at::randn( {  9,32,24 } );
+  at::Tensor l_right_1 = at::randn( {  9,16,32 } );
+  at::Tensor l_out_1   = at::zeros( {  9,16,24 } );
+
+  ContractionBackendTpp l_cont_0;
+  l_cont_0.init( l_loop_dim_type,
+                 l_loop_exec_type,
+                 l_loop_sizes_0,
+                 l_loop_strides_left_0,
+                 l_loop_strides_right_0,
+                 l_loop_strides_out_aux,
+                 l_loop_strides_out_0,
+                 l_packing_strides,
+                 l_packing_strides,
+                 data_t::FP32,
+                 data_t::FP32,
+                 data_t::FP32,
+                 data_t::FP32,
+                 kernel_t::ZERO,
+                 kernel_t::MADD,
+                 kernel_t::UNDEFINED_KTYPE,
+                 2,
+                 1,
+                 1,
+                 nullptr );
+  REQUIRE( l_cont_0.compile() == err_t::SUCCESS );
+
+  ContractionBackendTpp l_cont_1;
+  l_cont_1.init( l_loop_dim_type,
+                 l_loop_exec_type,
+                 l_loop_sizes_1,
+                 l_loop_strides_left_1,
+                 l_loop_strides_right_1,
+                 l_loop_strides_out_aux,
+                 l_loop_strides_out_1,
+                 l_packing_strides,
+                 l_packing_strides,
+                 data_t::FP32,
+                 data_t::FP32,
+                 data_t::FP32,
+                 data_t::FP32,
+                 kernel_t::ZERO,
+                 kernel_t::MADD,
+                 kernel_t::UNDEFINED_KTYPE,
+                 2,
+                 1,
+                 1,
+                 nullptr );
+  REQUIRE( l_cont_1.compile() == err_t::SUCCESS );
+
+  // both contractions are queued before either finished, the executor runs them one after another
+  std::future< void > l_future_0 = l_cont_0.contract_async( l_left_0.data_ptr(),
+                                                            l_right_0.data_ptr(),
+                                                            nullptr,
+                                                            l_out_0.data_ptr() );
+  std::future< void > l_future_1 = l_cont_1.contract_async( l_left_1.data_ptr(),
+                                                            l_right_1.data_ptr(),
+                                                            nullptr,
+                                                            l_out_1.data_ptr() );
+  l_future_1.get();
+  l_future_0.get();
+
+  at::Tensor l_out_ref_0 = at::einsum( "xcb,xac->xab",
+                                       { l_left_0, l_right_0 } );
+  at::Tensor l_out_ref_1 = at::einsum( "xcb,xac->xab",
+                                       { l_left_1, l_right_1 } );
+  REQUIRE( at::allclose( l_out_0, l_out_ref_0, 1E-4, 1E-5 ) );
+  REQUIRE( at::allclose( l_out_1, l_out_ref_1, 1E-4, 1E-5 ) );
+}
+
 TEST_CASE( "Packed Matmul with sequential M dimension.", "[contraction_backend]" ) {
   //example: [m2,k1,m1,c1],[n1,k1,c1]->[m2,n1,m1,c1]
   //sizes:   [ 5,13,20,17],[47,13,17]->[ 5,47,20,17]
@@ -607,7 +709,7 @@ TEST_CASE( "Tensor contraction with SFC and omp parallelisation.", "[contraction
   REQUIRE( at::allclose( l_out, l_out_ref, 1E-4, 1E-5 ) );
 }
 
-TEST_CASE( "Tensor contraction with packing of left tensor and SFC parallelisation.", "[contraction_backend]" ) {
+TEST_CASE( "Tensor contraction with SFC and omp parallelisation using dynamic scheduling.", "[contraction_backend]" ) {
   //example: [c1,m1,k1,m1],[c1,n2,n1,k1]->[c1,n2,m1,n1,m1]
   //sizes:   [ 5,17,13,20],[ 5, 8,47,13]->[ 5, 8,17,47,20]
   using namespace einsum_ir::basic;
@@ -618,7 +720,7 @@ TEST_CASE( "Tensor contraction with packing of left tensor and SFC parallelisati
                                              dim_t::M, 
                                              dim_t::N, 
                                              dim_t::K };
-  std::vector< exec_t > l_loop_exec_type = { exec_t::SEQ,
+  std::vector< exec_t > l_loop_exec_type = { exec_t::OMP,
                                              exec_t::SFC,
                                              exec_t::SFC,
                                              exec_t::PRIM, 
@@ -627,11 +729,11 @@ TEST_CASE( "Tensor contraction with packing of left tensor and SFC parallelisati
 
   //                                                     c1,  m2,   n2,m1,n1,k1
   std::vector< int64_t > l_loop_sizes            = {      5, 17,    8,20,47,13 };  
-  std::vector< int64_t > l_loop_strides_left     = {   4420,260,    0,13, 0, 1 };
+  std::vector< int64_t > l_loop_strides_left     = {   4420,260,    0, 1, 0,20 };
   std::vector< int64_t > l_loop_strides_right    = {   4888,  0,  611, 0,13, 1 };
   std::vector< int64_t > l_loop_strides_out_aux  = {      0,  0,    0, 0, 0, 0 };
   std::vector< int64_t > l_loop_strides_out      = { 127840,940,15980, 1,20, 0 };
-  std::vector< int64_t > l_packing_strides_left  = {      0,  0,    0, 1, 0,20 };
+  std::vector< int64_t > l_packing_strides_left  = {};
   std::vector< int64_t > l_packing_strides_right = {};
 
   at::Tensor l_left    = at::randn( {   5,17,13,20 } );
@@ -658,10 +760,225 @@ TEST_CASE( "Tensor contraction with packing of left tensor and SFC parallelisati
                kernel_t::MADD,
                kernel_t::UNDEFINED_KTYPE,
                10,
-               5,
+               2,
+               3,
+               nullptr );     
+                
+  l_cont.set_sched( sched_t::DYNAMIC );
+  err_t l_err = l_cont.compile();
+  REQUIRE( l_err == err_t::SUCCESS );
+
+  l_cont.contract( l_left.data_ptr(),
+                   l_right.data_ptr(),
+                   nullptr,
+                   l_out.data_ptr() );
+
+
+  l_out_ref = at::einsum( "zxcb,zyac->zyxab",
+                          { l_left, l_right } );
+
+  REQUIRE( at::allclose( l_out, l_out_ref, 1E-4, 1E-5 ) );
+}
+
+TEST_CASE( "Tensor contraction with parallel split-K and SFC parallelisation.", "[contraction_backend]" ) {
+  //example: [m2,k2,k1,m1],[n2,n1,k2,k1]->[n2,m2,n1,m1]
+  //sizes:   [ 4, 8,16,16],[ 3, 8, 8,16]->[ 3, 4, 8,16]
+  using namespace einsum_ir::basic;
+
+  std::vector< dim_t >  l_loop_dim_type  = { dim_t::K,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::K };
+  std::vector< exec_t > l_loop_exec_type = { exec_t::OMP,
+                                             exec_t::SFC,
+                                             exec_t::SFC,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM };
+
+  //                                                     k2,  m2,  n2,m1, n1,k1
+  std::vector< int64_t > l_loop_sizes            = {      8,   4,   3,16,  8,16 };
+  std::vector< int64_t > l_loop_strides_left     = {    256,2048,   0, 1,  0,16 };
+  std::vector< int64_t > l_loop_strides_right    = {     16,   0,1024, 0,128, 1 };
+  std::vector< int64_t > l_loop_strides_out_aux  = {      0,   0,   0, 0,  0, 0 };
+  std::vector< int64_t > l_loop_strides_out      = {      0, 128, 512, 1, 16, 0 };
+  std::vector< int64_t > l_packing_strides_left  = {};
+  std::vector< int64_t > l_packing_strides_right = {};
+
+  at::Tensor l_left    = at::randn( { 4,8,16,16 } );
+  at::Tensor l_right   = at::randn( { 3,8, 8,16 } );
+  at::Tensor l_out     = at::randn( { 3,4, 8,16 } );
+  at::Tensor l_out_ref = l_out.clone();
+
+  ContractionBackendTpp l_cont;
+
+  l_cont.init( l_loop_dim_type,
+               l_loop_exec_type,
+               l_loop_sizes,
+               l_loop_strides_left,
+               l_loop_strides_right,
+               l_loop_strides_out_aux,
+               l_loop_strides_out,
+               l_packing_strides_left,
+               l_packing_strides_right,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               kernel_t::ZERO,
+               kernel_t::MADD,
+               kernel_t::RELU,
                4,
+               1,
+               1,
                nullptr );
-      
+
+  err_t l_err = l_cont.compile();
+  REQUIRE( l_err == err_t::SUCCESS );
+
+  l_cont.contract( l_left.data_ptr(),
+                   l_right.data_ptr(),
+                   nullptr,
+                   l_out.data_ptr() );
+
+  l_out_ref = at::einsum( "abcd,efbc->eafd",
+                          { l_left, l_right } );
+  l_out_ref = at::relu( l_out_ref );
+
+  REQUIRE( at::allclose( l_out, l_out_ref, 1E-4, 1E-5 ) );
+}
+
+TEST_CASE( "Repeated tensor contraction with parallel split-K inside a sequential loop.", "[contraction_backend]" ) {
+  //example: [c1,k2,k1,m1],[c1,n2,k2,n1,k1]->[c1,n2,n1,m1]
+  //sizes:   [ 2, 4,16,16],[ 2, 3, 4, 8,16]->[ 2, 3, 8,16]
+  using namespace einsum_ir::basic;
+
+  std::vector< dim_t >  l_loop_dim_type  = { dim_t::C,
+                                             dim_t::K,
+                                             dim_t::N,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::K };
+  std::vector< exec_t > l_loop_exec_type = { exec_t::SEQ,
+                                             exec_t::OMP,
+                                             exec_t::OMP,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM };
+
+  //                                                     c1, k2, n2,m1,n1,k1
+  std::vector< int64_t > l_loop_sizes            = {      2,  4,  3,16, 8,16 };
+  std::vector< int64_t > l_loop_strides_left     = {   1024,256,  0, 1, 0,16 };
+  std::vector< int64_t > l_loop_strides_right    = {   1536,128,512, 0,16, 1 };
+  std::vector< int64_t > l_loop_strides_out_aux  = {      0,  0,  0, 0, 0, 0 };
+  std::vector< int64_t > l_loop_strides_out      = {    384,  0,128, 1,16, 0 };
+  std::vector< int64_t > l_packing_strides_left  = {};
+  std::vector< int64_t > l_packing_strides_right = {};
+
+  at::Tensor l_left    = at::randn( { 2,4,16,16 } );
+  at::Tensor l_right   = at::randn( { 2,3,4,8,16 } );
+  at::Tensor l_out     = at::randn( { 2,3,8,16 } );
+  at::Tensor l_out_ref = at::einsum( "zabc,zdaeb->zdec",
+                                     { l_left, l_right } );
+
+  ContractionBackendTpp l_cont;
+
+  //three threads: not every thread accumulates in every tile of the private output memory
+  l_cont.init( l_loop_dim_type,
+               l_loop_exec_type,
+               l_loop_sizes,
+               l_loop_strides_left,
+               l_loop_strides_right,
+               l_loop_strides_out_aux,
+               l_loop_strides_out,
+               l_packing_strides_left,
+               l_packing_strides_right,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               kernel_t::ZERO,
+               kernel_t::MADD,
+               kernel_t::UNDEFINED_KTYPE,
+               3,
+               1,
+               1,
+               nullptr );
+
+  err_t l_err = l_cont.compile();
+  REQUIRE( l_err == err_t::SUCCESS );
+
+  //the private output memory of the first contraction must not leak into the second one
+  for( int64_t l_re = 0; l_re < 2; l_re++ ){
+    l_out = at::randn( { 2,3,8,16 } );
+    l_cont.contract( l_left.data_ptr(),
+                     l_right.data_ptr(),
+                     nullptr,
+                     l_out.data_ptr() );
+
+    REQUIRE( at::allclose( l_out, l_out_ref, 1E-4, 1E-5 ) );
+  }
+}
+
+TEST_CASE( "Tensor contraction with SFC and omp parallelisation and software prefetching.", "[contraction_backend]" ) {
+  //example: [c1,m1,k1,m1],[c1,n2,n1,k1]->[c1,n2,m1,n1,m1]
+  //sizes:   [ 5,17,13,20],[ 5, 8,47,13]->[ 5, 8,17,47,20]
+  using namespace einsum_ir::basic;
+
+  std::vector< dim_t >  l_loop_dim_type  = { dim_t::C,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::M, 
+                                             dim_t::N, 
+                                             dim_t::K };
+  std::vector< exec_t > l_loop_exec_type = { exec_t::OMP,
+                                             exec_t::SFC,
+                                             exec_t::SFC,
+                                             exec_t::PRIM, 
+                                             exec_t::PRIM, 
+                                             exec_t::PRIM };
+
+  //                                                     c1,  m2,   n2,m1,n1,k1
+  std::vector< int64_t > l_loop_sizes            = {      5, 17,    8,20,47,13 };  
+  std::vector< int64_t > l_loop_strides_left     = {   4420,260,    0, 1, 0,20 };
+  std::vector< int64_t > l_loop_strides_right    = {   4888,  0,  611, 0,13, 1 };
+  std::vector< int64_t > l_loop_strides_out_aux  = {      0,  0,    0, 0, 0, 0 };
+  std::vector< int64_t > l_loop_strides_out      = { 127840,940,15980, 1,20, 0 };
+  std::vector< int64_t > l_packing_strides_left  = {};
+  std::vector< int64_t > l_packing_strides_right = {};
+
+  at::Tensor l_left    = at::randn( {   5,17,13,20 } );
+  at::Tensor l_right   = at::randn( {   5, 8,47,13 } );
+  at::Tensor l_out     = at::zeros( { 5,8,17,47,20 } );
+  at::Tensor l_out_ref = l_out.clone();
+
+  ContractionBackendTpp l_cont;
+
+  l_cont.init( l_loop_dim_type,
+               l_loop_exec_type,
+               l_loop_sizes,
+               l_loop_strides_left,
+               l_loop_strides_right,
+               l_loop_strides_out_aux,
+               l_loop_strides_out,
+               l_packing_strides_left,
+               l_packing_strides_right,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               kernel_t::ZERO,
+               kernel_t::MADD,
+               kernel_t::UNDEFINED_KTYPE,
+               10,
+               2,
+               3,
+               nullptr );     
+                
+  l_cont.set_loop_nest( loop_nest_t::FLAT );
+  l_cont.set_prefetch( prefetch_t::SFC_PREFETCH );
   err_t l_err = l_cont.compile();
   REQUIRE( l_err == err_t::SUCCESS );
 
@@ -677,8 +994,7 @@ TEST_CASE( "Tensor contraction with packing of left tensor and SFC parallelisati
   REQUIRE( at::allclose( l_out, l_out_ref, 1E-4, 1E-5 ) );
 }
 
-
-TEST_CASE( "Tensor contraction with packing of both tensors and SFC parallelisation.", "[contraction_backend]" ) {
+TEST_CASE( "Tensor contraction with packing of left tensor and SFC parallelisation.", "[contraction_backend]" ) {
   //example: [c1,m1,k1,m1],[c1,n2,n1,k1]->[c1,n2,m1,n1,m1]
   //sizes:   [ 5,17,13,20],[ 5, 8,47,13]->[ 5, 8,17,47,20]
   using namespace einsum_ir::basic;
@@ -699,18 +1015,17 @@ TEST_CASE( "Tensor contraction with packing of both tensors and SFC parallelisat
   //                                                     c1,  m2,   n2,m1,n1,k1
   std::vector< int64_t > l_loop_sizes            = {      5, 17,    8,20,47,13 };  
   std::vector< int64_t > l_loop_strides_left     = {   4420,260,    0,13, 0, 1 };
-  std::vector< int64_t > l_loop_strides_right    = {   4888,  0,  611, 0, 1,47 };
+  std::vector< int64_t > l_loop_strides_right    = {   4888,  0,  611, 0,13, 1 };
   std::vector< int64_t > l_loop_strides_out_aux  = {      0,  0,    0, 0, 0, 0 };
   std::vector< int64_t > l_loop_strides_out      = { 127840,940,15980, 1,20, 0 };
   std::vector< int64_t > l_packing_strides_left  = {      0,  0,    0, 1, 0,20 };
-  std::vector< int64_t > l_packing_strides_right = {      0,  0,    0, 0,13, 1 };
+  std::vector< int64_t > l_packing_strides_right = {};
 
   at::Tensor l_left    = at::randn( {   5,17,13,20 } );
   at::Tensor l_right   = at::randn( {   5, 8,47,13 } );
   at::Tensor l_out     = at::zeros( { 5,8,17,47,20 } );
   at::Tensor l_out_ref = l_out.clone();
 
-  ContractionMemoryManager l_mem;
   ContractionBackendTpp l_cont;
 
   l_cont.init( l_loop_dim_type,
@@ -730,15 +1045,13 @@ TEST_CASE( "Tensor contraction with packing of both tensors and SFC parallelisat
                kernel_t::MADD,
                kernel_t::UNDEFINED_KTYPE,
                10,
-               7,
-               2,
-               &l_mem );
+               5,
+               4,
+               nullptr );
       
   err_t l_err = l_cont.compile();
   REQUIRE( l_err == err_t::SUCCESS );
 
-  l_mem.alloc_all_memory();
-
   l_cont.contract( l_left.data_ptr(),
                    l_right.data_ptr(),
                    nullptr,
@@ -749,4 +1062,713 @@ TEST_CASE( "Tensor contraction with packing of both tensors and SFC parallelisat
                           { l_left, l_right } );
 
   REQUIRE( at::allclose( l_out, l_out_ref, 1E-4, 1E-5 ) );
-}
\ No newline at end of file
+}
+
+
+TEST_CASE( "Batched tensor contraction with packing of left tensor and SFC parallelisation.", "[contraction_backend]" ) {
+  //example: [c1,m1,k1,m1],[c1,n2,n1,k1]->[c1,n2,m1,n1,m1]
+  //sizes:   [ 5,17,13,20],[ 5, 8,47,13]->[ 5, 8,17,47,20]
+  using namespace einsum_ir::basic;
+
+  std::vector< dim_t >  l_loop_dim_type  = { dim_t::C,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::M, 
+                                             dim_t::N, 
+                                             dim_t::K };
+  std::vector< exec_t > l_loop_exec_type = { exec_t::SEQ,
+                                             exec_t::SFC,
+                                             exec_t::SFC,
+                                             exec_t::PRIM, 
+                                             exec_t::PRIM, 
+                                             exec_t::PRIM };
+
+  //                                                     c1,  m2,   n2,m1,n1,k1
+  std::vector< int64_t > l_loop_sizes            = {      5, 17,    8,20,47,13 };  
+  std::vector< int64_t > l_loop_strides_left     = {   4420,260,    0,13, 0, 1 };
+  std::vector< int64_t > l_loop_strides_right    = {   4888,  0,  611, 0,13, 1 };
+  std::vector< int64_t > l_loop_strides_out_aux  = {      0,  0,    0, 0, 0, 0 };
+  std::vector< int64_t > l_loop_strides_out      = { 127840,940,15980, 1,20, 0 };
+  std::vector< int64_t > l_packing_strides_left  = {      0,  0,    0, 1, 0,20 };
+  std::vector< int64_t > l_packing_strides_right = {};
+
+  at::Tensor l_left    = at::randn( { 3,   5,17,13,20 } );
+  at::Tensor l_right   = at::randn( {      5, 8,47,13 } );
+  at::Tensor l_out     = at::zeros( { 3, 5,8,17,47,20 } );
+  at::Tensor l_out_ref = l_out.clone();
+
+  ContractionBackendTpp l_cont;
+
+  l_cont.init( l_loop_dim_type,
+               l_loop_exec_type,
+               l_loop_sizes,
+               l_loop_strides_left,
+               l_loop_strides_right,
+               l_loop_strides_out_aux,
+               l_loop_strides_out,
+               l_packing_strides_left,
+               l_packing_strides_right,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               kernel_t::ZERO,
+               kernel_t::MADD,
+               kernel_t::UNDEFINED_KTYPE,
+               10,
+               5,
+               4,
+               nullptr );
+      
+  err_t l_err = l_cont.compile();
+  REQUIRE( l_err == err_t::SUCCESS );
+
+  std::vector< void const * > l_ptrs_left;
+  std::vector< void const * > l_ptrs_right;
+  std::vector< void       * > l_ptrs_out;
+  for( int64_t l_ba = 0; l_ba < 3; l_ba++ ) {
+    l_ptrs_left.push_back(  l_left[l_ba].data_ptr() );
+    l_ptrs_right.push_back( l_right.data_ptr()      );
+    l_ptrs_out.push_back(   l_out[l_ba].data_ptr()  );
+  }
+
+  l_cont.contract_batch( 3,
+                         l_ptrs_left.data(),
+                         l_ptrs_right.data(),
+                         nullptr,
+                         l_ptrs_out.data() );
+
+  l_out_ref = at::einsum( "wzxcb,zyac->wzyxab",
+                          { l_left, l_right } );
+
+  REQUIRE( at::allclose( l_out, l_out_ref, 1E-4, 1E-5 ) );
+}
+
+TEST_CASE( "Tensor contraction with packing of both tensors and SFC parallelisation.", "[contraction_backend]" ) {
+  //example: [c1,m1,k1,m1],[c1,n2,n1,k1]->[c1,n2,m1,n1,m1]
+  //sizes:   [ 5,17,13,20],[ 5, 8,47,13]->[ 5, 8,17,47,20]
+  using namespace einsum_ir::basic;
+
+  std::vector< dim_t >  l_loop_dim_type  = { dim_t::C,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::M, 
+                                             dim_t::N, 
+                                             dim_t::K };
+  std::vector< exec_t > l_loop_exec_type = { exec_t::SEQ,
+                                             exec_t::SFC,
+                                             exec_t::SFC,
+                                             exec_t::PRIM, 
+                                             exec_t::PRIM, 
+                                             exec_t::PRIM };
+
+  //                                                     c1,  m2,   n2,m1,n1,k1
+  std::vector< int64_t > l_loop_sizes            = {      5, 17,    8,20,47,13 };  
+  std::vector< int64_t > l_loop_strides_left     = {   4420,260,    0,13, 0, 1 };
+  std::vector< int64_t > l_loop_strides_right    = {   4888,  0,  611, 0, 1,47 };
+  std::vector< int64_t > l_loop_strides_out_aux  = {      0,  0,    0, 0, 0, 0 };
+  std::vector< int64_t > l_loop_strides_out      = { 127840,940,15980, 1,20, 0 };
+  std::vector< int64_t > l_packing_strides_left  = {      0,  0,    0, 1, 0,20 };
+  std::vector< int64_t > l_packing_strides_right = {      0,  0,    0, 0,13, 1 };
+
+  at::Tensor l_left    = at::randn( {   5,17,13,20 } );
+  at::Tensor l_right   = at::randn( {   5, 8,47,13 } );
+  at::Tensor l_out     = at::zeros( { 5,8,17,47,20 } );
+  at::Tensor l_out_ref = l_out.clone();
+
+  ContractionMemoryManager l_mem;
+  ContractionBackendTpp l_cont;
+
+  l_cont.init( l_loop_dim_type,
+               l_loop_exec_type,
+               l_loop_sizes,
+               l_loop_strides_left,
+               l_loop_strides_right,
+               l_loop_strides_out_aux,
+               l_loop_strides_out,
+               l_packing_strides_left,
+               l_packing_strides_right,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               kernel_t::ZERO,
+               kernel_t::MADD,
+               kernel_t::UNDEFINED_KTYPE,
+               10,
+               7,
+               2,
+               &l_mem );
+      
+  err_t l_err = l_cont.compile();
+  REQUIRE( l_err == err_t::SUCCESS );
+
+  l_mem.alloc_all_memory();
+
+  l_cont.contract( l_left.data_ptr(),
+                   l_right.data_ptr(),
+                   nullptr,
+                   l_out.data_ptr() );
+
+
+  l_out_ref = at::einsum( "zxcb,zyac->zyxab",
+                          { l_left, l_right } );
+
+  REQUIRE( at::allclose( l_out, l_out_ref, 1E-4, 1E-5 ) );
+}
+
+TEST_CASE( "Tensor contraction with packing of both tensors, SFC parallelisation and a flat loop nest.", "[contraction_backend]" ) {
+  //example: [c1,m1,k1,m1],[c1,n2,n1,k1]->[c1,n2,m1,n1,m1]
+  //sizes:   [ 5,17,13,20],[ 5, 8,47,13]->[ 5, 8,17,47,20]
+  using namespace einsum_ir::basic;
+
+  std::vector< dim_t >  l_loop_dim_type  = { dim_t::C,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::M, 
+                                             dim_t::N, 
+                                             dim_t::K };
+  std::vector< exec_t > l_loop_exec_type = { exec_t::SEQ,
+                                             exec_t::SFC,
+                                             exec_t::SFC,
+                                             exec_t::PRIM, 
+                                             exec_t::PRIM, 
+                                             exec_t::PRIM };
+
+  //                                                     c1,  m2,   n2,m1,n1,k1
+  std::vector< int64_t > l_loop_sizes            = {      5, 17,    8,20,47,13 };  
+  std::vector< int64_t > l_loop_strides_left     = {   4420,260,    0,13, 0, 1 };
+  std::vector< int64_t > l_loop_strides_right    = {   4888,  0,  611, 0, 1,47 };
+  std::vector< int64_t > l_loop_strides_out_aux  = {      0,  0,    0, 0, 0, 0 };
+  std::vector< int64_t > l_loop_strides_out      = { 127840,940,15980, 1,20, 0 };
+  std::vector< int64_t > l_packing_strides_left  = {      0,  0,    0, 1, 0,20 };
+  std::vector< int64_t > l_packing_strides_right = {      0,  0,    0, 0,13, 1 };
+
+  at::Tensor l_left    = at::randn( {   5,17,13,20 } );
+  at::Tensor l_right   = at::randn( {   5, 8,47,13 } );
+  at::Tensor l_out     = at::zeros( { 5,8,17,47,20 } );
+  at::Tensor l_out_ref = l_out.clone();
+
+  ContractionMemoryManager l_mem;
+  ContractionBackendTpp l_cont;
+
+  l_cont.init( l_loop_dim_type,
+               l_loop_exec_type,
+               l_loop_sizes,
+               l_loop_strides_left,
+               l_loop_strides_right,
+               l_loop_strides_out_aux,
+               l_loop_strides_out,
+               l_packing_strides_left,
+               l_packing_strides_right,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               kernel_t::ZERO,
+               kernel_t::MADD,
+               kernel_t::UNDEFINED_KTYPE,
+               10,
+               7,
+               2,
+               &l_mem );
+      
+  l_cont.set_loop_nest( loop_nest_t::FLAT );
+  err_t l_err = l_cont.compile();
+  REQUIRE( l_err == err_t::SUCCESS );
+
+  l_mem.alloc_all_memory();
+
+  l_cont.contract( l_left.data_ptr(),
+                   l_right.data_ptr(),
+                   nullptr,
+                   l_out.data_ptr() );
+
+
+  l_out_ref = at::einsum( "zxcb,zyac->zyxab",
+                          { l_left, l_right } );
+
+  REQUIRE( at::allclose( l_out, l_out_ref, 1E-4, 1E-5 ) );
+}
+
+TEST_CASE( "Matmul with a constant left tensor which is packed once.", "[contraction_backend]" ) {
+  //example: [c1,k2,k1,m2,m1],[c1,n1,k2,k1]->[c1,n1,m2,m1]
+  //sizes:   [ 3, 4,16, 2,32],[ 3,16, 4,16]->[ 3,16, 2,32]
+  using namespace einsum_ir::basic;
+
+  std::vector< dim_t >  l_loop_dim_type  = { dim_t::C,
+                                             dim_t::M,
+                                             dim_t::K,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::K };
+  std::vector< exec_t > l_loop_exec_type = { exec_t::SEQ,
+                                             exec_t::OMP,
+                                             exec_t::SEQ,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM };
+
+  //                                                    c1,m2,  k2,m1,n1,k1
+  std::vector< int64_t > l_loop_sizes            = {    3, 2,   4,32,16,16 };
+  std::vector< int64_t > l_loop_strides_left     = { 4096,32,1024, 1, 0,32 };
+  std::vector< int64_t > l_loop_strides_right    = { 1024, 0,  16, 0,64, 1 };
+  std::vector< int64_t > l_loop_strides_out_aux  = {    0, 0,   0, 0, 0, 0 };
+  std::vector< int64_t > l_loop_strides_out      = { 1024,32,   0, 1,64, 0 };
+  std::vector< int64_t > l_packing_strides_left  = {    0, 0,   0, 1, 0,64 };
+  std::vector< int64_t > l_packing_strides_right = {};
+
+  at::Tensor l_left      = at::randn( { 3,4,16,2,32 } );
+  at::Tensor l_left_new  = at::randn( { 3,4,16,2,32 } );
+  at::Tensor l_right     = at::randn( { 3,16,4,16 } );
+  at::Tensor l_out       = at::zeros( { 3,16,2,32 } );
+
+  ContractionMemoryManager l_mem;
+  ContractionBackendTpp l_cont;
+
+  l_cont.init( l_loop_dim_type,
+               l_loop_exec_type,
+               l_loop_sizes,
+               l_loop_strides_left,
+               l_loop_strides_right,
+               l_loop_strides_out_aux,
+               l_loop_strides_out,
+               l_packing_strides_left,
+               l_packing_strides_right,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               kernel_t::ZERO,
+               kernel_t::MADD,
+               kernel_t::UNDEFINED_KTYPE,
+               2,
+               1,
+               1,
+               &l_mem );
+  l_cont.set_constant_inputs( true,
+                              false );
+
+  err_t l_err = l_cont.compile();
+  REQUIRE( l_err == err_t::SUCCESS );
+
+  l_mem.alloc_all_memory();
+
+  at::Tensor l_out_ref = at::einsum( "zabyx,zcab->zcyx",
+                                     { l_left, l_right } );
+  at::Tensor l_out_ref_new = at::einsum( "zabyx,zcab->zcyx",
+                                         { l_left_new, l_right } );
+
+  l_cont.contract( l_left.data_ptr(),
+                   l_right.data_ptr(),
+                   nullptr,
+                   l_out.data_ptr() );
+  REQUIRE( at::allclose( l_out, l_out_ref, 1E-4, 1E-5 ) );
+
+  //the packed data of the first contraction is reused
+  l_cont.contract( l_left_new.data_ptr(),
+                   l_right.data_ptr(),
+                   nullptr,
+                   l_out.data_ptr() );
+  REQUIRE( at::allclose( l_out, l_out_ref, 1E-4, 1E-5 ) );
+
+  //the constant input is packed again after an invalidation
+  l_cont.invalidate_constant_inputs();
+  l_cont.contract( l_left_new.data_ptr(),
+                   l_right.data_ptr(),
+                   nullptr,
+                   l_out.data_ptr() );
+  REQUIRE( at::allclose( l_out, l_out_ref_new, 1E-4, 1E-5 ) );
+}
+
+TEST_CASE( "Tensor contraction with SFC and omp parallelisation and a chain of last touch operations.", "[contraction_backend]" ) {
+  //example: [c1,m1,k1,m1],[c1,n2,n1,k1]->[c1,n2,m1,n1,m1]
+  //sizes:   [ 5,17,13,20],[ 5, 8,47,13]->[ 5, 8,17,47,20]
+  //bias:    [17,20]
+  using namespace einsum_ir::basic;
+
+  std::vector< dim_t >  l_loop_dim_type  = { dim_t::C,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::M, 
+                                             dim_t::N, 
+                                             dim_t::K };
+  std::vector< exec_t > l_loop_exec_type = { exec_t::OMP,
+                                             exec_t::SFC,
+                                             exec_t::SFC,
+                                             exec_t::PRIM, 
+                                             exec_t::PRIM, 
+                                             exec_t::PRIM };
+
+  //                                                     c1,  m2,   n2,m1,n1,k1
+  std::vector< int64_t > l_loop_sizes            = {      5, 17,    8,20,47,13 };  
+  std::vector< int64_t > l_loop_strides_left     = {   4420,260,    0, 1, 0,20 };
+  std::vector< int64_t > l_loop_strides_right    = {   4888,  0,  611, 0,13, 1 };
+  std::vector< int64_t > l_loop_strides_out_aux  = {      0, 20,    0, 1, 0, 0 };
+  std::vector< int64_t > l_loop_strides_out      = { 127840,940,15980, 1,20, 0 };
+  std::vector< int64_t > l_packing_strides_left  = {};
+  std::vector< int64_t > l_packing_strides_right = {};
+
+  at::Tensor l_left    = at::randn( {   5,17,13,20 } );
+  at::Tensor l_right   = at::randn( {   5, 8,47,13 } );
+  at::Tensor l_bias    = at::randn( {        17,20 } );
+  at::Tensor l_out     = at::zeros( { 5,8,17,47,20 } );
+  at::Tensor l_out_ref = l_out.clone();
+
+  ContractionBackendTpp l_cont;
+
+  l_cont.init( l_loop_dim_type,
+               l_loop_exec_type,
+               l_loop_sizes,
+               l_loop_strides_left,
+               l_loop_strides_right,
+               l_loop_strides_out_aux,
+               l_loop_strides_out,
+               l_packing_strides_left,
+               l_packing_strides_right,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               data_t::FP32,
+               kernel_t::ZERO,
+               kernel_t::MADD,
+               kernel_t::UNDEFINED_KTYPE,
+               10,
+               2,
+               3,
+               nullptr );
+
+  l_cont.set_last_touch_ops( { { kernel_t::ADD,    0,   0 },
+                               { kernel_t::SCALE,  0.5, 0 },
+                               { kernel_t::GELU,   0,   0 },
+                               { kernel_t::CLAMP, -0.1, 2 } } );
+
+  err_t l_err = l_cont.compile();
+  REQUIRE( l_err == err_t::SUCCESS );
+
+  l_cont.contract( l_left.data_ptr(),
+                   l_right.data_ptr(),
+                   l_bias.data_ptr(),
+                   l_out.data_ptr() );
+
+  l_out_ref = at::einsum( "zxcb,zyac->zyxab",
+                          { l_left, l_right } );
+  l_out_ref += l_bias.view( { 1, 1, 17, 1, 20 } );
+  l_out_ref = at::gelu( 0.5 * l_out_ref );
+  l_out_ref = at::clamp( l_out_ref, -0.1, 2 );
+
+  REQUIRE( at::allclose( l_out, l_out_ref, 1E-3, 1E-4 ) );
+}
+
+TEST_CASE( "Tensor contraction with BF16 inputs, packing of left tensor and FP32 accumulation.", "[contraction_backend]" ) {
+  //example: [c1,m1,k1,m1],[c1,n2,n1,k1]->[c1,n2,m1,n1,m1]
+  //sizes:   [ 5,17,14,20],[ 5, 8,47,14]->[ 5, 8,17,47,20]
+  using namespace einsum_ir::basic;
+
+  std::vector< dim_t >  l_loop_dim_type  = { dim_t::C,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::K };
+  std::vector< exec_t > l_loop_exec_type = { exec_t::SEQ,
+                                             exec_t::SFC,
+                                             exec_t::SFC,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM };
+
+  //                                                     c1,  m2,   n2,m1,n1,k1
+  std::vector< int64_t > l_loop_sizes            = {      5, 17,    8,20,47,14 };
+  std::vector< int64_t > l_loop_strides_left     = {   4760,280,    0,14, 0, 1 };
+  std::vector< int64_t > l_loop_strides_right    = {   5264,  0,  658, 0,14, 1 };
+  std::vector< int64_t > l_loop_strides_out_aux  = {      0,  0,    0, 0, 0, 0 };
+  std::vector< int64_t > l_loop_strides_out      = { 127840,940,15980, 1,20, 0 };
+  std::vector< int64_t > l_packing_strides_left  = {      0,  0,    0, 1, 0,20 };
+  std::vector< int64_t > l_packing_strides_right = {};
+
+  at::Tensor l_left    = at::randn( {   5,17,14,20 } ).to( at::ScalarType::BFloat16 );
+  at::Tensor l_right   = at::randn( {   5, 8,47,14 } ).to( at::ScalarType::BFloat16 );
+  at::Tensor l_out     = at::zeros( { 5,8,17,47,20 } );
+  at::Tensor l_out_ref = l_out.clone();
+
+  ContractionBackendTpp l_cont;
+
+  l_cont.init( l_loop_dim_type,
+               l_loop_exec_type,
+               l_loop_sizes,
+               l_loop_strides_left,
+               l_loop_strides_right,
+               l_loop_strides_out_aux,
+               l_loop_strides_out,
+               l_packing_strides_left,
+               l_packing_strides_right,
+               data_t::BF16,
+               data_t::BF16,
+               data_t::FP32,
+               data_t::FP32,
+               kernel_t::ZERO,
+               kernel_t::MADD,
+               kernel_t::UNDEFINED_KTYPE,
+               10,
+               5,
+               4,
+               nullptr );
+
+  err_t l_err = l_cont.compile();
+  REQUIRE( l_err == err_t::SUCCESS );
+
+  l_cont.contract( l_left.data_ptr(),
+                   l_right.data_ptr(),
+                   nullptr,
+                   l_out.data_ptr() );
+
+  l_out_ref = at::einsum( "zxcb,zyac->zyxab",
+                          { l_left.to( at::ScalarType::Float ),
+                            l_right.to( at::ScalarType::Float ) } );
+
+  REQUIRE( at::allclose( l_out, l_out_ref, 1E-4, 1E-5 ) );
+}
+
+TEST_CASE( "INT8 matmul with sequential batch dimension and per-channel requantization.", "[contraction_backend]" ) {
+  //example: [c1,k1,m1],[c1,n1,k1]->[c1,n1,m1]
+  //sizes:   [17,13,20],[17,47,13]->[17,47,20]
+  using namespace einsum_ir::basic;
+
+  std::vector< dim_t >  l_loop_dim_type  = { dim_t::C,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::K };
+  std::vector< exec_t > l_loop_exec_type = { exec_t::SEQ,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM };
+
+  //                                                  c1,m1,n1,k1
+  std::vector< int64_t > l_loop_sizes            = {  17,20,47,13 };
+  std::vector< int64_t > l_loop_strides_left     = { 260, 1, 0,20 };
+  std::vector< int64_t > l_loop_strides_right    = { 611, 0,13, 1 };
+  std::vector< int64_t > l_loop_strides_out_aux  = {   0, 1, 0, 0 };
+  std::vector< int64_t > l_loop_strides_out      = { 940, 1,20, 0 };
+  std::vector< int64_t > l_packing_strides_left  = {};
+  std::vector< int64_t > l_packing_strides_right = {};
+
+  at::Tensor l_left    = at::randint( -128, 128, { 17,13,20 }, at::ScalarType::Char );
+  at::Tensor l_right   = at::randint( -128, 128, { 17,47,13 }, at::ScalarType::Char );
+  at::Tensor l_scales  = at::rand( { 20 } ) + 0.5;
+  at::Tensor l_out_acc = at::zeros( { 17,47,20 }, at::ScalarType::Int );
+  at::Tensor l_out     = at::zeros( { 17,47,20 }, at::ScalarType::Char );
+
+  // int32 accumulation
+  ContractionBackendTpp l_cont_acc;
+  l_cont_acc.init( l_loop_dim_type,
+                   l_loop_exec_type,
+                   l_loop_sizes,
+                   l_loop_strides_left,
+                   l_loop_strides_right,
+                   l_loop_strides_out_aux,
+                   l_loop_strides_out,
+                   l_packing_strides_left,
+                   l_packing_strides_right,
+                   data_t::INT8,
+                   data_t::INT8,
+                   data_t::INT32,
+                   data_t::INT32,
+                   kernel_t::ZERO,
+                   kernel_t::MADD,
+                   kernel_t::UNDEFINED_KTYPE,
+                   2,
+                   2,
+                   2,
+                   nullptr );
+
+  err_t l_err = l_cont_acc.compile();
+  REQUIRE( l_err == err_t::SUCCESS );
+
+  l_cont_acc.contract( l_left.data_ptr(),
+                       l_right.data_ptr(),
+                       nullptr,
+                       l_out_acc.data_ptr() );
+
+  at::Tensor l_out_acc_ref = at::einsum( "xcb,xac->xab",
+                                         { l_left.to( at::ScalarType::Long ),
+                                           l_right.to( at::ScalarType::Long ) } );
+  REQUIRE( at::equal( l_out_acc.to( at::ScalarType::Long ), l_out_acc_ref ) );
+
+  // requantization to int8
+  ContractionBackendTpp l_cont;
+  l_cont.init( l_loop_dim_type,
+               l_loop_exec_type,
+               l_loop_sizes,
+               l_loop_strides_left,
+               l_loop_strides_right,
+               l_loop_strides_out_aux,
+               l_loop_strides_out,
+               l_packing_strides_left,
+               l_packing_strides_right,
+               data_t::INT8,
+               data_t::INT8,
+               data_t::INT32,
+               data_t::INT8,
+               kernel_t::ZERO,
+               kernel_t::MADD,
+               kernel_t::REQUANTIZE,
+               2,
+               2,
+               2,
+               nullptr );
+  l_cont.set_last_touch_ops( { { kernel_t::REQUANTIZE, 1.0 / 1024, 3 } } );
+
+  l_err = l_cont.compile();
+  REQUIRE( l_err == err_t::SUCCESS );
+
+  l_cont.contract( l_left.data_ptr(),
+                   l_right.data_ptr(),
+                   l_scales.data_ptr(),
+                   l_out.data_ptr() );
+
+  at::Tensor l_out_ref = at::round( l_out_acc.to( at::ScalarType::Float ) * ( l_scales * float( 1.0 / 1024 ) ) ) + 3;
+  l_out_ref = at::clamp( l_out_ref, -128, 127 );
+  REQUIRE( at::allclose( l_out.to( at::ScalarType::Float ), l_out_ref, 0, 1 ) );
+}
+
+TEST_CASE( "Complex matmul with sequential batch dimension.", "[contraction_backend]" ) {
+  //example: [r1,c1,k1,m1],[r1,c1,n1,k1]->[r1,c1,n1,m1]
+  //sizes:   [ 2,17,13,20],[ 2,17,47,13]->[ 2,17,47,20]
+  using namespace einsum_ir::basic;
+
+  std::vector< dim_t >  l_loop_dim_type  = { dim_t::C,
+                                             dim_t::CPX,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::K };
+  std::vector< exec_t > l_loop_exec_type = { exec_t::SEQ,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM };
+
+  //                                                  c1,   r1,m1,n1,k1
+  std::vector< int64_t > l_loop_sizes            = {  17,    2,20,47,13 };
+  std::vector< int64_t > l_loop_strides_left     = { 260, 4420, 1, 0,20 };
+  std::vector< int64_t > l_loop_strides_right    = { 611,10387, 0,13, 1 };
+  std::vector< int64_t > l_loop_strides_out_aux  = {   0,    0, 0, 0, 0 };
+  std::vector< int64_t > l_loop_strides_out      = { 940,15980, 1,20, 0 };
+  std::vector< int64_t > l_packing_strides_left  = {};
+  std::vector< int64_t > l_packing_strides_right = {};
+
+  at::Tensor l_left    = at::randn( { 2,17,13,20 }, at::ScalarType::Double );
+  at::Tensor l_right   = at::randn( { 2,17,47,13 }, at::ScalarType::Double );
+  at::Tensor l_out     = at::randn( { 2,17,47,20 }, at::ScalarType::Double );
+  at::Tensor l_out_ref = l_out.clone();
+
+  ContractionBackendTpp l_cont;
+
+  l_cont.init( l_loop_dim_type,
+               l_loop_exec_type,
+               l_loop_sizes,
+               l_loop_strides_left,
+               l_loop_strides_right,
+               l_loop_strides_out_aux,
+               l_loop_strides_out,
+               l_packing_strides_left,
+               l_packing_strides_right,
+               data_t::FP64,
+               data_t::FP64,
+               data_t::FP64,
+               data_t::FP64,
+               kernel_t::CPX_ZERO,
+               kernel_t::CPX_MADD,
+               kernel_t::UNDEFINED_KTYPE,
+               2,
+               1,
+               1,
+               nullptr );
+
+  err_t l_err = l_cont.compile();
+  REQUIRE( l_err == err_t::SUCCESS );
+
+  l_cont.contract( l_left.data_ptr(),
+                   l_right.data_ptr(),
+                   nullptr,
+                   l_out.data_ptr() );
+
+  at::Tensor l_left_cpx  = at::view_as_complex( l_left.permute(  { 1, 2, 3, 0 } ).contiguous() );
+  at::Tensor l_right_cpx = at::view_as_complex( l_right.permute( { 1, 2, 3, 0 } ).contiguous() );
+  at::Tensor l_out_cpx   = at::einsum( "xcb,xac->xab",
+                                       { l_left_cpx, l_right_cpx } );
+  l_out_ref = at::view_as_real( l_out_cpx ).permute( { 3, 0, 1, 2 } );
+
+  REQUIRE( at::allclose( l_out, l_out_ref ) );
+}
+
+TEST_CASE( "Complex matmul with sequential batch dimension using the 3m algorithm.", "[contraction_backend]" ) {
+  //example: [r1,c1,k1,m1],[r1,c1,n1,k1]->[r1,c1,n1,m1]
+  //sizes:   [ 2,17,13,20],[ 2,17,47,13]->[ 2,17,47,20]
+  using namespace einsum_ir::basic;
+
+  std::vector< dim_t >  l_loop_dim_type  = { dim_t::C,
+                                             dim_t::CPX,
+                                             dim_t::M,
+                                             dim_t::N,
+                                             dim_t::K };
+  std::vector< exec_t > l_loop_exec_type = { exec_t::SEQ,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM,
+                                             exec_t::PRIM };
+
+  //                                                  c1,   r1,m1,n1,k1
+  std::vector< int64_t > l_loop_sizes            = {  17,    2,20,47,13 };
+  std::vector< int64_t > l_loop_strides_left     = { 260, 4420, 1, 0,20 };
+  std::vector< int64_t > l_loop_strides_right    = { 611,10387, 0,13, 1 };
+  std::vector< int64_t > l_loop_strides_out_aux  = {   0,    0, 0, 0, 0 };
+  std::vector< int64_t > l_loop_strides_out      = { 940,15980, 1,20, 0 };
+  std::vector< int64_t > l_packing_strides_left  = {};
+  std::vector< int64_t > l_packing_strides_right = {};
+
+  at::Tensor l_left    = at::randn( { 2,17,13,20 }, at::ScalarType::Double );
+  at::Tensor l_right   = at::randn( { 2,17,47,13 }, at::ScalarType::Double );
+  at::Tensor l_out     = at::randn( { 2,17,47,20 }, at::ScalarType::Double );
+  at::Tensor l_out_ref = l_out.clone();
+  at::Tensor l_out_init = l_out.clone();
+
+  ContractionBackendTpp l_cont;
+
+  l_cont.init( l_loop_dim_type,
+               l_loop_exec_type,
+               l_loop_sizes,
+               l_loop_strides_left,
+               l_loop_strides_right,
+               l_loop_strides_out_aux,
+               l_loop_strides_out,
+               l_packing_strides_left,
+               l_packing_strides_right,
+               data_t::FP64,
+               data_t::FP64,
+               data_t::FP64,
+               data_t::FP64,
+               kernel_t::UNDEFINED_KTYPE,
+               kernel_t::CPX_MADD_3M,
+               kernel_t::UNDEFINED_KTYPE,
+               2,
+               1,
+               1,
+               nullptr );
+
+  err_t l_err = l_cont.compile();
+  REQUIRE( l_err == err_t::SUCCESS );
+
+  l_cont.contract( l_left.data_ptr(),
+                   l_right.data_ptr(),
+                   nullptr,
+                   l_out.data_ptr() );
+
+  at::Tensor l_left_cpx  = at::view_as_complex( l_left.permute(  { 1, 2, 3, 0 } ).contiguous() );
+  at::Tensor l_right_cpx = at::view_as_complex( l_right.permute( { 1, 2, 3, 0 } ).contiguous() );
+  at::Tensor l_out_cpx   = at::einsum( "xcb,xac->xab",
+                                       { l_left_cpx, l_right_cpx } );
+  l_out_ref = l_out_init + at::view_as_real( l_out_cpx ).permute( { 3, 0, 1, 2 } );
+
+  REQUIRE( at::allclose( l_out, l_out_ref ) );
+}
@@ -0,0 +1,177 @@
+#include "ContractionCostModel.h"
+#include "../parallel/HardwareTopology.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+void einsum_ir::basic::ContractionCostModel::init() {
+  HardwareTopology * l_topology = HardwareTopology::get_default();
+
+  m_machine.vector_bytes         = l_topology->get_vector_bytes();
+  m_machine.num_vector_registers = l_topology->get_num_vector_registers();
+  m_machine.l1_cache_size        = l_topology->get_l1_cache_size();
+  m_machine.l2_cache_size        = l_topology->get_l2_cache_size();
+}
+
+einsum_ir::basic::ContractionCostModel const * einsum_ir::basic::ContractionCostModel::get_default() {
+  static ContractionCostModel l_model = [](){
+    ContractionCostModel l_mod;
+    l_mod.init();
+    return l_mod;
+  }();
+
+  return &l_model;
+}
+
+void einsum_ir::basic::ContractionCostModel::set_machine( machine_params const & i_machine ) {
+  m_machine = i_machine;
+}
+
+einsum_ir::basic::ContractionCostModel::machine_params const & einsum_ir::basic::ContractionCostModel::get_machine() const {
+  return m_machine;
+}
+
+double einsum_ir::basic::ContractionCostModel::efficiency_kernel( blocking const & i_blocking ) const {
+  int64_t l_num_lanes = std::max( m_machine.vector_bytes / i_blocking.num_bytes_scalar, (int64_t) 1 );
+  double l_num_fma_units  = (double) std::max( m_machine.num_fma_units,  (int64_t) 1 );
+  double l_num_load_units = (double) std::max( m_machine.num_load_units, (int64_t) 1 );
+
+  // packed kernels vectorize the c dimension, all other kernels the m dimension
+  int64_t l_size_vec  = i_blocking.size_m;
+  int64_t l_size_rows = i_blocking.size_n;
+  if( i_blocking.size_c > 1 ) {
+    l_size_vec  = i_blocking.size_c;
+    l_size_rows = i_blocking.size_m * i_blocking.size_n;
+  }
+  int64_t l_size_k = i_blocking.size_k * i_blocking.size_br;
+
+  // register blocking: vectors of A, broadcasts of B and the accumulators share the register file
+  int64_t l_num_vecs = (l_size_vec + l_num_lanes - 1) / l_num_lanes;
+  int64_t l_block_vecs = std::min( l_num_vecs,
+                                   std::max( m_machine.num_vector_registers / 4, (int64_t) 1 ) );
+  int64_t l_block_rows = std::min( l_size_rows,
+                                   std::max( (m_machine.num_vector_registers - l_block_vecs - 1) / l_block_vecs, (int64_t) 1 ) );
+
+  // cycles of one k step of a register block, limited by the FMAs or the loads
+  double l_num_fmas  = (double) (l_block_vecs * l_block_rows);
+  double l_num_loads = (double) (l_block_vecs + l_block_rows);
+  double l_cycles_step = std::max( l_num_fmas  / l_num_fma_units,
+                                   l_num_loads / l_num_load_units );
+
+  // the register blocks of a row reuse the A block only if it stays in L1
+  double l_bytes_block_a = (double) l_num_vecs * m_machine.vector_bytes * l_size_k;
+  if( l_bytes_block_a > m_machine.l1_cache_size / 2 ) {
+    l_cycles_step = std::max( l_cycles_step,
+                              l_block_vecs * m_machine.vector_bytes / m_machine.bandwidth_l2 );
+  }
+
+  // every register block loads and stores its accumulators once
+  double l_cycles_block = l_size_k * l_cycles_step + 2 * l_num_fmas / l_num_load_units;
+  int64_t l_num_blocks =   ( (l_num_vecs  + l_block_vecs - 1) / l_block_vecs )
+                         * ( (l_size_rows + l_block_rows - 1) / l_block_rows );
+  double l_cycles_call = l_num_blocks * l_cycles_block + m_machine.call_overhead;
+
+  double l_cycles_peak =   (double) l_size_vec * l_size_rows * l_size_k
+                         / ( l_num_lanes * l_num_fma_units );
+
+  return std::min( l_cycles_peak / l_cycles_call, 1.0 );
+}
+
+einsum_ir::basic::ContractionCostModel::estimate einsum_ir::basic::ContractionCostModel::predict( blocking const & i_blocking ) const {
+  estimate l_est;
+
+  double l_num_bytes = (double) i_blocking.num_bytes_scalar;
+  int64_t l_num_lanes = std::max( m_machine.vector_bytes / i_blocking.num_bytes_scalar, (int64_t) 1 );
+  double l_size_k_prim = (double) (i_blocking.size_k * i_blocking.size_br);
+
+  // number of primitive calls and independent tasks
+  double l_blocks_c = (double) i_blocking.size_all_c / i_blocking.size_c;
+  double l_blocks_m = (double) i_blocking.size_all_m / i_blocking.size_m;
+  double l_blocks_n = (double) i_blocking.size_all_n / i_blocking.size_n;
+  double l_blocks_k = (double) i_blocking.size_all_k / l_size_k_prim;
+  double l_num_calls = l_blocks_c * l_blocks_m * l_blocks_n * l_blocks_k;
+
+  double l_num_tasks = l_blocks_c * l_blocks_m * l_blocks_n;
+  if( i_blocking.split_k ) {
+    l_num_tasks *= l_blocks_k;
+  }
+  double l_num_threads = (double) std::max( i_blocking.num_threads, (int64_t) 1 );
+  l_est.efficiency_parallel = l_num_tasks / ( std::ceil( l_num_tasks / l_num_threads ) * l_num_threads );
+  double l_num_threads_busy = std::min( l_num_threads, std::ceil( l_num_tasks ) );
+
+  // compute
+  l_est.efficiency_kernel = efficiency_kernel( i_blocking );
+  double l_cycles_peak_call =   (double) i_blocking.size_c * i_blocking.size_m * i_blocking.size_n * l_size_k_prim
+                              / ( l_num_lanes * std::max( m_machine.num_fma_units, (int64_t) 1 ) );
+  l_est.time_compute =   l_num_calls * l_cycles_peak_call / l_est.efficiency_kernel
+                       / ( l_num_threads * l_est.efficiency_parallel );
+
+  // L2: the inputs are streamed, C is served by L1 if it fits into one half
+  double l_bytes_a = (double) i_blocking.size_c * i_blocking.size_m * l_size_k_prim * l_num_bytes;
+  double l_bytes_b = (double) i_blocking.size_c * i_blocking.size_n * l_size_k_prim * l_num_bytes;
+  double l_bytes_c = (double) i_blocking.size_c * i_blocking.size_m * i_blocking.size_n * l_num_bytes;
+  double l_bytes_call = l_bytes_a + l_bytes_b;
+  if( l_bytes_c > m_machine.l1_cache_size / 2 ) {
+    l_bytes_call += 2 * l_bytes_c;
+  }
+  l_est.bytes_l2 = l_num_calls * l_bytes_call;
+  l_est.time_l2 = l_est.bytes_l2 / ( m_machine.bandwidth_l2 * l_num_threads_busy );
+
+  // memory: neighboring tasks reuse the A and B panels which fit into one half of L2
+  double l_bytes_panels =   (double) i_blocking.size_c * ( i_blocking.size_m + i_blocking.size_n )
+                          * i_blocking.size_all_k * l_num_bytes;
+  double l_num_tiles = std::max( std::floor( m_machine.l2_cache_size / 2 / l_bytes_panels ), 1.0 );
+  double l_side = std::sqrt( l_num_tiles );
+  double l_reads_a = std::max( l_blocks_n / l_side, 1.0 );
+  double l_reads_b = std::max( l_blocks_m / l_side, 1.0 );
+
+  double l_size_all_a   = (double) i_blocking.size_all_c * i_blocking.size_all_m * i_blocking.size_all_k;
+  double l_size_all_b   = (double) i_blocking.size_all_c * i_blocking.size_all_n * i_blocking.size_all_k;
+  double l_size_all_out = (double) i_blocking.size_all_c * i_blocking.size_all_m * i_blocking.size_all_n;
+  l_est.bytes_memory = l_num_bytes * (   l_size_all_a * l_reads_a
+                                       + l_size_all_b * l_reads_b
+                                       + 2 * l_size_all_out );
+  l_est.time_memory = l_est.bytes_memory / m_machine.bandwidth_memory;
+
+  l_est.time = std::max( l_est.time_compute,
+                         std::max( l_est.time_l2,
+                                   l_est.time_memory ) );
+
+  return l_est;
+}
+
+void einsum_ir::basic::ContractionCostModel::blocking_targets( int64_t   i_size_kernel_in,
+                                                               int64_t   i_size_kernel_out,
+                                                               int64_t   i_num_bytes_scalar_in,
+                                                               int64_t   i_num_bytes_scalar_out,
+                                                               int64_t & o_target_thread_tasks,
+                                                               int64_t & o_target_blocking_k ) const {
+  int64_t l_bytes_in  = std::max( i_size_kernel_in  * i_num_bytes_scalar_in,  (int64_t) 1 );
+  int64_t l_bytes_out = std::max( i_size_kernel_out * i_num_bytes_scalar_out, (int64_t) 1 );
+  int64_t l_half = m_machine.l2_cache_size / 2;
+
+  o_target_blocking_k = std::max( l_half / l_bytes_in, (int64_t) 1 );
+  int64_t l_bytes_panels = std::min( o_target_blocking_k * l_bytes_in, l_half );
+  o_target_thread_tasks = std::max( (m_machine.l2_cache_size - l_bytes_panels) / l_bytes_out, (int64_t) 1 );
+}
+
+std::string einsum_ir::basic::ContractionCostModel::describe( blocking const & i_blocking,
+                                                              estimate const & i_estimate ) {
+  std::ostringstream l_desc;
+  l_desc.precision( 3 );
+  l_desc << "br="  << i_blocking.size_br
+         << " c="  << i_blocking.size_c
+         << " m="  << i_blocking.size_m
+         << " n="  << i_blocking.size_n
+         << " k="  << i_blocking.size_k
+         << ": kernel efficiency "   << i_estimate.efficiency_kernel
+         << ", parallel efficiency " << i_estimate.efficiency_parallel
+         << ", compute "             << i_estimate.time_compute
+         << ", l2 "                  << i_estimate.time_l2
+         << " (" << i_estimate.bytes_l2 << " bytes)"
+         << ", memory "              << i_estimate.time_memory
+         << " (" << i_estimate.bytes_memory << " bytes)"
+         << " -> "                   << i_estimate.time << " cycles";
+
+  return l_desc.str();
+}
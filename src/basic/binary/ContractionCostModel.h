@@ -0,0 +1,172 @@
+#ifndef EINSUM_IR_BASIC_BINARY_CONTRACTION_COST_MODEL
+#define EINSUM_IR_BASIC_BINARY_CONTRACTION_COST_MODEL
+
+#include <string>
+#include "../constants.h"
+
+namespace einsum_ir {
+  namespace basic {
+    class ContractionCostModel;
+  }
+}
+
+/**
+ * Analytical performance model of a blocked binary contraction.
+ * A primitive is modeled as a register-blocked microkernel whose efficiency follows from the vector utilization,
+ * the ratio of loads to FMAs, the reuse of A in L1 and the cost of loading and storing the accumulators.
+ * The memory traffic assumes that the C blocks of a thread stay in L2 while the A and B panels are streamed.
+ * Compute, L2 and memory times overlap, i.e., the predicted time is the maximum of the three.
+ * All times are given in cycles. Derived classes may override the predictions.
+ **/
+class einsum_ir::basic::ContractionCostModel {
+  public:
+    //! parameters of the machine
+    struct machine_params {
+      //! width of the vector registers in bytes
+      int64_t vector_bytes         = 64;
+      //! number of vector registers
+      int64_t num_vector_registers = 32;
+      //! number of vector FMAs per cycle and core
+      int64_t num_fma_units        = 2;
+      //! number of vector loads per cycle and core
+      int64_t num_load_units       = 2;
+      //! cycles spent in a kernel call besides the computations
+      double  call_overhead        = 30;
+      //! size of the L1 data cache in bytes
+      int64_t l1_cache_size        = 49152;
+      //! size of the L2 cache in bytes
+      int64_t l2_cache_size        = 1048576;
+      //! L2 bandwidth per core in bytes per cycle
+      double  bandwidth_l2         = 48;
+      //! memory bandwidth of all cores in bytes per cycle
+      double  bandwidth_memory     = 32;
+    };
+
+    //! primitive sizes and the contraction around them
+    struct blocking {
+      //! primitive sizes
+      int64_t size_br          = 1;
+      int64_t size_c           = 1;
+      int64_t size_m           = 1;
+      int64_t size_n           = 1;
+      int64_t size_k           = 1;
+      //! sizes of all dimensions of the contraction
+      int64_t size_all_c       = 1;
+      int64_t size_all_m       = 1;
+      int64_t size_all_n       = 1;
+      int64_t size_all_k       = 1;
+      //! number of bytes per scalar
+      int64_t num_bytes_scalar = 4;
+      //! number of threads
+      int64_t num_threads      = 1;
+      //! true if k dimensions may be parallelized
+      bool    split_k          = false;
+    };
+
+    //! predicted performance of a blocking
+    struct estimate {
+      //! fraction of the peak which is reached by the primitive
+      double efficiency_kernel   = 0;
+      //! fraction of the threads doing useful work
+      double efficiency_parallel = 0;
+      //! cycles of the computations
+      double time_compute        = 0;
+      //! bytes transferred between L2 and the cores
+      double bytes_l2            = 0;
+      //! cycles of the L2 transfers
+      double time_l2             = 0;
+      //! bytes transferred between memory and L2
+      double bytes_memory        = 0;
+      //! cycles of the memory transfers
+      double time_memory         = 0;
+      //! predicted cycles of the contraction
+      double time                = 0;
+    };
+
+  private:
+    //! parameters of the machine
+    machine_params m_machine;
+
+  public:
+    /**
+     * Destructor.
+     **/
+    virtual ~ContractionCostModel() = default;
+
+    /**
+     * Initializes the vector registers and caches of the machine from the hardware topology.
+     * The remaining parameters keep their defaults.
+     **/
+    void init();
+
+    /**
+     * Gets the cost model of the machine, initialized from the hardware topology.
+     *
+     * @return cost model.
+     **/
+    static ContractionCostModel const * get_default();
+
+    /**
+     * Sets the parameters of the machine.
+     *
+     * @param i_machine parameters of the machine.
+     **/
+    void set_machine( machine_params const & i_machine );
+
+    /**
+     * Gets the parameters of the machine.
+     *
+     * @return parameters of the machine.
+     **/
+    machine_params const & get_machine() const;
+
+    /**
+     * Predicts the fraction of the peak reached by a primitive.
+     *
+     * @param i_blocking blocking.
+     *
+     * @return efficiency in (0,1].
+     **/
+    virtual double efficiency_kernel( blocking const & i_blocking ) const;
+
+    /**
+     * Predicts the performance of a blocking.
+     *
+     * @param i_blocking blocking.
+     *
+     * @return estimate.
+     **/
+    virtual estimate predict( blocking const & i_blocking ) const;
+
+    /**
+     * Derives the blocking of the loops around the primitive.
+     * A sequential block of k iterations keeps its A and B panels in one half of L2,
+     * the other half holds the C blocks of a thread.
+     *
+     * @param i_size_kernel_in number of scalars read from both inputs by a primitive.
+     * @param i_size_kernel_out number of scalars of the primitive's output.
+     * @param i_num_bytes_scalar_in number of bytes per scalar of the inputs.
+     * @param i_num_bytes_scalar_out number of bytes per scalar of the output.
+     * @param o_target_thread_tasks number of C blocks per thread.
+     * @param o_target_blocking_k number of primitives in a sequential k block.
+     **/
+    virtual void blocking_targets( int64_t   i_size_kernel_in,
+                                   int64_t   i_size_kernel_out,
+                                   int64_t   i_num_bytes_scalar_in,
+                                   int64_t   i_num_bytes_scalar_out,
+                                   int64_t & o_target_thread_tasks,
+                                   int64_t & o_target_blocking_k ) const;
+
+    /**
+     * Describes a blocking and its estimate in a single line.
+     *
+     * @param i_blocking blocking.
+     * @param i_estimate estimate of the blocking.
+     *
+     * @return description.
+     **/
+    static std::string describe( blocking const & i_blocking,
+                                 estimate const & i_estimate );
+};
+
+#endif
@@ -0,0 +1,126 @@
+#include "catch.hpp"
+#include "ContractionCostModel.h"
+#include "ContractionOptimizer.h"
+
+TEST_CASE( "Predictions of the analytical cost model.", "[contraction_cost_model]" ) {
+  using namespace einsum_ir::basic;
+
+  ContractionCostModel l_model;
+
+  ContractionCostModel::blocking l_blocking;
+  l_blocking.size_all_m       = 256;
+  l_blocking.size_all_n       = 256;
+  l_blocking.size_all_k       = 256;
+  l_blocking.num_bytes_scalar = 4;
+  l_blocking.num_threads      = 1;
+
+  // tiny primitives are dominated by the call overhead
+  ContractionCostModel::blocking l_tiny = l_blocking;
+  ContractionCostModel::blocking l_large = l_blocking;
+  l_large.size_m = 64;
+  l_large.size_n = 12;
+  l_large.size_k = 64;
+  REQUIRE( l_model.efficiency_kernel( l_large ) > l_model.efficiency_kernel( l_tiny ) );
+  REQUIRE( l_model.predict( l_large ).time < l_model.predict( l_tiny ).time );
+
+  // partially filled vectors lower the efficiency
+  ContractionCostModel::blocking l_full = l_large;
+  ContractionCostModel::blocking l_partial = l_large;
+  l_full.size_m = 16;
+  l_partial.size_m = 17;
+  REQUIRE( l_model.efficiency_kernel( l_full ) > l_model.efficiency_kernel( l_partial ) );
+
+  // a single task keeps three of four threads idle
+  ContractionCostModel::blocking l_single = l_large;
+  l_single.size_all_m  = 64;
+  l_single.size_all_n  = 12;
+  l_single.num_threads = 4;
+  ContractionCostModel::estimate l_est = l_model.predict( l_single );
+  REQUIRE( l_est.efficiency_parallel == Approx( 0.25 ) );
+  REQUIRE( l_est.time >= l_est.time_compute );
+  REQUIRE( l_est.time >= l_est.time_memory );
+
+  std::string l_desc = ContractionCostModel::describe( l_single,
+                                                       l_est );
+  REQUIRE( l_desc.find( "m=64" ) != std::string::npos );
+
+  // one half of L2 for the inputs of a k block, the other half for C blocks
+  ContractionCostModel::machine_params l_machine;
+  l_machine.l2_cache_size = 1048576;
+  l_model.set_machine( l_machine );
+
+  int64_t l_target_thread_tasks = 0;
+  int64_t l_target_blocking_k = 0;
+  l_model.blocking_targets( 1024,
+                            256,
+                            4,
+                            4,
+                            l_target_thread_tasks,
+                            l_target_blocking_k );
+  REQUIRE( l_target_blocking_k == 128 );
+  REQUIRE( l_target_thread_tasks == 512 );
+}
+
+TEST_CASE( "Contraction optimizer using the analytical cost model.", "[contraction_cost_model]" ) {
+  using namespace einsum_ir::basic;
+
+  std::vector< iter_property > l_iters = { {dim_t::M, exec_t::SEQ, 256,   1,   0, 0,   1},
+                                           {dim_t::N, exec_t::SEQ, 256,   0, 256, 0, 256},
+                                           {dim_t::K, exec_t::SEQ, 256, 256,   1, 0,   0} };
+
+  kernel_t l_ktype_main = kernel_t::MADD;
+  int64_t l_num_threads_shared = 4;
+  int64_t l_num_threads_m = 1;
+  int64_t l_num_threads_n = 1;
+
+  ContractionCostModel l_model;
+
+  ContractionOptimizer l_opt;
+  l_opt.init( &l_iters,
+              &l_ktype_main,
+              16,
+              64,
+              256,
+              true,
+              false,
+              false,
+              packed_gemm_t::NONE,
+              false,
+              false,
+              4,
+              1024 * 1024,
+              &l_num_threads_shared,
+              &l_num_threads_m,
+              &l_num_threads_n );
+  l_opt.set_tuning_database( nullptr );
+  l_opt.set_cost_model( &l_model );
+  REQUIRE( l_opt.optimize() == err_t::SUCCESS );
+
+  std::string const & l_explanation = l_opt.get_explanation();
+  REQUIRE( l_explanation.find( "chosen:" ) != std::string::npos );
+  REQUIRE( l_explanation.find( "blocking:" ) != std::string::npos );
+
+  // the primitive fills the vectors and the loops still cover the contraction
+  int64_t l_num_iters = l_iters.size();
+  REQUIRE( l_iters[l_num_iters - 1].exec_type == exec_t::PRIM );
+  REQUIRE( l_iters[l_num_iters - 2].exec_type == exec_t::PRIM );
+  REQUIRE( l_iters[l_num_iters - 3].exec_type == exec_t::PRIM );
+
+  int64_t l_size_prim_m = 1;
+  int64_t l_sizes[3] = { 1, 1, 1 };
+  for( std::size_t l_id = 0; l_id < l_iters.size(); l_id++ ) {
+    if( l_iters[l_id].dim_type == dim_t::M ) {
+      l_sizes[0] *= l_iters[l_id].size;
+      if( l_iters[l_id].exec_type == exec_t::PRIM ) {
+        l_size_prim_m *= l_iters[l_id].size;
+      }
+    }
+    if( l_iters[l_id].dim_type == dim_t::N ) l_sizes[1] *= l_iters[l_id].size;
+    if( l_iters[l_id].dim_type == dim_t::K ) l_sizes[2] *= l_iters[l_id].size;
+  }
+  REQUIRE( l_size_prim_m % 16 == 0 );
+  REQUIRE( l_sizes[0] == 256 );
+  REQUIRE( l_sizes[1] == 256 );
+  REQUIRE( l_sizes[2] == 256 );
+  REQUIRE( l_num_threads_shared * l_num_threads_m * l_num_threads_n == 4 );
+}
@@ -1,40 +1,58 @@
 #include "ContractionMemoryManager.h"
-
-#ifdef _OPENMP
-#include <omp.h>
-#endif
+#include "../parallel/ExecutionContext.h"
+#include "../parallel/NumaTopology.h"
 
 einsum_ir::basic::ContractionMemoryManager::~ContractionMemoryManager() {
   for( std::size_t l_id = 0; l_id < m_thread_memory.size(); l_id++ ){
     if( m_thread_memory[l_id] != nullptr ){
-      delete [] (char *) m_thread_memory[l_id];
+      NumaTopology::free_pages( m_thread_memory[l_id],
+                                m_alloc_thread_mem,
+                                m_page_types[l_id] );
     }
   }
 }
 
 void einsum_ir::basic::ContractionMemoryManager::alloc_all_memory(){
+  //keep a previous allocation if it is large enough
+  if(    (int64_t) m_thread_memory.size() == m_num_threads
+      && m_alloc_thread_mem >= m_req_thread_mem + m_alignment_line ){
+    return;
+  }
+  for( std::size_t l_id = 0; l_id < m_thread_memory.size(); l_id++ ){
+    if( m_thread_memory[l_id] != nullptr ){
+      NumaTopology::free_pages( m_thread_memory[l_id],
+                                m_alloc_thread_mem,
+                                m_page_types[l_id] );
+    }
+  }
+  m_thread_memory.clear();
+  m_aligned_thread_memory.clear();
+  m_page_types.clear();
+
   if( m_req_thread_mem ){
     m_thread_memory.resize( m_num_threads, nullptr );
     m_aligned_thread_memory.resize(m_num_threads, nullptr);
+    m_page_types.resize( m_num_threads, NumaTopology::get_page_type() );
+    m_alloc_thread_mem = m_req_thread_mem + m_alignment_line;
 
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(m_num_threads)
-#endif
-    for( int64_t l_thread_id = 0; l_thread_id < m_num_threads; l_thread_id++ ){
-      //allocate memory
-      char * l_ptr = new char[ m_req_thread_mem + m_alignment_line ];
+    ExecutionContext::get_default()->parallel( m_num_threads,
+                                               [&]( int64_t l_thread_id ){
+      //allocate fresh pages which are not touched by other threads
+      char * l_ptr = NumaTopology::alloc_pages( m_alloc_thread_mem,
+                                                m_page_types[l_thread_id] );
       m_thread_memory[l_thread_id] = l_ptr;
+      int64_t l_size_page = NumaTopology::get_size_page( m_page_types[l_thread_id] );
 
       //allign data in memory
       int64_t l_align_offset = (unsigned long)l_ptr % m_alignment_line;
       l_align_offset = l_align_offset ? m_alignment_line - l_align_offset : 0;
       m_aligned_thread_memory[l_thread_id] = l_ptr + l_align_offset;
 
-      //first touch policy
-      for( int64_t l_mem_id = 0; l_mem_id <= m_req_thread_mem; l_mem_id++ ){
-        m_aligned_thread_memory[l_thread_id][l_mem_id] = 0;
+      //first touch policy, fresh pages are zero and a single write per page faults them in
+      for( int64_t l_mem_id = 0; l_mem_id < m_alloc_thread_mem; l_mem_id += l_size_page ){
+        l_ptr[l_mem_id] = 0;
       }
-    }
+    } );
   }
 }
 
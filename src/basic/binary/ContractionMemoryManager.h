@@ -22,6 +22,10 @@ class einsum_ir::basic::ContractionMemoryManager{
 
     //! required memory per thread
     int64_t m_req_thread_mem = 0;
+    //! allocated memory per thread
+    int64_t m_alloc_thread_mem = 0;
+    //! thread specific type of the pages backing the thread memory
+    std::vector<page_t> m_page_types;
     //! number of threads
     int64_t m_num_threads = 1;
     
@@ -33,6 +37,9 @@ class einsum_ir::basic::ContractionMemoryManager{
 
     /**
      * Allocates the required memory.
+     * Every thread allocates and first-touches its own pages such that they are placed on the thread's NUMA node.
+     * The pages are of the type set in NumaTopology::set_page_type.
+     * A previous allocation is kept if it is large enough, otherwise it is replaced.
      **/
     void alloc_all_memory();
 
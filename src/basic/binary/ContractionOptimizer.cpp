@@ -1,6 +1,8 @@
 #include "ContractionOptimizer.h"
+#include "../parallel/HardwareTopology.h"
 #include <algorithm>
 #include <cmath>
+#include <string>
 
 void einsum_ir::basic::ContractionOptimizer::init( std::vector< iter_property > * i_iter_space,
                                                    kernel_t                     * i_ktype_main,
@@ -11,6 +13,8 @@ void einsum_ir::basic::ContractionOptimizer::init( std::vector< iter_property >
                                                    bool                           i_br_gemm_support,
                                                    bool                           i_packing_support,
                                                    packed_gemm_t                  i_packed_gemm_support,
+                                                   bool                           i_split_k_support,
+                                                   bool                           i_cpx_3m_support,
                                                    int64_t                        i_num_bytes_scalar_out,
                                                    int64_t                        i_l2_cache_size,
                                                    int64_t                      * io_num_threads_shared,
@@ -29,9 +33,17 @@ void einsum_ir::basic::ContractionOptimizer::init( std::vector< iter_property >
   m_br_gemm_support = i_br_gemm_support;
   m_packing_support = i_packing_support;
   m_packed_gemm_support = i_packed_gemm_support;
+  m_split_k_support = i_split_k_support;
+  m_cpx_3m_support = i_cpx_3m_support;
 
   m_num_bytes_scalar_out = i_num_bytes_scalar_out;
   m_l2_cache_size = i_l2_cache_size;
+  if( m_l2_cache_size <= 0 ){
+    m_l2_cache_size = HardwareTopology::get_default()->get_l2_cache_size();
+  }
+  m_l1_cache_size = HardwareTopology::get_default()->get_l1_cache_size();
+  m_l3_cache_size = HardwareTopology::get_default()->get_l3_cache_size();
+  m_num_bytes_scalar_in = i_num_bytes_scalar_out;
 
   m_num_threads_sfc_m   = io_num_threads_sfc_m;
   m_num_threads_sfc_n   = io_num_threads_sfc_n;
@@ -42,9 +54,100 @@ void einsum_ir::basic::ContractionOptimizer::init( std::vector< iter_property >
   //small power of 2 to avoid extra overhead and still utilise the stride one dimension to some extend
   //heuristic right now, could choose this parameter architecture dependent
   m_target_extra_packing = 8;
+
+  //the 3m algorithm saves one of four gemms but adds O(mk+kn+mn) element-wise operations per kernel call
+  //heuristic right now, only pays off for long k dimensions
+  m_target_cpx_3m_k = 64;
+
+  m_tuning_database = ContractionTuningDatabase::get_default();
+}
+
+void einsum_ir::basic::ContractionOptimizer::set_tuning_database( ContractionTuningDatabase * i_database ){
+  m_tuning_database = i_database;
+}
+
+void einsum_ir::basic::ContractionOptimizer::set_tuning_signature( data_t   i_dtype_left,
+                                                                   data_t   i_dtype_right,
+                                                                   data_t   i_dtype_comp,
+                                                                   data_t   i_dtype_out,
+                                                                   kernel_t i_ktype_first_touch,
+                                                                   kernel_t i_ktype_last_touch ){
+  m_dtype_left        = i_dtype_left;
+  m_dtype_right       = i_dtype_right;
+  m_dtype_comp        = i_dtype_comp;
+  m_dtype_out         = i_dtype_out;
+  m_ktype_first_touch = i_ktype_first_touch;
+  m_ktype_last_touch  = i_ktype_last_touch;
+}
+
+void einsum_ir::basic::ContractionOptimizer::set_cache_sizes( int64_t i_l1_cache_size,
+                                                              int64_t i_l3_cache_size ){
+  m_l1_cache_size = i_l1_cache_size;
+  m_l3_cache_size = i_l3_cache_size;
+}
+
+void einsum_ir::basic::ContractionOptimizer::set_num_bytes_scalar_in( int64_t i_num_bytes_scalar_in ){
+  m_num_bytes_scalar_in = i_num_bytes_scalar_in;
+}
+
+void einsum_ir::basic::ContractionOptimizer::set_keep_k_whole( bool i_keep_k_whole ){
+  m_keep_k_whole = i_keep_k_whole;
+}
+
+void einsum_ir::basic::ContractionOptimizer::set_cost_model( ContractionCostModel const * i_cost_model ){
+  m_cost_model = i_cost_model;
+}
+
+std::string const & einsum_ir::basic::ContractionOptimizer::get_explanation() const {
+  return m_explanation;
+}
+
+void einsum_ir::basic::ContractionOptimizer::apply_tuning_params( tuning_params const & i_params ){
+  if( i_params.target_m > 0 ) m_target_m = i_params.target_m;
+  if( i_params.target_n > 0 ) m_target_n = i_params.target_n;
+  if( i_params.target_k > 0 && !m_keep_k_whole ) m_target_k = i_params.target_k;
+  if( i_params.l2_cache_size > 0 ) m_l2_cache_size = i_params.l2_cache_size;
+
+  m_generate_sfcs   = m_generate_sfcs   && i_params.generate_sfcs;
+  m_br_gemm_support = m_br_gemm_support && i_params.br_gemm_support;
+  m_packing_support = m_packing_support && i_params.packing_support;
+  if( !i_params.packed_gemm ){
+    m_packed_gemm_support = packed_gemm_t::NONE;
+  }
+
+  if( !i_params.cost_model ){
+    m_cost_model = nullptr;
+  }
+  else if( m_cost_model == nullptr ){
+    m_cost_model = ContractionCostModel::get_default();
+  }
 }
 
 einsum_ir::basic::err_t einsum_ir::basic::ContractionOptimizer::optimize(){
+  // look up tuned parameters of the unoptimized contraction
+  tuning_params l_tuned;
+  bool l_has_tuned = false;
+  if( m_tuning_database != nullptr ){
+    std::string l_signature = ContractionTuningDatabase::signature( *m_iter_space,
+                                                                    m_dtype_left,
+                                                                    m_dtype_right,
+                                                                    m_dtype_comp,
+                                                                    m_dtype_out,
+                                                                    m_ktype_first_touch,
+                                                                    *m_ktype_main,
+                                                                    m_ktype_last_touch,
+                                                                    m_num_threads,
+                                                                    m_packed_gemm_support,
+                                                                    m_split_k_support,
+                                                                    m_cpx_3m_support );
+    l_has_tuned = m_tuning_database->find( l_signature,
+                                           l_tuned );
+  }
+  if( l_has_tuned ){
+    apply_tuning_params( l_tuned );
+  }
+  m_explanation.clear();
+
   // removes size 1 iters
   remove_empty_iters();
 
@@ -70,6 +173,17 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionOptimizer::optimize(){
                        m_num_threads_sfc_n
                       );
 
+  // tuned thread split, if it fits the generated sfc
+  if(    l_has_tuned
+      && l_tuned.num_threads_shared > 0
+      && l_tuned.num_threads_shared * l_tuned.num_threads_sfc_m * l_tuned.num_threads_sfc_n == m_num_threads
+      && l_tuned.num_threads_sfc_m <= m_size_sfc_m
+      && l_tuned.num_threads_sfc_n <= m_size_sfc_n ){
+    *m_num_threads_shared = l_tuned.num_threads_shared;
+    *m_num_threads_sfc_m  = l_tuned.num_threads_sfc_m;
+    *m_num_threads_sfc_n  = l_tuned.num_threads_sfc_n;
+  }
+
   return err_t::SUCCESS;
 }
 
@@ -179,6 +293,12 @@ void einsum_ir::basic::ContractionOptimizer::get_size_all_m_n( int64_t & o_size_
 void einsum_ir::basic::ContractionOptimizer::set_kernel_targets_heuristic( int64_t * i_potential_kernel_size,
                                                                            int64_t * io_kernel_targets,
                                                                            bool    * i_iter_required ){
+  //whole k dimensions are targeted as is
+  if( m_keep_k_whole ){
+    io_kernel_targets[ PRIM_BR ] = i_potential_kernel_size[ PRIM_BR ];
+    io_kernel_targets[ PRIM_K  ] = i_potential_kernel_size[ PRIM_K  ];
+  }
+
   //adapt all kernel target sizes depending on what is possible e.g. small k kernel -> choose bigger m target
   if( i_potential_kernel_size[ PRIM_C ] > 1 ){
     io_kernel_targets[ PRIM_C  ] = i_potential_kernel_size[ PRIM_C ];
@@ -210,6 +330,23 @@ void einsum_ir::basic::ContractionOptimizer::set_kernel_targets_heuristic( int64
   int64_t l_size_m, l_size_n;
   get_size_all_m_n( l_size_m, l_size_n );
   int64_t l_possible_parallelism = l_size_m * l_size_n;
+
+  //parallel k dimensions offer additional parallelism if the output tensor is small
+  int64_t l_size_c = 1;
+  int64_t l_size_k = 1;
+  std::vector<iter_property>::iterator l_it;
+  for( l_it = m_iter_space->begin(); l_it < m_iter_space->end(); l_it++ ){
+    if( l_it->dim_type == dim_t::C ){
+      l_size_c *= l_it->size;
+    }
+    if( l_it->dim_type == dim_t::K ){
+      l_size_k *= l_it->size;
+    }
+  }
+  if(    m_split_k_support
+      && l_size_c * l_size_m * l_size_n * m_num_bytes_scalar_out <= m_l2_cache_size ){
+    l_possible_parallelism *= std::max( l_size_k / (io_kernel_targets[PRIM_K] * io_kernel_targets[PRIM_BR]), (int64_t)1 );
+  }
   while( l_possible_parallelism / (io_kernel_targets[PRIM_M] * io_kernel_targets[PRIM_N]) < m_num_threads &&
          io_kernel_targets[PRIM_M] * io_kernel_targets[PRIM_N] > 1 ){
     if(io_kernel_targets[PRIM_M] < io_kernel_targets[PRIM_N]){
@@ -228,6 +365,125 @@ void einsum_ir::basic::ContractionOptimizer::set_kernel_targets_heuristic( int64
 
 }
 
+void einsum_ir::basic::ContractionOptimizer::set_kernel_targets_model( int64_t * i_potential_kernel_size,
+                                                                       int64_t * io_kernel_targets,
+                                                                       bool    * i_iter_required ){
+  //sizes of the whole contraction
+  int64_t l_size_all_c = 1;
+  int64_t l_size_all_k = 1;
+  int64_t l_size_all_m, l_size_all_n;
+  get_size_all_m_n( l_size_all_m, l_size_all_n );
+  std::vector<iter_property>::iterator l_it;
+  for( l_it = m_iter_space->begin(); l_it < m_iter_space->end(); l_it++ ){
+    if( l_it->dim_type == dim_t::C ){
+      l_size_all_c *= l_it->size;
+    }
+    if( l_it->dim_type == dim_t::K ){
+      l_size_all_k *= l_it->size;
+    }
+  }
+
+  //candidates are the divisors closest to powers of two, packed kernels use the whole C dimension,
+  //a required BR dimension (extra packing) is never collapsed to size 1, whole k dimensions are the only k candidates
+  //enum                            {PRIM_BR = 0, PRIM_C  = 1, PRIM_M  = 2, PRIM_N  = 3, PRIM_K  = 4};
+  int64_t l_max_size[] = {          64,            1,          256,          256,          512};
+  std::vector<int64_t> l_candidates[5];
+  for( int64_t l_prim_id = 0; l_prim_id < 5; l_prim_id++ ){
+    int64_t l_size = i_potential_kernel_size[l_prim_id];
+    if(    l_prim_id == PRIM_C
+        || ( m_keep_k_whole && ( l_prim_id == PRIM_BR || l_prim_id == PRIM_K ) ) ){
+      l_candidates[l_prim_id].push_back( l_size );
+      continue;
+    }
+    for( int64_t l_target = 1; l_target <= std::min( l_size, l_max_size[l_prim_id] ); l_target *= 2 ){
+      int64_t l_split = find_split( l_size, l_target );
+      if(    l_prim_id == PRIM_BR
+          && i_iter_required[PRIM_BR]
+          && l_split == 1
+          && l_size > 1 ){
+        continue;
+      }
+      if(    l_split <= l_max_size[l_prim_id]
+          && std::find( l_candidates[l_prim_id].begin(), l_candidates[l_prim_id].end(), l_split ) == l_candidates[l_prim_id].end() ){
+        l_candidates[l_prim_id].push_back( l_split );
+      }
+    }
+    if( l_candidates[l_prim_id].empty() ){
+      l_candidates[l_prim_id].push_back( find_split( l_size, l_max_size[l_prim_id] ) );
+    }
+  }
+
+  //parallel k dimensions offer additional parallelism if the output tensor is small
+  bool l_split_k =    m_split_k_support
+                   && l_size_all_c * l_size_all_m * l_size_all_n * m_num_bytes_scalar_out <= m_l2_cache_size;
+
+  //predict all combinations
+  std::vector< ContractionCostModel::blocking > l_blockings;
+  std::vector< ContractionCostModel::estimate > l_estimates;
+  for( int64_t l_br : l_candidates[PRIM_BR] ){
+    for( int64_t l_m : l_candidates[PRIM_M] ){
+      for( int64_t l_n : l_candidates[PRIM_N] ){
+        for( int64_t l_k : l_candidates[PRIM_K] ){
+          ContractionCostModel::blocking l_blocking;
+          l_blocking.size_br          = l_br;
+          l_blocking.size_c           = l_candidates[PRIM_C][0];
+          l_blocking.size_m           = l_m;
+          l_blocking.size_n           = l_n;
+          l_blocking.size_k           = l_k;
+          l_blocking.size_all_c       = l_size_all_c;
+          l_blocking.size_all_m       = l_size_all_m;
+          l_blocking.size_all_n       = l_size_all_n;
+          l_blocking.size_all_k       = l_size_all_k;
+          l_blocking.num_bytes_scalar = m_num_bytes_scalar_in;
+          l_blocking.num_threads      = m_num_threads;
+          l_blocking.split_k          = l_split_k;
+
+          l_blockings.push_back( l_blocking );
+          l_estimates.push_back( m_cost_model->predict( l_blocking ) );
+        }
+      }
+    }
+  }
+
+  //rank the candidates, ties are broken by the data transfers
+  std::vector<std::size_t> l_ranking( l_blockings.size() );
+  for( std::size_t l_ca = 0; l_ca < l_ranking.size(); l_ca++ ){
+    l_ranking[l_ca] = l_ca;
+  }
+  std::stable_sort( l_ranking.begin(), l_ranking.end(),
+                    [&](std::size_t l_a, std::size_t l_b) -> bool {
+                      ContractionCostModel::estimate const & l_est_a = l_estimates[l_a];
+                      ContractionCostModel::estimate const & l_est_b = l_estimates[l_b];
+                      if( std::abs( l_est_a.time - l_est_b.time ) > 1E-6 * l_est_b.time ){
+                        return l_est_a.time < l_est_b.time;
+                      }
+                      return l_est_a.time_l2 + l_est_a.time_memory < l_est_b.time_l2 + l_est_b.time_memory;
+                    });
+
+  ContractionCostModel::blocking const & l_best = l_blockings[ l_ranking[0] ];
+  io_kernel_targets[ PRIM_BR ] = l_best.size_br;
+  io_kernel_targets[ PRIM_C  ] = l_best.size_c;
+  io_kernel_targets[ PRIM_M  ] = l_best.size_m;
+  io_kernel_targets[ PRIM_N  ] = l_best.size_n;
+  io_kernel_targets[ PRIM_K  ] = l_best.size_k;
+
+  m_explanation += "contraction: c=" + std::to_string( l_size_all_c )
+                 + " m=" + std::to_string( l_size_all_m )
+                 + " n=" + std::to_string( l_size_all_n )
+                 + " k=" + std::to_string( l_size_all_k )
+                 + ", " + std::to_string( l_blockings.size() ) + " candidates\n";
+  for( std::size_t l_ca = 0; l_ca < std::min( l_ranking.size(), (std::size_t) 4 ); l_ca++ ){
+    m_explanation += l_ca == 0 ? "chosen:      " : "alternative: ";
+    m_explanation += ContractionCostModel::describe( l_blockings[ l_ranking[l_ca] ],
+                                                     l_estimates[ l_ranking[l_ca] ] ) + "\n";
+  }
+
+  //use extra values for packing if there is no reuse
+  if(   l_size_all_m / io_kernel_targets[PRIM_M] == 1
+     || l_size_all_n / io_kernel_targets[PRIM_N] == 1){
+    m_target_extra_packing *= 2;
+  }
+}
 
 einsum_ir::basic::err_t einsum_ir::basic::ContractionOptimizer::set_primitive_iters(){
   //The Algorithm consits of three steps:
@@ -417,6 +673,7 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionOptimizer::set_primitive_it
 
   //find possible BR kernel dimension
   if(    m_br_gemm_support 
+      && l_complex_iter_prop.dim_type != dim_t::CPX
       && l_potential_kernel_size[ PRIM_C ] <= 1){
     //if an extra packing dimension of type K is available use it as BR kernel dimension
     if( l_extra_packing_iter_left != m_iter_space->end() &&
@@ -476,7 +733,44 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionOptimizer::set_primitive_it
   }
 
   //addapts the kernel targets depending on the potential kernel size
-  set_kernel_targets_heuristic( l_potential_kernel_size, l_kernel_targets, l_iter_required );
+  if( m_cost_model != nullptr ){
+    set_kernel_targets_model( l_potential_kernel_size, l_kernel_targets, l_iter_required );
+  }
+  else{
+    set_kernel_targets_heuristic( l_potential_kernel_size, l_kernel_targets, l_iter_required );
+  }
+
+  //L1 blocking: the packed panels of a primitive stay in one half of L1, k is reduced before br
+  if(    ( l_packing_left || l_packing_right )
+      && !m_keep_k_whole ){
+    int64_t l_min_br = l_iter_required[PRIM_BR] ? 2 : 1;
+    while( true ){
+      int64_t l_size_panel_k = l_kernel_targets[PRIM_C] * l_kernel_targets[PRIM_BR] * l_kernel_targets[PRIM_K];
+      int64_t l_size_panels = 0;
+      if( l_packing_left ){
+        l_size_panels += l_size_panel_k * l_kernel_targets[PRIM_M] * (l_extra_packing_left_required ? m_target_extra_packing : 1);
+      }
+      if( l_packing_right ){
+        l_size_panels += l_size_panel_k * l_kernel_targets[PRIM_N] * (l_extra_packing_right_required ? m_target_extra_packing : 1);
+      }
+      if( l_size_panels * m_num_bytes_scalar_in <= m_l1_cache_size / 2 ){
+        break;
+      }
+
+      if( l_kernel_targets[PRIM_K] > 1 && l_kernel_targets[PRIM_K] >= l_kernel_targets[PRIM_BR] ){
+        l_kernel_targets[PRIM_K] /= 2;
+      }
+      else if( l_kernel_targets[PRIM_BR] > l_min_br ){
+        l_kernel_targets[PRIM_BR] /= 2;
+      }
+      else if( l_kernel_targets[PRIM_K] > 1 ){
+        l_kernel_targets[PRIM_K] /= 2;
+      }
+      else{
+        break;
+      }
+    }
+  }
 
 
   //------------------------------------------
@@ -504,6 +798,10 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionOptimizer::set_primitive_it
     if( l_kernel_targets[PRIM_C] > 1 ){
       *m_ktype_main = kernel_t::CPX_PACKED_MADD;
     }
+    else if(    m_cpx_3m_support
+             && l_kernel_targets[PRIM_K] >= m_target_cpx_3m_k ){
+      *m_ktype_main = kernel_t::CPX_MADD_3M;
+    }
     else{
       *m_ktype_main = kernel_t::CPX_MADD;
     }
@@ -550,7 +848,8 @@ einsum_ir::basic::err_t einsum_ir::basic::ContractionOptimizer::set_primitive_it
     if( *m_ktype_main == kernel_t::BR_MADD ){
       l_packing_order.insert(l_packing_order.end(), l_next_id--);
     }
-    if( *m_ktype_main == kernel_t::CPX_MADD ||
+    if( *m_ktype_main == kernel_t::CPX_MADD    ||
+        *m_ktype_main == kernel_t::CPX_MADD_3M ||
         *m_ktype_main == kernel_t::CPX_PACKED_MADD){
       l_packing_order.insert(l_packing_order.end(), l_next_id--);
     }
@@ -606,10 +905,42 @@ void einsum_ir::basic::ContractionOptimizer::reorder_and_parallelize_iters(){
     }
   }
 
-  //use about half of the L2 cache for C blocking (A and B tend to be a lot smaller because of SFC blocking in M and N)
-  int64_t l_target_thread_tasks = m_l2_cache_size / 2 / (l_kernel_size_out * m_num_bytes_scalar_out );
-  if( l_target_thread_tasks < 1 ){
-    l_target_thread_tasks = 1;
+  int64_t l_kernel_size_left = 1;
+  int64_t l_kernel_size_right = 1;
+  for( l_it = l_kernel_iters.begin(); l_it < l_kernel_iters.end(); l_it++ ){
+    if( l_it->stride_left != 0 || l_it->packing_stride_left != 0 ){
+      l_kernel_size_left *= l_it->size;
+    }
+    if( l_it->stride_right != 0 || l_it->packing_stride_right != 0 ){
+      l_kernel_size_right *= l_it->size;
+    }
+  }
+  int64_t l_kernel_size_in = l_kernel_size_left + l_kernel_size_right;
+
+  //L2 blocking: C blocks of a thread, L3 blocking: sequential k block
+  //the cost model derives both targets from the L2 cache of its machine, its targets are used as is
+  int64_t l_target_thread_tasks = 1;
+  int64_t l_target_blocking_k = 64;
+  if( m_cost_model != nullptr ){
+    m_cost_model->blocking_targets( l_kernel_size_in,
+                                    l_kernel_size_out,
+                                    m_num_bytes_scalar_in,
+                                    m_num_bytes_scalar_out,
+                                    l_target_thread_tasks,
+                                    l_target_blocking_k );
+  }
+  else{
+    //use about half of the L2 cache for C blocking (A and B tend to be a lot smaller because of SFC blocking in M and N)
+    l_target_thread_tasks = m_l2_cache_size / 2 / (l_kernel_size_out * m_num_bytes_scalar_out );
+    if( l_target_thread_tasks < 1 ){
+      l_target_thread_tasks = 1;
+    }
+
+    //the other half holds the A and B panels which neighboring C blocks of a thread share in one k step
+    while(    l_target_thread_tasks > 1
+           && std::sqrt( (double)l_target_thread_tasks ) * l_kernel_size_in * m_num_bytes_scalar_in > m_l2_cache_size / 2 ){
+      l_target_thread_tasks /= 2;
+    }
   }
   int64_t l_target_parallel = m_num_threads * l_target_thread_tasks;
 
@@ -627,7 +958,18 @@ void einsum_ir::basic::ContractionOptimizer::reorder_and_parallelize_iters(){
   }
   l_target_parallel_c = l_target_parallel / (l_target_parallel_m * l_target_parallel_n);
 
+  //size of the output tensor, used to decide on parallel k dimensions
+  int64_t l_size_out = l_kernel_size_out;
+  for( l_it = m_iter_space->begin(); l_it < m_iter_space->end(); l_it++ ){
+    if( l_it->dim_type != dim_t::K ){
+      l_size_out *= l_it->size;
+    }
+  }
+
   //add parallel dimension
+  int64_t l_size_parallel = 1;
+  int64_t l_size_parallel_m = 1;
+  int64_t l_size_parallel_n = 1;
   std::vector<iter_property> l_blocking_iters;
   if( m_generate_sfcs ) {
     m_size_sfc_n = move_iters_until( &l_blocking_iters, 
@@ -638,32 +980,71 @@ void einsum_ir::basic::ContractionOptimizer::reorder_and_parallelize_iters(){
                                     l_target_parallel_m,
                                     dim_t::M,
                                     exec_t::SFC);
+    l_size_parallel_m = m_size_sfc_m;
+    l_size_parallel_n = m_size_sfc_n;
   }
   else{
-    move_iters_until( &l_blocking_iters, 
-                      l_target_parallel_n,
-                      dim_t::N,
-                      exec_t::OMP);
-    move_iters_until( &l_blocking_iters, 
-                      l_target_parallel_m,
-                      dim_t::M,
-                      exec_t::OMP);
+    l_size_parallel_n = move_iters_until( &l_blocking_iters, 
+                                          l_target_parallel_n,
+                                          dim_t::N,
+                                          exec_t::OMP);
+    l_size_parallel_m = move_iters_until( &l_blocking_iters, 
+                                          l_target_parallel_m,
+                                          dim_t::M,
+                                          exec_t::OMP);
     m_size_sfc_n = 1;
     m_size_sfc_m = 1;
   }
+  l_size_parallel = l_size_parallel_m * l_size_parallel_n;
+
+  //add parallel K dimension if the output tensor is small and offers too little parallelism,
+  //every thread accumulates in a private copy of the output tensor
+  std::vector<iter_property> l_split_k_iters;
+  if( m_split_k_support ){
+    //the parallel C loops are added below, their size is bounded by the target
+    int64_t l_size_c = 1;
+    for( l_it = m_iter_space->begin(); l_it < m_iter_space->end(); l_it++ ){
+      if( l_it->dim_type == dim_t::C ){
+        l_size_c *= l_it->size;
+      }
+    }
+    int64_t l_size_parallel_c = std::min( l_size_c, l_target_parallel_c );
+
+    if(    l_size_parallel * l_size_parallel_c < m_num_threads
+        && l_size_out * m_num_bytes_scalar_out <= m_l2_cache_size ){
+      move_iters_until( &l_split_k_iters,
+                        (m_num_threads + l_size_parallel * l_size_parallel_c - 1) / (l_size_parallel * l_size_parallel_c),
+                        dim_t::K,
+                        exec_t::OMP);
+    }
+  }
 
-  //add sequential K dimension for L3 blocking
+  //add sequential K dimension
+  if( m_cost_model != nullptr ){
+    m_explanation += "blocking: " + std::to_string( l_target_thread_tasks ) + " C blocks per thread, "
+                                  + std::to_string( l_target_blocking_k ) + " primitives per sequential k block\n";
+  }
+  else{
+    l_target_blocking_k = get_target_blocking_k( l_kernel_size_left,
+                                                 l_kernel_size_right,
+                                                 l_size_parallel_m,
+                                                 l_size_parallel_n,
+                                                 l_target_blocking_k );
+  }
   move_iters_until( &l_blocking_iters, 
-                    64,
+                    l_target_blocking_k,
                     dim_t::K,
                     exec_t::SEQ);
-  
+
   //add parallel C dimension
   move_iters_until( &l_blocking_iters, 
                     l_target_parallel_c,
                     dim_t::C,
                     exec_t::OMP);
 
+  //parallel k loops are the outermost loops, the first split writes the output tensor
+  l_blocking_iters.insert( l_blocking_iters.begin(), l_split_k_iters.begin(), l_split_k_iters.end() );
+
   //sort remaining dimensions by sum of strides
   std::sort( m_iter_space->begin(), m_iter_space->end(), 
              [&](iter_property l_a, iter_property l_b) -> bool {
@@ -678,6 +1059,40 @@ void einsum_ir::basic::ContractionOptimizer::reorder_and_parallelize_iters(){
   m_iter_space->insert(m_iter_space->end(), l_kernel_iters.begin(), l_kernel_iters.end() );
 }
 
+int64_t einsum_ir::basic::ContractionOptimizer::get_target_blocking_k( int64_t i_kernel_size_left,
+                                                                       int64_t i_kernel_size_right,
+                                                                       int64_t i_size_parallel_m,
+                                                                       int64_t i_size_parallel_n,
+                                                                       int64_t i_target_default ){
+  //without an L3 cache the default target is used
+  if( m_l3_cache_size <= 0 ){
+    return i_target_default;
+  }
+
+  //without sequential m or n loops, A and B are not reused across k blocks and C is reused best with all of k
+  bool l_outer_m_n = false;
+  int64_t l_size_k = 1;
+  std::vector<iter_property>::iterator l_it;
+  for( l_it = m_iter_space->begin(); l_it < m_iter_space->end(); l_it++ ){
+    if( l_it->dim_type == dim_t::M || l_it->dim_type == dim_t::N ){
+      l_outer_m_n = true;
+    }
+    if( l_it->dim_type == dim_t::K ){
+      l_size_k *= l_it->size;
+    }
+  }
+  if( !l_outer_m_n ){
+    return l_size_k;
+  }
+
+  //the A and B slabs of the k block are reused by the next sequential m or n block if they fit into one half of L3
+  int64_t l_bytes_step =   (  i_kernel_size_left  * i_size_parallel_m
+                            + i_kernel_size_right * i_size_parallel_n ) * m_num_bytes_scalar_in;
+  int64_t l_target = (m_l3_cache_size / 2) / std::max( l_bytes_step, (int64_t)1 );
+
+  return std::max( l_target, (int64_t)1 );
+}
+
 void einsum_ir::basic::ContractionOptimizer::set_num_threads_sfc( int64_t   i_size_sfc_m, 
                                                                   int64_t   i_size_sfc_n,
                                                                   int64_t * io_num_threads_shared,
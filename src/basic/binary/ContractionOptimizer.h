@@ -1,8 +1,11 @@
 #ifndef EINSUM_IR_BASIC_BINARY_CONTRACTION_OPTIMIZER
 #define EINSUM_IR_BASIC_BINARY_CONTRACTION_OPTIMIZER
 
+#include <string>
 #include <vector>
 #include "../constants.h"
+#include "ContractionCostModel.h"
+#include "ContractionTuningDatabase.h"
 
 namespace einsum_ir {
   namespace basic {
@@ -34,12 +37,24 @@ class einsum_ir::basic::ContractionOptimizer {
     //! number of bytes for scalar data types in output tensor
     int64_t m_num_bytes_scalar_out = 0;
 
+    //! number of bytes for scalar data types in input tensors
+    int64_t m_num_bytes_scalar_in = 0;
+
+    //! size of L1 data cache in bytes
+    int64_t m_l1_cache_size = 0;
+
     //! size of L2 cache in bytes
     int64_t m_l2_cache_size = 0;
 
+    //! size of L3 cache in bytes which is shared by all threads, zero if there is none
+    int64_t m_l3_cache_size = 0;
+
     //! target size for extra packing dimensions
     int64_t m_target_extra_packing = 0;
 
+    //! minimum size of the kernel k dimension for which complex kernels use the 3m algorithm
+    int64_t m_target_cpx_3m_k = 0;
+
     //! number of threads
     int64_t m_num_threads = 0;
 
@@ -58,6 +73,15 @@ class einsum_ir::basic::ContractionOptimizer {
     //! indicates if backend supports packed gemms
     packed_gemm_t m_packed_gemm_support = packed_gemm_t::NONE;
 
+    //! indicates if backend supports parallel k dimensions
+    bool m_split_k_support = false;
+
+    //! indicates if backend supports complex kernels using the 3m algorithm
+    bool m_cpx_3m_support = false;
+
+    //! indicates if all k dimensions have to be primitive dimensions, e.g., for outputs requantized from an accumulator block
+    bool m_keep_k_whole = false;
+
     //! pointer to number of threads in m dimension
     int64_t * m_num_threads_sfc_m = nullptr;
 
@@ -73,6 +97,33 @@ class einsum_ir::basic::ContractionOptimizer {
     //! size of the sfc in n dimension
     int64_t m_size_sfc_n = 1;
 
+    //! database of tuned parameters, nullptr if the heuristics are used only
+    ContractionTuningDatabase * m_tuning_database = nullptr;
+
+    //! data types of the left input, right input, computations and output, part of the tuning signature
+    data_t m_dtype_left  = data_t::UNDEFINED_DTYPE;
+    data_t m_dtype_right = data_t::UNDEFINED_DTYPE;
+    data_t m_dtype_comp  = data_t::UNDEFINED_DTYPE;
+    data_t m_dtype_out   = data_t::UNDEFINED_DTYPE;
+
+    //! types of the first and last touch kernels, part of the tuning signature
+    kernel_t m_ktype_first_touch = kernel_t::UNDEFINED_KTYPE;
+    kernel_t m_ktype_last_touch  = kernel_t::UNDEFINED_KTYPE;
+
+    //! performance model which chooses the blocking, nullptr if the heuristics are used
+    ContractionCostModel const * m_cost_model = nullptr;
+
+    //! explanation of the choices of the cost model
+    std::string m_explanation;
+
+    /**
+     * Replaces the targets and switches with the tuned parameters.
+     * Switches are only disabled, i.e., the support of the backend is never extended.
+     *
+     * @param i_params tuned parameters.
+     **/
+    void apply_tuning_params( tuning_params const & i_params );
+
     /**
       * Finds all iters with a specific stride in the iteration space.
       *
@@ -119,6 +170,36 @@ class einsum_ir::basic::ContractionOptimizer {
                                        int64_t * io_kernel_targets,
                                        bool    * i_iter_required );
 
+    /**
+      * Sets the kernel targets to the candidate with the lowest time predicted by the cost model.
+      * Candidates are the divisors of the potential kernel sizes which are closest to powers of two.
+      *
+      * @param i_potential_kernel_size potential kernel size for each dimension.
+      * @param io_kernel_targets kernel targets for each dimension.
+      * @param i_iter_required indicates if at least a size 1 dimension is required.
+      **/
+    void set_kernel_targets_model( int64_t * i_potential_kernel_size,
+                                   int64_t * io_kernel_targets,
+                                   bool    * i_iter_required );
+
+    /**
+     * Determines the number of primitives in the sequential k block from the L3 cache size.
+     * The A and B slabs of a block are reused by the next sequential m or n block if they fit into one half of L3.
+     *
+     * @param i_kernel_size_left number of scalars of the left input read by a primitive.
+     * @param i_kernel_size_right number of scalars of the right input read by a primitive.
+     * @param i_size_parallel_m number of parallel primitive blocks in m dimension.
+     * @param i_size_parallel_n number of parallel primitive blocks in n dimension.
+     * @param i_target_default target which is used if there is no L3 cache.
+     *
+     * @return number of primitives in the k block.
+     **/
+    int64_t get_target_blocking_k( int64_t i_kernel_size_left,
+                                   int64_t i_kernel_size_right,
+                                   int64_t i_size_parallel_m,
+                                   int64_t i_size_parallel_n,
+                                   int64_t i_target_default );
+
     /**
      * Splits an iteration depending on a target size.
      *
@@ -182,8 +263,10 @@ class einsum_ir::basic::ContractionOptimizer {
      * @param i_br_gemm_support true if backend supports br gemms
      * @param i_packing_support true if backend supports packing
      * @param i_packed_gemm_support indicates the support level for packed gemms
+     * @param i_split_k_support true if backend supports parallel k dimensions
+     * @param i_cpx_3m_support true if backend supports complex kernels using the 3m algorithm
      * @param i_num_bytes_scalar_out number of bytes for scalar data types in output tensor
-     * @param i_l2_cache_size size of L2 cache in bytes
+     * @param i_l2_cache_size size of L2 cache in bytes, zero to use the L2 cache size of the hardware topology
      * @param io_num_threads_shared number of threads used for shared parallelization.
      * @param io_num_threads_sfc_m number of threads used for sfc m parallelization.
      * @param io_num_threads_sfc_n number of threads used for sfc n parallelization.
@@ -196,15 +279,86 @@ class einsum_ir::basic::ContractionOptimizer {
                bool                           i_generate_sfcs,
                bool                           i_br_gemm_support,
                bool                           i_packing_support,
-               packed_gemm_t                  i_packed_gemm_support,                  
+               packed_gemm_t                  i_packed_gemm_support,
+               bool                           i_split_k_support,
+               bool                           i_cpx_3m_support,
                int64_t                        i_num_bytes_scalar_out,
                int64_t                        i_l2_cache_size,
                int64_t                      * io_num_threads_shared,
                int64_t                      * io_num_threads_sfc_m,
                int64_t                      * io_num_threads_sfc_n );    
   
+    /**
+     * Sets the database of tuned parameters which is consulted by optimize.
+     * init sets the default database.
+     *
+     * @param i_database database, nullptr to disable tuned parameters.
+     **/
+    void set_tuning_database( ContractionTuningDatabase * i_database );
+
+    /**
+     * Sets the data types and touch kernels of the contraction which identify its tuned parameters in the tuning database.
+     * The optimizer itself uses the sizes of the scalar data types only.
+     *
+     * @param i_dtype_left data type of the left input.
+     * @param i_dtype_right data type of the right input.
+     * @param i_dtype_comp data type used for computations.
+     * @param i_dtype_out data type of the output.
+     * @param i_ktype_first_touch type of the first touch kernel.
+     * @param i_ktype_last_touch type of the last touch kernel.
+     **/
+    void set_tuning_signature( data_t   i_dtype_left,
+                               data_t   i_dtype_right,
+                               data_t   i_dtype_comp,
+                               data_t   i_dtype_out,
+                               kernel_t i_ktype_first_touch,
+                               kernel_t i_ktype_last_touch );
+
+    /**
+     * Sets the L1 and L3 cache sizes used for blocking.
+     * init sets the sizes of the hardware topology.
+     *
+     * @param i_l1_cache_size size of L1 data cache in bytes.
+     * @param i_l3_cache_size size of L3 cache in bytes which is shared by all threads, zero if there is none.
+     **/
+    void set_cache_sizes( int64_t i_l1_cache_size,
+                          int64_t i_l3_cache_size );
+
+    /**
+     * Sets the number of bytes for scalar data types in the input tensors.
+     * init assumes the data type of the output tensor.
+     *
+     * @param i_num_bytes_scalar_in number of bytes.
+     **/
+    void set_num_bytes_scalar_in( int64_t i_num_bytes_scalar_in );
+
+    /**
+     * Keeps all k dimensions in the primitive: neither the kernel targets, the L1 blocking nor tuned parameters split k.
+     * Used by backends which finalize the output of a primitive, e.g., requantized int8 outputs.
+     *
+     * @param i_keep_k_whole true if all k dimensions have to be primitive dimensions.
+     **/
+    void set_keep_k_whole( bool i_keep_k_whole );
+
+    /**
+     * Sets the performance model which replaces the heuristics for the kernel targets and the blocking.
+     * The model's C and k blocking targets follow the L2 cache of its machine parameters and replace the L2 and L3 blocking of the heuristics.
+     * Tuned parameters of the tuning database enable or disable the model.
+     *
+     * @param i_cost_model cost model, nullptr to use the heuristics.
+     **/
+    void set_cost_model( ContractionCostModel const * i_cost_model );
+
+    /**
+     * Gets the explanation of the cost model's choices made by the last call of optimize.
+     *
+     * @return explanation, empty if no cost model is set.
+     **/
+    std::string const & get_explanation() const;
+
     /**
      * Optimizes the iters.
+     * If the tuning database has an entry for the contraction, the tuned parameters replace the given ones.
      *
      * @return SUCCESS if the compilation was successful, otherwise an appropiate error code.
      **/
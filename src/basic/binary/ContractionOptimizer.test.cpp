@@ -42,6 +42,8 @@ TEST_CASE( "Simple test for Contraction Optimizer", "[contraction_optimizer]" )
               false,
               true,
               packed_gemm_t::ALL_STRIDE_ONE, 
+              false,
+              false,
               4, 
               1024 * 1024, 
               &l_num_threads_m, 
@@ -124,6 +126,8 @@ TEST_CASE( "Matmul blocking test for Contraction Optimizer", "[contraction_optim
               false,
               false,
               packed_gemm_t::NONE, 
+              false,
+              false,
               4, 
               1024 * 1024, 
               &l_num_threads_m, 
@@ -206,6 +210,8 @@ TEST_CASE( "Test of Contraction Optimizer for transposed kernel", "[contraction_
               false,
               true,
               packed_gemm_t::OUT_STRIDE_ONE, 
+              false,
+              false,
               4, 
               1024 * 1024, 
               &l_num_threads_m, 
@@ -246,4 +252,238 @@ TEST_CASE( "Test of Contraction Optimizer for transposed kernel", "[contraction_
   REQUIRE( l_size_before[1] == l_size_after[1] );
   REQUIRE( l_size_before[2] == l_size_after[2] );
   REQUIRE( l_size_before[3] == l_size_after[3] );
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Multi-level cache blocking test for Contraction Optimizer", "[contraction_optimizer]" ) {
+  using namespace einsum_ir::basic;
+
+  kernel_t l_kernel_main = kernel_t::MADD;
+
+  SECTION( "L3 blocking" ) {
+    // the sequential k block is the innermost sequential loop if its A and B slabs fit into L3
+    std::vector< int64_t > l_sizes_l3 = { 32 * 1024 * 1024, 1024 * 1024 };
+    std::vector< dim_t > l_dims_expected = { dim_t::K, dim_t::M };
+
+    for( std::size_t l_id = 0; l_id < l_sizes_l3.size(); l_id++ ){
+      std::vector< iter_property > l_iters = { {dim_t::N, exec_t::SEQ, 2048,    0, 2048, 0, 2048},
+                                               {dim_t::K, exec_t::SEQ, 2048, 2048,    1, 0,    0},
+                                               {dim_t::M, exec_t::SEQ, 2048,    1,    0, 0,    1}};
+
+      int64_t l_num_threads_omp = 4;
+      int64_t l_num_threads_m = 1;
+      int64_t l_num_threads_n = 1;
+
+      ContractionOptimizer l_opt;
+      l_opt.init( &l_iters,
+                  &l_kernel_main,
+                  16,
+                  64,
+                  256,
+                  false,
+                  false,
+                  false,
+                  packed_gemm_t::NONE,
+                  false,
+                  false,
+                  4,
+                  1024 * 1024,
+                  &l_num_threads_omp,
+                  &l_num_threads_m,
+                  &l_num_threads_n );
+      l_opt.set_cache_sizes( 32768, l_sizes_l3[l_id] );
+      l_opt.optimize();
+
+      std::size_t l_id_omp = 0;
+      while( l_id_omp < l_iters.size() && l_iters[l_id_omp].exec_type != exec_t::OMP ){
+        l_id_omp++;
+      }
+      REQUIRE( l_id_omp > 0 );
+      REQUIRE( l_id_omp < l_iters.size() );
+      REQUIRE( l_iters[l_id_omp - 1].exec_type == exec_t::SEQ );
+      REQUIRE( l_iters[l_id_omp - 1].dim_type  == l_dims_expected[l_id] );
+    }
+  }
+
+  SECTION( "L1 blocking of packed panels" ) {
+    // the k size of the primitive is reduced until the packed panel of the left input fits into L1
+    std::vector< int64_t > l_sizes_l1 = { 1024 * 1024, 32768 };
+    std::vector< int64_t > l_sizes_k_expected = { 256, 64 };
+
+    for( std::size_t l_id = 0; l_id < l_sizes_l1.size(); l_id++ ){
+      std::vector< iter_property > l_iters = { {dim_t::N, exec_t::SEQ,   64,    0, 512, 0, 2048},
+                                               {dim_t::M, exec_t::SEQ, 2048,    1,   0, 0,    1},
+                                               {dim_t::K, exec_t::SEQ,  512, 2048,   1, 0,    0}};
+
+      int64_t l_num_threads_omp = 4;
+      int64_t l_num_threads_m = 1;
+      int64_t l_num_threads_n = 1;
+
+      ContractionOptimizer l_opt;
+      l_opt.init( &l_iters,
+                  &l_kernel_main,
+                  64,
+                  64,
+                  256,
+                  false,
+                  false,
+                  true,
+                  packed_gemm_t::NONE,
+                  false,
+                  false,
+                  4,
+                  1024 * 1024,
+                  &l_num_threads_omp,
+                  &l_num_threads_m,
+                  &l_num_threads_n );
+      l_opt.set_cache_sizes( l_sizes_l1[l_id], 0 );
+      l_opt.optimize();
+
+      REQUIRE( l_iters.back().exec_type == exec_t::PRIM );
+      REQUIRE( l_iters.back().dim_type  == dim_t::K );
+      REQUIRE( l_iters.back().size      == l_sizes_k_expected[l_id] );
+    }
+  }
+}
+
+TEST_CASE( "Placement of the parallel C and K loops in the Contraction Optimizer", "[contraction_optimizer]" ) {
+  using namespace einsum_ir::basic;
+
+  kernel_t l_kernel_main = kernel_t::MADD;
+
+  SECTION( "Enough parallelism without split-K" ) {
+    // the parallel C loops enclose the sequential k block
+    std::vector< iter_property > l_iters = { {dim_t::C, exec_t::SEQ,    8, 65536, 65536, 0, 4096},
+                                             {dim_t::N, exec_t::SEQ,   64,     0,  1024, 0,   64},
+                                             {dim_t::K, exec_t::SEQ, 1024,    64,     1, 0,    0},
+                                             {dim_t::M, exec_t::SEQ,   64,     1,     0, 0,    1}};
+
+    bool l_split_k_support = GENERATE( false, true );
+
+    int64_t l_num_threads_omp = 8;
+    int64_t l_num_threads_m = 1;
+    int64_t l_num_threads_n = 1;
+
+    ContractionOptimizer l_opt;
+    l_opt.init( &l_iters,
+                &l_kernel_main,
+                16,
+                16,
+                16,
+                false,
+                false,
+                false,
+                packed_gemm_t::NONE,
+                l_split_k_support,
+                false,
+                4,
+                1024 * 1024,
+                &l_num_threads_omp,
+                &l_num_threads_m,
+                &l_num_threads_n );
+    l_opt.optimize();
+
+    REQUIRE( l_iters.size() == 7 );
+    REQUIRE( l_iters[0].dim_type  == dim_t::C   );
+    REQUIRE( l_iters[0].exec_type == exec_t::OMP );
+    REQUIRE( l_iters[0].size      == 8           );
+    REQUIRE( l_iters[1].dim_type  == dim_t::K   );
+    REQUIRE( l_iters[1].exec_type == exec_t::SEQ );
+    REQUIRE( l_iters[1].size      == 64          );
+
+    for( std::size_t l_id = 0; l_id < l_iters.size(); l_id++ ){
+      REQUIRE( !( l_iters[l_id].dim_type == dim_t::K && l_iters[l_id].exec_type == exec_t::OMP ) );
+    }
+  }
+
+  SECTION( "Split-K" ) {
+    // the parallel k loops are the outermost loops
+    std::vector< iter_property > l_iters = { {dim_t::C, exec_t::SEQ,    2, 65536, 65536, 0, 4096},
+                                             {dim_t::N, exec_t::SEQ,   64,     0,  1024, 0,   64},
+                                             {dim_t::K, exec_t::SEQ, 1024,    64,     1, 0,    0},
+                                             {dim_t::M, exec_t::SEQ,   64,     1,     0, 0,    1}};
+
+    int64_t l_num_threads_omp = 8;
+    int64_t l_num_threads_m = 1;
+    int64_t l_num_threads_n = 1;
+
+    ContractionOptimizer l_opt;
+    l_opt.init( &l_iters,
+                &l_kernel_main,
+                64,
+                64,
+                64,
+                false,
+                false,
+                false,
+                packed_gemm_t::NONE,
+                true,
+                false,
+                4,
+                1024 * 1024,
+                &l_num_threads_omp,
+                &l_num_threads_m,
+                &l_num_threads_n );
+    l_opt.optimize();
+
+    REQUIRE( l_iters.size() == 6 );
+    REQUIRE( l_iters[0].dim_type  == dim_t::K   );
+    REQUIRE( l_iters[0].exec_type == exec_t::OMP );
+    REQUIRE( l_iters[0].size      == 4           );
+    REQUIRE( l_iters[1].dim_type  == dim_t::C   );
+    REQUIRE( l_iters[1].exec_type == exec_t::OMP );
+    REQUIRE( l_iters[1].size      == 2           );
+    REQUIRE( l_iters[2].dim_type  == dim_t::K   );
+    REQUIRE( l_iters[2].exec_type == exec_t::SEQ );
+    REQUIRE( l_iters[2].size      == 4           );
+  }
+}
+
+TEST_CASE( "Whole k dimensions in the primitive of the Contraction Optimizer", "[contraction_optimizer]" ) {
+  using namespace einsum_ir::basic;
+
+  kernel_t l_kernel_main = kernel_t::MADD;
+
+  // km,nk->nm with m=2048, n=64, k=512: the k stride of the left tensor triggers packing and the L1 blocking
+  std::vector< iter_property > l_iters = { {dim_t::M, exec_t::SEQ, 2048,    1,   0, 0,    1},
+                                           {dim_t::N, exec_t::SEQ,   64,    0, 512, 0, 2048},
+                                           {dim_t::K, exec_t::SEQ,  512, 2048,   1, 0,    0}};
+
+  bool l_cost_model = GENERATE( false, true );
+
+  int64_t l_num_threads_omp = 4;
+  int64_t l_num_threads_m = 1;
+  int64_t l_num_threads_n = 1;
+
+  ContractionOptimizer l_opt;
+  l_opt.init( &l_iters,
+              &l_kernel_main,
+              64,
+              16,
+              64,
+              true,
+              true,
+              true,
+              packed_gemm_t::NONE,
+              false,
+              false,
+              1,
+              1024 * 1024,
+              &l_num_threads_omp,
+              &l_num_threads_m,
+              &l_num_threads_n );
+  l_opt.set_tuning_database( nullptr );
+  l_opt.set_keep_k_whole( true );
+  if( l_cost_model ){
+    l_opt.set_cost_model( ContractionCostModel::get_default() );
+  }
+  REQUIRE( l_opt.optimize() == err_t::SUCCESS );
+
+  int64_t l_size_k_prim = 1;
+  for( std::size_t l_id = 0; l_id < l_iters.size(); l_id++ ){
+    if( l_iters[l_id].dim_type == dim_t::K ){
+      REQUIRE( l_iters[l_id].exec_type == exec_t::PRIM );
+      l_size_k_prim *= l_iters[l_id].size;
+    }
+  }
+  REQUIRE( l_size_k_prim == 512 );
+}
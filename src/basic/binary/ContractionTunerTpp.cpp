@@ -0,0 +1,272 @@
+#include "ContractionTunerTpp.h"
+#include "ContractionOptimizer.h"
+#include "ContractionCostModel.h"
+#include "ContractionBackendTpp.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+void einsum_ir::basic::ContractionTunerTpp::init( std::vector< iter_property > const & i_iter_space,
+                                                  data_t                               i_dtype_left,
+                                                  data_t                               i_dtype_right,
+                                                  data_t                               i_dtype_comp,
+                                                  data_t                               i_dtype_out,
+                                                  kernel_t                             i_ktype_first_touch,
+                                                  kernel_t                             i_ktype_main,
+                                                  kernel_t                             i_ktype_last_touch,
+                                                  int64_t                              i_num_threads,
+                                                  packed_gemm_t                        i_packed_gemm_support,
+                                                  bool                                 i_split_k_support,
+                                                  bool                                 i_cpx_3m_support,
+                                                  tuning_params                const & i_params_default ) {
+  m_iter_space          = i_iter_space;
+  m_dtype_left          = i_dtype_left;
+  m_dtype_right         = i_dtype_right;
+  m_dtype_comp          = i_dtype_comp;
+  m_dtype_out           = i_dtype_out;
+  m_ktype_first_touch   = i_ktype_first_touch;
+  m_ktype_main          = i_ktype_main;
+  m_ktype_last_touch    = i_ktype_last_touch;
+  m_num_threads         = i_num_threads;
+  m_packed_gemm_support = i_packed_gemm_support;
+  m_split_k_support     = i_split_k_support;
+  m_cpx_3m_support      = i_cpx_3m_support;
+  m_params_default      = i_params_default;
+
+  m_num_candidates = 0;
+  m_params_best = m_params_default;
+  m_time_best = -1;
+}
+
+void einsum_ir::basic::ContractionTunerTpp::set_search_space( std::vector< int64_t > const & i_targets_m,
+                                                              std::vector< int64_t > const & i_targets_n,
+                                                              std::vector< int64_t > const & i_targets_k,
+                                                              std::vector< int64_t > const & i_l2_cache_sizes ) {
+  m_targets_m      = i_targets_m;
+  m_targets_n      = i_targets_n;
+  m_targets_k      = i_targets_k;
+  m_l2_cache_sizes = i_l2_cache_sizes;
+}
+
+void einsum_ir::basic::ContractionTunerTpp::set_num_reps( int64_t i_num_reps ) {
+  m_num_reps = std::max( i_num_reps, (int64_t) 1 );
+}
+
+double einsum_ir::basic::ContractionTunerTpp::benchmark( tuning_params const & i_params ) {
+  // the candidate reaches the optimizer through a private database
+  std::string l_signature = ContractionTuningDatabase::signature( m_iter_space,
+                                                                  m_dtype_left,
+                                                                  m_dtype_right,
+                                                                  m_dtype_comp,
+                                                                  m_dtype_out,
+                                                                  m_ktype_first_touch,
+                                                                  m_ktype_main,
+                                                                  m_ktype_last_touch,
+                                                                  m_num_threads,
+                                                                  m_packed_gemm_support,
+                                                                  m_split_k_support,
+                                                                  m_cpx_3m_support );
+  ContractionTuningDatabase l_database;
+  l_database.insert( l_signature,
+                     i_params );
+
+  std::vector< iter_property > l_loops = m_iter_space;
+  kernel_t l_ktype_main = m_ktype_main;
+  int64_t l_num_threads_shared = m_num_threads;
+  int64_t l_num_threads_m = 1;
+  int64_t l_num_threads_n = 1;
+
+  ContractionOptimizer l_optim;
+  l_optim.init( &l_loops,
+                &l_ktype_main,
+                m_params_default.target_m,
+                m_params_default.target_n,
+                m_params_default.target_k,
+                true,
+                true,
+                true,
+                m_packed_gemm_support,
+                m_split_k_support,
+                m_cpx_3m_support,
+                ce_n_bytes( m_dtype_out ),
+                m_params_default.l2_cache_size,
+                &l_num_threads_shared,
+                &l_num_threads_m,
+                &l_num_threads_n );
+  l_optim.set_num_bytes_scalar_in( std::max( ce_n_bytes( m_dtype_left ), ce_n_bytes( m_dtype_right ) ) );
+  //requantized int8 outputs require all k dimensions in the primitive
+  l_optim.set_keep_k_whole( m_dtype_out == INT8 );
+  l_optim.set_tuning_signature( m_dtype_left,
+                                m_dtype_right,
+                                m_dtype_comp,
+                                m_dtype_out,
+                                m_ktype_first_touch,
+                                m_ktype_last_touch );
+  l_optim.set_tuning_database( &l_database );
+  if( i_params.cost_model ) {
+    l_optim.set_cost_model( ContractionCostModel::get_default() );
+  }
+  if( l_optim.optimize() != err_t::SUCCESS ) {
+    return -1;
+  }
+
+  ContractionBackendTpp l_backend;
+  l_backend.init( l_loops,
+                  m_dtype_left,
+                  m_dtype_right,
+                  m_dtype_comp,
+                  m_dtype_out,
+                  m_ktype_first_touch,
+                  l_ktype_main,
+                  m_ktype_last_touch,
+                  l_num_threads_shared,
+                  l_num_threads_m,
+                  l_num_threads_n,
+                  nullptr );
+  if( l_backend.compile() != err_t::SUCCESS ) {
+    return -1;
+  }
+
+  // tensors are sized by the extents of the unoptimized loops
+  int64_t l_size_left    = 1;
+  int64_t l_size_right   = 1;
+  int64_t l_size_out_aux = 1;
+  int64_t l_size_out     = 1;
+  for( std::size_t l_id = 0; l_id < m_iter_space.size(); l_id++ ) {
+    int64_t l_size = m_iter_space[l_id].size - 1;
+    l_size_left    += l_size * std::abs( m_iter_space[l_id].stride_left    );
+    l_size_right   += l_size * std::abs( m_iter_space[l_id].stride_right   );
+    l_size_out_aux += l_size * std::abs( m_iter_space[l_id].stride_out_aux );
+    l_size_out     += l_size * std::abs( m_iter_space[l_id].stride_out     );
+  }
+
+  std::vector< char > l_left(    l_size_left    * ce_n_bytes( m_dtype_left  ), 0 );
+  std::vector< char > l_right(   l_size_right   * ce_n_bytes( m_dtype_right ), 0 );
+  std::vector< char > l_out_aux( l_size_out_aux * ce_n_bytes( m_dtype_out   ), 0 );
+  std::vector< char > l_out(     l_size_out     * ce_n_bytes( m_dtype_out   ), 0 );
+
+  // warm up
+  l_backend.contract( l_left.data(),
+                      l_right.data(),
+                      l_out_aux.data(),
+                      l_out.data() );
+
+  double l_time_min = -1;
+  for( int64_t l_re = 0; l_re < m_num_reps; l_re++ ) {
+    std::chrono::steady_clock::time_point l_tp0 = std::chrono::steady_clock::now();
+    l_backend.contract( l_left.data(),
+                        l_right.data(),
+                        l_out_aux.data(),
+                        l_out.data() );
+    std::chrono::steady_clock::time_point l_tp1 = std::chrono::steady_clock::now();
+
+    double l_time = std::chrono::duration_cast< std::chrono::duration< double > >( l_tp1 - l_tp0 ).count();
+    if( l_time_min < 0 || l_time < l_time_min ) {
+      l_time_min = l_time;
+    }
+  }
+
+  return l_time_min;
+}
+
+void einsum_ir::basic::ContractionTunerTpp::try_candidate( tuning_params const & i_params ) {
+  m_num_candidates++;
+
+  double l_time = benchmark( i_params );
+  if(    l_time >= 0
+      && ( m_time_best < 0 || l_time < m_time_best ) ) {
+    m_time_best = l_time;
+    m_params_best = i_params;
+  }
+}
+
+einsum_ir::basic::err_t einsum_ir::basic::ContractionTunerTpp::tune( ContractionTuningDatabase * io_database ) {
+  m_num_candidates = 0;
+  m_params_best = m_params_default;
+  m_time_best = -1;
+
+  try_candidate( m_params_default );
+
+  // kernel targets
+  tuning_params l_base = m_params_best;
+  for( std::size_t l_tm = 0; l_tm < m_targets_m.size(); l_tm++ ) {
+    for( std::size_t l_tn = 0; l_tn < m_targets_n.size(); l_tn++ ) {
+      for( std::size_t l_tk = 0; l_tk < m_targets_k.size(); l_tk++ ) {
+        tuning_params l_params = l_base;
+        l_params.target_m = m_targets_m[l_tm];
+        l_params.target_n = m_targets_n[l_tn];
+        l_params.target_k = m_targets_k[l_tk];
+        try_candidate( l_params );
+      }
+    }
+  }
+
+  // l2 cache size
+  l_base = m_params_best;
+  for( std::size_t l_ca = 0; l_ca < m_l2_cache_sizes.size(); l_ca++ ) {
+    tuning_params l_params = l_base;
+    l_params.l2_cache_size = m_l2_cache_sizes[l_ca];
+    try_candidate( l_params );
+  }
+
+  // switches, every one disabled separately, the cost model is toggled
+  l_base = m_params_best;
+  for( int64_t l_sw = 0; l_sw < 5; l_sw++ ) {
+    tuning_params l_params = l_base;
+    if(      l_sw == 0 ) l_params.generate_sfcs   = false;
+    else if( l_sw == 1 ) l_params.br_gemm_support = false;
+    else if( l_sw == 2 ) l_params.packing_support = false;
+    else if( l_sw == 3 ) l_params.packed_gemm     = false;
+    else                 l_params.cost_model      = !l_base.cost_model;
+    try_candidate( l_params );
+  }
+
+  // thread splits
+  l_base = m_params_best;
+  for( int64_t l_tm = 1; l_tm <= m_num_threads; l_tm++ ) {
+    if( m_num_threads % l_tm != 0 ) continue;
+    for( int64_t l_tn = 1; l_tn <= m_num_threads / l_tm; l_tn++ ) {
+      if( (m_num_threads / l_tm) % l_tn != 0 ) continue;
+      tuning_params l_params = l_base;
+      l_params.num_threads_shared = m_num_threads / (l_tm * l_tn);
+      l_params.num_threads_sfc_m  = l_tm;
+      l_params.num_threads_sfc_n  = l_tn;
+      try_candidate( l_params );
+    }
+  }
+
+  if( m_time_best < 0 ) {
+    return err_t::COMPILATION_FAILED;
+  }
+
+  if( io_database != nullptr ) {
+    std::string l_signature = ContractionTuningDatabase::signature( m_iter_space,
+                                                                    m_dtype_left,
+                                                                    m_dtype_right,
+                                                                    m_dtype_comp,
+                                                                    m_dtype_out,
+                                                                    m_ktype_first_touch,
+                                                                    m_ktype_main,
+                                                                    m_ktype_last_touch,
+                                                                    m_num_threads,
+                                                                    m_packed_gemm_support,
+                                                                    m_split_k_support,
+                                                                    m_cpx_3m_support );
+    io_database->insert( l_signature,
+                         m_params_best );
+  }
+
+  return err_t::SUCCESS;
+}
+
+einsum_ir::basic::tuning_params einsum_ir::basic::ContractionTunerTpp::get_params_best() {
+  return m_params_best;
+}
+
+double einsum_ir::basic::ContractionTunerTpp::get_time_best() {
+  return m_time_best;
+}
+
+int64_t einsum_ir::basic::ContractionTunerTpp::get_num_candidates() {
+  return m_num_candidates;
+}
@@ -0,0 +1,185 @@
+#ifndef EINSUM_IR_BASIC_BINARY_CONTRACTION_TUNER_TPP
+#define EINSUM_IR_BASIC_BINARY_CONTRACTION_TUNER_TPP
+
+#include <vector>
+#include "../constants.h"
+#include "ContractionTuningDatabase.h"
+
+namespace einsum_ir {
+  namespace basic {
+    class ContractionTunerTpp;
+  }
+}
+
+/**
+ * Empirical autotuner of the contraction optimizer's parameters for the TPP backend.
+ * Every candidate is optimized, compiled and benchmarked; the fastest parameters are stored in a tuning database.
+ * The search first sweeps the kernel targets, then the L2 cache size, the optimizer's switches including the analytical cost model and the thread splits,
+ * every stage starting from the best parameters of the previous one.
+ **/
+class einsum_ir::basic::ContractionTunerTpp {
+  private:
+    //! loops of the unoptimized contraction
+    std::vector< iter_property > m_iter_space;
+
+    //! datatype of the left input
+    data_t m_dtype_left = UNDEFINED_DTYPE;
+
+    //! datatype of the right input
+    data_t m_dtype_right = UNDEFINED_DTYPE;
+
+    //! datatype of the computations
+    data_t m_dtype_comp = UNDEFINED_DTYPE;
+
+    //! datatype of the output
+    data_t m_dtype_out = UNDEFINED_DTYPE;
+
+    //! type of the first-touch kernel
+    kernel_t m_ktype_first_touch = UNDEFINED_KTYPE;
+
+    //! type of the main kernel
+    kernel_t m_ktype_main = UNDEFINED_KTYPE;
+
+    //! type of the last-touch kernel
+    kernel_t m_ktype_last_touch = UNDEFINED_KTYPE;
+
+    //! number of threads
+    int64_t m_num_threads = 1;
+
+    //! support level of the backend for packed gemms
+    packed_gemm_t m_packed_gemm_support = packed_gemm_t::NONE;
+
+    //! true if the backend supports parallel k dimensions
+    bool m_split_k_support = false;
+
+    //! true if the backend supports complex kernels using the 3m algorithm
+    bool m_cpx_3m_support = false;
+
+    //! parameters at which the search starts
+    tuning_params m_params_default;
+
+    //! candidates for the kernel m target
+    std::vector< int64_t > m_targets_m = { 8, 16, 32, 64 };
+
+    //! candidates for the kernel n target
+    std::vector< int64_t > m_targets_n = { 4, 12, 24, 48 };
+
+    //! candidates for the kernel k target
+    std::vector< int64_t > m_targets_k = { 32, 64, 128, 256 };
+
+    //! candidates for the L2 cache size in bytes
+    std::vector< int64_t > m_l2_cache_sizes = { 524288, 1048576, 2097152 };
+
+    //! number of timed repetitions per candidate
+    int64_t m_num_reps = 5;
+
+    //! number of benchmarked candidates
+    int64_t m_num_candidates = 0;
+
+    //! best parameters
+    tuning_params m_params_best;
+
+    //! time of the best parameters in seconds
+    double m_time_best = -1;
+
+    /**
+     * Optimizes, compiles and benchmarks the contraction for the given parameters.
+     *
+     * @param i_params parameters.
+     *
+     * @return minimum time of a contraction in seconds, negative if the compilation failed.
+     **/
+    double benchmark( tuning_params const & i_params );
+
+    /**
+     * Benchmarks a candidate and keeps it if it is faster than the best parameters.
+     *
+     * @param i_params parameters.
+     **/
+    void try_candidate( tuning_params const & i_params );
+
+  public:
+    /**
+     * Initializes the tuner.
+     * The arguments follow the contraction optimizer and the TPP contraction backend.
+     *
+     * @param i_iter_space loops of the unoptimized contraction, strides in elements.
+     * @param i_dtype_left datatype of the left input.
+     * @param i_dtype_right datatype of the right input.
+     * @param i_dtype_comp datatype of the computations.
+     * @param i_dtype_out datatype of the output.
+     * @param i_ktype_first_touch type of the first-touch kernel.
+     * @param i_ktype_main type of the main kernel.
+     * @param i_ktype_last_touch type of the last-touch kernel.
+     * @param i_num_threads number of threads.
+     * @param i_packed_gemm_support support level of the backend for packed gemms.
+     * @param i_split_k_support true if the backend supports parallel k dimensions.
+     * @param i_cpx_3m_support true if the backend supports complex kernels using the 3m algorithm.
+     * @param i_params_default parameters at which the search starts.
+     **/
+    void init( std::vector< iter_property > const & i_iter_space,
+               data_t                               i_dtype_left,
+               data_t                               i_dtype_right,
+               data_t                               i_dtype_comp,
+               data_t                               i_dtype_out,
+               kernel_t                             i_ktype_first_touch,
+               kernel_t                             i_ktype_main,
+               kernel_t                             i_ktype_last_touch,
+               int64_t                              i_num_threads,
+               packed_gemm_t                        i_packed_gemm_support,
+               bool                                 i_split_k_support,
+               bool                                 i_cpx_3m_support,
+               tuning_params                const & i_params_default );
+
+    /**
+     * Sets the candidates of the kernel targets and L2 cache sizes.
+     *
+     * @param i_targets_m candidates for the kernel m target.
+     * @param i_targets_n candidates for the kernel n target.
+     * @param i_targets_k candidates for the kernel k target.
+     * @param i_l2_cache_sizes candidates for the L2 cache size in bytes.
+     **/
+    void set_search_space( std::vector< int64_t > const & i_targets_m,
+                           std::vector< int64_t > const & i_targets_n,
+                           std::vector< int64_t > const & i_targets_k,
+                           std::vector< int64_t > const & i_l2_cache_sizes );
+
+    /**
+     * Sets the number of timed repetitions per candidate.
+     *
+     * @param i_num_reps number of repetitions.
+     **/
+    void set_num_reps( int64_t i_num_reps );
+
+    /**
+     * Benchmarks the search space and stores the fastest parameters in the database.
+     *
+     * @param io_database tuning database.
+     *
+     * @return SUCCESS if at least one candidate compiled, otherwise an appropiate error code.
+     **/
+    err_t tune( ContractionTuningDatabase * io_database );
+
+    /**
+     * Gets the fastest parameters.
+     *
+     * @return fastest parameters.
+     **/
+    tuning_params get_params_best();
+
+    /**
+     * Gets the time of a contraction with the fastest parameters.
+     *
+     * @return time in seconds, negative if no candidate compiled.
+     **/
+    double get_time_best();
+
+    /**
+     * Gets the number of benchmarked candidates.
+     *
+     * @return number of candidates.
+     **/
+    int64_t get_num_candidates();
+};
+
+#endif
@@ -0,0 +1,64 @@
+#include "catch.hpp"
+#include "ContractionTunerTpp.h"
+
+TEST_CASE( "Autotuning of a matmul with the TPP backend.", "[contraction_tuner_tpp]" ) {
+  //example: [k,m],[n,k]->[n,m]
+  //sizes:   [40,48],[36,40]->[36,48]
+  using namespace einsum_ir::basic;
+
+  std::vector< iter_property > l_iters = { {dim_t::M, exec_t::SEQ, 48,  1,  0, 0,  1},
+                                           {dim_t::N, exec_t::SEQ, 36,  0, 40, 0, 48},
+                                           {dim_t::K, exec_t::SEQ, 40, 48,  1, 0,  0} };
+
+  tuning_params l_params_default;
+  l_params_default.target_m      = 16;
+  l_params_default.target_n      = 12;
+  l_params_default.target_k      = 64;
+  l_params_default.l2_cache_size = 1048576;
+
+  ContractionTunerTpp l_tuner;
+  l_tuner.init( l_iters,
+                data_t::FP32,
+                data_t::FP32,
+                data_t::FP32,
+                data_t::FP32,
+                kernel_t::ZERO,
+                kernel_t::MADD,
+                kernel_t::UNDEFINED_KTYPE,
+                2,
+                packed_gemm_t::ALL_STRIDE_ONE,
+                true,
+                true,
+                l_params_default );
+  l_tuner.set_search_space( { 16, 48 },
+                            { 12 },
+                            { 40 },
+                            { 1048576 } );
+  l_tuner.set_num_reps( 1 );
+
+  ContractionTuningDatabase l_db;
+  REQUIRE( l_tuner.tune( &l_db ) == err_t::SUCCESS );
+
+  // default, two targets, one cache size, five switches and three thread splits
+  REQUIRE( l_tuner.get_num_candidates() == 12 );
+  REQUIRE( l_tuner.get_time_best() >= 0 );
+
+  tuning_params l_found;
+  std::string l_signature = ContractionTuningDatabase::signature( l_iters,
+                                                                  data_t::FP32,
+                                                                  data_t::FP32,
+                                                                  data_t::FP32,
+                                                                  data_t::FP32,
+                                                                  kernel_t::ZERO,
+                                                                  kernel_t::MADD,
+                                                                  kernel_t::UNDEFINED_KTYPE,
+                                                                  2,
+                                                                  packed_gemm_t::ALL_STRIDE_ONE,
+                                                                  true,
+                                                                  true );
+  REQUIRE( l_db.size() == 1 );
+  REQUIRE( l_db.find( l_signature, l_found ) );
+  REQUIRE( l_found.target_m == l_tuner.get_params_best().target_m );
+  REQUIRE( l_found.num_threads_sfc_m == l_tuner.get_params_best().num_threads_sfc_m );
+  REQUIRE( l_found.cost_model == l_tuner.get_params_best().cost_model );
+}
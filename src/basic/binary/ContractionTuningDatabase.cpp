@@ -0,0 +1,209 @@
+#include "ContractionTuningDatabase.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+std::string einsum_ir::basic::ContractionTuningDatabase::signature( std::vector< iter_property > const & i_iter_space,
+                                                                    data_t                               i_dtype_left,
+                                                                    data_t                               i_dtype_right,
+                                                                    data_t                               i_dtype_comp,
+                                                                    data_t                               i_dtype_out,
+                                                                    kernel_t                             i_ktype_first_touch,
+                                                                    kernel_t                             i_ktype_main,
+                                                                    kernel_t                             i_ktype_last_touch,
+                                                                    int64_t                              i_num_threads,
+                                                                    packed_gemm_t                        i_packed_gemm_support,
+                                                                    bool                                 i_split_k_support,
+                                                                    bool                                 i_cpx_3m_support ) {
+  std::ostringstream l_sig;
+  l_sig << i_dtype_left << ","
+        << i_dtype_right << ","
+        << i_dtype_comp << ","
+        << i_dtype_out << ","
+        << i_ktype_first_touch << ","
+        << i_ktype_main << ","
+        << i_ktype_last_touch << ","
+        << i_num_threads << ","
+        << i_packed_gemm_support << ","
+        << i_split_k_support << ","
+        << i_cpx_3m_support;
+
+  for( std::size_t l_id = 0; l_id < i_iter_space.size(); l_id++ ) {
+    iter_property const & l_iter = i_iter_space[l_id];
+    l_sig << "|" << l_iter.dim_type
+          << "," << l_iter.exec_type
+          << "," << l_iter.size
+          << "," << l_iter.stride_left
+          << "," << l_iter.stride_right
+          << "," << l_iter.stride_out_aux
+          << "," << l_iter.stride_out;
+  }
+
+  return l_sig.str();
+}
+
+einsum_ir::basic::ContractionTuningDatabase * einsum_ir::basic::ContractionTuningDatabase::get_default() {
+  static ContractionTuningDatabase l_database;
+  static std::once_flag l_flag;
+  std::call_once( l_flag, [](){
+    l_database.init();
+    char * l_path = std::getenv( "EINSUM_IR_TUNING_DB" );
+    if( l_path != nullptr ) {
+      l_database.load( l_path );
+    }
+  } );
+
+  return &l_database;
+}
+
+void einsum_ir::basic::ContractionTuningDatabase::init() {
+  std::string l_model = "unknown";
+
+#ifdef __linux__
+  FILE * l_cpuinfo = std::fopen( "/proc/cpuinfo", "r" );
+  if( l_cpuinfo != nullptr ) {
+    char l_line[512] = { 0 };
+    while( std::fgets( l_line, sizeof(l_line), l_cpuinfo ) != nullptr ) {
+      if( std::strncmp( l_line, "model name", 10 ) == 0 ) {
+        char * l_value = std::strchr( l_line, ':' );
+        if( l_value != nullptr ) {
+          l_model = l_value + 1;
+        }
+        break;
+      }
+    }
+    std::fclose( l_cpuinfo );
+  }
+#endif
+
+  // keys are separated by semicolons, entries by newlines
+  for( std::size_t l_ch = 0; l_ch < l_model.size(); l_ch++ ) {
+    if( l_model[l_ch] == ';' || l_model[l_ch] == '\n' ) {
+      l_model[l_ch] = ' ';
+    }
+  }
+  std::size_t l_first = l_model.find_first_not_of( ' ' );
+  std::size_t l_last  = l_model.find_last_not_of( ' ' );
+  l_model = l_first == std::string::npos ? "unknown" : l_model.substr( l_first, l_last - l_first + 1 );
+
+  std::lock_guard< std::mutex > l_lock( m_mutex );
+  m_machine = l_model + "/" + std::to_string( std::thread::hardware_concurrency() );
+}
+
+std::string einsum_ir::basic::ContractionTuningDatabase::get_machine() {
+  std::lock_guard< std::mutex > l_lock( m_mutex );
+  return m_machine;
+}
+
+std::string einsum_ir::basic::ContractionTuningDatabase::key( std::string const & i_signature ) {
+  return m_machine + ";" + i_signature;
+}
+
+bool einsum_ir::basic::ContractionTuningDatabase::find( std::string const & i_signature,
+                                                        tuning_params     & o_params ) {
+  std::lock_guard< std::mutex > l_lock( m_mutex );
+
+  std::map< std::string, tuning_params >::iterator l_it = m_entries.find( key( i_signature ) );
+  if( l_it == m_entries.end() ) {
+    return false;
+  }
+
+  o_params = l_it->second;
+  return true;
+}
+
+void einsum_ir::basic::ContractionTuningDatabase::insert( std::string   const & i_signature,
+                                                          tuning_params const & i_params ) {
+  std::lock_guard< std::mutex > l_lock( m_mutex );
+  m_entries[ key( i_signature ) ] = i_params;
+}
+
+int64_t einsum_ir::basic::ContractionTuningDatabase::size() {
+  std::lock_guard< std::mutex > l_lock( m_mutex );
+  return m_entries.size();
+}
+
+void einsum_ir::basic::ContractionTuningDatabase::clear() {
+  std::lock_guard< std::mutex > l_lock( m_mutex );
+  m_entries.clear();
+}
+
+einsum_ir::basic::err_t einsum_ir::basic::ContractionTuningDatabase::load( std::string const & i_path ) {
+  std::ifstream l_file( i_path );
+  if( !l_file.is_open() ) {
+    return err_t::UNDEFINED_ERROR;
+  }
+
+  std::lock_guard< std::mutex > l_lock( m_mutex );
+
+  // line format: machine;signature;parameters
+  std::string l_line;
+  while( std::getline( l_file, l_line ) ) {
+    std::size_t l_sep = l_line.rfind( ';' );
+    if( l_sep == std::string::npos || l_line.find( ';' ) == l_sep ) {
+      continue;
+    }
+
+    tuning_params l_params;
+    std::istringstream l_values( l_line.substr( l_sep + 1 ) );
+    l_values >> l_params.target_m
+             >> l_params.target_n
+             >> l_params.target_k
+             >> l_params.l2_cache_size
+             >> l_params.generate_sfcs
+             >> l_params.br_gemm_support
+             >> l_params.packing_support
+             >> l_params.packed_gemm
+             >> l_params.num_threads_shared
+             >> l_params.num_threads_sfc_m
+             >> l_params.num_threads_sfc_n;
+    if( l_values.fail() ) {
+      continue;
+    }
+    // the cost model switch is optional to support databases without it
+    bool l_cost_model = false;
+    if( l_values >> l_cost_model ) {
+      l_params.cost_model = l_cost_model;
+    }
+
+    m_entries[ l_line.substr( 0, l_sep ) ] = l_params;
+  }
+
+  return err_t::SUCCESS;
+}
+
+einsum_ir::basic::err_t einsum_ir::basic::ContractionTuningDatabase::store( std::string const & i_path ) {
+  std::ofstream l_file( i_path );
+  if( !l_file.is_open() ) {
+    return err_t::UNDEFINED_ERROR;
+  }
+
+  std::lock_guard< std::mutex > l_lock( m_mutex );
+
+  for( std::map< std::string, tuning_params >::iterator l_it = m_entries.begin(); l_it != m_entries.end(); l_it++ ) {
+    tuning_params const & l_params = l_it->second;
+    l_file << l_it->first << ";"
+           << l_params.target_m << " "
+           << l_params.target_n << " "
+           << l_params.target_k << " "
+           << l_params.l2_cache_size << " "
+           << l_params.generate_sfcs << " "
+           << l_params.br_gemm_support << " "
+           << l_params.packing_support << " "
+           << l_params.packed_gemm << " "
+           << l_params.num_threads_shared << " "
+           << l_params.num_threads_sfc_m << " "
+           << l_params.num_threads_sfc_n << " "
+           << l_params.cost_model << "\n";
+  }
+
+  l_file.flush();
+  if( !l_file.good() ) {
+    return err_t::UNDEFINED_ERROR;
+  }
+
+  return err_t::SUCCESS;
+}
@@ -0,0 +1,143 @@
+#ifndef EINSUM_IR_BASIC_BINARY_CONTRACTION_TUNING_DATABASE
+#define EINSUM_IR_BASIC_BINARY_CONTRACTION_TUNING_DATABASE
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../constants.h"
+
+namespace einsum_ir {
+  namespace basic {
+    class ContractionTuningDatabase;
+  }
+}
+
+/**
+ * Persistent database of tuned contraction optimizer parameters.
+ * Entries are keyed by the machine and the signature of the unoptimized contraction.
+ * The default database is consulted by the contraction optimizer and loaded from the file in EINSUM_IR_TUNING_DB if set.
+ **/
+class einsum_ir::basic::ContractionTuningDatabase {
+  private:
+    //! mutex which guards the entries
+    std::mutex m_mutex;
+
+    //! identifier of the machine
+    std::string m_machine;
+
+    //! tuned parameters, keyed by machine and signature
+    std::map< std::string, tuning_params > m_entries;
+
+    /**
+     * Derives the key of an entry.
+     *
+     * @param i_signature signature of the contraction.
+     *
+     * @return key.
+     **/
+    std::string key( std::string const & i_signature );
+
+  public:
+    /**
+     * Derives the signature of an unoptimized contraction.
+     *
+     * @param i_iter_space loops of the unoptimized contraction.
+     * @param i_dtype_left data type of the left input.
+     * @param i_dtype_right data type of the right input.
+     * @param i_dtype_comp data type used for computations.
+     * @param i_dtype_out data type of the output.
+     * @param i_ktype_first_touch type of the first touch kernel.
+     * @param i_ktype_main type of the main kernel.
+     * @param i_ktype_last_touch type of the last touch kernel.
+     * @param i_num_threads total number of threads.
+     * @param i_packed_gemm_support support level for packed gemms.
+     * @param i_split_k_support true if backend supports parallel k dimensions.
+     * @param i_cpx_3m_support true if backend supports complex kernels using the 3m algorithm.
+     *
+     * @return signature.
+     **/
+    static std::string signature( std::vector< iter_property > const & i_iter_space,
+                                  data_t                               i_dtype_left,
+                                  data_t                               i_dtype_right,
+                                  data_t                               i_dtype_comp,
+                                  data_t                               i_dtype_out,
+                                  kernel_t                             i_ktype_first_touch,
+                                  kernel_t                             i_ktype_main,
+                                  kernel_t                             i_ktype_last_touch,
+                                  int64_t                              i_num_threads,
+                                  packed_gemm_t                        i_packed_gemm_support,
+                                  bool                                 i_split_k_support,
+                                  bool                                 i_cpx_3m_support );
+
+    /**
+     * Gets the default database.
+     *
+     * @return default database.
+     **/
+    static ContractionTuningDatabase * get_default();
+
+    /**
+     * Initializes the database for the executing machine, which is identified by its cpu model and number of cpus.
+     **/
+    void init();
+
+    /**
+     * Gets the identifier of the machine.
+     *
+     * @return identifier.
+     **/
+    std::string get_machine();
+
+    /**
+     * Finds the tuned parameters of a contraction on the executing machine.
+     *
+     * @param i_signature signature of the contraction.
+     * @param o_params will be set to the tuned parameters if found.
+     *
+     * @return true if found, false otherwise.
+     **/
+    bool find( std::string const & i_signature,
+               tuning_params     & o_params );
+
+    /**
+     * Inserts or replaces the tuned parameters of a contraction on the executing machine.
+     *
+     * @param i_signature signature of the contraction.
+     * @param i_params tuned parameters.
+     **/
+    void insert( std::string   const & i_signature,
+                 tuning_params const & i_params );
+
+    /**
+     * Gets the number of entries.
+     *
+     * @return number of entries.
+     **/
+    int64_t size();
+
+    /**
+     * Removes all entries.
+     **/
+    void clear();
+
+    /**
+     * Loads entries from a file, existing entries with the same key are replaced.
+     *
+     * @param i_path path of the file.
+     *
+     * @return SUCCESS if the file was read, otherwise an appropiate error code.
+     **/
+    err_t load( std::string const & i_path );
+
+    /**
+     * Stores all entries in a file.
+     *
+     * @param i_path path of the file.
+     *
+     * @return SUCCESS if the file was written, otherwise an appropiate error code.
+     **/
+    err_t store( std::string const & i_path );
+};
+
+#endif
@@ -0,0 +1,217 @@
+#include <cstdio>
+#include "catch.hpp"
+#include "ContractionTuningDatabase.h"
+#include "ContractionOptimizer.h"
+
+TEST_CASE( "Insertion, lookup and persistence of tuned parameters.", "[contraction_tuning_database]" ) {
+  using namespace einsum_ir::basic;
+
+  std::vector< iter_property > l_iters = { {dim_t::M, exec_t::SEQ,  64,   1,  0, 0,   1},
+                                           {dim_t::N, exec_t::SEQ,  48,   0, 32, 0,  64},
+                                           {dim_t::K, exec_t::SEQ,  32,  64,  1, 0,   0} };
+
+  std::string l_sig_0 = ContractionTuningDatabase::signature( l_iters,
+                                                              data_t::FP32,
+                                                              data_t::FP32,
+                                                              data_t::FP32,
+                                                              data_t::FP32,
+                                                              kernel_t::ZERO,
+                                                              kernel_t::MADD,
+                                                              kernel_t::UNDEFINED_KTYPE,
+                                                              4,
+                                                              packed_gemm_t::ALL_STRIDE_ONE,
+                                                              true,
+                                                              true );
+  l_iters[1].size = 49;
+  std::string l_sig_1 = ContractionTuningDatabase::signature( l_iters,
+                                                              data_t::FP32,
+                                                              data_t::FP32,
+                                                              data_t::FP32,
+                                                              data_t::FP32,
+                                                              kernel_t::ZERO,
+                                                              kernel_t::MADD,
+                                                              kernel_t::UNDEFINED_KTYPE,
+                                                              4,
+                                                              packed_gemm_t::ALL_STRIDE_ONE,
+                                                              true,
+                                                              true );
+  l_iters[1].size = 48;
+  std::string l_sig_2 = ContractionTuningDatabase::signature( l_iters,
+                                                              data_t::BF16,
+                                                              data_t::FP32,
+                                                              data_t::FP32,
+                                                              data_t::FP32,
+                                                              kernel_t::ZERO,
+                                                              kernel_t::MADD,
+                                                              kernel_t::UNDEFINED_KTYPE,
+                                                              4,
+                                                              packed_gemm_t::ALL_STRIDE_ONE,
+                                                              true,
+                                                              true );
+  std::string l_sig_3 = ContractionTuningDatabase::signature( l_iters,
+                                                              data_t::FP32,
+                                                              data_t::FP32,
+                                                              data_t::FP32,
+                                                              data_t::FP32,
+                                                              kernel_t::UNDEFINED_KTYPE,
+                                                              kernel_t::MADD,
+                                                              kernel_t::RELU,
+                                                              4,
+                                                              packed_gemm_t::ALL_STRIDE_ONE,
+                                                              true,
+                                                              true );
+  REQUIRE( l_sig_0 != l_sig_1 );
+  // data types and touch kernels are part of the signature
+  REQUIRE( l_sig_0 != l_sig_2 );
+  REQUIRE( l_sig_0 != l_sig_3 );
+
+  ContractionTuningDatabase l_db;
+  l_db.init();
+  REQUIRE( l_db.get_machine().size() > 0 );
+
+  tuning_params l_params;
+  l_params.target_m           = 32;
+  l_params.target_n           = 12;
+  l_params.target_k           = 128;
+  l_params.l2_cache_size      = 2097152;
+  l_params.generate_sfcs      = false;
+  l_params.packed_gemm        = false;
+  l_params.cost_model         = true;
+  l_params.num_threads_shared = 2;
+  l_params.num_threads_sfc_m  = 2;
+  l_params.num_threads_sfc_n  = 1;
+  l_db.insert( l_sig_0,
+               l_params );
+
+  tuning_params l_found;
+  REQUIRE( l_db.find( l_sig_0, l_found ) );
+  REQUIRE( !l_db.find( l_sig_1, l_found ) );
+  REQUIRE( !l_db.find( l_sig_2, l_found ) );
+  REQUIRE( !l_db.find( l_sig_3, l_found ) );
+
+  // round trip through a file
+  std::string l_path = "contraction_tuning_database.test.txt";
+  REQUIRE( l_db.store( l_path ) == err_t::SUCCESS );
+
+  ContractionTuningDatabase l_db_loaded;
+  l_db_loaded.init();
+  REQUIRE( l_db_loaded.load( l_path ) == err_t::SUCCESS );
+  std::remove( l_path.c_str() );
+
+  REQUIRE( l_db_loaded.size() == 1 );
+  REQUIRE( l_db_loaded.find( l_sig_0, l_found ) );
+  REQUIRE( l_found.target_m           == 32 );
+  REQUIRE( l_found.target_n           == 12 );
+  REQUIRE( l_found.target_k           == 128 );
+  REQUIRE( l_found.l2_cache_size      == 2097152 );
+  REQUIRE( l_found.generate_sfcs      == false );
+  REQUIRE( l_found.br_gemm_support    == true );
+  REQUIRE( l_found.packing_support    == true );
+  REQUIRE( l_found.packed_gemm        == false );
+  REQUIRE( l_found.cost_model         == true );
+  REQUIRE( l_found.num_threads_shared == 2 );
+  REQUIRE( l_found.num_threads_sfc_m  == 2 );
+  REQUIRE( l_found.num_threads_sfc_n  == 1 );
+
+  REQUIRE( l_db_loaded.load( "does/not/exist.txt" ) != err_t::SUCCESS );
+}
+
+TEST_CASE( "Contraction optimizer consulting a tuning database.", "[contraction_tuning_database]" ) {
+  using namespace einsum_ir::basic;
+
+  std::vector< iter_property > l_iters = { {dim_t::M, exec_t::SEQ, 256,   1,   0, 0,   1},
+                                           {dim_t::N, exec_t::SEQ, 256,   0, 256, 0, 256},
+                                           {dim_t::K, exec_t::SEQ, 256, 256,   1, 0,   0} };
+
+  // optimizes the loops and returns the size of the primitive m loop
+  auto l_optimize = [&]( ContractionTuningDatabase * i_db,
+                         data_t                      i_dtype_out,
+                         int64_t                   * o_num_threads ) {
+    std::vector< iter_property > l_loops = l_iters;
+    kernel_t l_ktype_main = kernel_t::MADD;
+    o_num_threads[0] = 4;
+    o_num_threads[1] = 1;
+    o_num_threads[2] = 1;
+
+    ContractionOptimizer l_opt;
+    l_opt.init( &l_loops,
+                &l_ktype_main,
+                16,
+                64,
+                256,
+                true,
+                false,
+                false,
+                packed_gemm_t::NONE,
+                false,
+                false,
+                4,
+                1024 * 1024,
+                o_num_threads+0,
+                o_num_threads+1,
+                o_num_threads+2 );
+    l_opt.set_tuning_signature( data_t::FP32,
+                                data_t::FP32,
+                                data_t::FP32,
+                                i_dtype_out,
+                                kernel_t::ZERO,
+                                kernel_t::UNDEFINED_KTYPE );
+    l_opt.set_tuning_database( i_db );
+    REQUIRE( l_opt.optimize() == err_t::SUCCESS );
+
+    int64_t l_size_m = 1;
+    for( std::size_t l_id = 0; l_id < l_loops.size(); l_id++ ) {
+      if(    l_loops[l_id].exec_type == exec_t::PRIM
+          && l_loops[l_id].dim_type  == dim_t::M ) {
+        l_size_m *= l_loops[l_id].size;
+      }
+    }
+    return l_size_m;
+  };
+
+  int64_t l_num_threads_heuristic[3] = { 0, 0, 0 };
+  int64_t l_size_m_heuristic = l_optimize( nullptr,
+                                           data_t::FP32,
+                                           l_num_threads_heuristic );
+  REQUIRE( l_size_m_heuristic == 16 );
+
+  ContractionTuningDatabase l_db;
+  tuning_params l_params;
+  l_params.target_m           = 64;
+  l_params.target_n           = 64;
+  l_params.target_k           = 256;
+  l_params.l2_cache_size      = 1024 * 1024;
+  l_params.num_threads_shared = 1;
+  l_params.num_threads_sfc_m  = 1;
+  l_params.num_threads_sfc_n  = 4;
+  l_db.insert( ContractionTuningDatabase::signature( l_iters,
+                                                     data_t::FP32,
+                                                     data_t::FP32,
+                                                     data_t::FP32,
+                                                     data_t::FP32,
+                                                     kernel_t::ZERO,
+                                                     kernel_t::MADD,
+                                                     kernel_t::UNDEFINED_KTYPE,
+                                                     4,
+                                                     packed_gemm_t::NONE,
+                                                     false,
+                                                     false ),
+               l_params );
+
+  int64_t l_num_threads_tuned[3] = { 0, 0, 0 };
+  int64_t l_size_m_tuned = l_optimize( &l_db,
+                                       data_t::FP32,
+                                       l_num_threads_tuned );
+  REQUIRE( l_size_m_tuned == 64 );
+  REQUIRE( l_num_threads_tuned[0] == 1 );
+  REQUIRE( l_num_threads_tuned[1] == 1 );
+  REQUIRE( l_num_threads_tuned[2] == 4 );
+
+  // other data types do not share the tuned parameters
+  int64_t l_num_threads_other[3] = { 0, 0, 0 };
+  int64_t l_size_m_other = l_optimize( &l_db,
+                                       data_t::FP64,
+                                       l_num_threads_other );
+  REQUIRE( l_size_m_other == l_size_m_heuristic );
+  REQUIRE( l_num_threads_other[0] == l_num_threads_heuristic[0] );
+}
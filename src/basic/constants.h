@@ -19,6 +19,15 @@ namespace einsum_ir {
       BR_MADD         = 12,
       PACKED_MADD     = 13,
       CPX_PACKED_MADD = 14,
+      SCALE           = 15, // out = scalar_0 * out
+      ADD_SCALED      = 16, // out = out + scalar_0 * aux
+      MUL             = 17, // out = out * aux
+      SIGMOID         = 18,
+      TANH            = 19,
+      GELU            = 20,
+      CLAMP           = 21, // out = min( max( out, scalar_0 ), scalar_1 )
+      REQUANTIZE      = 22, // out = sat( round( scalar_0 * aux * acc ) + scalar_1 ), aux: per-channel scales if used
+      CPX_MADD_3M     = 23, // complex madd with three real gemms (3m / gauss algorithm)
       UNDEFINED_KTYPE = 99
     } kernel_t;
 
@@ -43,6 +52,10 @@ namespace einsum_ir {
     typedef enum {
       FP32            = 0,
       FP64            = 1,
+      BF16            = 2,
+      FP16            = 3,
+      INT8            = 4,
+      INT32           = 5,
       UNDEFINED_DTYPE = 99
     } data_t;
 
@@ -60,8 +73,50 @@ namespace einsum_ir {
       OUT_STRIDE_ONE = 2  // output dimension has stride one
     } packed_gemm_t;
 
+    typedef enum {
+      RECURSIVE = 0, // one function call per loop and iteration
+      FLAT      = 1  // sequential and sfc loops are executed as one flat loop nest
+    } loop_nest_t;
+
+    typedef enum {
+      STATIC  = 0, // every thread executes a fixed range of tasks
+      DYNAMIC = 1  // tasks are split into finer chunks, idle threads steal chunks of other threads
+    } sched_t;
+
+    typedef enum {
+      NO_PREFETCH  = 0, // no software prefetching
+      SFC_PREFETCH = 1  // the blocks of the next sfc step are prefetched while the current step is computed
+    } prefetch_t;
+
+    typedef enum {
+      SMALL_PAGES            = 0, // memory is backed by pages of the base page size
+      TRANSPARENT_HUGE_PAGES = 1, // memory is aligned to huge pages and advised to be backed by transparent huge pages
+      EXPLICIT_HUGE_PAGES    = 2, // memory is mapped from the huge page pool, falls back to transparent huge pages
+      HEAP_MEMORY            = 3  // memory is obtained from the regular allocator, used if no pages could be mapped
+    } page_t;
+
     typedef uint8_t sfc_t;
 
+    struct last_touch_op {
+      kernel_t ktype    = kernel_t::UNDEFINED_KTYPE;
+      double   scalar_0 = 0;
+      double   scalar_1 = 0;
+    };
+
+    struct flat_loop_state {
+      int64_t        counter          = 0;
+      int64_t        id_sfc_m         = 0;
+      int64_t        id_sfc_n         = 0;
+      char const   * ptr_left         = nullptr;
+      char const   * ptr_right        = nullptr;
+      char const   * ptr_out_aux      = nullptr;
+      char         * ptr_out          = nullptr;
+      char const   * ptr_left_active  = nullptr;
+      char const   * ptr_right_active = nullptr;
+      bool           first_access     = false;
+      bool           last_access      = false;
+    };
+
     struct thread_info {
       int64_t   offset_left    = 0;
       int64_t   offset_right   = 0;
@@ -69,6 +124,9 @@ namespace einsum_ir {
       int64_t   offset_out     = 0;
       char    * memory_left    = nullptr;
       char    * memory_right   = nullptr;
+      char    * memory_out     = nullptr;
+      char    * tensor_out     = nullptr;
+      uint8_t * touched_out    = nullptr;
 
       int64_t id_shared_loop_start = 0;
       int64_t id_shared_loop_end   = 0;
@@ -80,6 +138,8 @@ namespace einsum_ir {
       std::vector<sfc_t>   movement_ids;
       std::vector<const char *> cached_ptrs_left;
       std::vector<const char *> cached_ptrs_right;
+      std::vector<int64_t> shared_counters;
+      std::vector<flat_loop_state> flat_states;
     };
 
     struct iter_property {
@@ -94,11 +154,42 @@ namespace einsum_ir {
       int64_t packing_stride_right = 0;
     };
 
+    //! tuned parameters of the contraction optimizer
+    struct tuning_params {
+      int64_t target_m           = 0;
+      int64_t target_n           = 0;
+      int64_t target_k           = 0;
+      int64_t l2_cache_size      = 0;
+      bool    generate_sfcs      = true;
+      bool    br_gemm_support    = true;
+      bool    packing_support    = true;
+      bool    packed_gemm        = true;
+      //! true if the kernel targets and the blocking are derived by the analytical cost model
+      bool    cost_model         = false;
+      //! thread split, zero if the optimizer's split is used
+      int64_t num_threads_shared = 0;
+      int64_t num_threads_sfc_m  = 0;
+      int64_t num_threads_sfc_n  = 0;
+    };
+
     constexpr int64_t ce_n_bytes( data_t i_dtype ) {
       if(      i_dtype == FP32 )  return 4;
       else if( i_dtype == FP64 )  return 8;
+      else if( i_dtype == BF16 )  return 2;
+      else if( i_dtype == FP16 )  return 2;
+      else if( i_dtype == INT8 )  return 1;
+      else if( i_dtype == INT32 ) return 4;
       else                        return -1;
     }
+
+    constexpr bool ce_low_precision( data_t i_dtype ) {
+      return i_dtype == BF16 || i_dtype == FP16;
+    }
+
+    // requantized int8 outputs use fp32 scales as auxiliary output tensor
+    constexpr data_t ce_dtype_out_aux( data_t i_dtype_out ) {
+      return i_dtype_out == INT8 ? FP32 : i_dtype_out;
+    }
   }
 }
 
@@ -0,0 +1,53 @@
+#include "AsyncExecutor.h"
+
+einsum_ir::basic::AsyncExecutor::~AsyncExecutor() {
+  {
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+    m_stop = true;
+  }
+  m_cv.notify_all();
+
+  if( m_thread.joinable() ) {
+    m_thread.join();
+  }
+}
+
+void einsum_ir::basic::AsyncExecutor::work() {
+  while( true ) {
+    std::packaged_task< void() > l_job;
+    {
+      std::unique_lock< std::mutex > l_lock( m_mutex );
+      m_cv.wait( l_lock, [&]{ return m_stop || !m_jobs.empty(); } );
+
+      //remaining jobs are finished before terminating
+      if( m_jobs.empty() ) {
+        return;
+      }
+      l_job = std::move( m_jobs.front() );
+      m_jobs.pop_front();
+    }
+
+    l_job();
+  }
+}
+
+std::future< void > einsum_ir::basic::AsyncExecutor::submit( std::function< void() > i_job ) {
+  std::packaged_task< void() > l_job( std::move( i_job ) );
+  std::future< void > l_future = l_job.get_future();
+
+  {
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+    if( !m_thread.joinable() ) {
+      m_thread = std::thread( [this]() { work(); } );
+    }
+    m_jobs.push_back( std::move( l_job ) );
+  }
+  m_cv.notify_one();
+
+  return l_future;
+}
+
+einsum_ir::basic::AsyncExecutor * einsum_ir::basic::AsyncExecutor::get_default() {
+  static AsyncExecutor l_executor;
+  return &l_executor;
+}
@@ -0,0 +1,70 @@
+#ifndef EINSUM_IR_BASIC_PARALLEL_ASYNC_EXECUTOR
+#define EINSUM_IR_BASIC_PARALLEL_ASYNC_EXECUTOR
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include "../constants.h"
+
+namespace einsum_ir {
+  namespace basic {
+    class AsyncExecutor;
+  }
+}
+
+/**
+ * Executes submitted jobs asynchronously in submission order on a dispatching thread.
+ * The jobs are executed one after another, they overlap only with the work of the submitting thread.
+ * Parallel work of the jobs is submitted by the dispatching thread to the default execution context.
+ * With the OpenMP context the dispatching thread opens its own team next to a team of the submitting thread,
+ * which oversubscribes the cores if both are busy. The worker pool context serializes the submissions instead.
+ **/
+class einsum_ir::basic::AsyncExecutor {
+  private:
+    //! dispatching thread, started with the first submission
+    std::thread m_thread;
+
+    //! jobs which are not started yet
+    std::deque< std::packaged_task< void() > > m_jobs;
+
+    //! true if the dispatching thread has to terminate
+    bool m_stop = false;
+
+    //! mutex of the job queue
+    std::mutex m_mutex;
+
+    //! condition variable on which the dispatching thread waits for jobs
+    std::condition_variable m_cv;
+
+    /**
+     * Main loop of the dispatching thread.
+     **/
+    void work();
+
+  public:
+    /**
+     * Destructor, finishes all submitted jobs and terminates the dispatching thread.
+     **/
+    ~AsyncExecutor();
+
+    /**
+     * Submits a job.
+     *
+     * @param i_job job which is executed asynchronously.
+     *
+     * @return future which becomes ready once the job finished.
+     **/
+    std::future< void > submit( std::function< void() > i_job );
+
+    /**
+     * Gets the executor which is used for asynchronous contractions and expressions.
+     *
+     * @return default executor.
+     **/
+    static AsyncExecutor * get_default();
+};
+
+#endif
@@ -0,0 +1,44 @@
+#include <vector>
+#include "catch.hpp"
+#include "AsyncExecutor.h"
+#include "ExecutionContextPool.h"
+
+TEST_CASE( "Jobs of the async executor are executed in submission order.", "[async_executor]" ) {
+  using namespace einsum_ir::basic;
+
+  AsyncExecutor l_executor;
+  std::vector< int64_t > l_order;
+  std::vector< std::future< void > > l_futures;
+
+  for( int64_t l_jo = 0; l_jo < 10; l_jo++ ) {
+    l_futures.push_back( l_executor.submit( [&l_order, l_jo]() { l_order.push_back( l_jo ); } ) );
+  }
+
+  l_futures.back().wait();
+  for( int64_t l_jo = 0; l_jo < 10; l_jo++ ) {
+    REQUIRE( l_futures[l_jo].wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready );
+    REQUIRE( l_order[l_jo] == l_jo );
+  }
+}
+
+TEST_CASE( "Async jobs submit parallel work to a worker pool.", "[async_executor]" ) {
+  using namespace einsum_ir::basic;
+
+  ExecutionContextPool l_pool;
+  l_pool.init( 3,
+               false );
+
+  AsyncExecutor l_executor;
+  std::vector< int64_t > l_counts( 6, 0 );
+  std::future< void > l_future = l_executor.submit( [&]() {
+                                                      l_pool.parallel( 6,
+                                                                       [&]( int64_t i_id_thread ) {
+                                                                         l_counts[i_id_thread]++;
+                                                                       } );
+                                                    } );
+  l_future.get();
+
+  for( int64_t l_id = 0; l_id < 6; l_id++ ) {
+    REQUIRE( l_counts[l_id] == 1 );
+  }
+}
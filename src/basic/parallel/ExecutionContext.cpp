@@ -0,0 +1,38 @@
+#include "ExecutionContext.h"
+#include "ExecutionContextOmp.h"
+
+einsum_ir::basic::ExecutionContext * einsum_ir::basic::ExecutionContext::s_default = nullptr;
+
+void einsum_ir::basic::ExecutionContext::parallel_for( int64_t                                i_num_threads,
+                                                       int64_t                                i_size,
+                                                       std::function< void( int64_t ) > const & i_func ) {
+  int64_t l_num_threads = i_num_threads < i_size ? i_num_threads : i_size;
+  if( l_num_threads <= 1 ) {
+    for( int64_t l_it = 0; l_it < i_size; l_it++ ) {
+      i_func( l_it );
+    }
+    return;
+  }
+
+  parallel( l_num_threads,
+            [&]( int64_t i_id_thread ) {
+              int64_t l_begin = ( i_id_thread     * i_size ) / l_num_threads;
+              int64_t l_end   = ( (i_id_thread+1) * i_size ) / l_num_threads;
+              for( int64_t l_it = l_begin; l_it < l_end; l_it++ ) {
+                i_func( l_it );
+              }
+            } );
+}
+
+einsum_ir::basic::ExecutionContext * einsum_ir::basic::ExecutionContext::get_default() {
+  if( s_default != nullptr ) {
+    return s_default;
+  }
+
+  static ExecutionContextOmp l_context_omp;
+  return &l_context_omp;
+}
+
+void einsum_ir::basic::ExecutionContext::set_default( ExecutionContext * i_context ) {
+  s_default = i_context;
+}
@@ -0,0 +1,69 @@
+#ifndef EINSUM_IR_BASIC_PARALLEL_EXECUTION_CONTEXT
+#define EINSUM_IR_BASIC_PARALLEL_EXECUTION_CONTEXT
+
+#include <functional>
+#include "../constants.h"
+
+namespace einsum_ir {
+  namespace basic {
+    class ExecutionContext;
+  }
+}
+
+class einsum_ir::basic::ExecutionContext {
+  private:
+    //! execution context to which all backends submit their parallel work, nullptr selects the OpenMP context
+    static ExecutionContext * s_default;
+
+  public:
+    /**
+     * Destructor.
+     **/
+    virtual ~ExecutionContext(){};
+
+    /**
+     * Executes the given function once for every thread id.
+     * The call returns after all executions finished.
+     *
+     * @param i_num_threads number of thread ids.
+     * @param i_func function which is called with the thread id as argument.
+     **/
+    virtual void parallel( int64_t                                i_num_threads,
+                           std::function< void( int64_t ) > const & i_func ) = 0;
+
+    /**
+     * Gets the maximum number of threads which execute concurrently.
+     *
+     * @return maximum number of threads.
+     **/
+    virtual int64_t get_max_threads() = 0;
+
+    /**
+     * Executes the iterations of a loop in parallel.
+     * Every thread id executes a contiguous chunk of the iterations.
+     *
+     * @param i_num_threads number of thread ids.
+     * @param i_size number of iterations.
+     * @param i_func function which is called with the iteration as argument.
+     **/
+    void parallel_for( int64_t                                i_num_threads,
+                       int64_t                                i_size,
+                       std::function< void( int64_t ) > const & i_func );
+
+    /**
+     * Gets the execution context which is used by all backends.
+     *
+     * @return default execution context.
+     **/
+    static ExecutionContext * get_default();
+
+    /**
+     * Sets the execution context which is used by all backends.
+     * The context has to outlive all executions which use it.
+     *
+     * @param i_context execution context, nullptr restores the OpenMP context.
+     **/
+    static void set_default( ExecutionContext * i_context );
+};
+
+#endif
@@ -0,0 +1,23 @@
+#include "ExecutionContextOmp.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+void einsum_ir::basic::ExecutionContextOmp::parallel( int64_t                                i_num_threads,
+                                                      std::function< void( int64_t ) > const & i_func ) {
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(i_num_threads)
+#endif
+  for( int64_t l_id_thread = 0; l_id_thread < i_num_threads; l_id_thread++ ) {
+    i_func( l_id_thread );
+  }
+}
+
+int64_t einsum_ir::basic::ExecutionContextOmp::get_max_threads() {
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
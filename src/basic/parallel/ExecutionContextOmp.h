@@ -0,0 +1,35 @@
+#ifndef EINSUM_IR_BASIC_PARALLEL_EXECUTION_CONTEXT_OMP
+#define EINSUM_IR_BASIC_PARALLEL_EXECUTION_CONTEXT_OMP
+
+#include "ExecutionContext.h"
+
+namespace einsum_ir {
+  namespace basic {
+    class ExecutionContextOmp;
+  }
+}
+
+/**
+ * Execution context which opens an OpenMP parallel region per call.
+ * Executes sequentially if OpenMP is not available.
+ **/
+class einsum_ir::basic::ExecutionContextOmp: public ExecutionContext {
+  public:
+    /**
+     * Executes the given function once for every thread id in an OpenMP parallel region.
+     *
+     * @param i_num_threads number of thread ids.
+     * @param i_func function which is called with the thread id as argument.
+     **/
+    void parallel( int64_t                                i_num_threads,
+                   std::function< void( int64_t ) > const & i_func );
+
+    /**
+     * Gets the maximum number of OpenMP threads.
+     *
+     * @return maximum number of threads.
+     **/
+    int64_t get_max_threads();
+};
+
+#endif
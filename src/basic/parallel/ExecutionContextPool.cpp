@@ -0,0 +1,157 @@
+#include "ExecutionContextPool.h"
+#include "NumaTopology.h"
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+  //! true if the thread executes work of a pool
+  thread_local bool t_in_pool = false;
+
+  /**
+   * Hints the processor that the thread is spinning.
+   **/
+  inline void spin_pause() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile( "yield" );
+#endif
+  }
+}
+
+einsum_ir::basic::ExecutionContextPool::~ExecutionContextPool() {
+  {
+    std::lock_guard< std::mutex > l_lock( m_mutex_sleep );
+    m_stop = true;
+  }
+  m_cv_sleep.notify_all();
+
+  for( std::size_t l_wo = 0; l_wo < m_workers.size(); l_wo++ ) {
+    m_workers[l_wo].join();
+  }
+}
+
+void einsum_ir::basic::ExecutionContextPool::init( int64_t i_num_threads,
+                                                   bool    i_pin_threads ) {
+  //spinning threads slow down working threads if the cores are oversubscribed
+  int64_t l_num_cores = std::thread::hardware_concurrency();
+  if( l_num_cores > 0 && i_num_threads > l_num_cores ) {
+    m_spin_count = m_spin_count_oversubscribed;
+  }
+
+  //contiguous thread ids share a NUMA node, thus neighboring SFC partitions and their thread memory stay on one node
+  //the calling thread belongs to the application and keeps its affinity
+  NumaTopology * l_topology = NumaTopology::get_default();
+
+  for( int64_t l_wo = 1; l_wo < i_num_threads; l_wo++ ) {
+    int64_t l_cpu = l_topology->get_cpu( l_wo, i_num_threads );
+    m_workers.emplace_back( [this, l_wo, l_cpu, i_pin_threads]() {
+                              if( i_pin_threads ) {
+                                pin( l_cpu );
+                              }
+                              work( l_wo );
+                            } );
+  }
+}
+
+void einsum_ir::basic::ExecutionContextPool::pin( int64_t i_id_core ) {
+#ifdef __linux__
+  if( i_id_core < 0 || i_id_core >= CPU_SETSIZE ) {
+    return;
+  }
+
+  cpu_set_t l_cpu_set;
+  CPU_ZERO( &l_cpu_set );
+  CPU_SET( i_id_core, &l_cpu_set );
+  pthread_setaffinity_np( pthread_self(),
+                          sizeof(cpu_set_t),
+                          &l_cpu_set );
+#else
+  (void) i_id_core;
+#endif
+}
+
+void einsum_ir::basic::ExecutionContextPool::work( int64_t i_id_worker ) {
+  t_in_pool = true;
+  int64_t l_generation_done = 0;
+
+  while( true ) {
+    //spin on new work
+    int64_t l_generation = m_generation.load( std::memory_order_acquire );
+    for( int64_t l_sp = 0; l_sp < m_spin_count && l_generation == l_generation_done; l_sp++ ) {
+      spin_pause();
+      l_generation = m_generation.load( std::memory_order_acquire );
+    }
+
+    //sleep until new work arrives
+    if( l_generation == l_generation_done ) {
+      std::unique_lock< std::mutex > l_lock( m_mutex_sleep );
+      m_cv_sleep.wait( l_lock, [&]{ return    m_stop
+                                           || m_generation.load( std::memory_order_acquire ) != l_generation_done; } );
+      if( m_stop ) {
+        return;
+      }
+      l_generation = m_generation.load( std::memory_order_acquire );
+    }
+
+    execute( i_id_worker );
+    l_generation_done = l_generation;
+    m_num_pending.fetch_sub( 1, std::memory_order_acq_rel );
+  }
+}
+
+void einsum_ir::basic::ExecutionContextPool::execute( int64_t i_id_thread ) {
+  for( int64_t l_id = i_id_thread; l_id < m_num_ids && i_id_thread < m_num_active; l_id += m_num_active ) {
+    (*m_func)( l_id );
+  }
+}
+
+void einsum_ir::basic::ExecutionContextPool::parallel( int64_t                                i_num_threads,
+                                                       std::function< void( int64_t ) > const & i_func ) {
+  //execute sequentially if no workers are available or the call is nested
+  if( i_num_threads <= 1 || m_workers.size() == 0 || t_in_pool ) {
+    for( int64_t l_id = 0; l_id < i_num_threads; l_id++ ) {
+      i_func( l_id );
+    }
+    return;
+  }
+
+  std::lock_guard< std::mutex > l_lock_submit( m_mutex_submit );
+  int64_t l_num_workers = m_workers.size();
+
+  //publish work
+  m_func = &i_func;
+  m_num_ids = i_num_threads;
+  m_num_active = std::min( i_num_threads, l_num_workers + 1 );
+  m_num_pending.store( l_num_workers, std::memory_order_relaxed );
+  {
+    std::lock_guard< std::mutex > l_lock_sleep( m_mutex_sleep );
+    m_generation.fetch_add( 1, std::memory_order_release );
+  }
+  m_cv_sleep.notify_all();
+
+  //participate as thread 0
+  t_in_pool = true;
+  execute( 0 );
+  t_in_pool = false;
+
+  //wait for the workers
+  int64_t l_sp = 0;
+  while( m_num_pending.load( std::memory_order_acquire ) != 0 ) {
+    if( l_sp < m_spin_count ) {
+      spin_pause();
+      l_sp++;
+    }
+    else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+int64_t einsum_ir::basic::ExecutionContextPool::get_max_threads() {
+  return m_workers.size() + 1;
+}
@@ -0,0 +1,114 @@
+#ifndef EINSUM_IR_BASIC_PARALLEL_EXECUTION_CONTEXT_POOL
+#define EINSUM_IR_BASIC_PARALLEL_EXECUTION_CONTEXT_POOL
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ExecutionContext.h"
+
+namespace einsum_ir {
+  namespace basic {
+    class ExecutionContextPool;
+  }
+}
+
+/**
+ * Execution context with a persistent pool of worker threads.
+ * The workers spin for a while after finishing their work and sleep afterwards.
+ * The calling thread participates in the execution as thread 0.
+ **/
+class einsum_ir::basic::ExecutionContextPool: public ExecutionContext {
+  private:
+    //! persistent worker threads
+    std::vector< std::thread > m_workers;
+
+    //! number of spin iterations before a waiting thread sleeps or yields
+    int64_t m_spin_count = 100000;
+
+    //! number of spin iterations if there are more threads than cores
+    int64_t m_spin_count_oversubscribed = 100;
+
+    //! generation of the submitted work, incremented for every call of parallel
+    std::atomic< int64_t > m_generation{ 0 };
+
+    //! number of workers which did not finish the current generation
+    std::atomic< int64_t > m_num_pending{ 0 };
+
+    //! true if the workers have to terminate
+    bool m_stop = false;
+
+    //! function of the current generation
+    std::function< void( int64_t ) > const * m_func = nullptr;
+
+    //! number of thread ids of the current generation
+    int64_t m_num_ids = 0;
+
+    //! number of threads which execute the current generation
+    int64_t m_num_active = 0;
+
+    //! serializes the submissions of different calling threads
+    std::mutex m_mutex_submit;
+
+    //! mutex of the sleeping workers
+    std::mutex m_mutex_sleep;
+
+    //! condition variable on which sleeping workers wait
+    std::condition_variable m_cv_sleep;
+
+    /**
+     * Main loop of a worker thread.
+     *
+     * @param i_id_worker id of the worker, starting at 1.
+     **/
+    void work( int64_t i_id_worker );
+
+    /**
+     * Executes the thread ids of the current generation assigned to the given thread.
+     *
+     * @param i_id_thread id of the executing thread, 0 is the calling thread.
+     **/
+    void execute( int64_t i_id_thread );
+
+    /**
+     * Pins the calling thread to the given core.
+     *
+     * @param i_id_core id of the core.
+     **/
+    static void pin( int64_t i_id_core );
+
+  public:
+    /**
+     * Destructor, terminates all workers.
+     **/
+    ~ExecutionContextPool();
+
+    /**
+     * Initializes the pool and starts the workers.
+     *
+     * @param i_num_threads number of threads including the calling thread.
+     * @param i_pin_threads true if the workers are pinned to the cores given by the NUMA topology, the calling thread is never pinned.
+     **/
+    void init( int64_t i_num_threads,
+               bool    i_pin_threads );
+
+    /**
+     * Executes the given function once for every thread id on the workers and the calling thread.
+     * Nested calls from inside an execution are executed sequentially.
+     *
+     * @param i_num_threads number of thread ids.
+     * @param i_func function which is called with the thread id as argument.
+     **/
+    void parallel( int64_t                                i_num_threads,
+                   std::function< void( int64_t ) > const & i_func );
+
+    /**
+     * Gets the number of threads of the pool, including the calling thread.
+     *
+     * @return number of threads.
+     **/
+    int64_t get_max_threads();
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "catch.hpp"
+#include "ExecutionContextPool.h"
+
+TEST_CASE( "Every thread id is executed exactly once by the worker pool.", "[execution_context_pool]" ) {
+  using namespace einsum_ir::basic;
+
+  ExecutionContextPool l_pool;
+  l_pool.init( 3,
+               false );
+  REQUIRE( l_pool.get_max_threads() == 3 );
+
+  for( int64_t l_num_threads : { 1, 2, 3, 7 } ) {
+    for( int64_t l_rep = 0; l_rep < 50; l_rep++ ) {
+      std::vector< int64_t > l_counts( l_num_threads, 0 );
+      l_pool.parallel( l_num_threads,
+                       [&]( int64_t i_id_thread ) {
+                         l_counts[i_id_thread]++;
+                       } );
+
+      for( int64_t l_id = 0; l_id < l_num_threads; l_id++ ) {
+        REQUIRE( l_counts[l_id] == 1 );
+      }
+    }
+  }
+}
+
+TEST_CASE( "Nested and chunked execution with the worker pool.", "[execution_context_pool]" ) {
+  using namespace einsum_ir::basic;
+
+  ExecutionContextPool l_pool;
+  l_pool.init( 4,
+               false );
+
+  // nested calls are executed sequentially
+  std::vector< int64_t > l_counts( 16, 0 );
+  l_pool.parallel( 4,
+                   [&]( int64_t i_id_outer ) {
+                     l_pool.parallel( 4,
+                                      [&]( int64_t i_id_inner ) {
+                                        l_counts[i_id_outer * 4 + i_id_inner]++;
+                                      } );
+                   } );
+  for( int64_t l_id = 0; l_id < 16; l_id++ ) {
+    REQUIRE( l_counts[l_id] == 1 );
+  }
+
+  // every iteration of a loop is executed once
+  std::vector< int64_t > l_its( 101, 0 );
+  l_pool.parallel_for( 4,
+                       101,
+                       [&]( int64_t i_it ) {
+                         l_its[i_it]++;
+                       } );
+  for( int64_t l_it = 0; l_it < 101; l_it++ ) {
+    REQUIRE( l_its[l_it] == 1 );
+  }
+}
+
+#ifdef __linux__
+TEST_CASE( "Pinning the worker pool keeps the affinity of the calling thread.", "[execution_context_pool]" ) {
+  using namespace einsum_ir::basic;
+
+  cpu_set_t l_set_before;
+  CPU_ZERO( &l_set_before );
+  pthread_getaffinity_np( pthread_self(),
+                          sizeof(cpu_set_t),
+                          &l_set_before );
+
+  {
+    ExecutionContextPool l_pool;
+    l_pool.init( 2,
+                 true );
+
+    std::vector< int64_t > l_counts( 2, 0 );
+    l_pool.parallel( 2,
+                     [&]( int64_t i_id_thread ) {
+                       l_counts[i_id_thread]++;
+                     } );
+    REQUIRE( l_counts[0] == 1 );
+    REQUIRE( l_counts[1] == 1 );
+  }
+
+  cpu_set_t l_set_after;
+  CPU_ZERO( &l_set_after );
+  pthread_getaffinity_np( pthread_self(),
+                          sizeof(cpu_set_t),
+                          &l_set_after );
+  REQUIRE( CPU_EQUAL( &l_set_before, &l_set_after ) );
+}
+#endif
@@ -0,0 +1,267 @@
+#include "HardwareTopology.h"
+#include "NumaTopology.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#include <sys/prctl.h>
+#endif
+
+int64_t einsum_ir::basic::HardwareTopology::parse_size( char const * i_str ) {
+  char * l_end = nullptr;
+  int64_t l_size = std::strtoll( i_str, &l_end, 10 );
+  if( l_end == i_str || l_size < 0 ) {
+    return 0;
+  }
+
+  if(      *l_end == 'K' ) l_size *= 1024;
+  else if( *l_end == 'M' ) l_size *= 1024 * 1024;
+  else if( *l_end == 'G' ) l_size *= 1024 * 1024 * 1024;
+
+  return l_size;
+}
+
+void einsum_ir::basic::HardwareTopology::init_caches() {
+#ifdef __linux__
+  for( int64_t l_id = 0; true; l_id++ ) {
+    std::string l_path = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string( l_id ) + "/";
+
+    FILE * l_file = std::fopen( (l_path + "level").c_str(), "r" );
+    if( l_file == nullptr ) {
+      break;
+    }
+    int l_level = 0;
+    if( std::fscanf( l_file, "%d", &l_level ) != 1 ) {
+      l_level = 0;
+    }
+    std::fclose( l_file );
+
+    char l_type[64] = { 0 };
+    l_file = std::fopen( (l_path + "type").c_str(), "r" );
+    if( l_file != nullptr ) {
+      if( std::fgets( l_type, sizeof(l_type), l_file ) == nullptr ) {
+        l_type[0] = '\0';
+      }
+      std::fclose( l_file );
+    }
+    if( std::strncmp( l_type, "Instruction", 11 ) == 0 ) {
+      continue;
+    }
+
+    char l_size_str[64] = { 0 };
+    int64_t l_size = 0;
+    l_file = std::fopen( (l_path + "size").c_str(), "r" );
+    if( l_file != nullptr ) {
+      if( std::fgets( l_size_str, sizeof(l_size_str), l_file ) != nullptr ) {
+        l_size = parse_size( l_size_str );
+      }
+      std::fclose( l_file );
+    }
+    if( l_size <= 0 ) {
+      continue;
+    }
+
+    if(      l_level == 1 ) m_l1_cache_size = l_size;
+    else if( l_level == 2 ) m_l2_cache_size = l_size;
+    else if( l_level == 3 ) m_l3_cache_size = l_size;
+  }
+#endif
+}
+
+void einsum_ir::basic::HardwareTopology::init_cores() {
+  m_num_cpus = std::thread::hardware_concurrency();
+  m_num_cpus = m_num_cpus > 0 ? m_num_cpus : 1;
+  m_num_cores = m_num_cpus;
+
+#ifdef __linux__
+  FILE * l_file = std::fopen( "/sys/devices/system/cpu/online", "r" );
+  if( l_file == nullptr ) {
+    return;
+  }
+  char l_list[4096] = { 0 };
+  bool l_read = std::fgets( l_list, sizeof(l_list), l_file ) != nullptr;
+  std::fclose( l_file );
+  if( !l_read ) {
+    return;
+  }
+
+  std::vector< int64_t > l_cpus;
+  NumaTopology::parse_cpu_list( l_list,
+                                l_cpus );
+
+  //cpus of the same core share their list of siblings
+  std::set< std::string > l_cores;
+  for( std::size_t l_cp = 0; l_cp < l_cpus.size(); l_cp++ ) {
+    std::string l_path =   "/sys/devices/system/cpu/cpu" + std::to_string( l_cpus[l_cp] )
+                         + "/topology/thread_siblings_list";
+    l_file = std::fopen( l_path.c_str(), "r" );
+    if( l_file == nullptr ) {
+      continue;
+    }
+    char l_siblings[4096] = { 0 };
+    if( std::fgets( l_siblings, sizeof(l_siblings), l_file ) != nullptr ) {
+      l_cores.insert( l_siblings );
+    }
+    std::fclose( l_file );
+  }
+
+  if( l_cpus.size() > 0 ) {
+    m_num_cpus = l_cpus.size();
+  }
+  m_num_cores = l_cores.size() > 0 ? l_cores.size() : m_num_cpus;
+#endif
+}
+
+void einsum_ir::basic::HardwareTopology::init_isa() {
+  m_features.clear();
+
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int l_eax = 0, l_ebx = 0, l_ecx = 0, l_edx = 0;
+  unsigned int l_max_leaf = __get_cpuid_max( 0, nullptr );
+
+  bool l_os_ymm = false;
+  bool l_os_zmm = false;
+  if( l_max_leaf >= 1 && __get_cpuid( 1, &l_eax, &l_ebx, &l_ecx, &l_edx ) ) {
+    if( l_ecx & (1u << 12) ) m_features.insert( "fma" );
+    if( l_ecx & (1u << 28) ) m_features.insert( "avx" );
+
+    //vector states enabled by the operating system
+    if( l_ecx & (1u << 27) ) {
+      unsigned int l_xcr0_lo = 0, l_xcr0_hi = 0;
+      __asm__ volatile( "xgetbv" : "=a"(l_xcr0_lo), "=d"(l_xcr0_hi) : "c"(0) );
+      l_os_ymm = (l_xcr0_lo & 0x06) == 0x06;
+      l_os_zmm = (l_xcr0_lo & 0xe6) == 0xe6;
+    }
+  }
+  if( l_max_leaf >= 7 && __get_cpuid_count( 7, 0, &l_eax, &l_ebx, &l_ecx, &l_edx ) ) {
+    if( l_ebx & (1u <<  5) ) m_features.insert( "avx2" );
+    if( l_ebx & (1u << 16) ) m_features.insert( "avx512f" );
+    if( l_ebx & (1u << 17) ) m_features.insert( "avx512dq" );
+    if( l_ebx & (1u << 30) ) m_features.insert( "avx512bw" );
+    if( l_ecx & (1u << 11) ) m_features.insert( "avx512_vnni" );
+    if( l_edx & (1u << 22) ) m_features.insert( "amx_bf16" );
+    if( l_edx & (1u << 24) ) m_features.insert( "amx_tile" );
+    if( l_edx & (1u << 25) ) m_features.insert( "amx_int8" );
+    if( __get_cpuid_count( 7, 1, &l_eax, &l_ebx, &l_ecx, &l_edx ) ) {
+      if( l_eax & (1u << 5) ) m_features.insert( "avx512_bf16" );
+    }
+  }
+
+  if( m_features.count( "avx512f" ) && l_os_zmm ) {
+    m_vector_bytes = 64;
+    m_num_vector_registers = 32;
+  }
+  else if( m_features.count( "avx" ) && l_os_ymm ) {
+    m_vector_bytes = 32;
+    m_num_vector_registers = 16;
+  }
+  else {
+    m_vector_bytes = 16;
+    m_num_vector_registers = 16;
+  }
+#else
+#ifdef __linux__
+  FILE * l_cpuinfo = std::fopen( "/proc/cpuinfo", "r" );
+  if( l_cpuinfo != nullptr ) {
+    char l_line[4096] = { 0 };
+    while( std::fgets( l_line, sizeof(l_line), l_cpuinfo ) != nullptr ) {
+      if(    std::strncmp( l_line, "Features", 8 ) == 0
+          || std::strncmp( l_line, "flags",    5 ) == 0 ) {
+        char const * l_colon = std::strchr( l_line, ':' );
+        if( l_colon != nullptr ) {
+          std::istringstream l_flags( l_colon + 1 );
+          std::string l_flag;
+          while( l_flags >> l_flag ) {
+            m_features.insert( l_flag );
+          }
+        }
+        break;
+      }
+    }
+    std::fclose( l_cpuinfo );
+  }
+#endif
+
+  //neon and sve provide 32 vector registers
+  m_vector_bytes = 16;
+  m_num_vector_registers = m_features.count( "asimd" ) ? 32 : 16;
+
+#if defined(__aarch64__) && defined(__linux__) && defined(HWCAP_SVE) && defined(PR_SVE_GET_VL)
+  //sve vectors have an implementation-defined length of at least 16 bytes
+  if( getauxval( AT_HWCAP ) & HWCAP_SVE ) {
+    int l_sve_vl = prctl( PR_SVE_GET_VL );
+    if( l_sve_vl > 0 ) {
+      m_vector_bytes = std::max( (int64_t) ( l_sve_vl & PR_SVE_VL_LEN_MASK ), (int64_t) 16 );
+    }
+  }
+#endif
+#endif
+}
+
+void einsum_ir::basic::HardwareTopology::init() {
+  init_caches();
+  init_cores();
+  init_isa();
+
+  m_num_nodes = NumaTopology::get_default()->get_num_nodes();
+}
+
+einsum_ir::basic::HardwareTopology * einsum_ir::basic::HardwareTopology::get_default() {
+  static HardwareTopology l_topology = [](){
+    HardwareTopology l_topo;
+    l_topo.init();
+    return l_topo;
+  }();
+
+  return &l_topology;
+}
+
+int64_t einsum_ir::basic::HardwareTopology::get_l1_cache_size() {
+  return m_l1_cache_size;
+}
+
+int64_t einsum_ir::basic::HardwareTopology::get_l2_cache_size() {
+  return m_l2_cache_size;
+}
+
+int64_t einsum_ir::basic::HardwareTopology::get_l3_cache_size() {
+  return m_l3_cache_size;
+}
+
+int64_t einsum_ir::basic::HardwareTopology::get_num_cpus() {
+  return m_num_cpus;
+}
+
+int64_t einsum_ir::basic::HardwareTopology::get_num_cores() {
+  return m_num_cores;
+}
+
+int64_t einsum_ir::basic::HardwareTopology::get_num_threads_per_core() {
+  return ( m_num_cpus + m_num_cores - 1 ) / m_num_cores;
+}
+
+int64_t einsum_ir::basic::HardwareTopology::get_num_nodes() {
+  return m_num_nodes;
+}
+
+int64_t einsum_ir::basic::HardwareTopology::get_vector_bytes() {
+  return m_vector_bytes;
+}
+
+int64_t einsum_ir::basic::HardwareTopology::get_num_vector_registers() {
+  return m_num_vector_registers;
+}
+
+bool einsum_ir::basic::HardwareTopology::has_feature( std::string const & i_feature ) {
+  return m_features.count( i_feature ) > 0;
+}
@@ -0,0 +1,159 @@
+#ifndef EINSUM_IR_BASIC_PARALLEL_HARDWARE_TOPOLOGY
+#define EINSUM_IR_BASIC_PARALLEL_HARDWARE_TOPOLOGY
+
+#include <set>
+#include <string>
+#include "../constants.h"
+
+namespace einsum_ir {
+  namespace basic {
+    class HardwareTopology;
+  }
+}
+
+/**
+ * Caches, core layout, NUMA nodes and ISA features of the machine.
+ * The default topology provides the hardware-dependent defaults of the optimizers, e.g., the L2 cache size.
+ * Values which cannot be detected keep conservative defaults.
+ **/
+class einsum_ir::basic::HardwareTopology {
+  private:
+    //! size of the L1 data cache in bytes
+    int64_t m_l1_cache_size = 32768;
+
+    //! size of the L2 cache in bytes
+    int64_t m_l2_cache_size = 1048576;
+
+    //! size of the L3 cache in bytes, zero if there is none
+    int64_t m_l3_cache_size = 0;
+
+    //! number of logical cpus
+    int64_t m_num_cpus = 1;
+
+    //! number of physical cores
+    int64_t m_num_cores = 1;
+
+    //! number of NUMA nodes with cpus
+    int64_t m_num_nodes = 1;
+
+    //! width of the vector registers in bytes
+    int64_t m_vector_bytes = 16;
+
+    //! number of vector registers
+    int64_t m_num_vector_registers = 16;
+
+    //! detected ISA features, e.g., avx2, avx512f or asimd
+    std::set< std::string > m_features;
+
+    /**
+     * Parses a cache size, e.g., 48K or 2M.
+     *
+     * @param i_str size.
+     *
+     * @return size in bytes, zero if the size could not be parsed.
+     **/
+    static int64_t parse_size( char const * i_str );
+
+    /**
+     * Reads the caches of cpu0 from sysfs.
+     **/
+    void init_caches();
+
+    /**
+     * Reads the number of logical cpus and physical cores from sysfs.
+     **/
+    void init_cores();
+
+    /**
+     * Detects the ISA features through cpuid on x86 and procfs otherwise and derives the vector registers.
+     * On aarch64, the vector width is the SVE vector length of the process if SVE is available.
+     **/
+    void init_isa();
+
+  public:
+    /**
+     * Initializes the topology of the executing machine.
+     **/
+    void init();
+
+    /**
+     * Gets the topology of the machine.
+     *
+     * @return topology.
+     **/
+    static HardwareTopology * get_default();
+
+    /**
+     * Gets the size of the L1 data cache.
+     *
+     * @return size in bytes.
+     **/
+    int64_t get_l1_cache_size();
+
+    /**
+     * Gets the size of the L2 cache.
+     *
+     * @return size in bytes.
+     **/
+    int64_t get_l2_cache_size();
+
+    /**
+     * Gets the size of the L3 cache.
+     *
+     * @return size in bytes, zero if there is none.
+     **/
+    int64_t get_l3_cache_size();
+
+    /**
+     * Gets the number of logical cpus.
+     *
+     * @return number of cpus.
+     **/
+    int64_t get_num_cpus();
+
+    /**
+     * Gets the number of physical cores.
+     *
+     * @return number of cores.
+     **/
+    int64_t get_num_cores();
+
+    /**
+     * Gets the number of hardware threads per core.
+     *
+     * @return number of threads per core.
+     **/
+    int64_t get_num_threads_per_core();
+
+    /**
+     * Gets the number of NUMA nodes with cpus.
+     *
+     * @return number of nodes.
+     **/
+    int64_t get_num_nodes();
+
+    /**
+     * Gets the width of the vector registers.
+     *
+     * @return width in bytes.
+     **/
+    int64_t get_vector_bytes();
+
+    /**
+     * Gets the number of vector registers.
+     *
+     * @return number of registers.
+     **/
+    int64_t get_num_vector_registers();
+
+    /**
+     * Checks if an ISA feature was detected.
+     *
+     * @param i_feature name of the feature, e.g., avx512f.
+     *
+     * @return true if the feature is available, false otherwise.
+     **/
+    bool has_feature( std::string const & i_feature );
+};
+
+#endif
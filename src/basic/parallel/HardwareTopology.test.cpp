@@ -0,0 +1,29 @@
+#include "catch.hpp"
+#include "HardwareTopology.h"
+#include "NumaTopology.h"
+
+TEST_CASE( "Discovery of the hardware topology.", "[hardware_topology]" ) {
+  using namespace einsum_ir::basic;
+
+  HardwareTopology * l_topology = HardwareTopology::get_default();
+
+  REQUIRE( l_topology->get_l1_cache_size() > 0 );
+  REQUIRE( l_topology->get_l2_cache_size() >= l_topology->get_l1_cache_size() );
+  REQUIRE( l_topology->get_l3_cache_size() >= 0 );
+
+  REQUIRE( l_topology->get_num_cores() >= 1 );
+  REQUIRE( l_topology->get_num_cpus() >= l_topology->get_num_cores() );
+  REQUIRE( l_topology->get_num_threads_per_core() >= 1 );
+  REQUIRE( l_topology->get_num_nodes() == NumaTopology::get_default()->get_num_nodes() );
+
+  int64_t l_vector_bytes = l_topology->get_vector_bytes();
+  // sve vectors are multiples of 16 bytes up to 256 bytes
+  REQUIRE( l_vector_bytes >= 16 );
+  REQUIRE( l_vector_bytes <= 256 );
+  REQUIRE( l_vector_bytes % 16 == 0 );
+  REQUIRE( l_topology->get_num_vector_registers() >= 16 );
+  if( l_topology->has_feature( "avx512f" ) ) {
+    REQUIRE( l_topology->has_feature( "avx2" ) );
+  }
+  REQUIRE( !l_topology->has_feature( "no_such_feature" ) );
+}
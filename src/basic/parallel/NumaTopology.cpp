@@ -0,0 +1,251 @@
+#include "NumaTopology.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+einsum_ir::basic::page_t einsum_ir::basic::NumaTopology::s_page_type = page_t::SMALL_PAGES;
+
+int64_t einsum_ir::basic::NumaTopology::round_size( int64_t i_size,
+                                                    page_t  i_page_type ) {
+  int64_t l_size_page = get_size_page( i_page_type );
+  return ( (i_size + l_size_page - 1) / l_size_page ) * l_size_page;
+}
+
+void einsum_ir::basic::NumaTopology::parse_cpu_list( char             const * i_list,
+                                                     std::vector< int64_t > & o_cpus ) {
+  o_cpus.clear();
+
+  char const * l_ptr = i_list;
+  while( *l_ptr != '\0' && *l_ptr != '\n' ) {
+    char * l_end = nullptr;
+    int64_t l_first = std::strtoll( l_ptr, &l_end, 10 );
+    if( l_end == l_ptr ) {
+      break;
+    }
+    int64_t l_last = l_first;
+    l_ptr = l_end;
+
+    if( *l_ptr == '-' ) {
+      l_last = std::strtoll( l_ptr + 1, &l_end, 10 );
+      l_ptr = l_end;
+    }
+    for( int64_t l_cpu = l_first; l_cpu <= l_last; l_cpu++ ) {
+      o_cpus.push_back( l_cpu );
+    }
+
+    if( *l_ptr == ',' ) {
+      l_ptr++;
+    }
+  }
+}
+
+void einsum_ir::basic::NumaTopology::init() {
+  m_cpus_node.clear();
+
+#ifdef __linux__
+  for( int64_t l_no = 0; true; l_no++ ) {
+    std::string l_path = "/sys/devices/system/node/node" + std::to_string( l_no ) + "/cpulist";
+    FILE * l_file = std::fopen( l_path.c_str(), "r" );
+    if( l_file == nullptr ) {
+      break;
+    }
+
+    char l_list[4096] = { 0 };
+    if( std::fgets( l_list, sizeof(l_list), l_file ) != nullptr ) {
+      std::vector< int64_t > l_cpus;
+      parse_cpu_list( l_list,
+                      l_cpus );
+      //nodes without cpus hold memory only
+      if( l_cpus.size() > 0 ) {
+        m_cpus_node.push_back( l_cpus );
+      }
+    }
+    std::fclose( l_file );
+  }
+#endif
+
+#ifdef __linux__
+  FILE * l_meminfo = std::fopen( "/proc/meminfo", "r" );
+  if( l_meminfo != nullptr ) {
+    char l_line[256] = { 0 };
+    while( std::fgets( l_line, sizeof(l_line), l_meminfo ) != nullptr ) {
+      long long l_size_kib = 0;
+      if( std::sscanf( l_line, "Hugepagesize: %lld kB", &l_size_kib ) == 1 && l_size_kib > 0 ) {
+        m_size_huge_page = l_size_kib * 1024;
+        break;
+      }
+    }
+    std::fclose( l_meminfo );
+  }
+#endif
+
+  if( m_cpus_node.size() == 0 ) {
+    int64_t l_num_cpus = std::thread::hardware_concurrency();
+    l_num_cpus = l_num_cpus > 0 ? l_num_cpus : 1;
+
+    m_cpus_node.resize( 1 );
+    for( int64_t l_cpu = 0; l_cpu < l_num_cpus; l_cpu++ ) {
+      m_cpus_node[0].push_back( l_cpu );
+    }
+  }
+}
+
+int64_t einsum_ir::basic::NumaTopology::get_num_nodes() {
+  return m_cpus_node.size();
+}
+
+int64_t einsum_ir::basic::NumaTopology::get_node( int64_t i_id_thread,
+                                                  int64_t i_num_threads ) {
+  int64_t l_num_nodes = m_cpus_node.size();
+  if( l_num_nodes <= 1 || i_num_threads <= 0 ) {
+    return 0;
+  }
+
+  return ( (i_id_thread % i_num_threads) * l_num_nodes ) / i_num_threads;
+}
+
+int64_t einsum_ir::basic::NumaTopology::get_cpu( int64_t i_id_thread,
+                                                 int64_t i_num_threads ) {
+  int64_t l_num_nodes = m_cpus_node.size();
+  int64_t l_node = get_node( i_id_thread,
+                             i_num_threads );
+
+  //first thread id of the node
+  int64_t l_first = ( l_node * i_num_threads + l_num_nodes - 1 ) / l_num_nodes;
+  int64_t l_id_local = (i_id_thread % i_num_threads) - l_first;
+
+  std::vector< int64_t > const & l_cpus = m_cpus_node[l_node];
+  return l_cpus[ l_id_local % l_cpus.size() ];
+}
+
+int64_t einsum_ir::basic::NumaTopology::get_size_huge_page() {
+  return m_size_huge_page;
+}
+
+int64_t einsum_ir::basic::NumaTopology::get_size_page( page_t i_page_type ) {
+  if(    i_page_type == page_t::SMALL_PAGES
+      || i_page_type == page_t::HEAP_MEMORY ) {
+    return 4096;
+  }
+  return get_default()->get_size_huge_page();
+}
+
+einsum_ir::basic::NumaTopology * einsum_ir::basic::NumaTopology::get_default() {
+  static NumaTopology l_topology = [](){
+    NumaTopology l_topo;
+    l_topo.init();
+    return l_topo;
+  }();
+
+  return &l_topology;
+}
+
+void einsum_ir::basic::NumaTopology::set_page_type( page_t i_page_type ) {
+  s_page_type = i_page_type;
+}
+
+einsum_ir::basic::page_t einsum_ir::basic::NumaTopology::get_page_type() {
+  return s_page_type;
+}
+
+char * einsum_ir::basic::NumaTopology::alloc_pages( int64_t   i_size,
+                                                    page_t  & io_page_type ) {
+#ifdef __linux__
+  void * l_ptr = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+  if( io_page_type == page_t::EXPLICIT_HUGE_PAGES ) {
+    l_ptr = mmap( nullptr,
+                  round_size( i_size,
+                              io_page_type ),
+                  PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                  -1,
+                  0 );
+    if( l_ptr != MAP_FAILED ) {
+      return (char *) l_ptr;
+    }
+  }
+#endif
+
+  if(    io_page_type == page_t::EXPLICIT_HUGE_PAGES
+      || io_page_type == page_t::TRANSPARENT_HUGE_PAGES ) {
+    //over-allocate and trim the mapping to huge page alignment
+    int64_t l_size = round_size( i_size,
+                                 page_t::TRANSPARENT_HUGE_PAGES );
+    int64_t l_size_page = get_size_page( page_t::TRANSPARENT_HUGE_PAGES );
+    l_ptr = mmap( nullptr,
+                  l_size + l_size_page,
+                  PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS,
+                  -1,
+                  0 );
+
+    if( l_ptr != MAP_FAILED ) {
+      char * l_ptr_raw = (char *) l_ptr;
+      int64_t l_offset = (unsigned long) l_ptr_raw % l_size_page;
+      l_offset = l_offset ? l_size_page - l_offset : 0;
+      if( l_offset > 0 ) {
+        munmap( l_ptr_raw,
+                l_offset );
+      }
+      if( l_size_page - l_offset > 0 ) {
+        munmap( l_ptr_raw + l_offset + l_size,
+                l_size_page - l_offset );
+      }
+
+#ifdef MADV_HUGEPAGE
+      madvise( l_ptr_raw + l_offset,
+               l_size,
+               MADV_HUGEPAGE );
+#endif
+
+      io_page_type = page_t::TRANSPARENT_HUGE_PAGES;
+      return l_ptr_raw + l_offset;
+    }
+  }
+
+  if( io_page_type != page_t::HEAP_MEMORY ) {
+    l_ptr = mmap( nullptr,
+                  round_size( i_size,
+                              page_t::SMALL_PAGES ),
+                  PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS,
+                  -1,
+                  0 );
+    if( l_ptr != MAP_FAILED ) {
+      io_page_type = page_t::SMALL_PAGES;
+      return (char *) l_ptr;
+    }
+  }
+#endif
+
+  //regular allocator, aligned to the base page size
+  io_page_type = page_t::HEAP_MEMORY;
+  return new (std::align_val_t( get_size_page( page_t::SMALL_PAGES ) )) char[ round_size( i_size,
+                                                                                        page_t::SMALL_PAGES ) ]();
+}
+
+void einsum_ir::basic::NumaTopology::free_pages( char    * i_ptr,
+                                                 int64_t   i_size,
+                                                 page_t    i_page_type ) {
+  if( i_page_type == page_t::HEAP_MEMORY ) {
+    operator delete[]( i_ptr,
+                       std::align_val_t( get_size_page( page_t::SMALL_PAGES ) ) );
+    return;
+  }
+
+#ifdef __linux__
+  munmap( i_ptr,
+          round_size( i_size,
+                      i_page_type ) );
+#else
+  (void) i_size;
+#endif
+}
@@ -0,0 +1,148 @@
+#ifndef EINSUM_IR_BASIC_PARALLEL_NUMA_TOPOLOGY
+#define EINSUM_IR_BASIC_PARALLEL_NUMA_TOPOLOGY
+
+#include <vector>
+#include "../constants.h"
+
+namespace einsum_ir {
+  namespace basic {
+    class NumaTopology;
+  }
+}
+
+/**
+ * NUMA topology of the machine and page-granular memory allocation with optional huge pages.
+ * Placement of memory follows the first-touch policy, i.e., pages are allocated on the NUMA node of the touching thread.
+ **/
+class einsum_ir::basic::NumaTopology {
+  private:
+    //! cpus of every NUMA node
+    std::vector< std::vector< int64_t > > m_cpus_node;
+
+    //! size of a huge page in bytes
+    int64_t m_size_huge_page = 2097152;
+
+    //! type of the pages which back the memory of the memory managers
+    static page_t s_page_type;
+
+  public:
+    /**
+     * Parses a cpu list, e.g., 0-3,8-11.
+     *
+     * @param i_list cpu list.
+     * @param o_cpus will be set to the parsed cpus.
+     **/
+    static void parse_cpu_list( char             const * i_list,
+                                std::vector< int64_t > & o_cpus );
+
+    /**
+     * Rounds the given size up to a multiple of the page size used by the given page type.
+     *
+     * @param i_size size in bytes.
+     * @param i_page_type type of the pages.
+     *
+     * @return rounded size in bytes.
+     **/
+    static int64_t round_size( int64_t i_size,
+                               page_t  i_page_type );
+
+    /**
+     * Initializes the topology from sysfs and the huge page size from procfs.
+     * Falls back to a single node with all cpus if the topology is not available.
+     **/
+    void init();
+
+    /**
+     * Gets the number of NUMA nodes.
+     *
+     * @return number of NUMA nodes.
+     **/
+    int64_t get_num_nodes();
+
+    /**
+     * Gets the NUMA node to which the given thread is assigned.
+     * Contiguous thread ids are distributed evenly in contiguous blocks to the nodes.
+     *
+     * @param i_id_thread id of the thread.
+     * @param i_num_threads total number of threads.
+     *
+     * @return id of the node.
+     **/
+    int64_t get_node( int64_t i_id_thread,
+                      int64_t i_num_threads );
+
+    /**
+     * Gets the cpu to which the given thread is pinned.
+     * The threads of a node are placed round-robin on the cpus of the node.
+     *
+     * @param i_id_thread id of the thread.
+     * @param i_num_threads total number of threads.
+     *
+     * @return id of the cpu.
+     **/
+    int64_t get_cpu( int64_t i_id_thread,
+                     int64_t i_num_threads );
+
+    /**
+     * Gets the size of a huge page.
+     *
+     * @return size of a huge page in bytes.
+     **/
+    int64_t get_size_huge_page();
+
+    /**
+     * Gets the page size which is used for the given page type.
+     *
+     * @param i_page_type type of the pages.
+     *
+     * @return size of a page in bytes.
+     **/
+    static int64_t get_size_page( page_t i_page_type );
+
+    /**
+     * Gets the topology of the machine.
+     *
+     * @return topology.
+     **/
+    static NumaTopology * get_default();
+
+    /**
+     * Sets the type of the pages which back the memory of the memory managers.
+     *
+     * @param i_page_type type of the pages.
+     **/
+    static void set_page_type( page_t i_page_type );
+
+    /**
+     * Gets the type of the pages which back the memory of the memory managers.
+     *
+     * @return type of the pages.
+     **/
+    static page_t get_page_type();
+
+    /**
+     * Allocates fresh zero-initialized memory without touching it.
+     * The memory is aligned to the page size of the page type.
+     * If the pages cannot be mapped, the allocation falls back to smaller pages and finally to the regular allocator.
+     *
+     * @param i_size size of the memory in bytes.
+     * @param io_page_type requested type of the pages, set to the type which was used for the allocation.
+     *
+     * @return pointer to the memory.
+     **/
+    static char * alloc_pages( int64_t   i_size,
+                               page_t  & io_page_type );
+
+    /**
+     * Frees memory which was allocated by alloc_pages.
+     *
+     * @param i_ptr pointer to the memory.
+     * @param i_size size of the memory in bytes.
+     * @param i_page_type type of the pages which was used for the allocation.
+     **/
+    static void free_pages( char    * i_ptr,
+                            int64_t   i_size,
+                            page_t    i_page_type );
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include "catch.hpp"
+#include "NumaTopology.h"
+
+TEST_CASE( "Threads are assigned in contiguous blocks to NUMA nodes.", "[numa_topology]" ) {
+  using namespace einsum_ir::basic;
+
+  NumaTopology * l_topology = NumaTopology::get_default();
+  int64_t l_num_nodes = l_topology->get_num_nodes();
+  REQUIRE( l_num_nodes >= 1 );
+
+  int64_t l_num_threads = 7 * l_num_nodes;
+  int64_t l_node_prev = 0;
+  for( int64_t l_id = 0; l_id < l_num_threads; l_id++ ) {
+    int64_t l_node = l_topology->get_node( l_id,
+                                           l_num_threads );
+    REQUIRE( l_node >= l_node_prev );
+    REQUIRE( l_node <= l_node_prev + 1 );
+    REQUIRE( l_node < l_num_nodes );
+    REQUIRE( l_topology->get_cpu( l_id, l_num_threads ) >= 0 );
+    l_node_prev = l_node;
+  }
+  REQUIRE( l_node_prev == l_num_nodes - 1 );
+}
+
+TEST_CASE( "Allocation of fresh pages.", "[numa_topology]" ) {
+  using namespace einsum_ir::basic;
+
+  page_t l_page_type_req = GENERATE( page_t::SMALL_PAGES,
+                                     page_t::TRANSPARENT_HUGE_PAGES,
+                                     page_t::EXPLICIT_HUGE_PAGES,
+                                     page_t::HEAP_MEMORY );
+  page_t l_page_type = l_page_type_req;
+
+  int64_t l_size = 3 * 4096 + 17;
+  char * l_ptr = NumaTopology::alloc_pages( l_size,
+                                            l_page_type );
+  REQUIRE( l_ptr != nullptr );
+  if( l_page_type_req == page_t::SMALL_PAGES ) {
+    REQUIRE( l_page_type != page_t::TRANSPARENT_HUGE_PAGES );
+    REQUIRE( l_page_type != page_t::EXPLICIT_HUGE_PAGES );
+  }
+  if( l_page_type_req == page_t::HEAP_MEMORY ) {
+    REQUIRE( l_page_type == page_t::HEAP_MEMORY );
+  }
+  REQUIRE( (unsigned long) l_ptr % 4096 == 0 );
+  if( l_page_type == page_t::TRANSPARENT_HUGE_PAGES ) {
+    REQUIRE( (unsigned long) l_ptr % NumaTopology::get_size_page( l_page_type ) == 0 );
+  }
+
+  int64_t l_errors = 0;
+  for( int64_t l_by = 0; l_by < l_size; l_by++ ) {
+    l_errors += l_ptr[l_by] != 0;
+    l_ptr[l_by] = 1;
+  }
+  REQUIRE( l_errors == 0 );
+
+  NumaTopology::free_pages( l_ptr,
+                            l_size,
+                            l_page_type );
+}
@@ -1,4 +1,5 @@
 #include "UnaryBackend.h"
+#include "../parallel/ExecutionContext.h"
 
 void einsum_ir::basic::UnaryBackend::init( std::vector< exec_t >  const & i_exec_types,
                                            std::vector< int64_t > const & i_dim_sizes,
@@ -155,10 +156,9 @@ void einsum_ir::basic::UnaryBackend::eval_iter_parallel( int64_t         i_id_lo
   
 
   // issue loop iterations
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(m_num_threads)
-#endif
-  for( int64_t l_it = 0; l_it < l_all_size; l_it++ ) {
+  ExecutionContext::get_default()->parallel_for( m_num_threads,
+                                                  l_all_size,
+                                                  [&]( int64_t l_it ) {
 
     char const * l_ptr_in  = i_ptr_in;
     char       * l_ptr_out = i_ptr_out;
@@ -184,7 +184,7 @@ void einsum_ir::basic::UnaryBackend::eval_iter_parallel( int64_t         i_id_lo
       kernel_main( l_ptr_in,
                    l_ptr_out );
     }
-  }
+  } );
 }
 
 einsum_ir::basic::err_t einsum_ir::basic::UnaryBackend::set_kernel_properties( ){
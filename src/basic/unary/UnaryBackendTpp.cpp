@@ -7,6 +7,18 @@ libxsmm_datatype einsum_ir::basic::UnaryBackendTpp::dtype_to_libxsmm( data_t i_d
   else if( i_dtype == FP64 ) {
     return libxsmm_datatype::LIBXSMM_DATATYPE_F64;
   }
+  else if( i_dtype == BF16 ) {
+    return libxsmm_datatype::LIBXSMM_DATATYPE_BF16;
+  }
+  else if( i_dtype == FP16 ) {
+    return libxsmm_datatype::LIBXSMM_DATATYPE_F16;
+  }
+  else if( i_dtype == INT8 ) {
+    return libxsmm_datatype::LIBXSMM_DATATYPE_I8;
+  }
+  else if( i_dtype == INT32 ) {
+    return libxsmm_datatype::LIBXSMM_DATATYPE_I32;
+  }
 
   return libxsmm_datatype::LIBXSMM_DATATYPE_UNSUPPORTED;
 }
@@ -54,9 +66,9 @@ einsum_ir::basic::err_t einsum_ir::basic::UnaryBackendTpp::compile_kernels(){
                                                                                                m_n,
                                                                                                m_lda,
                                                                                                m_ldb,
+                                                                                               l_xmm_dtype_in,
                                                                                                l_xmm_dtype_out,
-                                                                                               l_xmm_dtype_out,
-                                                                                               l_xmm_dtype_out );
+                                                                                               l_xmm_dtype_comp );
 
   libxsmm_meltw_binary_shape l_shape_single_touch_aux_binary = libxsmm_create_meltw_binary_shape( m_m,
                                                                                                   m_n,
@@ -64,32 +76,32 @@ einsum_ir::basic::err_t einsum_ir::basic::UnaryBackendTpp::compile_kernels(){
                                                                                                   m_lda,
                                                                                                   m_ldb,
                                                                                                   l_xmm_dtype_out,
+                                                                                                  l_xmm_dtype_in,
                                                                                                   l_xmm_dtype_out,
-                                                                                                  l_xmm_dtype_out,
-                                                                                                  l_xmm_dtype_out );
+                                                                                                  l_xmm_dtype_comp );
 
   //first touch kernel
   if( m_ktype == kernel_t::ZERO ) {
-    m_xmm_kernel_unary = libxsmm_dispatch_meltw_unary( LIBXSMM_MELTW_TYPE_UNARY_XOR,
-                                                       l_shape_single_touch,
-                                                       LIBXSMM_MELTW_FLAG_UNARY_NONE );
+    m_xmm_kernel_unary = KernelCacheTpp::get_default()->dispatch_unary( LIBXSMM_MELTW_TYPE_UNARY_XOR,
+                                                                        l_shape_single_touch,
+                                                                        LIBXSMM_MELTW_FLAG_UNARY_NONE );
   }
   else if( m_ktype == kernel_t::COPY ) {
     if(m_trans_a){
-      m_xmm_kernel_unary = libxsmm_dispatch_meltw_unary( LIBXSMM_MELTW_TYPE_UNARY_TRANSFORM_NORM_TO_NORMT,
-                                                        l_shape_single_touch_aux_unary,
-                                                        LIBXSMM_MELTW_FLAG_UNARY_NONE );
+      m_xmm_kernel_unary = KernelCacheTpp::get_default()->dispatch_unary( LIBXSMM_MELTW_TYPE_UNARY_TRANSFORM_NORM_TO_NORMT,
+                                                                         l_shape_single_touch_aux_unary,
+                                                                         LIBXSMM_MELTW_FLAG_UNARY_NONE );
     }
     else{
-      m_xmm_kernel_unary = libxsmm_dispatch_meltw_unary( LIBXSMM_MELTW_TYPE_UNARY_IDENTITY,
-                                                        l_shape_single_touch_aux_unary,
-                                                        LIBXSMM_MELTW_FLAG_UNARY_NONE );
+      m_xmm_kernel_unary = KernelCacheTpp::get_default()->dispatch_unary( LIBXSMM_MELTW_TYPE_UNARY_IDENTITY,
+                                                                         l_shape_single_touch_aux_unary,
+                                                                         LIBXSMM_MELTW_FLAG_UNARY_NONE );
     }
   }
   else if( m_ktype == kernel_t::ADD ) {
-    m_xmm_kernel_binary = libxsmm_dispatch_meltw_binary( LIBXSMM_MELTW_TYPE_BINARY_ADD,
-                                                         l_shape_single_touch_aux_binary,
-                                                         LIBXSMM_MELTW_FLAG_UNARY_NONE );
+    m_xmm_kernel_binary = KernelCacheTpp::get_default()->dispatch_binary( LIBXSMM_MELTW_TYPE_BINARY_ADD,
+                                                                          l_shape_single_touch_aux_binary,
+                                                                          LIBXSMM_MELTW_FLAG_UNARY_NONE );
   }
   else {
     return err_t::COMPILATION_FAILED;
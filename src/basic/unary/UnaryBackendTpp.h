@@ -3,6 +3,7 @@
 
 #include <libxsmm.h>
 #include "UnaryBackend.h"
+#include "../KernelCacheTpp.h"
 
 namespace einsum_ir {
   namespace basic {
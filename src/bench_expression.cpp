@@ -16,7 +16,7 @@ int main( int     i_argc,
     std::cerr << "  * dimension_sizes:  Dimension sizes have to be in ascending order of the dimension names." << std::endl;
     std::cerr << "                      ASCII numbers (see Example #3) are sorted by their numeric value." << std::endl;
     std::cerr << "  * contraction_path: Contraction path." << std::endl;
-    std::cerr << "  * dtype:            FP32, FP64, CPX_FP32 or CPX_FP64, default: FP32." << std::endl;
+    std::cerr << "  * dtype:            FP32, FP64, BF16, FP16, CPX_FP32 or CPX_FP64, default: FP32." << std::endl;
     std::cerr << "  * store_lock:       If 1 all einsum_ir input tensors are stored and locked before evaluation, default: 0." << std::endl;
     std::cerr << "  * print_tree:       If not 0 the einsum tree is printed (1: dimension ids, 2: characters), default: 0." << std::endl;
     std::cerr << std::endl;
@@ -129,6 +129,12 @@ int main( int     i_argc,
     else if( l_arg_dtype == "FP64" ) {
       l_dtype_at = at::ScalarType::Double;
     }
+    else if( l_arg_dtype == "BF16" ) {
+      l_dtype_at = at::ScalarType::BFloat16;
+    }
+    else if( l_arg_dtype == "FP16" ) {
+      l_dtype_at = at::ScalarType::Half;
+    }
     else if( l_arg_dtype == "CPX_FP32" ) {
       l_dtype_at = at::ScalarType::ComplexFloat;
     }
@@ -154,6 +160,12 @@ int main( int     i_argc,
   else if( l_dtype_einsum_ir == einsum_ir::FP64 ) {
     std::cout << "dtype: FP64" << std::endl;
   }
+  else if( l_dtype_einsum_ir == einsum_ir::BF16 ) {
+    std::cout << "dtype: BF16" << std::endl;
+  }
+  else if( l_dtype_einsum_ir == einsum_ir::FP16 ) {
+    std::cout << "dtype: FP16" << std::endl;
+  }
   else {
     std::cerr << "failed to determine dtype" << std::endl;
     return EXIT_FAILURE;
@@ -533,7 +545,14 @@ int main( int     i_argc,
     std::cout << "  frobenius norm of difference:                 " << l_frob_diff << std::endl;
     std::cout << "  relative error:                               " << l_err << std::endl;
 
-    double l_tol = (l_dtype_einsum_ir == einsum_ir::FP32) ? 1.0E-5 : 1.0E-12;
+    double l_tol = 1.0E-12;
+    if( l_dtype_einsum_ir == einsum_ir::FP32 ) {
+      l_tol = 1.0E-5;
+    }
+    else if(    l_dtype_einsum_ir == einsum_ir::BF16
+             || l_dtype_einsum_ir == einsum_ir::FP16 ) {
+      l_tol = 1.0E-2;
+    }
 
     if( l_err > l_tol ) {
       std::cerr << "warning: relative error is large!" << std::endl;
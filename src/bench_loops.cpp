@@ -0,0 +1,165 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "basic/binary/ContractionBackend.h"
+
+/**
+ * Contraction backend with empty kernels.
+ * Used to measure the overhead of the loops around the kernels.
+ **/
+class ContractionBackendEmpty: public einsum_ir::basic::ContractionBackend {
+  public:
+    void kernel_first_touch( void const *,
+                             void       * ) {}
+
+    void kernel_last_touch( void const *,
+                            void       * ) {}
+
+    void kernel_main( void const *,
+                      void const *,
+                      void       * ) {}
+
+    einsum_ir::basic::err_t compile_kernels() {
+      return einsum_ir::basic::err_t::SUCCESS;
+    }
+};
+
+/**
+ * Benchmarks the loop overhead per kernel call of the given loop nest type.
+ *
+ * @param i_loops loops of the contraction.
+ * @param i_loop_nest type of the loop nest.
+ * @param i_num_threads_m number of threads used for sfc m parallelization.
+ * @param i_num_threads_n number of threads used for sfc n parallelization.
+ * @param i_num_kernel_calls number of kernel calls per contraction.
+ * @param i_size_left size of the left tensor.
+ * @param i_size_right size of the right tensor.
+ * @param i_size_out size of the output tensor.
+ **/
+void bench_loops( std::vector< einsum_ir::basic::iter_property > const & i_loops,
+                  einsum_ir::basic::loop_nest_t                         i_loop_nest,
+                  int64_t                                               i_num_threads_m,
+                  int64_t                                               i_num_threads_n,
+                  int64_t                                               i_num_kernel_calls,
+                  int64_t                                               i_size_left,
+                  int64_t                                               i_size_right,
+                  int64_t                                               i_size_out ) {
+  std::vector< float > l_left(  i_size_left  );
+  std::vector< float > l_right( i_size_right );
+  std::vector< float > l_out(   i_size_out   );
+
+  ContractionBackendEmpty l_cont;
+  l_cont.init( i_loops,
+               einsum_ir::basic::FP32,
+               einsum_ir::basic::FP32,
+               einsum_ir::basic::FP32,
+               einsum_ir::basic::FP32,
+               einsum_ir::basic::ZERO,
+               einsum_ir::basic::MADD,
+               einsum_ir::basic::RELU,
+               1,
+               i_num_threads_m,
+               i_num_threads_n,
+               nullptr );
+
+  l_cont.set_loop_nest( i_loop_nest );
+  einsum_ir::basic::err_t l_err = l_cont.compile();
+  if( l_err != einsum_ir::basic::SUCCESS ) {
+    std::cerr << "error: failed to compile the contraction" << std::endl;
+    return;
+  }
+
+  // warm up
+  std::chrono::steady_clock::time_point l_tp0, l_tp1;
+  std::chrono::duration< double > l_dur;
+  l_tp0 = std::chrono::steady_clock::now();
+  l_cont.contract( l_left.data(),
+                   l_right.data(),
+                   nullptr,
+                   l_out.data() );
+  l_tp1 = std::chrono::steady_clock::now();
+  l_dur = std::chrono::duration_cast< std::chrono::duration< double> >( l_tp1 - l_tp0 );
+  int64_t l_repetitions = 1.0 / l_dur.count() + 1;
+
+  l_tp0 = std::chrono::steady_clock::now();
+  for( int64_t l_rep = 0; l_rep < l_repetitions; l_rep++ ) {
+    l_cont.contract( l_left.data(),
+                     l_right.data(),
+                     nullptr,
+                     l_out.data() );
+  }
+  l_tp1 = std::chrono::steady_clock::now();
+  l_dur = std::chrono::duration_cast< std::chrono::duration< double> >( l_tp1 - l_tp0 );
+  double l_time = l_dur.count() / l_repetitions;
+
+  std::cout << "  time (contract): " << l_time << std::endl;
+  std::cout << "  time per kernel call (ns): " << 1.0E9 * l_time / i_num_kernel_calls << std::endl;
+}
+
+int main( int     i_argc,
+          char  * i_argv[] ) {
+  std::cout << "running bench_loops!" << std::endl;
+
+  if( i_argc < 4 ) {
+    std::cerr << "Usage:" << std::endl;
+    std::cerr << "  bench_loops size_k size_m size_n num_threads_m num_threads_n" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Arguments:" << std::endl;
+    std::cerr << "  * size_k:        Size of the sequential K loop." << std::endl;
+    std::cerr << "  * size_m:        Size of the sfc M loop." << std::endl;
+    std::cerr << "  * size_n:        Size of the sfc N loop." << std::endl;
+    std::cerr << "  * num_threads_m: Number of threads in the sfc M loop, default: 1." << std::endl;
+    std::cerr << "  * num_threads_n: Number of threads in the sfc N loop, default: 1." << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Example:" << std::endl;
+    std::cerr << "  ./bench_loops 64 32 32 2 2" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  int64_t l_size_k = std::stoll( i_argv[1] );
+  int64_t l_size_m = std::stoll( i_argv[2] );
+  int64_t l_size_n = std::stoll( i_argv[3] );
+  int64_t l_num_threads_m = i_argc > 4 ? std::stoll( i_argv[4] ) : 1;
+  int64_t l_num_threads_n = i_argc > 5 ? std::stoll( i_argv[5] ) : 1;
+
+  /*
+   * loops of the contraction [k,m],[n,k]->[n,m] with kernels of size 1
+   */
+  using namespace einsum_ir::basic;
+  std::vector< iter_property > l_loops( 6 );
+  l_loops[0] = { dim_t::K, exec_t::SEQ,  l_size_k, l_size_m,        1, 0,        0, 0, 0 };
+  l_loops[1] = { dim_t::M, exec_t::SFC,  l_size_m,        1,        0, 0,        1, 0, 0 };
+  l_loops[2] = { dim_t::N, exec_t::SFC,  l_size_n,        0, l_size_k, 0, l_size_m, 0, 0 };
+  l_loops[3] = { dim_t::M, exec_t::PRIM,        1,        1,        0, 0,        1, 0, 0 };
+  l_loops[4] = { dim_t::N, exec_t::PRIM,        1,        0,        1, 0,        1, 0, 0 };
+  l_loops[5] = { dim_t::K, exec_t::PRIM,        1,        1,        1, 0,        0, 0, 0 };
+
+  int64_t l_num_kernel_calls = l_size_k * l_size_m * l_size_n;
+  std::cout << "kernel calls per contraction: " << l_num_kernel_calls << std::endl;
+
+  std::cout << "recursive loop nest:" << std::endl;
+  bench_loops( l_loops,
+               loop_nest_t::RECURSIVE,
+               l_num_threads_m,
+               l_num_threads_n,
+               l_num_kernel_calls,
+               l_size_k * l_size_m,
+               l_size_n * l_size_k,
+               l_size_n * l_size_m );
+
+  std::cout << "flat loop nest:" << std::endl;
+  bench_loops( l_loops,
+               loop_nest_t::FLAT,
+               l_num_threads_m,
+               l_num_threads_n,
+               l_num_kernel_calls,
+               l_size_k * l_size_m,
+               l_size_n * l_size_k,
+               l_size_n * l_size_m );
+
+  std::cout << "finished running bench_loops!" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -2,6 +2,7 @@
 #define EINSUM_IR_CONSTANTS
 
 #include <cstdint>
+#include <vector>
 #include "basic/constants.h"
 
 namespace einsum_ir {
@@ -48,6 +49,10 @@ namespace einsum_ir {
   typedef enum {
     FP32            = 0,
     FP64            = 1,
+    BF16            = 2,
+    FP16            = 3,
+    INT8            = 4,
+    INT32           = 5,
     UNDEFINED_DTYPE = 99
   } data_t;
 
@@ -74,9 +79,49 @@ namespace einsum_ir {
     BR_MADD         = 12,
     PACKED_MADD     = 13,
     CPX_PACKED_MADD = 14,
+    SCALE           = 15, // out = scalar_0 * out
+    ADD_SCALED      = 16, // out = out + scalar_0 * aux
+    MUL             = 17, // out = out * aux
+    SIGMOID         = 18,
+    TANH            = 19,
+    GELU            = 20,
+    CLAMP           = 21, // out = min( max( out, scalar_0 ), scalar_1 )
+    REQUANTIZE      = 22, // out = sat( round( scalar_0 * aux * acc ) + scalar_1 ), aux: per-channel scales if used
     UNDEFINED_KTYPE = 99
   } kernel_t;
 
+  struct last_touch_op {
+    kernel_t ktype    = kernel_t::UNDEFINED_KTYPE;
+    double   scalar_0 = 0;
+    double   scalar_1 = 0;
+  };
+
+  // block-sparse tensor: every dimension is partitioned into blocks, only the listed blocks are non-zero
+  // each non-zero block is stored as a dense tensor with the dimensions in the order of dim_ids
+  struct block_sparse_tensor {
+    std::vector< int64_t > dim_ids;   // dimension ids, outermost first
+    std::vector< int64_t > block_ids; // block ids of the non-zero blocks, dim_ids.size() entries per block
+  };
+
+  typedef enum {
+    COO               = 0,
+    CSF               = 1,
+    UNDEFINED_SFORMAT = 99
+  } sformat_t;
+
+  // sparse tensor: only the stored entries are non-zero, the dimensions are ordered as in the tensor's dimension ids
+  // COO: coords holds the coordinates of every non-zero, outermost dimension first
+  // CSF: level l of the fiber tree stores the coordinates of dimension l in crd[l],
+  //      the children of node x on level l-1 are pos[l][x] to pos[l][x+1]-1 on level l, pos[0] is { 0, #roots }
+  struct sparse_tensor {
+    sformat_t                      format  = sformat_t::UNDEFINED_SFORMAT;
+    int64_t                        num_nnz = 0;       // number of non-zeros
+    int64_t const                * coords  = nullptr; // COO: num_nnz x num_dims coordinates
+    std::vector< int64_t const * > pos;               // CSF: positions of the children, one array per level
+    std::vector< int64_t const * > crd;               // CSF: coordinates of the nodes, one array per level
+    void const                   * values  = nullptr; // values of the non-zeros, COO: order of the coordinates, CSF: order of the leaves
+  };
+
   typedef enum {
     AUTO   = 0,
     SCALAR = 1,
@@ -100,6 +145,10 @@ namespace einsum_ir {
   constexpr basic::data_t ce_dtype_to_basic( data_t i_dtype ) {
     if(      i_dtype == FP32 ) return basic::data_t::FP32;
     else if( i_dtype == FP64 ) return basic::data_t::FP64;
+    else if( i_dtype == BF16 ) return basic::data_t::BF16;
+    else if( i_dtype == FP16 ) return basic::data_t::FP16;
+    else if( i_dtype == INT8 ) return basic::data_t::INT8;
+    else if( i_dtype == INT32 ) return basic::data_t::INT32;
     else                       return basic::data_t::UNDEFINED_DTYPE;
   }
 
@@ -116,9 +165,23 @@ namespace einsum_ir {
     else if( i_ktype == BR_MADD         ) return basic::kernel_t::BR_MADD;
     else if( i_ktype == PACKED_MADD     ) return basic::kernel_t::PACKED_MADD;
     else if( i_ktype == CPX_PACKED_MADD ) return basic::kernel_t::CPX_PACKED_MADD;
+    else if( i_ktype == SCALE           ) return basic::kernel_t::SCALE;
+    else if( i_ktype == ADD_SCALED      ) return basic::kernel_t::ADD_SCALED;
+    else if( i_ktype == MUL             ) return basic::kernel_t::MUL;
+    else if( i_ktype == SIGMOID         ) return basic::kernel_t::SIGMOID;
+    else if( i_ktype == TANH            ) return basic::kernel_t::TANH;
+    else if( i_ktype == GELU            ) return basic::kernel_t::GELU;
+    else if( i_ktype == CLAMP           ) return basic::kernel_t::CLAMP;
+    else if( i_ktype == REQUANTIZE      ) return basic::kernel_t::REQUANTIZE;
     else                                  return basic::kernel_t::UNDEFINED_KTYPE;
   }
 
+  constexpr basic::last_touch_op ce_last_touch_op_to_basic( last_touch_op i_op ) {
+    return basic::last_touch_op{ ce_kernelt_to_basic( i_op.ktype ),
+                                 i_op.scalar_0,
+                                 i_op.scalar_1 };
+  }
+
   constexpr err_t ce_basic_err_to_err( basic::err_t i_err ) {
     if(      i_err == basic::err_t::SUCCESS                   ) return err_t::SUCCESS;
     else if( i_err == basic::err_t::COMPILATION_FAILED        ) return err_t::COMPILATION_FAILED;
@@ -129,6 +192,10 @@ namespace einsum_ir {
   constexpr int64_t ce_n_bytes( data_t i_dtype ) {
     if(      i_dtype == FP32 )  return 4;
     else if( i_dtype == FP64 )  return 8;
+    else if( i_dtype == BF16 )  return 2;
+    else if( i_dtype == FP16 )  return 2;
+    else if( i_dtype == INT8 )  return 1;
+    else if( i_dtype == INT32 ) return 4;
     else                        return -1;
   }
 
@@ -4,9 +4,8 @@
 #include <cmath>
 #include <string>
 #include <sstream>
-#ifdef _OPENMP
-#include "omp.h"
-#endif
+#include "../basic/parallel/ExecutionContext.h"
+#include "../basic/parallel/AsyncExecutor.h"
 
 void einsum_ir::frontend::EinsumExpression::histogram( int64_t         i_num_dims,
                                                        int64_t         i_string_size,
@@ -140,6 +139,21 @@ void einsum_ir::frontend::EinsumExpression::init( int64_t                 i_num_
         i_data_ptrs );
 }
 
+void einsum_ir::frontend::EinsumExpression::set_accumulate( bool i_accumulate ) {
+  m_accumulate = i_accumulate;
+}
+
+einsum_ir::err_t einsum_ir::frontend::EinsumExpression::set_sparse_input( int64_t               i_tensor_id,
+                                                                          sparse_tensor const * i_sparse ) {
+  if( i_tensor_id < 0 || !(i_tensor_id < m_num_conts+1) ) {
+    return err_t::INVALID_ID;
+  }
+
+  m_sparse_inputs[i_tensor_id] = i_sparse;
+
+  return err_t::SUCCESS;
+}
+
 einsum_ir::err_t einsum_ir::frontend::EinsumExpression::compile() {
   // derive contraction path using unqiue tensor ids
   m_path_int.resize( m_num_conts*2 );
@@ -253,17 +267,17 @@ einsum_ir::err_t einsum_ir::frontend::EinsumExpression::compile() {
                         m_dtype,
                         m_data_ptrs[l_te],
                         &m_memory );
+
+    if( m_sparse_inputs.count( l_te ) > 0 ) {
+      m_nodes[l_te].set_sparse( m_sparse_inputs.at( l_te ) );
+    }
   }
 
   // derive kernel types
   kernel_t l_ktype_first_touch = (m_ctype_ext == complex_t::REAL_ONLY) ? einsum_ir::ZERO : einsum_ir::CPX_ZERO;
   kernel_t l_ktype_main        = (m_ctype_ext == complex_t::REAL_ONLY) ? einsum_ir::MADD : einsum_ir::CPX_MADD;
 
-#ifdef _OPENMP
-  int64_t l_num_threads = omp_get_max_threads();
-#else
-  int64_t l_num_threads = 1;
-#endif
+  int64_t l_num_threads = basic::ExecutionContext::get_default()->get_max_threads();
 
   // add internal nodes
   for( int64_t l_co = 0; l_co < m_num_conts-1; l_co++ ) {
@@ -335,6 +349,14 @@ einsum_ir::err_t einsum_ir::frontend::EinsumExpression::compile() {
                          l_num_threads );
   }
 
+  // the root contraction writes the output tensor
+  if( m_accumulate ) {
+    if( m_ctype_ext == complex_t::BATCH_INNER ) {
+      return err_t::COMPILATION_FAILED;
+    }
+    m_nodes.back().set_accumulate( true );
+  }
+
   err_t l_err = m_nodes.back().compile();
 
   m_compiled = true;
@@ -372,6 +394,10 @@ void einsum_ir::frontend::EinsumExpression::eval() {
   m_nodes.back().eval();
 }
 
+std::future< void > einsum_ir::frontend::EinsumExpression::eval_async() {
+  return basic::AsyncExecutor::get_default()->submit( [this]() { eval(); } );
+}
+
 int64_t einsum_ir::frontend::EinsumExpression::num_ops() {
   if( m_nodes.size() > 0 ) {
     return m_nodes.back().num_ops( true );
@@ -2,6 +2,7 @@
 #define EINSUM_IR_FRONTEND_EINSUM_EXPRESSION
 
 #include <cstdint>
+#include <future>
 #include <string>
 #include "../backend/EinsumNode.h"
 
@@ -67,6 +68,12 @@ class einsum_ir::frontend::EinsumExpression {
     //! TODO: remove
     std::map< int64_t, int64_t > m_map_dim_sizes;
 
+    //! sparse input tensors by their ids in the einsum string
+    std::map< int64_t, sparse_tensor const * > m_sparse_inputs;
+
+    //! true if the expression adds to the output tensor
+    bool m_accumulate = false;
+
     //! nodes of the resulting einsum tree
     std::vector< backend::EinsumNode > m_nodes;
 
@@ -176,6 +183,28 @@ class einsum_ir::frontend::EinsumExpression {
                data_t                  i_dtype,
                void          * const * i_data_ptrs );
 
+    /**
+     * Declares an input tensor as sparse.
+     * The data pointer given in init is ignored for the tensor, the contraction consuming it uses a sparse-dense kernel.
+     * Has to be called before compile.
+     *
+     * @param i_tensor_id id of the input tensor in the einsum string.
+     * @param i_sparse sparse tensor whose dimensions are ordered as in the einsum string.
+     * @return SUCCESS if the id is valid, otherwise an appropiate error code.
+     **/
+    err_t set_sparse_input( int64_t               i_tensor_id,
+                            sparse_tensor const * i_sparse );
+
+    /**
+     * Sets the accumulate mode in which the evaluation adds to the output tensor instead of overwriting it.
+     * The root contraction accumulates directly into the output, e.g., to sum several expressions.
+     * Not supported for batch-inner complex tensors.
+     * Has to be called before compile.
+     *
+     * @param i_accumulate true if the expression accumulates into the output tensor.
+     **/
+    void set_accumulate( bool i_accumulate );
+
     /**
      * Compiles the einsum expression. 
      **/
@@ -200,6 +229,15 @@ class einsum_ir::frontend::EinsumExpression {
      */
     void eval();
 
+    /**
+     * Enqueues the evaluation of the einsum expression on the default async executor.
+     * Asynchronous contractions and evaluations are executed one after another in submission order.
+     * The expression and its tensors must not be used or modified until the returned future is ready.
+     *
+     * @return future which becomes ready once the evaluation finished.
+     */
+    std::future< void > eval_async();
+
     /**
      * Gets the number of scalar operations required to evaluate the expression.
      *
@@ -1,3 +1,5 @@
+#include <cmath>
+#include <vector>
 #include "catch.hpp"
 #include "EinsumExpression.h"
 
@@ -59,4 +61,74 @@ TEST_CASE( "Unique contraction path generation.", "[einsum_exp]" ) {
 
   REQUIRE( l_path_unique[4] == 3 );
   REQUIRE( l_path_unique[5] == 5 );
-}
\ No newline at end of file
+}
+TEST_CASE( "Queued asynchronous evaluations of einsum expressions.", "[einsum_exp]" ) {
+  // einsum: km,nk->nm
+  // m: 0, n: 1, k: 2
+  int64_t l_num_dims[3] = { 2, 2, 2 };
+  int64_t l_dim_ids[6]  = { 2, 0,
+                            1, 2,
+                            1, 0 };
+  int64_t l_path[2]     = { 0, 1 };
+
+  int64_t l_dim_sizes_0[3] = { 32, 24, 16 };
+  int64_t l_dim_sizes_1[3] = { 48, 20, 40 };
+  int64_t * l_dim_sizes[2] = { l_dim_sizes_0, l_dim_sizes_1 };
+
+  std::vector< float > l_left[2];
+  std::vector< float > l_right[2];
+  std::vector< float > l_out[2];
+  einsum_ir::frontend::EinsumExpression l_exprs[2];
+
+  for( int64_t l_ex = 0; l_ex < 2; l_ex++ ) {
+    int64_t l_size_m = l_dim_sizes[l_ex][0];
+    int64_t l_size_n = l_dim_sizes[l_ex][1];
+    int64_t l_size_k = l_dim_sizes[l_ex][2];
+
+    l_left[l_ex].resize( l_size_k * l_size_m );
+    l_right[l_ex].resize( l_size_n * l_size_k );
+    l_out[l_ex].resize( l_size_n * l_size_m );
+    for( std::size_t l_en = 0; l_en < l_left[l_ex].size(); l_en++ ) {
+      l_left[l_ex][l_en] = (float) ( (l_en + l_ex) % 11 ) - 5.0f;
+    }
+    for( std::size_t l_en = 0; l_en < l_right[l_ex].size(); l_en++ ) {
+      l_right[l_ex][l_en] = (float) ( (l_en + l_ex) % 7 ) - 3.0f;
+    }
+
+    void * l_data_ptrs[3] = { l_left[l_ex].data(),
+                              l_right[l_ex].data(),
+                              l_out[l_ex].data() };
+
+    l_exprs[l_ex].init( 3,
+                        l_dim_sizes[l_ex],
+                        1,
+                        l_num_dims,
+                        l_dim_ids,
+                        l_path,
+                        einsum_ir::FP32,
+                        l_data_ptrs );
+    REQUIRE( l_exprs[l_ex].compile() == einsum_ir::SUCCESS );
+  }
+
+  // both evaluations are queued before either finished, the executor runs them one after another
+  std::future< void > l_future_0 = l_exprs[0].eval_async();
+  std::future< void > l_future_1 = l_exprs[1].eval_async();
+  l_future_1.get();
+  l_future_0.get();
+
+  for( int64_t l_ex = 0; l_ex < 2; l_ex++ ) {
+    int64_t l_size_m = l_dim_sizes[l_ex][0];
+    int64_t l_size_n = l_dim_sizes[l_ex][1];
+    int64_t l_size_k = l_dim_sizes[l_ex][2];
+
+    for( int64_t l_n = 0; l_n < l_size_n; l_n++ ) {
+      for( int64_t l_m = 0; l_m < l_size_m; l_m++ ) {
+        float l_ref = 0;
+        for( int64_t l_k = 0; l_k < l_size_k; l_k++ ) {
+          l_ref += l_left[l_ex][ l_k * l_size_m + l_m ] * l_right[l_ex][ l_n * l_size_k + l_k ];
+        }
+        REQUIRE( std::abs( l_out[l_ex][ l_n * l_size_m + l_m ] - l_ref ) < 1E-3 );
+      }
+    }
+  }
+}
@@ -61,6 +61,65 @@ TEST_CASE( "Single matmul example using an einsum expression through the native
   REQUIRE( l_einsum_exp.num_ops() == 2*3*4*2 - 2*3 );
 }
 
+TEST_CASE( "Single matmul example using an einsum expression which accumulates into the output.", "[einsum_exp]" ) {
+  // test case:
+  //
+  //    ____nm___
+  //   /         \
+  // km           nk
+  //
+  // char   id   size
+  //    m    0     32
+  //    n    1     24
+  //    k    2     16
+
+  // data
+  at::Tensor l_left    = at::rand( {16, 32} );
+  at::Tensor l_right   = at::rand( {24, 16} );
+  at::Tensor l_out     = at::rand( {24, 32} );
+  at::Tensor l_out_ref = l_out.clone();
+
+  int64_t l_dim_sizes[3] = { 32, 24, 16 };
+
+  int64_t l_string_dim_ids[6] = { 2, 0,   // km
+                                  1, 2,   // nk
+                                  1, 0 }; // nm
+
+  int64_t l_string_num_dims[3] = { 2, 2, 2 };
+
+  void * l_data_ptrs[3] = { l_left.data_ptr(),
+                            l_right.data_ptr(),
+                            l_out.data_ptr() };
+
+  int64_t l_path[2] = { 0, 1 };
+
+  einsum_ir::frontend::EinsumExpression l_einsum_exp;
+
+  l_einsum_exp.init( 3,
+                     l_dim_sizes,
+                     1,
+                     l_string_num_dims,
+                     l_string_dim_ids,
+                     l_path,
+                     einsum_ir::FP32,
+                     l_data_ptrs );
+  l_einsum_exp.set_accumulate( true );
+
+  einsum_ir::err_t l_err = l_einsum_exp.compile();
+  REQUIRE( l_err == einsum_ir::SUCCESS );
+
+  // every evaluation adds to the output
+  l_einsum_exp.eval();
+  l_einsum_exp.eval();
+
+  // reference
+  l_out_ref += 2 * at::einsum( "km,nk->nm",
+                               {l_left, l_right} );
+
+  // check results
+  REQUIRE( at::allclose( l_out, l_out_ref, 1E-4, 1E-5 )  );
+}
+
 TEST_CASE( "Single batch-outer complex matmul example using an einsum expression through the native interface.", "[einsum_exp]" ) {
   // test case:
   //
@@ -160,7 +160,7 @@ class einsum_ir::frontend::EinsumExpressionAscii {
     /**
      * Extracts the data type from a string.
      * The input data type is expected to be in the following format:
-     * "FP32" or "FP64" or "CPX_FP32" or "CPX_FP64"
+     * "FP32" or "FP64" or "BF16" or "FP16" or "CPX_FP32" or "CPX_FP64"
      *
      * @param i_dtype_string data type string.
      * @param o_dtype will be set to extracted data type. 
@@ -171,7 +171,7 @@ class einsum_ir::frontend::EinsumExpressionAscii {
     /**
      * Extracts the complex type from a string.
      * The input complex type is expected to be in the following format:
-     * "FP32" or "FP64" or "CPX_FP32" or "CPX_FP64"
+     * "FP32" or "FP64" or "BF16" or "FP16" or "CPX_FP32" or "CPX_FP64"
      *
      * @param i_ctype_string complex type string.
      * @param o_ctype will be set to extracted complex type.